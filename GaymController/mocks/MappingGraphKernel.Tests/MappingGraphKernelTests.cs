@@ -1,4 +1,5 @@
 using GaymController.Mocks.Mapping;
+using GaymController.Shared.Contracts;
 using GaymController.Shared.Mapping;
 using Xunit;
 
@@ -24,6 +25,16 @@ public class MappingGraphKernelTests {
         Assert.Equal(1, b.EventCount);
     }
 
+    [Fact]
+    public void DispatchTracksNewestTimestamp() {
+        var kernel = new MappingGraphKernel();
+        kernel.AddNode(new DummyNode("A"));
+        kernel.Dispatch("A", new InputEvent("src", 1.0, 200, new LatencyTrace(7, 200_000)));
+        kernel.Dispatch("A", new InputEvent("src", 0.5, 150, new LatencyTrace(6, 150_000)));
+        Assert.Equal(200, kernel.LastTimestampUs);
+        Assert.Equal(7u, kernel.LastTrace.Sequence);
+    }
+
     [Fact]
     public void TickPropagatesToAllNodes(){
         var kernel = new MappingGraphKernel();
@@ -1,4 +1,5 @@
 using System.Collections.Generic;
+using GaymController.Shared.Contracts;
 using GaymController.Shared.Mapping;
 using GaymController.Interfaces.Mapping;
 
@@ -11,6 +12,15 @@ namespace GaymController.Mocks.Mapping {
         private readonly Dictionary<string, INode> _nodes = new();
         private readonly Dictionary<string, List<INode>> _edges = new();
 
+        /// <summary>Timestamp of the newest event dispatched into the graph.</summary>
+        public long LastTimestampUs { get; private set; }
+
+        /// <summary>
+        /// Latency trace of that newest event; the output stage hands it to
+        /// the SET_STATE sender with the state it produced.
+        /// </summary>
+        public LatencyTrace LastTrace { get; private set; }
+
         public void AddNode(INode node) {
             _nodes[node.Id] = node;
         }
@@ -28,6 +38,10 @@ namespace GaymController.Mocks.Mapping {
 
         public void Dispatch(string nodeId, InputEvent e) {
             if (!_nodes.TryGetValue(nodeId, out var node)) return;
+            if (e.TimestampUs > LastTimestampUs) {
+                LastTimestampUs = e.TimestampUs;
+                LastTrace = e.Trace;
+            }
             node.OnEvent(e);
             if (_edges.TryGetValue(nodeId, out var list)) {
                 foreach (var n in list) n.OnEvent(e);
@@ -0,0 +1,93 @@
+// Analog history store: append cost per 8 kHz frame, footprint for a few
+// minutes of 128 keys, and windowed query/decode speed.
+#include "gc/AnalogHistory.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t kKeys = 128;
+constexpr uint32_t kRateHz = 8000;
+constexpr uint32_t kSeconds = 180;
+constexpr uint32_t kBlock = 1024;
+
+double Seconds(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+// A gaming session: WASD-style keys travel and hold with sensor jitter,
+// a handful of others tap now and then, the rest stay idle.
+struct Session {
+    uint32_t S = 7;
+    int Cur[kKeys] = {};
+    int Target[kKeys] = {};
+    uint32_t Next() { S = S * 1664525u + 1013904223u; return S >> 8; }
+    void Step(uint8_t* frame) {
+        for (uint32_t k = 0; k < 16; ++k) {
+            if (Next() % (k < 4 ? 4000 : 24000) == 0) Target[k] = Target[k] ? 0 : 230 + int(Next() % 25);
+            int d = Target[k] - Cur[k];
+            Cur[k] += d > 2 ? 3 : d < -2 ? -3 : d;
+            int v = Cur[k] + (Cur[k] > 0 && Next() % 4 == 0 ? int(Next() % 3) - 1 : 0);
+            frame[k] = uint8_t(v < 0 ? 0 : v > 255 ? 255 : v);
+        }
+    }
+};
+
+} // namespace
+
+int main() {
+    const uint32_t frames = kRateHz * kSeconds;
+    GC_HISTORY_CONFIG cfg{kKeys, kBlock, frames / kBlock + 1, 4u << 20};
+    PGC_HISTORY h = GcHistoryCreate(&cfg);
+    if (!h) return 1;
+
+    Session s;
+    std::vector<uint8_t> frame(kKeys, 0);
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t f = 0; f < frames; ++f) {
+        s.Step(frame.data());
+        GcHistoryAppend(h, frame.data());
+    }
+    double appendS = Seconds(t0);
+    // Same loop without the store, to subtract signal generation.
+    Session s2;
+    t0 = std::chrono::steady_clock::now();
+    for (uint32_t f = 0; f < frames; ++f) s2.Step(frame.data());
+    double genS = Seconds(t0);
+
+    uint64_t kept = GcHistoryFrames(h) - GcHistoryOldestFrame(h);
+    std::printf("%u keys, %u s at %u Hz: %llu frames kept (%.1f s)\n", kKeys, kSeconds, kRateHz,
+                (unsigned long long)kept, kept / double(kRateHz));
+    std::printf("append          %8.1f ns/frame\n", (appendS - genS) * 1e9 / frames);
+    std::printf("memory          %8.2f MB total, %.2f MB coded (raw 8-bit would be %.1f MB)\n",
+                GcHistoryMemoryBytes(h) / 1048576.0, GcHistoryCodedBytes(h) / 1048576.0,
+                double(kept) * kKeys / 1048576.0);
+
+    // Last 2 seconds of every key.
+    const uint64_t end = GcHistoryFrames(h), window = 2 * kRateHz;
+    GC_HISTORY_STATS st;
+    volatile uint64_t sink = 0;
+    for (uint8_t thr : {uint8_t(0), uint8_t(128)}) {
+        const int reps = 20;
+        t0 = std::chrono::steady_clock::now();
+        for (int r = 0; r < reps; ++r)
+            for (uint32_t k = 0; k < kKeys; ++k) {
+                GcHistoryQuery(h, k, end - window, end, thr, &st);
+                sink += st.Sum + st.Crossings;
+            }
+        double q = Seconds(t0) / (reps * kKeys);
+        std::printf("query 2 s thr=%-3u %6.2f us/key (%.2f ns/sample)\n", thr, q * 1e6, q * 1e9 / window);
+    }
+
+    std::vector<uint8_t> out(window);
+    t0 = std::chrono::steady_clock::now();
+    for (uint32_t k = 0; k < kKeys; ++k) sink += GcHistoryRead(h, k, end - window, end, out.data());
+    double rd = Seconds(t0) / kKeys;
+    std::printf("read 2 s        %6.2f us/key (%.2f ns/sample)\n", rd * 1e6, rd * 1e9 / window);
+
+    GcHistoryDestroy(h);
+    return sink == 0;
+}
@@ -0,0 +1,132 @@
+// Per-report matching cost against profile size: ns per Evaluate of the
+// compiled matcher for 1..1000 bindings over the same synthetic report
+// stream, against the legacy approach of asking every binding in turn
+// whether its keys are down.
+#include "gc/Bindings.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+using namespace gc::bind;
+
+namespace {
+
+constexpr int kReports = 1 << 18;
+constexpr uint8_t kMods[4] = {0x10, 0x11, 0x12, 0x5B};   // Shift Ctrl Alt Win
+
+// Fixed-seed profile: mostly modifier chords, some tap/holds, toggles and
+// two- to four-key sequences.
+std::vector<Binding> Profile(int n) {
+    std::vector<Binding> b;
+    uint32_t s = 7;
+    auto next = [&] { return s = s * 1664525u + 1013904223u; };
+    for (int i = 0; i < n; ++i) {
+        Binding x;
+        x.Action = uint8_t(i);
+        uint32_t r = next();
+        switch (r % 8) {
+        case 0:
+            x.Type = Kind::TapHold;
+            x.Keys = {uint8_t(0x30 + next() % 64)};
+            x.HoldAction = uint8_t(i + 1);
+            break;
+        case 1:
+            x.Type = Kind::Toggle;
+            x.Keys = {kMods[next() % 4], uint8_t(0x70 + next() % 24)};
+            break;
+        case 2:
+            x.Type = Kind::Sequence;
+            for (uint32_t k = 0, len = 2 + next() % 3; k < len; ++k) x.Keys.push_back(uint8_t(0x30 + next() % 64));
+            break;
+        default: {
+            x.Type = Kind::Hold;
+            uint32_t mods = 1 + next() % 15;
+            for (int m = 0; m < 4; ++m)
+                if (mods >> m & 1) x.Keys.push_back(kMods[m]);
+            x.Keys.push_back(uint8_t(0x60 + next() % 128));
+            break;
+        }
+        }
+        b.push_back(x);
+    }
+    return b;
+}
+
+// 1 ms reports, like typing while gaming: each presses one key and lets go
+// of the one pressed three reports earlier; a quarter of them toggle a
+// modifier instead.
+struct Report {
+    uint64_t Pressed[4];
+    uint64_t NowUs;
+};
+
+std::vector<Report> Stream() {
+    std::vector<Report> r(4096);
+    uint64_t p[4] = {};
+    uint8_t recent[3] = {};
+    uint32_t s = 11;
+    for (size_t i = 0; i < r.size(); ++i) {
+        s = s * 1664525u + 1013904223u;
+        if ((s >> 30) == 0) {
+            uint8_t mod = kMods[(s >> 20) & 3];
+            p[mod >> 6] ^= 1ull << (mod & 63);
+        } else {
+            uint8_t& slot = recent[i % 3];
+            if (slot) p[slot >> 6] &= ~(1ull << (slot & 63));
+            slot = uint8_t(0x30 + (s >> 12) % 176);
+            p[slot >> 6] |= 1ull << (slot & 63);
+        }
+        std::copy(p, p + 4, r[i].Pressed);
+        r[i].NowUs = i * 1000;
+    }
+    return r;
+}
+
+template <class Fn>
+double NsPerReport(Fn&& fn) {
+    for (int i = 0; i < kReports / 16; ++i) fn(i);
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < kReports; ++i) fn(i);
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / kReports;
+}
+
+volatile size_t g_sink;
+
+} // namespace
+
+int main() {
+    const std::vector<Report> stream = Stream();
+    std::printf("bindings   compiled ns/report   per-binding scan ns/report\n");
+    for (int n : {1, 10, 100, 1000}) {
+        std::vector<Binding> profile = Profile(n);
+        Program p;
+        if (p.Compile(profile) != CompileStatus::Ok) return 1;
+        Matcher m(p);
+        std::vector<Event> out;
+        double compiled = NsPerReport([&](int i) {
+            const Report& r = stream[i & 4095];
+            m.Evaluate(r.Pressed, uint64_t(i) * 1000, out);
+            g_sink = g_sink + out.size();
+        });
+
+        // Legacy: every binding checks its keys each report and edges on the
+        // result (chords only; the legacy code had no sequences).
+        std::vector<uint8_t> was(profile.size());
+        double scan = NsPerReport([&](int i) {
+            const Report& r = stream[i & 4095];
+            size_t events = 0;
+            for (size_t b = 0; b < profile.size(); ++b) {
+                bool all = true;
+                for (uint8_t k : profile[b].Keys) all = all && (r.Pressed[k >> 6] >> (k & 63) & 1);
+                if (all != bool(was[b])) events++;
+                was[b] = all;
+            }
+            g_sink = g_sink + events;
+        });
+        std::printf("%8d %20.1f %28.1f\n", n, compiled, scan);
+    }
+    return 0;
+}
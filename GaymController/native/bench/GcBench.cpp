@@ -0,0 +1,877 @@
+// Unified native benchmark suite (GC-PAR-030): one binary, fixed seeds,
+// JSON results, a run-to-run comparison and a soak mode.
+//
+//   GcBench [run] [--filter S] [--json FILE] [--seed N] [--cpu N|--no-pin]
+//                 [--reps N] [--sample-ms N] [--warmup-ms N]
+//   GcBench compare BASE.json NEW.json [--threshold PCT] [--alpha P]
+//   GcBench soak [--seconds N] [--window-s N] [--json FILE] [--seed N]
+//                [--cpu N|--no-pin] [--max-rss-kb N] [--max-drift PCT]
+//   GcBench list
+//
+// run: every case is warmed up, calibrated to --sample-ms per sample and
+// sampled --reps times; each sample is ns per operation. Inputs come from
+// one seeded generator, so two runs with the same seed do the same work.
+// The thread is pinned to one CPU (the one it started on unless --cpu).
+//
+// compare: Mann-Whitney U on the per-sample values of each case (robust
+// to the skew timing samples have). A case regresses when its median got
+// slower by more than --threshold (default 5%) and p < --alpha (default
+// 0.01). Exit code 1 when anything regressed.
+//
+// soak: the graph.tick pipeline back to back for --seconds, with device
+// add/remove churn on the host WDK every window. Per window it records
+// RSS and tick latency percentiles; fails (exit 1) when RSS grew more than
+// --max-rss-kb after the first window or the median tick drifted more
+// than --max-drift (default 10%).
+//
+// The func/bus IOCTL cases and the IOCTL stage of graph.tick need the host
+// WDK (gc_vpad_host, gcc/clang builds).
+#include "gc/Bindings.h"
+#include "gc/KeyState.h"
+#include "gc/RecoilPattern.h"
+#include "gc/StickDsp.h"
+#include "gc/Wire.h"
+#ifdef GC_BENCH_HOST
+#include "gc/HostWdk.h"   // before VPadShared.h: the host CTL_CODE is unsigned
+#endif
+#include "VPadShared.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+volatile uint64_t g_sink;
+
+double NsSince(Clock::time_point t0) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+}
+
+// ---- seeded inputs ----
+
+struct Rng {
+    explicit Rng(uint64_t seed) : S(seed * 0x9E3779B97F4A7C15ull + 1) {}
+    uint32_t Next() {
+        S ^= S << 13; S ^= S >> 7; S ^= S << 17;
+        return (uint32_t)(S >> 32);
+    }
+    uint32_t Below(uint32_t n) { return (uint32_t)(((uint64_t)Next() * n) >> 32); }
+    int16_t Q15() { return (int16_t)(Next() >> 16); }
+    uint64_t S;
+};
+
+// ---- cases ----
+
+struct Case {
+    std::string Name;
+    std::string Desc;
+    uint32_t OpsPerBatch;
+    std::function<void()> Batch;
+};
+
+constexpr size_t kStates = 256;
+constexpr size_t kSticks = 1024;
+
+GC_GAMEPAD_STATE RandomState(Rng& r) {
+    GC_GAMEPAD_STATE s;
+    s.LX = (uint16_t)r.Next(); s.LY = (uint16_t)r.Next();
+    s.RX = (uint16_t)r.Next(); s.RY = (uint16_t)r.Next();
+    s.LT = (uint16_t)r.Next(); s.RT = (uint16_t)r.Next();
+    s.Buttons = r.Next() & 0xFFFF;
+    return s;
+}
+
+// What the broker hands the func driver: offset-binary sticks to signed,
+// 16-bit triggers to 8 (VPadDriver.cs).
+VPAD_STATE ToVPad(const GC_GAMEPAD_STATE& s) {
+    VPAD_STATE v;
+    v.Buttons = (uint16_t)s.Buttons;
+    v.LeftTrigger = (uint8_t)(s.LT >> 8);
+    v.RightTrigger = (uint8_t)(s.RT >> 8);
+    v.LX = (int16_t)(s.LX ^ 0x8000); v.LY = (int16_t)(s.LY ^ 0x8000);
+    v.RX = (int16_t)(s.RX ^ 0x8000); v.RY = (int16_t)(s.RY ^ 0x8000);
+    return v;
+}
+
+void AddWireCases(std::vector<Case>& out, uint64_t seed) {
+    struct State {
+        std::vector<GC_GAMEPAD_STATE> States;
+        std::vector<uint8_t> Frames;   // packed back to back, every other traced
+        uint8_t Out[64];
+    };
+    auto st = std::make_shared<State>();
+    Rng r(seed);
+    for (size_t i = 0; i < kStates; ++i) {
+        st->States.push_back(RandomState(r));
+        GC_TRACE t = { (uint32_t)i, 0, 1000 * i };
+        uint8_t f[64];
+        size_t n = GcWirePackSetState(f, sizeof(f), i + 1, &st->States.back(), (i & 1) ? &t : nullptr);
+        st->Frames.insert(st->Frames.end(), f, f + n);
+    }
+    out.push_back({"wire.pack_set_state", "GcWirePackSetState, no trace", kStates, [st] {
+        size_t n = 0;
+        for (size_t i = 0; i < kStates; ++i)
+            n += GcWirePackSetState(st->Out, sizeof(st->Out), i + 1, &st->States[i], nullptr);
+        g_sink = g_sink + n;
+    }});
+    out.push_back({"wire.parse_set_state", "GcWireParseFrame + GcWireReadSetState, half traced", kStates, [st] {
+        const uint8_t* p = st->Frames.data();
+        size_t left = st->Frames.size();
+        uint64_t h = 0;
+        GC_WIRE_FRAME f;
+        GC_WIRE_SET_STATE s;
+        while (GcWireParseFrame(p, left, &f) == GC_WIRE_OK) {
+            if (GcWireReadSetState(&f, &s) == GC_WIRE_OK) h += s.Handle + s.State.LX;
+            p += f.Length; left -= f.Length;
+        }
+        g_sink = g_sink + h;
+    }});
+}
+
+void AddDspCases(std::vector<Case>& out, uint64_t seed) {
+    struct State {
+        std::vector<int16_t> SrcX, SrcY, X, Y;
+        std::vector<float> SrcFx, SrcFy, Fx, Fy;
+        std::vector<int32_t> Ex, Ey, Dx, Dy;
+        GC_ONE_EURO_PARAMS_Q15 Euro = { 1000, 500, 1000, 1000 };
+        GC_STICKS_Q15 Q() { X = SrcX; Y = SrcY; return { X.data(), Y.data(), X.size() }; }
+        GC_STICKS_F F() { Fx = SrcFx; Fy = SrcFy; return { Fx.data(), Fy.data(), Fx.size() }; }
+    };
+    auto st = std::make_shared<State>();
+    Rng r(seed ^ 0xD5Fu);
+    for (size_t i = 0; i < kSticks; ++i) {
+        st->SrcX.push_back(r.Q15());
+        st->SrcY.push_back(r.Q15());
+    }
+    st->SrcFx.resize(kSticks); st->SrcFy.resize(kSticks);
+    GcDspFromQ15(st->SrcX.data(), st->SrcFx.data(), kSticks);
+    GcDspFromQ15(st->SrcY.data(), st->SrcFy.data(), kSticks);
+    st->Ex.assign(kSticks, 0); st->Ey.assign(kSticks, 0);
+    st->Dx.assign(kSticks, 0); st->Dy.assign(kSticks, 0);
+
+    // The input copy is part of every sample; it is the same for all
+    // seeds and builds, so it cancels out of a comparison.
+    out.push_back({"dsp.curve_q15", "GcDspRadialCurveQ15 per stick (with input copy)", kSticks, [st] {
+        GcDspRadialCurveQ15(st->Q(), 19661, 32767);
+        g_sink = g_sink + (uint16_t)st->X[7];
+    }});
+    out.push_back({"dsp.curve_f", "GcDspRadialCurveF per stick (with input copy)", kSticks, [st] {
+        GcDspRadialCurveF(st->F(), 0.6f, 1.0f);
+        g_sink = g_sink + (uint64_t)(st->Fx[7] * 1000.0f);
+    }});
+    out.push_back({"dsp.chain_q15", "deadzone, anti-deadzone, curve, one-euro, clamp per stick", kSticks, [st] {
+        GC_STICKS_Q15 s = st->Q();
+        GcDspRadialDeadzoneQ15(s, 3277, 1);
+        GcDspAntiDeadzoneQ15(s, 1638, 32767);
+        GcDspRadialCurveQ15(s, 19661, 32767);
+        GcDspOneEuroQ15(s, &st->Euro, { st->Ex.data(), st->Ey.data(), st->Dx.data(), st->Dy.data() });
+        GcDspCircularClampQ15(s, 32767);
+        g_sink = g_sink + (uint16_t)st->X[7];
+    }});
+}
+
+#ifdef GC_BENCH_HOST
+using Device = std::shared_ptr<void>;
+
+Device AddDevice(GC_HOST_DRIVER_ENTRY* entry) {
+    WDFDEVICE d = nullptr;
+    if (GcHostAddDevice(entry, &d) != STATUS_SUCCESS) {
+        std::fprintf(stderr, "host device add failed\n");
+        std::exit(2);
+    }
+    return Device(d, [](void* p) { GcHostRemoveDevice(p); });
+}
+
+void AddIoctlCases(std::vector<Case>& out, uint64_t seed) {
+    struct State {
+        Device Func, Bus;
+        std::vector<VPAD_STATE> States;
+    };
+    auto st = std::make_shared<State>();
+    st->Func = AddDevice(GcVPadFuncDriverEntry);
+    st->Bus = AddDevice(GcVPadBusDriverEntry);
+    Rng r(seed ^ 0x10C7u);
+    for (size_t i = 0; i < kStates; ++i) st->States.push_back(ToVPad(RandomState(r)));
+
+    out.push_back({"func.ioctl_set_state",
+                   "IOCTL_VPAD_SET_STATE through the host WDK: buffer, clamp, report pack, VHF submit",
+                   kStates, [st] {
+        size_t info;
+        for (const VPAD_STATE& s : st->States)
+            GcHostIoctl(st->Func.get(), IOCTL_VPAD_SET_STATE, &s, sizeof(s), nullptr, 0, &info);
+        g_sink = g_sink + GcHostVhfSubmits(st->Func.get());
+    }});
+    out.push_back({"func.ioctl_get_pressure", "IOCTL_VPAD_GET_PRESSURE through the host WDK", 64, [st] {
+        VPAD_PRESSURE p;
+        size_t info;
+        for (int i = 0; i < 64; ++i)
+            GcHostIoctl(st->Func.get(), IOCTL_VPAD_GET_PRESSURE, nullptr, 0, &p, sizeof(p), &info);
+        g_sink = g_sink + p.Submitted;
+    }});
+    out.push_back({"func.vhf_output", "rumble output report into VPadOnVhfProcessOutput", 64, [st] {
+        for (int i = 0; i < 64; ++i) {
+            const UCHAR rumble[2] = { (UCHAR)i, (UCHAR)(255 - i) };
+            GcHostVhfWrite(st->Func.get(), 1, rumble, sizeof(rumble));
+        }
+    }});
+    out.push_back({"bus.ioctl_get_padcount", "IOCTL_VPADBUS_GET_PADCOUNT through the host WDK", 64, [st] {
+        ULONG n = 0;
+        size_t info;
+        for (int i = 0; i < 64; ++i)
+            GcHostIoctl(st->Bus.get(), IOCTL_VPADBUS_GET_PADCOUNT, nullptr, 0, &n, sizeof(n), &info);
+        g_sink = g_sink + n;
+    }});
+}
+#endif
+
+// One tick of the native side of the mapping graph for one pad, in graph
+// order: key report -> hotkey matcher -> WASD stick -> right-stick DSP ->
+// recoil mix -> SET_STATE frame (app) -> parse (broker) -> IOCTL (driver).
+class Graph {
+public:
+    static constexpr uint8_t kFire = 0x01;   // VK_LBUTTON
+    static constexpr uint8_t kActionFire = 1;
+    static constexpr uint32_t kTickUs = 1000;
+
+    explicit Graph(uint64_t seed) {
+        GcKeyInit(&Keys, 128, 96);
+        using gc::bind::Binding;
+        using gc::bind::Kind;
+        std::vector<Binding> profile;
+        profile.push_back({Kind::Hold, {kFire}, kActionFire, 0, 0});
+        profile.push_back({Kind::TapHold, {'F'}, 2, 3, 200000});
+        profile.push_back({Kind::Toggle, {0x14 /* caps */}, 4, 0, 0});
+        profile.push_back({Kind::Sequence, {'G', 'G'}, 5, 0, 0});
+        for (uint8_t k = 'A'; k <= 'Z'; ++k) {
+            profile.push_back({Kind::Hold, {0x11 /* ctrl */, k}, (uint8_t)(16 + k - 'A'), 0, 0});
+            profile.push_back({Kind::Hold, {0x10 /* shift */, k}, (uint8_t)(48 + k - 'A'), 0, 0});
+        }
+        Prog.Compile(profile);
+        Match = std::make_unique<gc::bind::Matcher>(Prog);
+
+        // 30 shots at 600 RPM, pulling down and drifting right.
+        std::vector<GC_RECOIL_POINT> pts;
+        Rng r(seed ^ 0xEC011u);
+        for (uint32_t i = 0; i < 30; ++i)
+            pts.push_back({i * 100000, (int16_t)(r.Below(600) - 300), (int16_t)(-400 - (int16_t)r.Below(400))});
+        GC_RECOIL_DESC d = { pts.data(), (uint32_t)pts.size(), GC_RECOIL_KEY_TIME_US, 0, 0 };
+        RecoilMem.resize((GcRecoilBakeBytes(&d) + 3) / 4);
+        Recoil = GcRecoilBake(RecoilMem.data(), RecoilMem.size() * 4, &d);
+        GcRecoilMixerInit(&Mixer);
+
+        // Scripted input: a key edge on about one tick in six, the mouse
+        // moving every tick.
+        const uint8_t keys[] = { 'W', 'A', 'S', 'D', 'F', 'G', 'E', 'R', 0x10, 0x11, 0x14, kFire };
+        for (size_t i = 0; i < 4096; ++i) {
+            Step s = { 0, 0, r.Q15(), r.Q15() };
+            if (r.Below(6) == 0) { s.Key = keys[r.Below(sizeof(keys))]; s.Toggle = 1; }
+            Script.push_back(s);
+        }
+#ifdef GC_BENCH_HOST
+        Func = AddDevice(GcVPadFuncDriverEntry);
+#endif
+    }
+
+    void Tick() {
+        const Step& s = Script[Pos];
+        Pos = (Pos + 1) % Script.size();
+        Now += kTickUs;
+        if (s.Toggle) {
+            if (GcKeyIsDown(&Keys, s.Key)) GcKeyUp(&Keys, s.Key);
+            else GcKeyDown(&Keys, s.Key);
+        }
+
+        Match->Evaluate(Keys, Now, Events);
+        for (const auto& e : Events) {
+            if (e.Action != kActionFire) continue;
+            if (e.Down && RecoilId < 0) RecoilId = GcRecoilStart(&Mixer, Recoil, 32768);
+            else if (!e.Down && RecoilId >= 0) { GcRecoilStop(&Mixer, RecoilId); RecoilId = -1; }
+        }
+
+        int16_t lx, ly, rx, ry;
+        GcWasdToStick(&Keys, &Wasd, &lx, &ly);
+        // Right stick: mouse delta smoothed toward the new sample.
+        Sx[0] = (int16_t)((Sx[0] + s.MouseX) / 2);
+        Sy[0] = (int16_t)((Sy[0] + s.MouseY) / 2);
+        GC_STICKS_Q15 right = { Sx, Sy, 1 };
+        GcDspRadialDeadzoneQ15(right, 1638, 1);
+        GcDspRadialCurveQ15(right, 19661, 32767);
+        GcDspOneEuroQ15(right, &Euro, { &Ex, &Ey, &Dx, &Dy });
+        int16_t ox, oy;
+        GcRecoilTick(&Mixer, kTickUs, &ox, &oy);
+        rx = Sat(Sx[0] + ox);
+        ry = Sat(Sy[0] + oy);
+        GC_STICKS_Q15 out = { &rx, &ry, 1 };
+        GcDspCircularClampQ15(out, 32767);
+
+        GC_GAMEPAD_STATE g;
+        g.LX = (uint16_t)(lx ^ 0x8000); g.LY = (uint16_t)(ly ^ 0x8000);
+        g.RX = (uint16_t)(rx ^ 0x8000); g.RY = (uint16_t)(ry ^ 0x8000);
+        g.LT = Match->ActionOn(3) ? 65535 : 0;
+        g.RT = Match->ActionOn(kActionFire) ? 65535 : 0;
+        g.Buttons = Match->ActionOn(2) | (Match->ActionOn(4) << 1) | (Match->ActionOn(5) << 2);
+        GC_TRACE t = { (uint32_t)Pos, 0, Now * 1000 };
+        size_t n = GcWirePackSetState(Frame, sizeof(Frame), 1, &g, &t);
+
+        GC_WIRE_FRAME f;
+        GC_WIRE_SET_STATE w;
+        if (GcWireParseFrame(Frame, n, &f) != GC_WIRE_OK || GcWireReadSetState(&f, &w) != GC_WIRE_OK) return;
+#ifdef GC_BENCH_HOST
+        VPAD_STATE_TRACED v;
+        v.State = ToVPad(w.State);
+        v.Trace.Sequence = w.Trace.Sequence;
+        v.Trace.LastOffsetNs = w.Trace.LastOffsetNs;
+        v.Trace.OriginNs = w.Trace.OriginNs;
+        size_t info;
+        GcHostIoctl(Func.get(), IOCTL_VPAD_SET_STATE, &v, sizeof(v), nullptr, 0, &info);
+#else
+        g_sink = g_sink + w.State.RX;
+#endif
+    }
+
+private:
+    struct Step {
+        uint8_t Key, Toggle;
+        int16_t MouseX, MouseY;
+    };
+
+    static int16_t Sat(int32_t v) { return (int16_t)std::min(32767, std::max(-32767, v)); }
+
+    GC_KEY_STATE Keys;
+    GC_WASD_MAP Wasd = { 'W', 'A', 'S', 'D', GC_SOCD_LAST_WINS, GC_SOCD_LAST_WINS };
+    gc::bind::Program Prog;
+    std::unique_ptr<gc::bind::Matcher> Match;
+    std::vector<gc::bind::Event> Events;
+    std::vector<uint32_t> RecoilMem;
+    PGC_RECOIL_TABLE Recoil = nullptr;
+    GC_RECOIL_MIXER Mixer;
+    int RecoilId = -1;
+    int16_t Sx[1] = {}, Sy[1] = {};
+    int32_t Ex = 0, Ey = 0, Dx = 0, Dy = 0;
+    GC_ONE_EURO_PARAMS_Q15 Euro = { 1000, 700, 1000, 1000 };
+    std::vector<Step> Script;
+    size_t Pos = 0;
+    uint64_t Now = 0;
+    uint8_t Frame[64];
+#ifdef GC_BENCH_HOST
+    Device Func;
+#endif
+};
+
+constexpr uint32_t kGraphTicks = 64;
+
+void AddGraphCase(std::vector<Case>& out, uint64_t seed) {
+    auto g = std::make_shared<Graph>(seed);
+    out.push_back({"graph.tick", "one pad's native mapping tick, key report to IOCTL", kGraphTicks, [g] {
+        for (uint32_t i = 0; i < kGraphTicks; ++i) g->Tick();
+    }});
+}
+
+std::vector<Case> AllCases(uint64_t seed) {
+    std::vector<Case> c;
+    AddWireCases(c, seed);
+    AddDspCases(c, seed);
+#ifdef GC_BENCH_HOST
+    AddIoctlCases(c, seed);
+#endif
+    AddGraphCase(c, seed);
+    return c;
+}
+
+// ---- statistics ----
+
+struct Summary {
+    double Median = 0, Mean = 0, Stddev = 0, Min = 0, Max = 0;
+};
+
+double Percentile(std::vector<double> v, double q) {
+    if (v.empty()) return 0;
+    std::sort(v.begin(), v.end());
+    double pos = q * (v.size() - 1);
+    size_t lo = (size_t)pos;
+    size_t hi = std::min(lo + 1, v.size() - 1);
+    return v[lo] + (v[hi] - v[lo]) * (pos - lo);
+}
+
+Summary Summarize(const std::vector<double>& v) {
+    Summary s;
+    if (v.empty()) return s;
+    s.Median = Percentile(v, 0.5);
+    s.Min = *std::min_element(v.begin(), v.end());
+    s.Max = *std::max_element(v.begin(), v.end());
+    for (double x : v) s.Mean += x;
+    s.Mean /= v.size();
+    for (double x : v) s.Stddev += (x - s.Mean) * (x - s.Mean);
+    s.Stddev = v.size() > 1 ? std::sqrt(s.Stddev / (v.size() - 1)) : 0;
+    return s;
+}
+
+// Two-sided Mann-Whitney U, normal approximation with tie correction.
+double MannWhitneyP(const std::vector<double>& a, const std::vector<double>& b) {
+    size_t n1 = a.size(), n2 = b.size(), n = n1 + n2;
+    if (n1 < 2 || n2 < 2) return 1;
+    std::vector<std::pair<double, int>> all;
+    for (double x : a) all.push_back({x, 0});
+    for (double x : b) all.push_back({x, 1});
+    std::sort(all.begin(), all.end());
+    double r1 = 0, ties = 0;
+    for (size_t i = 0; i < n;) {
+        size_t j = i;
+        while (j < n && all[j].first == all[i].first) ++j;
+        double rank = (i + 1 + j) / 2.0, t = double(j - i);
+        for (size_t k = i; k < j; ++k) if (all[k].second == 0) r1 += rank;
+        ties += t * t * t - t;
+        i = j;
+    }
+    double u = r1 - n1 * (n1 + 1) / 2.0;
+    double mu = n1 * n2 / 2.0;
+    double sigma = std::sqrt(n1 * n2 / 12.0 * ((n + 1) - ties / (double(n) * (n - 1))));
+    if (sigma == 0) return 1;
+    double z = (std::fabs(u - mu) - 0.5) / sigma;
+    return z <= 0 ? 1 : std::erfc(z / std::sqrt(2.0));
+}
+
+// ---- JSON ----
+
+std::string Quote(const std::string& s) {
+    std::string o = "\"";
+    for (char c : s) {
+        if (c == '"' || c == '\\') o += '\\';
+        if ((unsigned char)c >= 0x20) o += c;
+    }
+    return o + "\"";
+}
+
+struct Json {
+    enum Type { Null, Bool, Number, String, Array, Object } T = Null;
+    double N = 0;
+    std::string S;
+    std::vector<Json> A;
+    std::vector<std::pair<std::string, Json>> O;
+
+    const Json* Get(const char* key) const {
+        for (const auto& kv : O) if (kv.first == key) return &kv.second;
+        return nullptr;
+    }
+    std::string Str(const char* key) const {
+        const Json* v = Get(key);
+        return v && v->T == String ? v->S : std::string();
+    }
+};
+
+// Enough JSON for the files this tool writes (no \u escapes).
+class JsonReader {
+public:
+    explicit JsonReader(const std::string& text) : P(text.c_str()), E(P + text.size()) {}
+    bool Parse(Json& out) { return Value(out) && (Ws(), P == E); }
+
+private:
+    void Ws() { while (P < E && (*P == ' ' || *P == '\n' || *P == '\r' || *P == '\t')) ++P; }
+    bool Lit(const char* s) {
+        size_t n = std::strlen(s);
+        if ((size_t)(E - P) < n || std::strncmp(P, s, n)) return false;
+        P += n;
+        return true;
+    }
+    bool Str(std::string& s) {
+        if (P == E || *P != '"') return false;
+        for (++P; P < E && *P != '"'; ++P) {
+            if (*P == '\\' && ++P == E) return false;
+            s += *P;
+        }
+        return P < E && *P++ == '"';
+    }
+    bool Value(Json& v) {
+        Ws();
+        if (P == E) return false;
+        if (*P == '{') {
+            v.T = Json::Object;
+            ++P; Ws();
+            if (P < E && *P == '}') { ++P; return true; }
+            for (;;) {
+                std::pair<std::string, Json> kv;
+                Ws();
+                if (!Str(kv.first)) return false;
+                Ws();
+                if (P == E || *P++ != ':' || !Value(kv.second)) return false;
+                v.O.push_back(std::move(kv));
+                Ws();
+                if (P < E && *P == ',') { ++P; continue; }
+                return P < E && *P++ == '}';
+            }
+        }
+        if (*P == '[') {
+            v.T = Json::Array;
+            ++P; Ws();
+            if (P < E && *P == ']') { ++P; return true; }
+            for (;;) {
+                v.A.emplace_back();
+                if (!Value(v.A.back())) return false;
+                Ws();
+                if (P < E && *P == ',') { ++P; continue; }
+                return P < E && *P++ == ']';
+            }
+        }
+        if (*P == '"') { v.T = Json::String; return Str(v.S); }
+        if (Lit("true")) { v.T = Json::Bool; v.N = 1; return true; }
+        if (Lit("false")) { v.T = Json::Bool; return true; }
+        if (Lit("null")) return true;
+        char* end = nullptr;
+        v.N = std::strtod(P, &end);
+        if (end == P) return false;
+        v.T = Json::Number;
+        P = end;
+        return true;
+    }
+
+    const char* P;
+    const char* E;
+};
+
+// ---- environment ----
+
+struct Options {
+    std::string Filter, JsonPath;
+    uint64_t Seed = 0x5EED;
+    int Cpu = -2;   // -2: the current CPU, -1: do not pin
+    int Reps = 20;
+    int SampleMs = 20;
+    int WarmupMs = 100;
+    double Threshold = 5, Alpha = 0.01;
+    int Seconds = 60, WindowS = 5;
+    long MaxRssKb = 1024;
+    double MaxDrift = 10;
+};
+
+int PinCpu(int cpu) {
+#ifdef __linux__
+    if (cpu == -1) return -1;
+    if (cpu == -2) cpu = sched_getcpu();
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+        std::fprintf(stderr, "warning: could not pin to CPU %d\n", cpu);
+        return -1;
+    }
+    return cpu;
+#else
+    (void)cpu;
+    return -1;
+#endif
+}
+
+long RssKb() {
+#ifdef __linux__
+    long pages = 0, resident = 0;
+    if (FILE* f = std::fopen("/proc/self/statm", "r")) {
+        if (std::fscanf(f, "%ld %ld", &pages, &resident) != 2) resident = -1;
+        std::fclose(f);
+        return resident < 0 ? -1 : resident * (sysconf(_SC_PAGESIZE) / 1024);
+    }
+#endif
+    return -1;
+}
+
+std::string CpuModel() {
+    std::ifstream f("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(f, line)) {
+        if (line.rfind("model name", 0) == 0) {
+            size_t c = line.find(':');
+            return c == std::string::npos ? line : line.substr(c + 2);
+        }
+    }
+    return "unknown";
+}
+
+std::string Compiler() {
+#if defined(__clang__)
+    return std::string("clang ") + __clang_version__;
+#elif defined(__GNUC__)
+    return std::string("gcc ") + __VERSION__;
+#elif defined(_MSC_VER)
+    return "msvc " + std::to_string(_MSC_VER);
+#else
+    return "unknown";
+#endif
+}
+
+std::string EnvJson(const Options& o, int cpu) {
+    std::ostringstream j;
+    j << "  \"suite\": \"GcBench\",\n  \"format\": 1,\n"
+      << "  \"seed\": " << o.Seed << ",\n  \"cpu\": " << cpu << ",\n"
+      << "  \"cpu_model\": " << Quote(CpuModel()) << ",\n"
+      << "  \"compiler\": " << Quote(Compiler()) << ",\n"
+#ifdef NDEBUG
+      << "  \"build\": \"release\",\n"
+#else
+      << "  \"build\": \"debug\",\n"
+#endif
+#ifdef GC_BENCH_HOST
+      << "  \"host_wdk\": true,\n";
+#else
+      << "  \"host_wdk\": false,\n";
+#endif
+    return j.str();
+}
+
+bool WriteFile(const std::string& path, const std::string& text) {
+    std::ofstream f(path);
+    f << text;
+    return bool(f);
+}
+
+bool ReadJson(const std::string& path, Json& out) {
+    std::ifstream f(path);
+    if (!f) { std::fprintf(stderr, "cannot open %s\n", path.c_str()); return false; }
+    std::stringstream ss;
+    ss << f.rdbuf();
+    if (!JsonReader(ss.str()).Parse(out) || out.T != Json::Object) {
+        std::fprintf(stderr, "%s: not a GcBench result\n", path.c_str());
+        return false;
+    }
+    return true;
+}
+
+// ---- run ----
+
+std::vector<double> Measure(Case& c, const Options& o) {
+    auto t0 = Clock::now();
+    uint64_t batches = 0;
+    do { c.Batch(); ++batches; } while (NsSince(t0) < o.WarmupMs * 1e6);
+    double perBatch = NsSince(t0) / batches;
+    uint64_t perSample = std::max<uint64_t>(1, (uint64_t)(o.SampleMs * 1e6 / perBatch));
+
+    std::vector<double> samples;
+    for (int r = 0; r < o.Reps; ++r) {
+        auto s0 = Clock::now();
+        for (uint64_t i = 0; i < perSample; ++i) c.Batch();
+        samples.push_back(NsSince(s0) / (double(perSample) * c.OpsPerBatch));
+    }
+    return samples;
+}
+
+int Run(const Options& o) {
+    int cpu = PinCpu(o.Cpu);
+    std::vector<Case> cases = AllCases(o.Seed);
+    std::ostringstream j;
+    j << "{\n" << EnvJson(o, cpu) << "  \"cases\": [";
+    std::printf("%-26s %10s %10s %10s   (ns/op; seed %llu, cpu %d, %d x %d ms)\n", "case", "median", "min",
+                "stddev", (unsigned long long)o.Seed, cpu, o.Reps, o.SampleMs);
+    bool first = true;
+    for (Case& c : cases) {
+        if (!o.Filter.empty() && c.Name.find(o.Filter) == std::string::npos) continue;
+        std::vector<double> v = Measure(c, o);
+        Summary s = Summarize(v);
+        std::printf("%-26s %10.2f %10.2f %10.2f\n", c.Name.c_str(), s.Median, s.Min, s.Stddev);
+        j << (first ? "\n" : ",\n") << "    {\"name\": " << Quote(c.Name) << ", \"unit\": \"ns/op\", "
+          << "\"ops_per_batch\": " << c.OpsPerBatch << ", \"median\": " << s.Median << ", \"mean\": " << s.Mean
+          << ", \"stddev\": " << s.Stddev << ", \"min\": " << s.Min << ", \"max\": " << s.Max << ",\n"
+          << "     \"samples\": [";
+        for (size_t i = 0; i < v.size(); ++i) j << (i ? ", " : "") << v[i];
+        j << "]}";
+        first = false;
+    }
+    j << "\n  ]\n}\n";
+    if (!o.JsonPath.empty() && !WriteFile(o.JsonPath, j.str())) {
+        std::fprintf(stderr, "cannot write %s\n", o.JsonPath.c_str());
+        return 2;
+    }
+    return 0;
+}
+
+// ---- compare ----
+
+std::vector<double> Samples(const Json& c) {
+    std::vector<double> v;
+    if (const Json* s = c.Get("samples"))
+        for (const Json& x : s->A) if (x.T == Json::Number) v.push_back(x.N);
+    return v;
+}
+
+int Compare(const std::string& basePath, const std::string& newPath, const Options& o) {
+    Json base, cur;
+    if (!ReadJson(basePath, base) || !ReadJson(newPath, cur)) return 2;
+    for (const char* k : { "cpu_model", "compiler", "build" })
+        if (base.Str(k) != cur.Str(k))
+            std::printf("note: %s differs: %s vs %s\n", k, base.Str(k).c_str(), cur.Str(k).c_str());
+
+    const Json* bc = base.Get("cases");
+    const Json* nc = cur.Get("cases");
+    if (!bc || !nc) { std::fprintf(stderr, "missing \"cases\"\n"); return 2; }
+    std::printf("%-26s %10s %10s %8s %9s  %s\n", "case", "base", "new", "delta", "p", "verdict");
+    int regressions = 0;
+    for (const Json& n : nc->A) {
+        std::string name = n.Str("name");
+        const Json* b = nullptr;
+        for (const Json& x : bc->A) if (x.Str("name") == name) b = &x;
+        if (!b) { std::printf("%-26s %10s %10s  only in new\n", name.c_str(), "-", ""); continue; }
+        std::vector<double> sb = Samples(*b), sn = Samples(n);
+        double mb = Percentile(sb, 0.5), mn = Percentile(sn, 0.5);
+        double delta = mb > 0 ? (mn - mb) / mb * 100 : 0;
+        double p = MannWhitneyP(sb, sn);
+        const char* verdict = "~";
+        if (p < o.Alpha && delta > o.Threshold) { verdict = "REGRESSION"; ++regressions; }
+        else if (p < o.Alpha && delta < -o.Threshold) verdict = "improved";
+        std::printf("%-26s %10.2f %10.2f %+7.1f%% %9.2g  %s\n", name.c_str(), mb, mn, delta, p, verdict);
+    }
+    for (const Json& b : bc->A) {
+        bool found = false;
+        for (const Json& x : nc->A) found |= x.Str("name") == b.Str("name");
+        if (!found) std::printf("%-26s  only in base\n", b.Str("name").c_str());
+    }
+    std::printf("%d regression%s (threshold %.1f%%, alpha %g)\n", regressions, regressions == 1 ? "" : "s",
+                o.Threshold, o.Alpha);
+    return regressions ? 1 : 0;
+}
+
+// ---- soak ----
+
+struct Window {
+    double Second;
+    long RssKb;
+    double P50, P99, Max;   // ns per tick, over batches of kGraphTicks
+};
+
+// Least-squares slope of y over x.
+double Slope(const std::vector<double>& x, const std::vector<double>& y) {
+    double n = double(x.size()), sx = 0, sy = 0, sxx = 0, sxy = 0;
+    for (size_t i = 0; i < x.size(); ++i) { sx += x[i]; sy += y[i]; sxx += x[i] * x[i]; sxy += x[i] * y[i]; }
+    double d = n * sxx - sx * sx;
+    return d == 0 ? 0 : (n * sxy - sx * sy) / d;
+}
+
+int Soak(const Options& o) {
+    int cpu = PinCpu(o.Cpu);
+    Graph g(o.Seed);
+    auto churn = [] {
+#ifdef GC_BENCH_HOST
+        // Device add/remove on both drivers: leaks there show up as RSS.
+        for (int i = 0; i < 32; ++i) {
+            Device f = AddDevice(GcVPadFuncDriverEntry);
+            Device b = AddDevice(GcVPadBusDriverEntry);
+        }
+#endif
+    };
+
+    // Warm up allocator, caches and branch predictors before window 0.
+    for (auto t0 = Clock::now(); NsSince(t0) < 1e9;) for (uint32_t i = 0; i < kGraphTicks; ++i) g.Tick();
+    churn();
+
+    std::printf("%8s %10s %10s %10s %10s   (graph.tick ns, seed %llu, cpu %d)\n", "second", "rss KB", "p50", "p99",
+                "max", (unsigned long long)o.Seed, cpu);
+    std::vector<Window> windows;
+    std::vector<double> ticks;   // reused so its growth lands in window 0 only
+    auto start = Clock::now();
+    int count = std::max(1, o.Seconds / std::max(1, o.WindowS));
+    for (int w = 0; w < count; ++w) {
+        ticks.clear();
+        auto w0 = Clock::now();
+        while (NsSince(w0) < o.WindowS * 1e9) {
+            auto b0 = Clock::now();
+            for (uint32_t i = 0; i < kGraphTicks; ++i) g.Tick();
+            ticks.push_back(NsSince(b0) / kGraphTicks);
+        }
+        churn();
+        Window win = { NsSince(start) / 1e9, RssKb(), Percentile(ticks, 0.5), Percentile(ticks, 0.99),
+                       *std::max_element(ticks.begin(), ticks.end()) };
+        windows.push_back(win);
+        std::printf("%8.1f %10ld %10.1f %10.1f %10.1f\n", win.Second, win.RssKb, win.P50, win.P99, win.Max);
+        std::fflush(stdout);
+    }
+
+    std::vector<double> xs, rss, p50;
+    for (const Window& w : windows) { xs.push_back(w.Second / 60); rss.push_back(double(w.RssKb)); p50.push_back(w.P50); }
+    long growth = windows.back().RssKb - windows.front().RssKb;
+    double drift = windows.front().P50 > 0 ? (windows.back().P50 - windows.front().P50) / windows.front().P50 * 100 : 0;
+    bool rssOk = windows.front().RssKb < 0 || growth <= o.MaxRssKb;
+    bool driftOk = drift <= o.MaxDrift;
+    std::printf("rss growth %ld KB (%.1f KB/min), p50 drift %+.1f%% (%.2f ns/min): %s\n", growth, Slope(xs, rss),
+                drift, Slope(xs, p50), rssOk && driftOk ? "ok" : "FAIL");
+
+    if (!o.JsonPath.empty()) {
+        std::ostringstream j;
+        j << "{\n" << EnvJson(o, cpu) << "  \"mode\": \"soak\",\n  \"windows\": [";
+        for (size_t i = 0; i < windows.size(); ++i) {
+            const Window& w = windows[i];
+            j << (i ? ",\n" : "\n") << "    {\"second\": " << w.Second << ", \"rss_kb\": " << w.RssKb
+              << ", \"p50_ns\": " << w.P50 << ", \"p99_ns\": " << w.P99 << ", \"max_ns\": " << w.Max << "}";
+        }
+        j << "\n  ],\n  \"rss_growth_kb\": " << growth << ",\n  \"rss_kb_per_min\": " << Slope(xs, rss)
+          << ",\n  \"p50_drift_pct\": " << drift << ",\n  \"p50_ns_per_min\": " << Slope(xs, p50)
+          << ",\n  \"ok\": " << (rssOk && driftOk ? "true" : "false") << "\n}\n";
+        if (!WriteFile(o.JsonPath, j.str())) { std::fprintf(stderr, "cannot write %s\n", o.JsonPath.c_str()); return 2; }
+    }
+    return rssOk && driftOk ? 0 : 1;
+}
+
+int Usage() {
+    std::fprintf(stderr,
+                 "usage: GcBench [run] [--filter S] [--json FILE] [--seed N] [--cpu N|--no-pin]\n"
+                 "                     [--reps N] [--sample-ms N] [--warmup-ms N]\n"
+                 "       GcBench compare BASE.json NEW.json [--threshold PCT] [--alpha P]\n"
+                 "       GcBench soak [--seconds N] [--window-s N] [--json FILE] [--seed N]\n"
+                 "                    [--cpu N|--no-pin] [--max-rss-kb N] [--max-drift PCT]\n"
+                 "       GcBench list\n");
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    std::string mode = "run";
+    std::vector<std::string> files;
+    Options o;
+    int i = 1;
+    if (i < argc && argv[i][0] != '-') mode = argv[i++];
+    for (; i < argc; ++i) {
+        std::string a = argv[i];
+        auto next = [&]() -> const char* { return i + 1 < argc ? argv[++i] : nullptr; };
+        const char* v = nullptr;
+        if (a == "--no-pin") { o.Cpu = -1; continue; }
+        if (a.rfind("--", 0) != 0) { files.push_back(a); continue; }
+        if (!(v = next())) return Usage();
+        if (a == "--filter") o.Filter = v;
+        else if (a == "--json") o.JsonPath = v;
+        else if (a == "--seed") o.Seed = std::strtoull(v, nullptr, 0);
+        else if (a == "--cpu") o.Cpu = std::atoi(v);
+        else if (a == "--reps") o.Reps = std::max(2, std::atoi(v));
+        else if (a == "--sample-ms") o.SampleMs = std::max(1, std::atoi(v));
+        else if (a == "--warmup-ms") o.WarmupMs = std::max(0, std::atoi(v));
+        else if (a == "--threshold") o.Threshold = std::atof(v);
+        else if (a == "--alpha") o.Alpha = std::atof(v);
+        else if (a == "--seconds") o.Seconds = std::max(1, std::atoi(v));
+        else if (a == "--window-s") o.WindowS = std::max(1, std::atoi(v));
+        else if (a == "--max-rss-kb") o.MaxRssKb = std::atol(v);
+        else if (a == "--max-drift") o.MaxDrift = std::atof(v);
+        else return Usage();
+    }
+
+    if (mode == "run" && files.empty()) return Run(o);
+    if (mode == "compare" && files.size() == 2) return Compare(files[0], files[1], o);
+    if (mode == "soak" && files.empty()) return Soak(o);
+    if (mode == "list") {
+        for (const Case& c : AllCases(o.Seed)) std::printf("%-26s %s\n", c.Name.c_str(), c.Desc.c_str());
+        return 0;
+    }
+    return Usage();
+}
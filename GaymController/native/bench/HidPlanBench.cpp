@@ -0,0 +1,91 @@
+// HID extraction throughput: the VPad gamepad report, a 128-key analog
+// keyboard report, and the byte-offset map loop RawHidProvider runs today.
+#include "gc/HidPlan.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+using UCHAR = unsigned char;
+#include "HidDescriptor.h"
+
+using namespace gc::hid;
+
+namespace {
+
+constexpr int kReports = 1 << 20;
+
+std::vector<uint8_t> AnalogKeyboardDescriptor(int keys) {
+    // Vendor collection, report 1: one 8-bit depth per keyboard usage.
+    return {0x06, 0x54, 0xFF, 0x09, 0x01, 0xA1, 0x01, 0x85, 0x01,
+            0x05, 0x07, 0x19, 0x00, 0x29, uint8_t(keys - 1), 0x15, 0x00, 0x26, 0xFF, 0x00,
+            0x75, 0x08, 0x95, uint8_t(keys), 0x81, 0x02, 0xC0};
+}
+
+template <typename Fn>
+double NsPerReport(Fn fn) {
+    for (int i = 0; i < kReports / 16; ++i) fn(i);
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < kReports; ++i) fn(i);
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count() / kReports;
+}
+
+void Run(const char* name, const uint8_t* desc, size_t len, ReportKind kind, uint8_t id) {
+    Plan plan;
+    if (Parse(desc, len, plan) != ParseStatus::Ok) {
+        std::printf("%s: parse failed\n", name);
+        return;
+    }
+    Extractor x;
+    x.Compile(plan, kind, id);
+    std::vector<std::vector<uint8_t>> reports(64, std::vector<uint8_t>(x.ReportBytes()));
+    uint32_t s = 1;
+    for (auto& r : reports) {
+        for (auto& b : r) b = uint8_t((s = s * 1664525u + 1013904223u) >> 24);
+        r[0] = id ? id : r[0];
+    }
+    std::vector<int32_t> v(x.Count());
+    std::vector<uint16_t> u(x.Count());
+    volatile int64_t sink = 0;
+
+    double raw = NsPerReport([&](int i) {
+        const auto& r = reports[i & 63];
+        x.Extract(r.data(), r.size(), v.data());
+        sink += v[0];
+    });
+    double unit = NsPerReport([&](int i) {
+        const auto& r = reports[i & 63];
+        x.ExtractUnit(r.data(), r.size(), u.data());
+        sink += u[0];
+    });
+    std::printf("%-22s %4zu fields %4u bytes  Extract %7.1f ns (%5.2f ns/field)  ExtractUnit %7.1f ns\n", name,
+                x.Count(), x.ReportBytes(), raw, raw / x.Count(), unit);
+}
+
+} // namespace
+
+int main() {
+    Run("vpad input", g_VPadReportDescriptor, sizeof g_VPadReportDescriptor, ReportKind::Input, 0);
+    Run("vpad rumble output", g_VPadReportDescriptor, sizeof g_VPadReportDescriptor, ReportKind::Output, 1);
+    auto kb = AnalogKeyboardDescriptor(128);
+    Run("analog keyboard 128", kb.data(), kb.size(), ReportKind::Input, 1);
+
+    // Reference: RawHidProvider's offset map, one byte per key scaled to double.
+    std::vector<uint8_t> report(129, 7);
+    std::vector<double> last(128);
+    volatile double sink = 0;
+    double map = NsPerReport([&](int i) {
+        report[1 + (i & 127)] = uint8_t(i);
+        for (int k = 0; k < 128; ++k) last[k] = report[1 + k] / 255.0;
+        sink += last[i & 127];
+    });
+    std::printf("%-22s  128 fields  129 bytes  offset map %5.1f ns\n", "byte offset map", map);
+
+    Plan plan;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < 10000; ++i) Parse(kb.data(), kb.size(), plan);
+    double parse = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count() / 10000;
+    std::printf("parse analog keyboard descriptor %.2f us\n", parse);
+    return 0;
+}
@@ -0,0 +1,87 @@
+// WASD resolution rate: one key event (press, release or analog depth)
+// followed by a full stick resolution, per SOCD mode, against the legacy
+// StickMapper path (HashSet lookups + sqrt).
+#include "gc/KeyState.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+
+constexpr int kOps = 1 << 22;
+constexpr uint8_t kKeys[4] = {0x57, 0x41, 0x53, 0x44};   // W A S D
+
+struct Event {
+    uint8_t Key;
+    uint8_t Depth;   // 0 = up
+};
+
+std::vector<Event> Events(bool analog) {
+    std::vector<Event> e(4096);
+    uint32_t s = 99;
+    for (auto& ev : e) {
+        s = s * 1664525u + 1013904223u;
+        ev.Key = kKeys[s >> 30];
+        ev.Depth = analog ? uint8_t(s >> 8) : ((s >> 12) & 1 ? 255 : 0);
+    }
+    return e;
+}
+
+template <class Fn>
+double ResolutionsPerSec(Fn&& fn) {
+    for (int i = 0; i < kOps / 16; ++i) fn(i);
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < kOps; ++i) fn(i);
+    return kOps / std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+volatile int32_t g_sink;
+
+} // namespace
+
+int main() {
+    auto digital = Events(false), analog = Events(true);
+    std::printf("mode          digital Mres/s   analog Mres/s   ns/res\n");
+    const char* names[] = {"last-wins", "neutral", "first-wins"};
+    for (int m = 0; m < 3; ++m) {
+        GC_WASD_MAP map = {0x57, 0x41, 0x53, 0x44, GC_SOCD_MODE(m), GC_SOCD_MODE(m)};
+        GC_KEY_STATE k;
+        GcKeyInit(&k, 1, 1);
+        double dr = ResolutionsPerSec([&](int i) {
+            const Event& e = digital[i & 4095];
+            if (e.Depth) GcKeyDown(&k, e.Key); else GcKeyUp(&k, e.Key);
+            int16_t x, y;
+            GcWasdToStick(&k, &map, &x, &y);
+            g_sink = g_sink + x + y;
+        });
+        double ar = ResolutionsPerSec([&](int i) {
+            const Event& e = analog[i & 4095];
+            GcKeySetDepth(&k, e.Key, e.Depth);
+            int16_t x, y;
+            GcWasdToStick(&k, &map, &x, &y);
+            g_sink = g_sink + x + y;
+        });
+        std::printf("%-12s %15.1f %15.1f %8.2f\n", names[m], dr / 1e6, ar / 1e6, 1e9 / ar);
+    }
+
+    // Legacy: HashSet<Keys> of held keys, four lookups and a sqrt per call.
+    std::unordered_set<int> held;
+    double lr = ResolutionsPerSec([&](int i) {
+        const Event& e = digital[i & 4095];
+        if (e.Depth) held.insert(e.Key); else held.erase(e.Key);
+        int x = 0, y = 0;
+        if (held.count(0x41)) x -= 1;
+        if (held.count(0x44)) x += 1;
+        if (held.count(0x57)) y -= 1;
+        if (held.count(0x53)) y += 1;
+        float fx = float(x), fy = float(y), len = std::sqrt(fx * fx + fy * fy);
+        if (len > 1e-5f) { fx /= len; fy /= len; }
+        g_sink = g_sink + short(fx * 32767) + short(-fy * 32767);
+    });
+    std::printf("%-12s %15.1f %15s %8.2f\n", "legacy", lr / 1e6, "-", 1e9 / lr);
+    return 0;
+}
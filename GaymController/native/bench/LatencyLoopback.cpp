@@ -0,0 +1,213 @@
+// In-process loopback of the whole input path on Linux:
+//   device -> HID read -> graph (stick DSP) -> SET_STATE wire -> broker -> SET_STATE IOCTL -> func driver
+// Each arrow is a socketpair between threads; every hop stamps the GC_TRACE
+// carried with the report and the run ends with a per-stage breakdown.
+//
+//   LatencyLoopback [reports=20000] [rateHz=8000]   (rateHz 0 = back-to-back)
+#include "gc/LatencyProbe.h"
+#include "gc/StickDsp.h"
+#include "gc/Wire.h"
+#include "VPadShared.h"
+
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+constexpr size_t kReportBytes = 64;
+constexpr size_t kOriginOffset = 56;  // harness-only: device write time rides in the report tail
+
+uint64_t NowNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return uint64_t(ts.tv_sec) * 1000000000ull + uint64_t(ts.tv_nsec);
+}
+
+bool WriteAll(int fd, const void* p, size_t n) {
+    auto b = static_cast<const uint8_t*>(p);
+    while (n) {
+        ssize_t w = write(fd, b, n);
+        if (w <= 0) return false;
+        b += w; n -= size_t(w);
+    }
+    return true;
+}
+
+int16_t ToSigned(uint16_t v) {
+    int32_t s = int32_t(v) - 32767;
+    return int16_t(s < -32768 ? -32768 : s);
+}
+
+// Synthetic analog keyboard: W/A/S/D depth plus a slow mouse-ish sweep.
+void Device(int fd, int reports, int rateHz) {
+    uint8_t rep[kReportBytes] = {};
+    uint64_t period = rateHz > 0 ? 1000000000ull / uint64_t(rateHz) : 0;
+    uint64_t next = NowNs();
+    for (int i = 0; i < reports; ++i) {
+        if (period) {
+            next += period;
+            timespec ts{time_t(next / 1000000000ull), long(next % 1000000000ull)};
+            clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr);
+        }
+        rep[0] = uint8_t(i * 3);          // W
+        rep[1] = uint8_t(255 - i * 5);    // A
+        rep[2] = uint8_t(i * 7 >> 1);     // S
+        rep[3] = uint8_t(i * 11 >> 2);    // D
+        rep[4] = uint8_t(128 + (i % 64)); // right stick X
+        rep[5] = uint8_t(128 - (i % 48)); // right stick Y
+        uint64_t origin = NowNs();
+        std::memcpy(rep + kOriginOffset, &origin, sizeof(origin));
+        if (!WriteAll(fd, rep, sizeof(rep))) break;
+    }
+    close(fd);
+}
+
+// App side: raw HID read, mapping graph, SET_STATE encode.
+void App(int hidFd, int wireFd, PGC_LATENCY_PROBE probe) {
+    uint8_t rep[kReportBytes];
+    uint8_t frame[64];
+    float x[2], y[2];
+    GC_STICKS_F sticks{x, y, 2};
+    for (;;) {
+        ssize_t n = read(hidFd, rep, sizeof(rep));
+        if (n != ssize_t(sizeof(rep))) break;
+        uint64_t origin;
+        std::memcpy(&origin, rep + kOriginOffset, sizeof(origin));
+        GC_TRACE t;
+        GcTraceBegin(probe, origin, &t);
+        GcTraceStamp(probe, GC_HOP_HID_READ, &t, NowNs());
+
+        x[0] = (rep[3] - rep[1]) / 255.0f;
+        y[0] = (rep[0] - rep[2]) / 255.0f;
+        x[1] = (rep[4] - 128) / 127.0f;
+        y[1] = (rep[5] - 128) / 127.0f;
+        GcDspRadialDeadzoneF(sticks, 0.05f, 1);
+        GcDspRadialCurveF(sticks, 0.35f, 1.0f);
+        GcDspAntiDeadzoneF(sticks, 0.05f, 1.0f);
+        GcDspCircularClampF(sticks, 1.0f);
+        int16_t q[4];
+        float v[4] = {x[0], y[0], x[1], y[1]};
+        GcDspToQ15(v, q, 4);
+        GC_GAMEPAD_STATE st{uint16_t(q[0] + 32767), uint16_t(q[1] + 32767), uint16_t(q[2] + 32767),
+                            uint16_t(q[3] + 32767), 0, 0, rep[0] > 200 ? 1u : 0u};
+        GcTraceStamp(probe, GC_HOP_GRAPH_OUT, &t, NowNs());
+
+        GcTraceStamp(probe, GC_HOP_WIRE_TX, &t, NowNs());
+        size_t len = GcWirePackSetState(frame, sizeof(frame), 1, &st, &t);
+        if (!WriteAll(wireFd, frame, len)) break;
+    }
+    close(hidFd);
+    close(wireFd);
+}
+
+// Broker side: stream reassembly, SET_STATE decode, IOCTL input buffer.
+void Broker(int wireFd, int ioctlFd, PGC_LATENCY_PROBE probe) {
+    std::vector<uint8_t> buf(GC_WIRE_MAX_FRAME * 2);
+    size_t have = 0;
+    for (;;) {
+        ssize_t n = read(wireFd, buf.data() + have, buf.size() - have);
+        if (n <= 0) break;
+        have += size_t(n);
+        size_t off = 0;
+        GC_WIRE_FRAME f;
+        while (GcWireParseFrame(buf.data() + off, have - off, &f) == GC_WIRE_OK) {
+            off += f.Length;
+            GC_WIRE_SET_STATE s;
+            if (GcWireReadSetState(&f, &s) != GC_WIRE_OK || !s.HasTrace) continue;
+            GcTraceStamp(probe, GC_HOP_BROKER_RX, &s.Trace, NowNs());
+            VPAD_STATE_TRACED in;
+            in.State.Buttons = uint16_t(s.State.Buttons);
+            in.State.LeftTrigger = uint8_t(s.State.LT >> 8);
+            in.State.RightTrigger = uint8_t(s.State.RT >> 8);
+            in.State.LX = ToSigned(s.State.LX);
+            in.State.LY = ToSigned(s.State.LY);
+            in.State.RX = ToSigned(s.State.RX);
+            in.State.RY = ToSigned(s.State.RY);
+            in.Trace.Sequence = s.Trace.Sequence;
+            in.Trace.LastOffsetNs = s.Trace.LastOffsetNs;
+            in.Trace.OriginNs = s.Trace.OriginNs;
+            if (!WriteAll(ioctlFd, &in, sizeof(in))) goto done;   // driver side gone
+        }
+        std::memmove(buf.data(), buf.data() + off, have - off);
+        have -= off;
+    }
+done:
+    close(wireFd);
+    close(ioctlFd);
+}
+
+// Func driver side: IOCTL_VPAD_SET_STATE -> 12-byte input report -> submit.
+void Driver(int ioctlFd, PGC_LATENCY_PROBE probe, volatile uint8_t* sink) {
+    VPAD_STATE_TRACED in;
+    for (;;) {
+        ssize_t n = read(ioctlFd, &in, sizeof(in));
+        if (n != ssize_t(sizeof(in))) break;
+        uint8_t report[12];
+        report[0] = uint8_t(in.State.Buttons);
+        report[1] = uint8_t(in.State.Buttons >> 8);
+        report[2] = in.State.LeftTrigger;
+        report[3] = in.State.RightTrigger;
+        std::memcpy(report + 4, &in.State.LX, 8);
+        for (uint8_t b : report) *sink ^= b;  // stands in for VhfReadReportSubmit
+        GC_TRACE t{in.Trace.Sequence, in.Trace.LastOffsetNs, in.Trace.OriginNs};
+        GcTraceStamp(probe, GC_HOP_DRIVER_SUBMIT, &t, NowNs());
+    }
+    close(ioctlFd);
+}
+
+void Print(const GC_LATENCY_PROBE& p) {
+    std::printf("%-14s %8s | %9s %9s %9s %9s | %9s %9s %9s\n", "hop", "count", "stage p50", "p99", "max", "mean",
+                "total p50", "p99", "max");
+    for (int h = 0; h < GC_HOP_COUNT; ++h) {
+        const auto& s = p.Stage[h];
+        const auto& t = p.Total[h];
+        std::printf("%-14s %8llu | %9.2f %9.2f %9.2f %9.2f | %9.2f %9.2f %9.2f\n", GcHopName(GC_HOP(h)),
+                    (unsigned long long)t.Count, GcLatencyPercentile(&s, 5000) / 1e3,
+                    GcLatencyPercentile(&s, 9900) / 1e3, s.MaxNs / 1e3, GcLatencyMeanNs(&s) / 1e3,
+                    GcLatencyPercentile(&t, 5000) / 1e3, GcLatencyPercentile(&t, 9900) / 1e3, t.MaxNs / 1e3);
+    }
+    std::printf("(microseconds; stage = since previous hop, total = since device write)\n");
+}
+
+bool Pair(int type, int fds[2]) {
+    if (socketpair(AF_UNIX, type, 0, fds) == 0) return true;
+    std::perror("socketpair");
+    return false;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int reports = argc > 1 ? std::atoi(argv[1]) : 20000;
+    int rateHz = argc > 2 ? std::atoi(argv[2]) : 8000;
+
+    int hid[2], wire[2], drv[2];
+    if (!Pair(SOCK_SEQPACKET, hid) || !Pair(SOCK_STREAM, wire) || !Pair(SOCK_SEQPACKET, drv)) return EXIT_FAILURE;
+
+    auto probe = std::make_unique<GC_LATENCY_PROBE>();
+    GcProbeReset(probe.get());
+    volatile uint8_t sink = 0;
+
+    std::thread driver(Driver, drv[1], probe.get(), &sink);
+    std::thread broker(Broker, wire[1], drv[0], probe.get());
+    std::thread app(App, hid[1], wire[0], probe.get());
+    std::thread device(Device, hid[0], reports, rateHz);
+    device.join();
+    app.join();
+    broker.join();
+    driver.join();
+
+    std::printf("%d reports at %s\n", reports, rateHz > 0 ? (std::to_string(rateHz) + " Hz").c_str() : "max rate");
+    Print(*probe);
+    return probe->Total[GC_HOP_DRIVER_SUBMIT].Count == uint64_t(reports) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
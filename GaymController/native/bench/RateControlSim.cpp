@@ -0,0 +1,57 @@
+// Adaptive rate control under step loads: a consumer whose per-report cost
+// jumps between fast and slow, and the AIMD sender tracking it.
+//
+//   RateControlSim [ms:us,ms:us,...]   schedule of (start ms, service us)
+#include "gc/RateSim.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+using gc::sim::RateSim;
+using gc::sim::Step;
+
+int main(int argc, char** argv) {
+    std::vector<Step> schedule = {{0, 50000}, {1000000000, 400000}, {3000000000ull, 800000},
+                                  {5000000000ull, 100000}, {7000000000ull, 250000}};
+    if (argc > 1) {
+        schedule.clear();
+        for (char* tok = std::strtok(argv[1], ","); tok; tok = std::strtok(nullptr, ",")) {
+            unsigned ms = 0, us = 0;
+            if (std::sscanf(tok, "%u:%u", &ms, &us) != 2 || us == 0) {
+                std::fprintf(stderr, "bad schedule entry '%s' (want ms:us)\n", tok);
+                return 2;
+            }
+            schedule.push_back({uint64_t(ms) * 1000000, us * 1000});
+        }
+    }
+    uint64_t end = schedule.back().AtNs + 2000000000ull;
+
+    GC_RATE_CONFIG cfg;
+    GcRateDefaultConfig(&cfg);
+    RateSim sim(cfg, schedule);
+    sim.Run(end);
+
+    std::printf("target %.1f ms, depth %u, rate %u..%u Hz, +%u Hz / x%.2f per %.0f ms\n\n",
+                cfg.TargetLatencyNs / 1e6, cfg.MaxQueueDepth, cfg.MinRateHz, cfg.MaxRateHz, cfg.IncreaseHz,
+                cfg.DecreaseQ16 / 65536.0, cfg.PeriodNs / 1e6);
+    std::printf("phase       service  capacity  steady rate  delivered  converge   p50     p99     max\n");
+    for (const auto& p : sim.Phases())
+        std::printf("%4.1f-%4.1fs %6u us %7.0f Hz %8.0f Hz %8.0f Hz %6.0f ms %5.2f ms %5.2f ms %5.2f ms\n",
+                    p.StartNs / 1e9, p.EndNs / 1e9, p.ServiceNs / 1000, p.CapacityHz, p.SteadyRateHz,
+                    p.DeliveredHz, p.ConvergeMs, p.P50Ns / 1e6, p.P99Ns / 1e6, p.MaxNs / 1e6);
+
+    // 100 ms timeline: controller rate and worst latency completed in the slot.
+    std::printf("\n   t     rate   worst latency\n");
+    const auto& rates = sim.RateTrace();
+    const auto& trace = sim.Trace();
+    size_t s = 0;
+    for (uint64_t t = 0; t < end; t += 100000000) {
+        uint32_t worst = 0;
+        for (; s < trace.size() && trace[s].DoneNs < t + 100000000; ++s) worst = std::max(worst, trace[s].LatencyNs);
+        std::printf("%5.1fs %6u Hz %8.2f ms\n", t / 1e9, rates[(t + 99875000) / 125000], worst / 1e6);
+    }
+    const auto& rc = sim.Controller();
+    std::printf("\n%u increases, %u decreases, %zu reports delivered\n", rc.Increases, rc.Decreases, trace.size());
+    return 0;
+}
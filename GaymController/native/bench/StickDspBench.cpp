@@ -0,0 +1,79 @@
+// Per-stage cost of the stick DSP kernels, reported as ns per stick sample.
+#include "gc/StickDsp.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace {
+
+constexpr size_t kSticks = 1024;
+constexpr int kIters = 2000;
+
+template <class Fn>
+double NsPerSample(Fn&& fn) {
+    for (int i = 0; i < kIters / 10; ++i) fn();
+    auto t0 = std::chrono::steady_clock::now();
+    for (int i = 0; i < kIters; ++i) fn();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / (double(kIters) * kSticks);
+}
+
+struct Batch {
+    std::vector<float> X, Y, SrcX, SrcY;
+    std::vector<int16_t> Qx, Qy, SrcQx, SrcQy;
+    Batch() : X(kSticks), Y(kSticks), SrcX(kSticks), SrcY(kSticks),
+              Qx(kSticks), Qy(kSticks), SrcQx(kSticks), SrcQy(kSticks) {
+        uint32_t s = 42;
+        for (size_t i = 0; i < kSticks; ++i) {
+            s = s * 1664525u + 1013904223u; SrcX[i] = ((s >> 8) / 16777216.0f) * 2.0f - 1.0f;
+            s = s * 1664525u + 1013904223u; SrcY[i] = ((s >> 8) / 16777216.0f) * 2.0f - 1.0f;
+        }
+        GcDspToQ15(SrcX.data(), SrcQx.data(), kSticks);
+        GcDspToQ15(SrcY.data(), SrcQy.data(), kSticks);
+    }
+    // Restore the input each iteration so stages never settle to all-zero.
+    GC_STICKS_F F() { X = SrcX; Y = SrcY; return {X.data(), Y.data(), kSticks}; }
+    GC_STICKS_Q15 Q() { Qx = SrcQx; Qy = SrcQy; return {Qx.data(), Qy.data(), kSticks}; }
+};
+
+} // namespace
+
+int main() {
+    Batch b;
+    std::vector<float> lastR(kSticks), sx(kSticks), sy(kSticks), dx(kSticks), dy(kSticks);
+    std::vector<int32_t> lastRQ(kSticks), sxQ(kSticks), syQ(kSticks), dxQ(kSticks), dyQ(kSticks);
+    GC_ONE_EURO_PARAMS p{1.0f, 0.5f, 1.0f, 1000.0f};
+    GC_ONE_EURO_PARAMS_Q15 pQ{1000, 500, 1000, 1000};
+    GC_ONE_EURO_STATE_F st{sx.data(), sy.data(), dx.data(), dy.data()};
+    GC_ONE_EURO_STATE_Q15 stQ{sxQ.data(), syQ.data(), dxQ.data(), dyQ.data()};
+
+    // Baseline: cost of the per-iteration input copy alone.
+    double copyF = NsPerSample([&] { b.F(); });
+    double copyQ = NsPerSample([&] { b.Q(); });
+
+    struct Row { const char* Name; double F, Q; } rows[] = {
+        {"RadialDeadzone", NsPerSample([&] { GcDspRadialDeadzoneF(b.F(), 0.1f, 1); }),
+                           NsPerSample([&] { GcDspRadialDeadzoneQ15(b.Q(), 3277, 1); })},
+        {"AxialDeadzone",  NsPerSample([&] { GcDspAxialDeadzoneF(b.F(), 0.1f, 1); }),
+                           NsPerSample([&] { GcDspAxialDeadzoneQ15(b.Q(), 3277, 1); })},
+        {"AntiDeadzone",   NsPerSample([&] { GcDspAntiDeadzoneF(b.F(), 0.05f, 1.0f); }),
+                           NsPerSample([&] { GcDspAntiDeadzoneQ15(b.Q(), 1638, 32767); })},
+        {"RadialCurve",    NsPerSample([&] { GcDspRadialCurveF(b.F(), 0.6f, 1.0f); }),
+                           NsPerSample([&] { GcDspRadialCurveQ15(b.Q(), 19661, 32767); })},
+        {"VelocityGain",   NsPerSample([&] { GcDspVelocityGainF(b.F(), 0.5f, lastR.data()); }),
+                           NsPerSample([&] { GcDspVelocityGainQ15(b.Q(), 16384, lastRQ.data()); })},
+        {"Ema",            NsPerSample([&] { GcDspEmaF(b.F(), 0.35f, sx.data(), sy.data()); }),
+                           NsPerSample([&] { GcDspEmaQ15(b.Q(), 11469, sxQ.data(), syQ.data()); })},
+        {"OneEuro",        NsPerSample([&] { GcDspOneEuroF(b.F(), &p, st); }),
+                           NsPerSample([&] { GcDspOneEuroQ15(b.Q(), &pQ, stQ); })},
+        {"CircularClamp",  NsPerSample([&] { GcDspCircularClampF(b.F(), 0.9f); }),
+                           NsPerSample([&] { GcDspCircularClampQ15(b.Q(), 29490); })},
+    };
+
+    std::printf("%-16s %12s %12s   (%zu sticks, input copy subtracted)\n", "stage", "float ns", "q15 ns", kSticks);
+    for (const auto& r : rows)
+        std::printf("%-16s %12.2f %12.2f\n", r.Name, r.F - copyF, r.Q - copyQ);
+    return 0;
+}
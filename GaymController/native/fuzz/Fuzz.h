@@ -0,0 +1,54 @@
+#pragma once
+
+// Shared pieces of the fuzz targets: the libFuzzer entry point, a reader
+// that turns the input into ops, and an invariant check that aborts (so
+// libFuzzer and FuzzDriver.cpp both record the input as a crash).
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+#define GC_FUZZ_CHECK(cond) \
+    do { if (!(cond)) { \
+        std::fprintf(stderr, "%s:%d: FUZZ_CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+        std::abort(); } } while (0)
+
+namespace gc::fuzz {
+
+// Consumes the input front to back; reads past the end yield zeros, so
+// every input decodes to some op sequence.
+class Input {
+public:
+    Input(const uint8_t* data, size_t size) : P(data), Left(size) {}
+
+    bool Empty() const { return Left == 0; }
+    size_t Remaining() const { return Left; }
+
+    uint8_t Byte() {
+        if (!Left) return 0;
+        --Left;
+        return *P++;
+    }
+    uint32_t U32() {
+        uint32_t v = 0;
+        for (int i = 0; i < 4; ++i) v |= uint32_t(Byte()) << (8 * i);
+        return v;
+    }
+    // Up to n bytes, fewer at the end of the input.
+    const uint8_t* Bytes(size_t n, size_t* got) {
+        const uint8_t* p = P;
+        *got = n < Left ? n : Left;
+        P += *got; Left -= *got;
+        return p;
+    }
+
+private:
+    const uint8_t* P;
+    size_t Left;
+};
+
+} // namespace gc::fuzz
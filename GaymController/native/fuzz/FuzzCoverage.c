@@ -0,0 +1,60 @@
+#include "FuzzCoverage.h"
+
+#include <string.h>
+
+uint8_t GcFuzzEdges[GC_FUZZ_EDGE_BYTES];
+GC_FUZZ_CMP GcFuzzCmps[GC_FUZZ_CMP_SLOTS];
+
+static uintptr_t g_prev;
+static uint32_t g_cmpNext;
+static int g_seen;
+
+void GcFuzzCoverageReset(void)
+{
+    memset(GcFuzzEdges, 0, sizeof(GcFuzzEdges));
+    g_prev = 0;
+}
+
+int GcFuzzCoverageSeen(void)
+{
+    return g_seen;
+}
+
+/* Edge = (previous block, this block), as in AFL: the shift keeps A->B
+   and B->A apart. */
+void __sanitizer_cov_trace_pc(void)
+{
+    uintptr_t pc = (uintptr_t)__builtin_return_address(0);
+    uintptr_t cur = ((pc >> 4) ^ (pc << 8)) * 0x9E3779B1u;
+    cur = (cur >> 8) & (GC_FUZZ_EDGE_BYTES - 1);
+    GcFuzzEdges[cur ^ g_prev]++;
+    g_prev = cur >> 1;
+    g_seen = 1;
+}
+
+static void Record(uint64_t a, uint64_t b, uint8_t width)
+{
+    /* Only operands that differ are worth trying; keep both sides, the
+       mutator does not know which one came from the input. */
+    if (a == b) return;
+    GcFuzzCmps[g_cmpNext++ & (GC_FUZZ_CMP_SLOTS - 1)] = (GC_FUZZ_CMP){ a, width };
+    GcFuzzCmps[g_cmpNext++ & (GC_FUZZ_CMP_SLOTS - 1)] = (GC_FUZZ_CMP){ b, width };
+}
+
+void __sanitizer_cov_trace_cmp1(uint8_t a, uint8_t b) { Record(a, b, 1); }
+void __sanitizer_cov_trace_cmp2(uint16_t a, uint16_t b) { Record(a, b, 2); }
+void __sanitizer_cov_trace_cmp4(uint32_t a, uint32_t b) { Record(a, b, 4); }
+void __sanitizer_cov_trace_cmp8(uint64_t a, uint64_t b) { Record(a, b, 8); }
+void __sanitizer_cov_trace_const_cmp1(uint8_t a, uint8_t b) { Record(a, b, 1); }
+void __sanitizer_cov_trace_const_cmp2(uint16_t a, uint16_t b) { Record(a, b, 2); }
+void __sanitizer_cov_trace_const_cmp4(uint32_t a, uint32_t b) { Record(a, b, 4); }
+void __sanitizer_cov_trace_const_cmp8(uint64_t a, uint64_t b) { Record(a, b, 8); }
+void __sanitizer_cov_trace_cmpf(float a, float b) { (void)a; (void)b; }
+void __sanitizer_cov_trace_cmpd(double a, double b) { (void)a; (void)b; }
+
+/* cases[0] = case count, cases[1] = operand width in bits, then values. */
+void __sanitizer_cov_trace_switch(uint64_t val, uint64_t* cases)
+{
+    uint8_t width = (uint8_t)(cases[1] / 8);
+    for (uint64_t i = 0; i < cases[0] && i < 16; ++i) Record(val, cases[2 + i], width);
+}
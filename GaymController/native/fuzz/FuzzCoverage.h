@@ -0,0 +1,41 @@
+#pragma once
+
+/* Coverage feedback for FuzzDriver.cpp, the standalone driver used where
+   libFuzzer is not available (gcc). Code built with
+   -fsanitize-coverage=trace-pc,trace-cmp calls the __sanitizer_cov_*
+   hooks defined in FuzzCoverage.c: basic blocks are hashed into an
+   AFL-style edge map, and comparison operands are kept in a small ring
+   the mutator splices back into inputs (so magic values such as IOCTL
+   codes and frame types are found without a dictionary).
+
+   FuzzCoverage.c itself must not be built with -fsanitize-coverage. */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GC_FUZZ_EDGE_BYTES 65536u   /* power of two */
+#define GC_FUZZ_CMP_SLOTS  256u     /* power of two */
+
+typedef struct _GC_FUZZ_CMP
+{
+    uint64_t Value;
+    uint8_t Width;     /* 1, 2, 4 or 8 bytes; 0 = empty slot */
+} GC_FUZZ_CMP;
+
+/* Hit counts per edge since the last GcFuzzCoverageReset. */
+extern uint8_t GcFuzzEdges[GC_FUZZ_EDGE_BYTES];
+/* Recent comparison operands, overwritten round-robin. */
+extern GC_FUZZ_CMP GcFuzzCmps[GC_FUZZ_CMP_SLOTS];
+
+/* Clears the edge map before an execution; the cmp ring is kept. */
+void GcFuzzCoverageReset(void);
+/* Nonzero once any instrumented code has run. */
+int GcFuzzCoverageSeen(void);
+
+#ifdef __cplusplus
+}
+#endif
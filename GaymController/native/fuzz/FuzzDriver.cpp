@@ -0,0 +1,368 @@
+// Standalone driver for the LLVMFuzzerTestOneInput targets in fuzz/, used
+// where libFuzzer is not available (gcc builds). Accepts the libFuzzer
+// command line subset the ctest entries and README use:
+//
+//   <fuzzer> [flags] FILE...           run each file once (reproduce a crash)
+//   <fuzzer> [flags] DIR [DIR|FILE...] load the corpus, then fuzz
+//
+//   -runs=N             mutated executions (default: until -max_total_time)
+//   -max_total_time=S   stop fuzzing after S seconds
+//   -max_len=N          longest generated input (default: twice the
+//                       largest corpus input, 64 to 4096, as libFuzzer
+//                       keeps inputs near the seeds' size)
+//   -seed=N             mutation seed (default 1)
+//   -artifact_prefix=P  crash-<hash> is written to P (default ./)
+//   --min-exec-per-sec=N  exit 1 when the measured rate is below N
+//                       (libFuzzer ignores flags starting with "--")
+//
+// Inputs that reach a new edge (FuzzCoverage.h) join the corpus and are
+// written to the first DIR, as libFuzzer does. Without coverage
+// instrumentation it still runs, as a plain random mutator.
+#include "Fuzz.h"
+#include "FuzzCoverage.h"
+
+#include <algorithm>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+extern "C" void __sanitizer_set_death_callback(void (*callback)(void)) __attribute__((weak));
+
+// gcc's UBSan exits without running the death callback; aborting instead
+// routes every sanitizer report through OnSignal, which saves the input.
+extern "C" const char* __asan_default_options() { return "abort_on_error=1"; }
+extern "C" const char* __ubsan_default_options() { return "abort_on_error=1:print_stacktrace=1"; }
+
+namespace {
+
+using Bytes = std::vector<uint8_t>;
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    long long Runs = -1;
+    double MaxTotalTime = 0;
+    size_t MaxLen = 0;   // 0: from the corpus
+    uint64_t Seed = 1;
+    std::string ArtifactPrefix = "./";
+    double MinExecPerSec = 0;
+};
+
+// ---- crash artifacts ----
+
+const uint8_t* g_current;
+size_t g_currentSize;
+char g_crashPath[4096];
+
+uint64_t Hash(const uint8_t* p, size_t n) {
+    uint64_t h = 0xcbf29ce484222325ull;   // FNV-1a
+    for (size_t i = 0; i < n; ++i) h = (h ^ p[i]) * 0x100000001b3ull;
+    return h;
+}
+
+// Runs from the sanitizer death callback or a signal handler: no stdio,
+// no allocation.
+void WriteCrash() {
+    static volatile sig_atomic_t written;
+    if (written || !g_crashPath[0]) return;
+    written = 1;
+    int fd = open(g_crashPath, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) return;
+    for (size_t off = 0; off < g_currentSize;) {
+        ssize_t n = write(fd, g_current + off, g_currentSize - off);
+        if (n <= 0) break;
+        off += (size_t)n;
+    }
+    close(fd);
+    const char msg[] = "FuzzDriver: crashing input written to ";
+    ssize_t ignored = write(2, msg, sizeof(msg) - 1);
+    ignored = write(2, g_crashPath, strlen(g_crashPath));
+    ignored = write(2, "\n", 1);
+    (void)ignored;
+}
+
+void OnSignal(int sig) {
+    WriteCrash();
+    std::signal(sig, SIG_DFL);
+    std::raise(sig);
+}
+
+// The input is copied to an exact-size heap block so ASan sees reads past
+// its end, as it does with libFuzzer.
+void Execute(const Bytes& in, const std::string& prefix) {
+    uint8_t* copy = static_cast<uint8_t*>(std::malloc(in.size() ? in.size() : 1));
+    if (!in.empty()) std::memcpy(copy, in.data(), in.size());
+    g_current = copy;
+    g_currentSize = in.size();
+    std::snprintf(g_crashPath, sizeof(g_crashPath), "%scrash-%016llx", prefix.c_str(),
+                  (unsigned long long)Hash(copy, in.size()));
+    GcFuzzCoverageReset();
+    LLVMFuzzerTestOneInput(copy, in.size());
+    g_current = nullptr;
+    g_crashPath[0] = 0;
+    std::free(copy);
+}
+
+// ---- coverage ----
+
+// AFL hit-count buckets: 1, 2, 3, 4-7, 8-15, 16-31, 32-127, 128+.
+uint8_t Bucket(uint8_t hits) {
+    if (hits <= 3) return hits ? uint8_t(1u << (hits - 1)) : 0;
+    if (hits < 8) return 8;
+    if (hits < 16) return 16;
+    if (hits < 32) return 32;
+    return hits < 128 ? 64 : 128;
+}
+
+class Coverage {
+public:
+    Coverage() : Seen(GC_FUZZ_EDGE_BYTES, 0) {}
+
+    // Folds the last execution in; true when it reached a new edge or a
+    // new hit-count bucket on a known one.
+    bool Merge() {
+        bool fresh = false;
+        // The map is sparse: skip untouched 8-byte words.
+        for (uint32_t w = 0; w < GC_FUZZ_EDGE_BYTES; w += 8) {
+            uint64_t word;
+            std::memcpy(&word, GcFuzzEdges + w, sizeof(word));
+            if (!word) continue;
+            for (uint32_t i = w; i < w + 8; ++i) {
+                if (!GcFuzzEdges[i]) continue;
+                uint8_t b = Bucket(GcFuzzEdges[i]);
+                if (Seen[i] & b) continue;
+                if (!Seen[i]) ++Edges;
+                Seen[i] |= b;
+                fresh = true;
+            }
+        }
+        return fresh;
+    }
+    size_t EdgeCount() const { return Edges; }
+
+private:
+    std::vector<uint8_t> Seen;
+    size_t Edges = 0;
+};
+
+// ---- mutation ----
+
+struct Rng {
+    explicit Rng(uint64_t seed) : S(seed * 0x9E3779B97F4A7C15ull + 1) {}
+    uint64_t Next() {
+        S ^= S << 13; S ^= S >> 7; S ^= S << 17;
+        return S;
+    }
+    size_t Below(size_t n) { return n ? size_t(Next() % n) : 0; }
+    uint64_t S;
+};
+
+void PutLe(Bytes& b, size_t at, uint64_t v, size_t width) {
+    for (size_t i = 0; i < width && at + i < b.size(); ++i) b[at + i] = uint8_t(v >> (8 * i));
+}
+
+void Mutate(Bytes& b, const std::vector<Bytes>& corpus, Rng& r, size_t maxLen) {
+    static const uint64_t kInteresting[] = { 0, 1, 2, 8, 12, 16, 24, 32, 40, 0x7F, 0x80, 0xFF,
+                                             0x7FFF, 0x8000, 0xFFFF, 0x7FFFFFFF, 0x80000000, 0xFFFFFFFF };
+    const int stack = 1 + int(r.Below(4));
+    for (int s = 0; s < stack; ++s) {
+        switch (b.empty() ? 4 : r.Below(9)) {
+        case 0: b[r.Below(b.size())] ^= uint8_t(1u << r.Below(8)); break;
+        case 1: b[r.Below(b.size())] = uint8_t(r.Next()); break;
+        case 2: {
+            size_t at = r.Below(b.size()), width = size_t(1) << r.Below(3);
+            PutLe(b, at, kInteresting[r.Below(sizeof(kInteresting) / sizeof(kInteresting[0]))], width);
+            break;
+        }
+        case 3: b[r.Below(b.size())] += uint8_t(int(r.Below(35)) - 17); break;
+        case 4: {
+            size_t n = 1 + r.Below(16), at = r.Below(b.size() + 1);
+            Bytes ins(n);
+            for (uint8_t& x : ins) x = uint8_t(r.Next());
+            b.insert(b.begin() + at, ins.begin(), ins.end());
+            break;
+        }
+        case 5: {
+            size_t at = r.Below(b.size()), n = 1 + r.Below(std::min<size_t>(b.size() - at, 16));
+            b.erase(b.begin() + at, b.begin() + at + n);
+            break;
+        }
+        case 6: {   // duplicate a run of bytes (repeats ops in op-sequence inputs)
+            size_t at = r.Below(b.size()), n = 1 + r.Below(std::min<size_t>(b.size() - at, 32));
+            Bytes run(b.begin() + at, b.begin() + at + n);
+            b.insert(b.begin() + r.Below(b.size() + 1), run.begin(), run.end());
+            break;
+        }
+        case 7: {   // splice: keep a prefix, append another entry's suffix
+            const Bytes& o = corpus[r.Below(corpus.size())];
+            if (o.empty()) break;
+            size_t keep = r.Below(b.size() + 1), from = r.Below(o.size());
+            b.resize(keep);
+            b.insert(b.end(), o.begin() + from, o.end());
+            break;
+        }
+        case 8: {   // a recent comparison operand
+            const GC_FUZZ_CMP& c = GcFuzzCmps[r.Below(GC_FUZZ_CMP_SLOTS)];
+            if (c.Width) PutLe(b, r.Below(b.size()), c.Value, c.Width);
+            break;
+        }
+        }
+        if (b.size() > maxLen) b.resize(maxLen);
+    }
+}
+
+// ---- corpus files ----
+
+bool IsDir(const std::string& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+bool ReadFile(const std::string& path, Bytes& out) {
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) return false;
+    out.clear();
+    uint8_t buf[4096];
+    size_t n;
+    while ((n = std::fread(buf, 1, sizeof(buf), f)) > 0) out.insert(out.end(), buf, buf + n);
+    std::fclose(f);
+    return true;
+}
+
+void LoadDir(const std::string& dir, std::vector<Bytes>& out) {
+    std::vector<std::string> names;
+    if (DIR* d = opendir(dir.c_str())) {
+        while (dirent* e = readdir(d))
+            if (e->d_name[0] != '.') names.push_back(e->d_name);
+        closedir(d);
+    }
+    std::sort(names.begin(), names.end());   // same order on every run
+    for (const std::string& n : names) {
+        Bytes b;
+        if (!IsDir(dir + "/" + n) && ReadFile(dir + "/" + n, b)) out.push_back(std::move(b));
+    }
+}
+
+void SaveNew(const std::string& dir, const Bytes& b) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "/%016llx", (unsigned long long)Hash(b.data(), b.size()));
+    if (FILE* f = std::fopen((dir + name).c_str(), "wb")) {
+        if (!b.empty()) std::fwrite(b.data(), 1, b.size(), f);
+        std::fclose(f);
+    }
+}
+
+bool ParseFlag(const char* arg, Options& o) {
+    auto val = [&](const char* name) -> const char* {
+        size_t n = std::strlen(name);
+        return std::strncmp(arg, name, n) == 0 && arg[n] == '=' ? arg + n + 1 : nullptr;
+    };
+    const char* v;
+    if ((v = val("-runs"))) o.Runs = std::atoll(v);
+    else if ((v = val("-max_total_time"))) o.MaxTotalTime = std::atof(v);
+    else if ((v = val("-max_len"))) o.MaxLen = std::max(1ll, std::atoll(v));
+    else if ((v = val("-seed"))) o.Seed = std::strtoull(v, nullptr, 0);
+    else if ((v = val("-artifact_prefix"))) o.ArtifactPrefix = v;
+    else if ((v = val("--min-exec-per-sec"))) o.MinExecPerSec = std::atof(v);
+    else return false;
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options o;
+    std::vector<std::string> paths;
+    for (int i = 1; i < argc; ++i) {
+        if (argv[i][0] != '-') paths.push_back(argv[i]);
+        else if (!ParseFlag(argv[i], o)) std::fprintf(stderr, "FuzzDriver: ignoring unknown flag %s\n", argv[i]);
+    }
+
+    if (__sanitizer_set_death_callback) __sanitizer_set_death_callback(WriteCrash);
+    std::signal(SIGABRT, OnSignal);
+    std::signal(SIGSEGV, OnSignal);
+    std::signal(SIGFPE, OnSignal);
+    std::signal(SIGILL, OnSignal);
+
+    // Reproduce mode: every argument is a file.
+    bool anyDir = std::any_of(paths.begin(), paths.end(), IsDir);
+    if (!paths.empty() && !anyDir) {
+        for (const std::string& p : paths) {
+            Bytes b;
+            if (!ReadFile(p, b)) { std::fprintf(stderr, "FuzzDriver: cannot read %s\n", p.c_str()); return 2; }
+            std::printf("Running: %s (%zu bytes)\n", p.c_str(), b.size());
+            std::fflush(stdout);
+            Execute(b, o.ArtifactPrefix);
+        }
+        return 0;
+    }
+
+    std::vector<Bytes> corpus;
+    std::string outDir = anyDir && IsDir(paths[0]) ? paths[0] : std::string();
+    for (const std::string& p : paths) {
+        if (IsDir(p)) LoadDir(p, corpus);
+        else if (Bytes b; ReadFile(p, b)) corpus.push_back(std::move(b));
+    }
+    if (corpus.empty()) corpus.emplace_back();
+    if (!o.MaxLen) {
+        size_t largest = 0;
+        for (const Bytes& b : corpus) largest = std::max(largest, b.size());
+        o.MaxLen = std::min<size_t>(4096, std::max<size_t>(64, 2 * largest));
+    }
+
+    Coverage cov;
+    Rng rng(o.Seed);
+    auto start = Clock::now();
+    auto seconds = [&] { return std::chrono::duration<double>(Clock::now() - start).count(); };
+    unsigned long long execs = 0;
+
+    // Replay the seeds; keep those that add coverage (all of them when
+    // the build is not instrumented).
+    std::vector<Bytes> seeds;
+    seeds.swap(corpus);
+    for (Bytes& b : seeds) {
+        Execute(b, o.ArtifactPrefix);
+        ++execs;
+        if (cov.Merge() || !GcFuzzCoverageSeen()) corpus.push_back(std::move(b));
+    }
+    if (corpus.empty()) corpus.emplace_back();
+    std::printf("#%llu\tINITED cov: %zu corp: %zu max_len: %zu%s\n", execs, cov.EdgeCount(), corpus.size(),
+                o.MaxLen, GcFuzzCoverageSeen() ? "" : " (no coverage instrumentation)");
+
+    const bool unbounded = o.Runs < 0 && o.MaxTotalTime <= 0;
+    if (unbounded) std::printf("fuzzing until interrupted (use -runs=N or -max_total_time=S)\n");
+    unsigned long long fuzzed = 0, nextPulse = 1024;
+    while ((o.Runs < 0 || (long long)fuzzed < o.Runs) && (o.MaxTotalTime <= 0 || seconds() < o.MaxTotalTime)) {
+        Bytes b = corpus[rng.Below(corpus.size())];
+        Mutate(b, corpus, rng, o.MaxLen);
+        Execute(b, o.ArtifactPrefix);
+        ++execs; ++fuzzed;
+        if (cov.Merge() && corpus.size() < 65536) {
+            if (!outDir.empty()) SaveNew(outDir, b);
+            corpus.push_back(std::move(b));
+            std::printf("#%llu\tNEW    cov: %zu corp: %zu exec/s: %.0f len: %zu\n", execs, cov.EdgeCount(),
+                        corpus.size(), execs / seconds(), corpus.back().size());
+        } else if (execs >= nextPulse) {
+            std::printf("#%llu\tpulse  cov: %zu corp: %zu exec/s: %.0f\n", execs, cov.EdgeCount(), corpus.size(),
+                        execs / seconds());
+            nextPulse *= 2;
+        }
+    }
+
+    double t = seconds(), rate = t > 0 ? execs / t : 0;
+    std::printf("Done %llu runs in %.2f s: exec/s %.0f, cov %zu, corp %zu\n", execs, t, rate, cov.EdgeCount(),
+                corpus.size());
+    if (o.MinExecPerSec > 0 && rate < o.MinExecPerSec) {
+        std::printf("exec/s %.0f is below the target %.0f\n", rate, o.MinExecPerSec);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,64 @@
+// VPadBusEvtIoctl through the host WDK. The first input byte seeds the
+// PadCount registry value the bus reads at DeviceAdd (0xFF: no value);
+// the rest is an op sequence against the fresh bus device:
+//
+//   0 idx inLen outLen in[inLen]      IOCTL kCodes[idx % count]
+//   1 code:u32 inLen outLen in[inLen] IOCTL with a raw code
+//   2 count:u32                       PadCount registry value, then re-add
+#include "Fuzz.h"
+#include "gc/HostWdk.h"
+#include "VPadShared.h"
+
+namespace {
+
+const ULONG kCodes[] = { IOCTL_VPADBUS_GET_PADCOUNT, IOCTL_VPADBUS_SET_PADCOUNT, IOCTL_VPADBUS_RESCAN };
+constexpr size_t kCodeCount = sizeof(kCodes) / sizeof(kCodes[0]);
+
+WDFDEVICE AddBus() {
+    WDFDEVICE dev = nullptr;
+    GC_FUZZ_CHECK(GcHostAddDevice(GcVPadBusDriverEntry, &dev) == STATUS_SUCCESS);
+    GC_FUZZ_CHECK(GcHostChildCount(dev) == 1);   // descriptions carry no index
+    return dev;
+}
+
+void Ioctl(WDFDEVICE dev, ULONG code, gc::fuzz::Input& in) {
+    size_t inLen = in.Byte(), outLen = in.Byte(), got = 0;
+    const uint8_t* src = in.Bytes(inLen, &got);
+    uint8_t out[256];
+    size_t info = 0;
+    NTSTATUS st = GcHostIoctl(dev, code, got ? src : nullptr, got, out, outLen, &info);
+    GC_FUZZ_CHECK(info <= outLen);
+    if (st == STATUS_SUCCESS && code == IOCTL_VPADBUS_GET_PADCOUNT) {
+        ULONG n;
+        std::memcpy(&n, out, sizeof(n));
+        GC_FUZZ_CHECK(info == sizeof(ULONG) && n >= 1 && n <= 16);
+    }
+    if (st == STATUS_SUCCESS && code == IOCTL_VPADBUS_SET_PADCOUNT) {
+        ULONG stored = 0;
+        GC_FUZZ_CHECK(GcHostRegistryGetULong(L"PadCount", &stored) && stored >= 1 && stored <= 16);
+    }
+}
+
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    gc::fuzz::Input in(data, size);
+    GcHostRegistryClear();
+    uint8_t initial = in.Byte();
+    if (initial != 0xFF) GcHostRegistrySetULong(L"PadCount", initial);
+    WDFDEVICE dev = AddBus();
+
+    while (!in.Empty()) {
+        switch (in.Byte() % 3) {
+        case 0: Ioctl(dev, kCodes[in.Byte() % kCodeCount], in); break;
+        case 1: Ioctl(dev, in.U32(), in); break;
+        case 2:
+            GcHostRegistrySetULong(L"PadCount", in.U32());
+            GcHostRemoveDevice(dev);
+            dev = AddBus();
+            break;
+        }
+    }
+    GcHostRemoveDevice(dev);
+    return 0;
+}
@@ -0,0 +1,70 @@
+// VPadFuncEvtIoDeviceControl through the host WDK. Each input is an op
+// sequence replayed against a fresh func device:
+//
+//   0 idx inLen outLen in[inLen]      IOCTL kCodes[idx % count]
+//   1 code:u32 inLen outLen in[inLen] IOCTL with a raw code
+//   2 id len report[len]              output report (VPadOnVhfProcessOutput)
+//   3                                 fire armed timers (watchdog)
+//   4 fail                            VhfReadReportSubmit fails while fail & 1
+//
+// The host gives every request one heap system buffer of max(in, out)
+// bytes, so a read or write past the lengths the driver checked is an
+// ASan report.
+#include "Fuzz.h"
+#include "gc/HostWdk.h"
+#include "VPadShared.h"
+
+namespace {
+
+const ULONG kCodes[] = {
+    IOCTL_VPAD_GET_VERSION, IOCTL_VPAD_SET_STATE, IOCTL_VPAD_CREATE, IOCTL_VPAD_DESTROY,
+    IOCTL_VPAD_GET_RUMBLE, IOCTL_VPAD_SET_LEDS, IOCTL_VPAD_GET_LEDS, IOCTL_VPAD_GET_LATENCY,
+    IOCTL_VPAD_GET_PRESSURE, IOCTL_VPAD_GET_WATCHDOG, IOCTL_VPAD_SET_WATCHDOG,
+};
+constexpr size_t kCodeCount = sizeof(kCodes) / sizeof(kCodes[0]);
+
+void Ioctl(WDFDEVICE dev, ULONG code, gc::fuzz::Input& in) {
+    size_t inLen = in.Byte(), outLen = in.Byte(), got = 0;
+    const uint8_t* src = in.Bytes(inLen, &got);
+    uint8_t out[256];
+    size_t info = 0;
+    uint64_t before = GcHostVhfSubmits(dev);
+    NTSTATUS st = GcHostIoctl(dev, code, got ? src : nullptr, got, out, outLen, &info);
+    GC_FUZZ_CHECK(info <= outLen);
+    if (st != STATUS_SUCCESS) GC_FUZZ_CHECK(GcHostVhfSubmits(dev) == before);
+    if (st == STATUS_SUCCESS && code == IOCTL_VPAD_GET_VERSION) {
+        ULONG v;
+        std::memcpy(&v, out, sizeof(v));
+        GC_FUZZ_CHECK(info == sizeof(ULONG) && v == VPAD_VERSION);
+    }
+}
+
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    gc::fuzz::Input in(data, size);
+    WDFDEVICE dev = nullptr;
+    GC_FUZZ_CHECK(GcHostAddDevice(GcVPadFuncDriverEntry, &dev) == STATUS_SUCCESS);
+
+    while (!in.Empty()) {
+        switch (in.Byte() % 5) {
+        case 0: Ioctl(dev, kCodes[in.Byte() % kCodeCount], in); break;
+        case 1: Ioctl(dev, in.U32(), in); break;
+        case 2: {
+            UCHAR id = in.Byte();
+            size_t got = 0;
+            const uint8_t* report = in.Bytes(in.Byte(), &got);
+            GcHostVhfWrite(dev, id, report, (ULONG)got);
+            break;
+        }
+        case 3: GcHostFireTimers(dev); break;
+        case 4: GcHostVhfSetSubmitStatus(dev, (in.Byte() & 1) ? STATUS_INSUFFICIENT_RESOURCES : STATUS_SUCCESS); break;
+        }
+    }
+
+    // Every report the driver submitted has the descriptor's input size.
+    UCHAR last[64];
+    GC_FUZZ_CHECK(GcHostVhfLastReport(dev, last, sizeof(last)) == sizeof(VPAD_STATE));
+    GcHostRemoveDevice(dev);
+    return 0;
+}
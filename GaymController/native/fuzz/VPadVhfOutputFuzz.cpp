@@ -0,0 +1,44 @@
+// VPadOnVhfProcessOutput through the host WDK: input byte 0 is the report
+// ID, the rest is the output report, delivered in a heap buffer of exactly
+// that length. The rumble/LED state read back must match what the report
+// set, and nothing else may change it.
+#include "Fuzz.h"
+#include "gc/HostWdk.h"
+#include "VPadShared.h"
+
+namespace {
+
+template <class T> T Get(WDFDEVICE dev, ULONG code) {
+    T out;
+    size_t info = 0;
+    GC_FUZZ_CHECK(GcHostIoctl(dev, code, nullptr, 0, &out, sizeof(out), &info) == STATUS_SUCCESS);
+    GC_FUZZ_CHECK(info == sizeof(out));
+    return out;
+}
+
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    if (size == 0) return 0;
+    WDFDEVICE dev = nullptr;
+    GC_FUZZ_CHECK(GcHostAddDevice(GcVPadFuncDriverEntry, &dev) == STATUS_SUCCESS);
+    const UCHAR id = data[0];
+    const uint8_t* report = data + 1;
+    const ULONG len = (ULONG)(size - 1);
+    GcHostVhfWrite(dev, id, report, len);
+
+    VPAD_RUMBLE r = Get<VPAD_RUMBLE>(dev, IOCTL_VPAD_GET_RUMBLE);
+    VPAD_LEDS l = Get<VPAD_LEDS>(dev, IOCTL_VPAD_GET_LEDS);
+    if (id == 1 && len >= 2) {
+        GC_FUZZ_CHECK(r.Sequence == 1 && r.Left == report[0] && r.Right == report[1]);
+        GC_FUZZ_CHECK(l.G == (report[0] < report[1] ? report[0] : report[1]));
+    } else if (id == 2 && len >= 3) {
+        GC_FUZZ_CHECK(r.Sequence == 0);
+        GC_FUZZ_CHECK(l.R == report[0] && l.G == report[1] && l.B == report[2]);
+    } else {
+        GC_FUZZ_CHECK(r.Sequence == 0 && r.Left == 0 && r.Right == 0);
+        GC_FUZZ_CHECK(l.R == 0 && l.G == 0 && l.B == 0);
+    }
+    GcHostRemoveDevice(dev);
+    return 0;
+}
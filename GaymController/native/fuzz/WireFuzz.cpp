@@ -0,0 +1,41 @@
+// Broker wire decoding: the input is a byte stream split into frames with
+// GcWireParseFrame the way the broker reads its pipe, stopping where the
+// broker would wait for more or drop the client. Each frame is copied to a
+// buffer of exactly its declared length before GcWireReadSetState, so a
+// read past the frame is an ASan report, and a SET_STATE that decodes
+// cleanly must pack back to the same bytes.
+#include "Fuzz.h"
+#include "gc/Wire.h"
+
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    const uint8_t* p = data;
+    size_t left = size;
+    GC_WIRE_FRAME f;
+    while (GcWireParseFrame(p, left, &f) == GC_WIRE_OK) {
+        GC_FUZZ_CHECK(f.Length >= GC_WIRE_HEADER_BYTES && f.Length <= left && f.Length <= GC_WIRE_MAX_FRAME);
+        GC_FUZZ_CHECK(f.Payload == p + GC_WIRE_HEADER_BYTES && f.PayloadLength == f.Length - GC_WIRE_HEADER_BYTES);
+
+        std::vector<uint8_t> own(p, p + f.Length);
+        GC_WIRE_FRAME g;
+        GC_FUZZ_CHECK(GcWireParseFrame(own.data(), own.size(), &g) == GC_WIRE_OK);
+        GC_WIRE_SET_STATE s;
+        if (GcWireReadSetState(&g, &s) == GC_WIRE_OK) {
+            GC_FUZZ_CHECK(g.Type == GC_MSG_SET_STATE);
+            GC_FUZZ_CHECK(s.HasTrace == ((g.Flags & GC_WIRE_FLAG_TRACE) != 0));
+            // Frames with extra payload or other flag bits are accepted but
+            // do not round-trip; everything else must.
+            uint8_t re[64];
+            size_t n = GcWirePackSetState(re, sizeof(re), s.Handle, &s.State, s.HasTrace ? &s.Trace : nullptr);
+            GC_FUZZ_CHECK(n != 0 && n <= own.size());
+            if (n == own.size() && g.Flags == (s.HasTrace ? GC_WIRE_FLAG_TRACE : 0))
+                GC_FUZZ_CHECK(std::memcmp(re, own.data(), n) == 0);
+        } else {
+            GC_FUZZ_CHECK(g.Type != GC_MSG_SET_STATE || g.PayloadLength < 40);
+        }
+        p += f.Length;
+        left -= f.Length;
+    }
+    return 0;
+}
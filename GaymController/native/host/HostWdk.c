@@ -0,0 +1,781 @@
+#include "gc/HostWdk.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#define HOST_MAGIC 0x4B445747u  /* "GWDK" */
+#define HOST_MAX_CHILDREN 64
+#define HOST_MAX_REPORT 64
+#define HOST_MAX_VALUES 16
+
+typedef enum _HOST_KIND
+{
+    HOST_KIND_DEVICE = 1,
+    HOST_KIND_QUEUE,
+    HOST_KIND_REQUEST,
+    HOST_KIND_TIMER,
+    HOST_KIND_SPINLOCK,
+    HOST_KIND_KEY,
+    HOST_KIND_CHILDLIST,
+    HOST_KIND_VHF
+} HOST_KIND;
+
+typedef struct _HOST_OBJECT
+{
+    uint32_t Magic;
+    uint32_t Kind;
+    struct _HOST_OBJECT* Parent;
+    struct _HOST_OBJECT* NextOwned;   /* in the owning device's list */
+    void* Context;
+} HOST_OBJECT;
+
+typedef struct _HOST_QUEUE
+{
+    HOST_OBJECT Header;
+    EVT_WDF_IO_QUEUE_IO_DEVICE_CONTROL* EvtIoDeviceControl;
+} HOST_QUEUE;
+
+typedef struct _HOST_TIMER
+{
+    HOST_OBJECT Header;
+    EVT_WDF_TIMER* EvtTimerFunc;
+    LONGLONG Due;
+    int Armed;
+} HOST_TIMER;
+
+typedef struct _HOST_SPINLOCK
+{
+    HOST_OBJECT Header;
+    int Held;
+} HOST_SPINLOCK;
+
+typedef struct _HOST_REQUEST
+{
+    HOST_OBJECT Header;
+    void* Buffer;
+    size_t InLen, OutLen;
+    ULONG_PTR Information;
+    NTSTATUS Status;
+    int Completions;
+} HOST_REQUEST;
+
+typedef struct _HOST_KEY
+{
+    HOST_OBJECT Header;
+    ACCESS_MASK Access;
+} HOST_KEY;
+
+typedef struct _HOST_CHILD
+{
+    UCHAR* Description;
+    struct _HOST_DEVICE* Pdo;
+} HOST_CHILD;
+
+typedef struct _HOST_DEVICE
+{
+    HOST_OBJECT Header;
+    HOST_OBJECT* Owned;
+    HOST_QUEUE* DefaultQueue;
+    EVT_WDF_DEVICE_D0_EXIT* EvtD0Exit;
+    /* VHF */
+    HOST_OBJECT VhfObject;
+    VHF_CONFIG Vhf;
+    int VhfCreated, VhfStarted;
+    NTSTATUS SubmitStatus;
+    uint64_t Submits;
+    UCHAR LastReport[HOST_MAX_REPORT];
+    ULONG LastReportLen;
+    /* default child list */
+    HOST_OBJECT ChildListObject;
+    WDF_CHILD_LIST_CONFIG ChildConfig;
+    int HasChildList;
+    HOST_CHILD Children[HOST_MAX_CHILDREN];
+    ULONG ChildCount;
+    UCHAR* Scan[HOST_MAX_CHILDREN];
+    ULONG ScanCount;
+} HOST_DEVICE;
+
+struct _WDFDEVICE_INIT
+{
+    DEVICE_TYPE DeviceType;
+    BOOLEAN Exclusive;
+    HOST_DEVICE* Bus;            /* PDO init: the FDO enumerating it */
+    WDF_CHILD_LIST_CONFIG ChildConfig;
+    int HasChildList;
+    EVT_WDF_DEVICE_D0_EXIT* EvtD0Exit;
+    HOST_DEVICE* Created;
+};
+
+typedef struct _HOST_VALUE
+{
+    wchar_t Name[32];
+    ULONG Value;
+} HOST_VALUE;
+
+static EVT_WDF_DRIVER_DEVICE_ADD* g_deviceAdd;
+static HOST_VALUE g_values[HOST_MAX_VALUES];
+static ULONG g_valueCount;
+
+static void HostFail(const char* what)
+{
+    fprintf(stderr, "host wdk: %s\n", what);
+    abort();
+}
+
+static HOST_OBJECT* HostObject(WDFOBJECT handle, uint32_t kind)
+{
+    HOST_OBJECT* o = (HOST_OBJECT*)handle;
+    if (!o || o->Magic != HOST_MAGIC) HostFail("not a framework object");
+    if (kind && o->Kind != kind) HostFail("wrong framework object type");
+    return o;
+}
+
+static HOST_DEVICE* HostDevice(WDFOBJECT handle)
+{
+    return (HOST_DEVICE*)HostObject(handle, HOST_KIND_DEVICE);
+}
+
+static void HostInitObject(HOST_OBJECT* o, uint32_t kind, HOST_OBJECT* parent)
+{
+    o->Magic = HOST_MAGIC;
+    o->Kind = kind;
+    o->Parent = parent;
+}
+
+static NTSTATUS HostAllocContext(HOST_OBJECT* o, PWDF_OBJECT_ATTRIBUTES attrs)
+{
+    if (!attrs || !attrs->ContextSize) return STATUS_SUCCESS;
+    /* Exact size, so an overrun is visible to ASan. */
+    o->Context = calloc(1, attrs->ContextSize);
+    return o->Context ? STATUS_SUCCESS : STATUS_INSUFFICIENT_RESOURCES;
+}
+
+/* Queues, timers and locks: freed with the device named by the parent
+   attribute (or the queue's device). */
+static void* HostNewOwned(size_t size, uint32_t kind, WDFOBJECT owner, PWDF_OBJECT_ATTRIBUTES attrs)
+{
+    if (!owner) HostFail("object needs a device parent");
+    HOST_DEVICE* d = HostDevice(owner);
+    HOST_OBJECT* o = (HOST_OBJECT*)calloc(1, size);
+    if (!o) return NULL;
+    HostInitObject(o, kind, &d->Header);
+    if (!NT_SUCCESS(HostAllocContext(o, attrs))) { free(o); return NULL; }
+    o->NextOwned = d->Owned;
+    d->Owned = o;
+    return o;
+}
+
+static void HostFreeDevice(HOST_DEVICE* d)
+{
+    for (ULONG i = 0; i < d->ChildCount; ++i)
+    {
+        if (d->Children[i].Pdo) HostFreeDevice(d->Children[i].Pdo);
+        free(d->Children[i].Description);
+    }
+    /* Removal powers the device down before its objects go away. */
+    if (d->EvtD0Exit) d->EvtD0Exit(d, WdfPowerDeviceD3Final);
+    for (ULONG i = 0; i < d->ScanCount; ++i) free(d->Scan[i]);
+    for (HOST_OBJECT* o = d->Owned; o;)
+    {
+        HOST_OBJECT* next = o->NextOwned;
+        o->Magic = 0;
+        free(o->Context);
+        free(o);
+        o = next;
+    }
+    d->Header.Magic = 0;
+    free(d->Header.Context);
+    free(d);
+}
+
+PVOID GcHostObjectContext(WDFOBJECT Handle)
+{
+    HOST_OBJECT* o = HostObject(Handle, 0);
+    if (!o->Context) HostFail("object has no context");
+    return o->Context;
+}
+
+/* ---- Rtl and Ke ---- */
+
+VOID RtlInitUnicodeString(PUNICODE_STRING DestinationString, PCWSTR SourceString)
+{
+    size_t bytes = SourceString ? wcslen(SourceString) * sizeof(WCHAR) : 0;
+    DestinationString->Buffer = (PWCH)SourceString;
+    DestinationString->Length = (USHORT)bytes;
+    DestinationString->MaximumLength = SourceString ? (USHORT)(bytes + sizeof(WCHAR)) : 0;
+}
+
+NTSTATUS RtlAppendUnicodeToString(PUNICODE_STRING Destination, PCWSTR Source)
+{
+    if (!Source) return STATUS_SUCCESS;
+    size_t bytes = wcslen(Source) * sizeof(WCHAR);
+    if (Destination->Length + bytes > Destination->MaximumLength) return STATUS_BUFFER_TOO_SMALL;
+    memcpy((UCHAR*)Destination->Buffer + Destination->Length, Source, bytes);
+    Destination->Length = (USHORT)(Destination->Length + bytes);
+    if (Destination->Length + sizeof(WCHAR) <= Destination->MaximumLength)
+        Destination->Buffer[Destination->Length / sizeof(WCHAR)] = 0;
+    return STATUS_SUCCESS;
+}
+
+LARGE_INTEGER KeQueryPerformanceCounter(PLARGE_INTEGER PerformanceFrequency)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    LARGE_INTEGER t;
+    t.QuadPart = (LONGLONG)ts.tv_sec * 10000000 + ts.tv_nsec / 100;
+    if (PerformanceFrequency) PerformanceFrequency->QuadPart = 10000000;
+    return t;
+}
+
+/* ---- driver and device ---- */
+
+NTSTATUS WdfDriverCreate(PDRIVER_OBJECT DriverObject, PCUNICODE_STRING RegistryPath,
+                         PWDF_OBJECT_ATTRIBUTES DriverAttributes, PWDF_DRIVER_CONFIG DriverConfig,
+                         WDFDRIVER* Driver)
+{
+    UNREFERENCED_PARAMETER(DriverObject);
+    UNREFERENCED_PARAMETER(RegistryPath);
+    UNREFERENCED_PARAMETER(DriverAttributes);
+    if (!DriverConfig || !DriverConfig->EvtDriverDeviceAdd) return STATUS_INVALID_PARAMETER;
+    g_deviceAdd = DriverConfig->EvtDriverDeviceAdd;
+    if (Driver) *Driver = NULL;
+    return STATUS_SUCCESS;
+}
+
+NTSTATUS WdfDeviceInitAssignSDDLString(PWDFDEVICE_INIT DeviceInit, PCUNICODE_STRING SDDLString)
+{
+    UNREFERENCED_PARAMETER(DeviceInit);
+    return SDDLString && SDDLString->Buffer ? STATUS_SUCCESS : STATUS_INVALID_PARAMETER;
+}
+
+VOID WdfDeviceInitSetDeviceType(PWDFDEVICE_INIT DeviceInit, DEVICE_TYPE DeviceType)
+{
+    DeviceInit->DeviceType = DeviceType;
+}
+
+VOID WdfDeviceInitSetExclusive(PWDFDEVICE_INIT DeviceInit, BOOLEAN IsExclusive)
+{
+    DeviceInit->Exclusive = IsExclusive;
+}
+
+VOID WdfDeviceInitSetPnpPowerEventCallbacks(PWDFDEVICE_INIT DeviceInit, PWDF_PNPPOWER_EVENT_CALLBACKS PnpPowerEventCallbacks)
+{
+    DeviceInit->EvtD0Exit = PnpPowerEventCallbacks->EvtDeviceD0Exit;
+}
+
+NTSTATUS WdfDeviceCreate(PWDFDEVICE_INIT* DeviceInit, PWDF_OBJECT_ATTRIBUTES DeviceAttributes, WDFDEVICE* Device)
+{
+    if (!DeviceInit || !*DeviceInit) HostFail("WdfDeviceCreate without a device init");
+    PWDFDEVICE_INIT init = *DeviceInit;
+    HOST_DEVICE* d = (HOST_DEVICE*)calloc(1, sizeof(*d));
+    if (!d) return STATUS_INSUFFICIENT_RESOURCES;
+    HostInitObject(&d->Header, HOST_KIND_DEVICE, init->Bus ? &init->Bus->Header : NULL);
+    if (!NT_SUCCESS(HostAllocContext(&d->Header, DeviceAttributes))) { free(d); return STATUS_INSUFFICIENT_RESOURCES; }
+    HostInitObject(&d->VhfObject, HOST_KIND_VHF, &d->Header);
+    HostInitObject(&d->ChildListObject, HOST_KIND_CHILDLIST, &d->Header);
+    d->SubmitStatus = STATUS_SUCCESS;
+    d->EvtD0Exit = init->EvtD0Exit;
+    if (init->HasChildList)
+    {
+        d->ChildConfig = init->ChildConfig;
+        d->HasChildList = 1;
+    }
+    init->Created = d;
+    *DeviceInit = NULL;   /* the framework owns it now */
+    *Device = d;
+    return STATUS_SUCCESS;
+}
+
+NTSTATUS WdfDeviceCreateDeviceInterface(WDFDEVICE Device, const GUID* InterfaceClassGUID, PCUNICODE_STRING ReferenceString)
+{
+    HostDevice(Device);
+    UNREFERENCED_PARAMETER(ReferenceString);
+    return InterfaceClassGUID ? STATUS_SUCCESS : STATUS_INVALID_PARAMETER;
+}
+
+PDEVICE_OBJECT WdfDeviceWdmGetDeviceObject(WDFDEVICE Device)
+{
+    return (PDEVICE_OBJECT)HostDevice(Device);
+}
+
+NTSTATUS GcHostAddDevice(GC_HOST_DRIVER_ENTRY* driverEntry, WDFDEVICE* device)
+{
+    *device = NULL;
+    g_deviceAdd = NULL;
+    UNICODE_STRING path;
+    RtlInitUnicodeString(&path, L"\\Registry\\Machine\\System\\CurrentControlSet\\Services\\GcHost");
+    NTSTATUS status = driverEntry(NULL, &path);
+    if (!NT_SUCCESS(status)) return status;
+    if (!g_deviceAdd) return STATUS_UNSUCCESSFUL;
+
+    struct _WDFDEVICE_INIT init;
+    memset(&init, 0, sizeof(init));
+    status = g_deviceAdd(NULL, &init);
+    if (!NT_SUCCESS(status))
+    {
+        if (init.Created) HostFreeDevice(init.Created);
+        return status;
+    }
+    if (!init.Created) return STATUS_UNSUCCESSFUL;
+    *device = init.Created;
+    return STATUS_SUCCESS;
+}
+
+void GcHostRemoveDevice(WDFDEVICE device)
+{
+    if (device) HostFreeDevice(HostDevice(device));
+}
+
+NTSTATUS GcHostPowerDown(WDFDEVICE device)
+{
+    HOST_DEVICE* d = HostDevice(device);
+    return d->EvtD0Exit ? d->EvtD0Exit(d, WdfPowerDeviceD3) : STATUS_SUCCESS;
+}
+
+/* ---- queues and requests ---- */
+
+NTSTATUS WdfIoQueueCreate(WDFDEVICE Device, PWDF_IO_QUEUE_CONFIG Config, PWDF_OBJECT_ATTRIBUTES QueueAttributes, WDFQUEUE* Queue)
+{
+    HOST_DEVICE* d = HostDevice(Device);
+    if (Config->DefaultQueue && d->DefaultQueue) return STATUS_INVALID_DEVICE_REQUEST;
+    HOST_QUEUE* q = (HOST_QUEUE*)HostNewOwned(sizeof(*q), HOST_KIND_QUEUE, Device, QueueAttributes);
+    if (!q) return STATUS_INSUFFICIENT_RESOURCES;
+    q->EvtIoDeviceControl = Config->EvtIoDeviceControl;
+    if (Config->DefaultQueue) d->DefaultQueue = q;
+    if (Queue) *Queue = q;
+    return STATUS_SUCCESS;
+}
+
+WDFDEVICE WdfIoQueueGetDevice(WDFQUEUE Queue)
+{
+    return HostObject(Queue, HOST_KIND_QUEUE)->Parent;
+}
+
+static NTSTATUS HostRetrieve(WDFREQUEST Request, size_t have, size_t MinimumRequiredSize, PVOID* Buffer, size_t* Length)
+{
+    HOST_REQUEST* r = (HOST_REQUEST*)HostObject(Request, HOST_KIND_REQUEST);
+    *Buffer = NULL;
+    if (Length) *Length = 0;
+    if (!have || have < MinimumRequiredSize) return STATUS_BUFFER_TOO_SMALL;
+    *Buffer = r->Buffer;
+    if (Length) *Length = have;
+    return STATUS_SUCCESS;
+}
+
+NTSTATUS WdfRequestRetrieveInputBuffer(WDFREQUEST Request, size_t MinimumRequiredSize, PVOID* Buffer, size_t* Length)
+{
+    return HostRetrieve(Request, ((HOST_REQUEST*)HostObject(Request, HOST_KIND_REQUEST))->InLen, MinimumRequiredSize, Buffer, Length);
+}
+
+NTSTATUS WdfRequestRetrieveOutputBuffer(WDFREQUEST Request, size_t MinimumRequiredSize, PVOID* Buffer, size_t* Length)
+{
+    return HostRetrieve(Request, ((HOST_REQUEST*)HostObject(Request, HOST_KIND_REQUEST))->OutLen, MinimumRequiredSize, Buffer, Length);
+}
+
+VOID WdfRequestSetInformation(WDFREQUEST Request, ULONG_PTR Information)
+{
+    ((HOST_REQUEST*)HostObject(Request, HOST_KIND_REQUEST))->Information = Information;
+}
+
+VOID WdfRequestComplete(WDFREQUEST Request, NTSTATUS Status)
+{
+    HOST_REQUEST* r = (HOST_REQUEST*)HostObject(Request, HOST_KIND_REQUEST);
+    if (r->Completions++) HostFail("request completed twice");
+    r->Status = Status;
+}
+
+NTSTATUS GcHostIoctl(WDFDEVICE device, ULONG code, const void* in, size_t inLen,
+                     void* out, size_t outLen, size_t* information)
+{
+    HOST_DEVICE* d = HostDevice(device);
+    if (information) *information = 0;
+    if (!d->DefaultQueue || !d->DefaultQueue->EvtIoDeviceControl) return STATUS_INVALID_DEVICE_REQUEST;
+
+    HOST_REQUEST r;
+    memset(&r, 0, sizeof(r));
+    HostInitObject(&r.Header, HOST_KIND_REQUEST, &d->Header);
+    size_t size = inLen > outLen ? inLen : outLen;
+    if (size)
+    {
+        r.Buffer = malloc(size);
+        if (!r.Buffer) return STATUS_INSUFFICIENT_RESOURCES;
+        /* Past the input the buffer is stale pool, not zeroes. */
+        memset(r.Buffer, 0xA5, size);
+        if (inLen) memcpy(r.Buffer, in, inLen);
+    }
+    r.InLen = inLen;
+    r.OutLen = outLen;
+
+    d->DefaultQueue->EvtIoDeviceControl(&d->DefaultQueue->Header, &r.Header, outLen, inLen, code);
+    if (r.Completions != 1) HostFail("request returned without being completed");
+    r.Header.Magic = 0;
+
+    /* The I/O manager copies Information bytes back unless the status is
+       an error (warnings such as STATUS_BUFFER_OVERFLOW still copy). */
+    if (((ULONG)r.Status >> 30) != 3)
+    {
+        if (r.Information > outLen) HostFail("information exceeds the output buffer");
+        if (r.Information) memcpy(out, r.Buffer, r.Information);
+        if (information) *information = r.Information;
+    }
+    free(r.Buffer);
+    return r.Status;
+}
+
+/* ---- VHF ---- */
+
+NTSTATUS VhfCreate(PVHF_CONFIG VhfConfig, VHFHANDLE* VhfHandle)
+{
+    HOST_DEVICE* d = HostDevice((WDFOBJECT)VhfConfig->DeviceObject);
+    if (d->VhfCreated) return STATUS_INVALID_DEVICE_REQUEST;
+    if (!VhfConfig->ReportDescriptor || !VhfConfig->ReportDescriptorLength) return STATUS_INVALID_PARAMETER;
+    d->Vhf = *VhfConfig;
+    d->VhfCreated = 1;
+    *VhfHandle = &d->VhfObject;
+    return STATUS_SUCCESS;
+}
+
+NTSTATUS VhfStart(VHFHANDLE VhfHandle)
+{
+    HOST_DEVICE* d = (HOST_DEVICE*)HostObject(VhfHandle, HOST_KIND_VHF)->Parent;
+    d->VhfStarted = 1;
+    return STATUS_SUCCESS;
+}
+
+NTSTATUS VhfReadReportSubmit(VHFHANDLE VhfHandle, PHID_XFER_PACKET HidTransferPacket)
+{
+    HOST_DEVICE* d = (HOST_DEVICE*)HostObject(VhfHandle, HOST_KIND_VHF)->Parent;
+    if (!d->VhfStarted) return STATUS_DEVICE_NOT_READY;
+    ULONG len = HidTransferPacket->reportBufferLen;
+    if (len > HOST_MAX_REPORT) len = HOST_MAX_REPORT;
+    memcpy(d->LastReport, HidTransferPacket->reportBuffer, len);
+    d->LastReportLen = len;
+    d->Submits++;
+    return d->SubmitStatus;
+}
+
+void GcHostVhfWrite(WDFDEVICE device, UCHAR reportId, const void* report, ULONG len)
+{
+    HOST_DEVICE* d = HostDevice(device);
+    if (!d->VhfCreated || !d->Vhf.EvtVhfProcessOutputReport) return;
+    HID_XFER_PACKET pkt;
+    pkt.reportBuffer = (PUCHAR)malloc(len ? len : 1);
+    if (!pkt.reportBuffer) return;
+    if (len) memcpy(pkt.reportBuffer, report, len);
+    pkt.reportBufferLen = len;
+    pkt.reportId = reportId;
+    d->Vhf.EvtVhfProcessOutputReport(d->Vhf.VhfClientContext, &pkt);
+    free(pkt.reportBuffer);
+}
+
+uint64_t GcHostVhfSubmits(WDFDEVICE device)
+{
+    return HostDevice(device)->Submits;
+}
+
+ULONG GcHostVhfLastReport(WDFDEVICE device, UCHAR* out, ULONG cap)
+{
+    HOST_DEVICE* d = HostDevice(device);
+    ULONG n = d->LastReportLen < cap ? d->LastReportLen : cap;
+    memcpy(out, d->LastReport, n);
+    return n;
+}
+
+void GcHostVhfSetSubmitStatus(WDFDEVICE device, NTSTATUS status)
+{
+    HostDevice(device)->SubmitStatus = status;
+}
+
+/* ---- timers and locks ---- */
+
+NTSTATUS WdfTimerCreate(PWDF_TIMER_CONFIG Config, PWDF_OBJECT_ATTRIBUTES Attributes, WDFTIMER* Timer)
+{
+    if (!Config->EvtTimerFunc) return STATUS_INVALID_PARAMETER;
+    HOST_TIMER* t = (HOST_TIMER*)HostNewOwned(sizeof(*t), HOST_KIND_TIMER, Attributes ? Attributes->ParentObject : NULL, Attributes);
+    if (!t) return STATUS_INSUFFICIENT_RESOURCES;
+    t->EvtTimerFunc = Config->EvtTimerFunc;
+    *Timer = t;
+    return STATUS_SUCCESS;
+}
+
+BOOLEAN WdfTimerStart(WDFTIMER Timer, LONGLONG DueTime)
+{
+    HOST_TIMER* t = (HOST_TIMER*)HostObject(Timer, HOST_KIND_TIMER);
+    BOOLEAN was = (BOOLEAN)t->Armed;
+    t->Armed = 1;
+    t->Due = DueTime;
+    return was;
+}
+
+BOOLEAN WdfTimerStop(WDFTIMER Timer, BOOLEAN Wait)
+{
+    UNREFERENCED_PARAMETER(Wait);
+    HOST_TIMER* t = (HOST_TIMER*)HostObject(Timer, HOST_KIND_TIMER);
+    BOOLEAN was = (BOOLEAN)t->Armed;
+    t->Armed = 0;
+    return was;
+}
+
+WDFOBJECT WdfTimerGetParentObject(WDFTIMER Timer)
+{
+    return HostObject(Timer, HOST_KIND_TIMER)->Parent;
+}
+
+ULONG GcHostFireTimers(WDFDEVICE device)
+{
+    HOST_DEVICE* d = HostDevice(device);
+    ULONG ran = 0;
+    for (HOST_OBJECT* o = d->Owned; o; o = o->NextOwned)
+    {
+        HOST_TIMER* t = (HOST_TIMER*)o;
+        if (o->Kind != HOST_KIND_TIMER || !t->Armed) continue;
+        t->Armed = 0;           /* one-shot; the callback may re-arm */
+        t->EvtTimerFunc(t);
+        ran++;
+    }
+    return ran;
+}
+
+LONGLONG GcHostTimerDue(WDFDEVICE device)
+{
+    HOST_DEVICE* d = HostDevice(device);
+    for (HOST_OBJECT* o = d->Owned; o; o = o->NextOwned)
+        if (o->Kind == HOST_KIND_TIMER && ((HOST_TIMER*)o)->Armed) return ((HOST_TIMER*)o)->Due;
+    return 0;
+}
+
+NTSTATUS WdfSpinLockCreate(PWDF_OBJECT_ATTRIBUTES SpinLockAttributes, WDFSPINLOCK* SpinLock)
+{
+    HOST_SPINLOCK* l = (HOST_SPINLOCK*)HostNewOwned(sizeof(*l), HOST_KIND_SPINLOCK,
+                                                    SpinLockAttributes ? SpinLockAttributes->ParentObject : NULL,
+                                                    SpinLockAttributes);
+    if (!l) return STATUS_INSUFFICIENT_RESOURCES;
+    *SpinLock = l;
+    return STATUS_SUCCESS;
+}
+
+/* Single-threaded host: a held lock being taken again is a deadlock. */
+VOID WdfSpinLockAcquire(WDFSPINLOCK SpinLock)
+{
+    HOST_SPINLOCK* l = (HOST_SPINLOCK*)HostObject(SpinLock, HOST_KIND_SPINLOCK);
+    if (l->Held) HostFail("spin lock acquired recursively");
+    l->Held = 1;
+}
+
+VOID WdfSpinLockRelease(WDFSPINLOCK SpinLock)
+{
+    HOST_SPINLOCK* l = (HOST_SPINLOCK*)HostObject(SpinLock, HOST_KIND_SPINLOCK);
+    if (!l->Held) HostFail("spin lock released while not held");
+    l->Held = 0;
+}
+
+/* ---- registry ---- */
+
+static HOST_VALUE* HostFindValue(const wchar_t* name, size_t chars)
+{
+    for (ULONG i = 0; i < g_valueCount; ++i)
+        if (wcslen(g_values[i].Name) == chars && !wcsncmp(g_values[i].Name, name, chars)) return &g_values[i];
+    return NULL;
+}
+
+static HOST_VALUE* HostAddValue(const wchar_t* name, size_t chars)
+{
+    HOST_VALUE* v = HostFindValue(name, chars);
+    if (v) return v;
+    if (g_valueCount == HOST_MAX_VALUES || chars >= sizeof(g_values[0].Name) / sizeof(wchar_t)) return NULL;
+    v = &g_values[g_valueCount++];
+    wmemcpy(v->Name, name, chars);
+    v->Name[chars] = 0;
+    return v;
+}
+
+void GcHostRegistrySetULong(const wchar_t* name, ULONG value)
+{
+    HOST_VALUE* v = HostAddValue(name, wcslen(name));
+    if (!v) HostFail("registry table full");
+    v->Value = value;
+}
+
+int GcHostRegistryGetULong(const wchar_t* name, ULONG* value)
+{
+    HOST_VALUE* v = HostFindValue(name, wcslen(name));
+    if (v) *value = v->Value;
+    return v != NULL;
+}
+
+void GcHostRegistryClear(void)
+{
+    g_valueCount = 0;
+}
+
+NTSTATUS WdfDeviceOpenRegistryKey(WDFDEVICE Device, ULONG DeviceInstanceKeyType, ACCESS_MASK DesiredAccess,
+                                  PWDF_OBJECT_ATTRIBUTES KeyAttributes, WDFKEY* Key)
+{
+    HostDevice(Device);
+    UNREFERENCED_PARAMETER(KeyAttributes);
+    if (DeviceInstanceKeyType != PLUGPLAY_REGKEY_DEVICE) return STATUS_OBJECT_NAME_NOT_FOUND;
+    HOST_KEY* k = (HOST_KEY*)calloc(1, sizeof(*k));
+    if (!k) return STATUS_INSUFFICIENT_RESOURCES;
+    HostInitObject(&k->Header, HOST_KIND_KEY, (HOST_OBJECT*)Device);
+    k->Access = DesiredAccess;
+    *Key = k;
+    return STATUS_SUCCESS;
+}
+
+NTSTATUS WdfRegistryQueryULong(WDFKEY Key, PCUNICODE_STRING ValueName, PULONG Value)
+{
+    HostObject(Key, HOST_KIND_KEY);
+    HOST_VALUE* v = HostFindValue(ValueName->Buffer, ValueName->Length / sizeof(WCHAR));
+    if (!v) return STATUS_OBJECT_NAME_NOT_FOUND;
+    *Value = v->Value;
+    return STATUS_SUCCESS;
+}
+
+NTSTATUS WdfRegistryAssignULong(WDFKEY Key, PCUNICODE_STRING ValueName, ULONG Value)
+{
+    HOST_KEY* k = (HOST_KEY*)HostObject(Key, HOST_KIND_KEY);
+    if ((k->Access & KEY_WRITE) != KEY_WRITE) return STATUS_ACCESS_DENIED;
+    HOST_VALUE* v = HostAddValue(ValueName->Buffer, ValueName->Length / sizeof(WCHAR));
+    if (!v) return STATUS_INSUFFICIENT_RESOURCES;
+    v->Value = Value;
+    return STATUS_SUCCESS;
+}
+
+VOID WdfRegistryClose(WDFKEY Key)
+{
+    HOST_KEY* k = (HOST_KEY*)HostObject(Key, HOST_KIND_KEY);
+    k->Header.Magic = 0;
+    free(k);
+}
+
+/* ---- bus: static child list and PDO init ---- */
+
+VOID WdfFdoInitSetDefaultChildListConfig(PWDFDEVICE_INIT DeviceInit, PWDF_CHILD_LIST_CONFIG Config,
+                                         PWDF_OBJECT_ATTRIBUTES DefaultChildListAttributes)
+{
+    UNREFERENCED_PARAMETER(DefaultChildListAttributes);
+    DeviceInit->ChildConfig = *Config;
+    DeviceInit->HasChildList = 1;
+}
+
+WDFCHILDLIST WdfFdoGetDefaultChildList(WDFDEVICE Fdo)
+{
+    HOST_DEVICE* d = HostDevice(Fdo);
+    return d->HasChildList ? &d->ChildListObject : NULL;
+}
+
+static HOST_DEVICE* HostChildListDevice(WDFCHILDLIST ChildList)
+{
+    return (HOST_DEVICE*)HostObject(ChildList, HOST_KIND_CHILDLIST)->Parent;
+}
+
+VOID WdfChildListBeginScan(WDFCHILDLIST ChildList)
+{
+    HOST_DEVICE* d = HostChildListDevice(ChildList);
+    for (ULONG i = 0; i < d->ScanCount; ++i) free(d->Scan[i]);
+    d->ScanCount = 0;
+}
+
+NTSTATUS WdfChildListAddOrUpdateChildDescriptionAsPresent(WDFCHILDLIST ChildList,
+                                                          PWDF_CHILD_IDENTIFICATION_DESCRIPTION_HEADER IdentificationDescription,
+                                                          PWDF_CHILD_ADDRESS_DESCRIPTION_HEADER AddressDescription)
+{
+    UNREFERENCED_PARAMETER(AddressDescription);
+    HOST_DEVICE* d = HostChildListDevice(ChildList);
+    ULONG size = d->ChildConfig.IdentificationDescriptionSize;
+    if (IdentificationDescription->IdentificationDescriptionSize != size) return STATUS_INVALID_PARAMETER;
+    /* No EvtChildListIdentificationDescriptionCompare: KMDF compares bytes. */
+    for (ULONG i = 0; i < d->ScanCount; ++i)
+        if (!memcmp(d->Scan[i], IdentificationDescription, size)) return STATUS_SUCCESS;
+    if (d->ScanCount == HOST_MAX_CHILDREN) return STATUS_INSUFFICIENT_RESOURCES;
+    UCHAR* copy = (UCHAR*)malloc(size);
+    if (!copy) return STATUS_INSUFFICIENT_RESOURCES;
+    memcpy(copy, IdentificationDescription, size);
+    d->Scan[d->ScanCount++] = copy;
+    return STATUS_SUCCESS;
+}
+
+VOID WdfChildListEndScan(WDFCHILDLIST ChildList)
+{
+    HOST_DEVICE* d = HostChildListDevice(ChildList);
+    ULONG size = d->ChildConfig.IdentificationDescriptionSize;
+    HOST_CHILD next[HOST_MAX_CHILDREN];
+    ULONG count = 0;
+    for (ULONG s = 0; s < d->ScanCount; ++s)
+    {
+        HOST_CHILD c = { d->Scan[s], NULL };
+        for (ULONG i = 0; i < d->ChildCount; ++i)
+        {
+            if (d->Children[i].Description && !memcmp(d->Children[i].Description, c.Description, size))
+            {
+                free(c.Description);
+                c = d->Children[i];
+                d->Children[i].Description = NULL;
+                break;
+            }
+        }
+        if (!c.Pdo && d->ChildConfig.EvtChildListCreateDevice)
+        {
+            struct _WDFDEVICE_INIT init;
+            memset(&init, 0, sizeof(init));
+            init.Bus = d;
+            NTSTATUS status = d->ChildConfig.EvtChildListCreateDevice(
+                ChildList, (PWDF_CHILD_IDENTIFICATION_DESCRIPTION_HEADER)c.Description, &init);
+            if (NT_SUCCESS(status)) c.Pdo = init.Created;
+            else if (init.Created) HostFreeDevice(init.Created);
+        }
+        next[count++] = c;
+    }
+    /* Children not reported this scan are gone. */
+    for (ULONG i = 0; i < d->ChildCount; ++i)
+    {
+        if (!d->Children[i].Description) continue;
+        if (d->Children[i].Pdo) HostFreeDevice(d->Children[i].Pdo);
+        free(d->Children[i].Description);
+    }
+    memcpy(d->Children, next, count * sizeof(next[0]));
+    d->ChildCount = count;
+    d->ScanCount = 0;
+}
+
+ULONG GcHostChildCount(WDFDEVICE device)
+{
+    HOST_DEVICE* d = HostDevice(device);
+    ULONG n = 0;
+    for (ULONG i = 0; i < d->ChildCount; ++i) n += d->Children[i].Pdo != NULL;
+    return n;
+}
+
+static PWDFDEVICE_INIT HostPdoInit(PWDFDEVICE_INIT DeviceInit)
+{
+    if (!DeviceInit || !DeviceInit->Bus) HostFail("PDO call on a non-PDO device init");
+    return DeviceInit;
+}
+
+NTSTATUS WdfPdoInitAssignHardwareIDs(PWDFDEVICE_INIT DeviceInit, PCUNICODE_STRING HardwareIDs, PCUNICODE_STRING CompatibleIDs)
+{
+    HostPdoInit(DeviceInit);
+    UNREFERENCED_PARAMETER(CompatibleIDs);
+    return HardwareIDs && HardwareIDs->Length ? STATUS_SUCCESS : STATUS_INVALID_PARAMETER;
+}
+
+NTSTATUS WdfPdoInitAssignInstanceID(PWDFDEVICE_INIT DeviceInit, PCUNICODE_STRING InstanceID)
+{
+    HostPdoInit(DeviceInit);
+    return InstanceID && InstanceID->Length ? STATUS_SUCCESS : STATUS_INVALID_PARAMETER;
+}
+
+NTSTATUS WdfPdoInitAddDeviceText(PWDFDEVICE_INIT DeviceInit, PCUNICODE_STRING DeviceDescription,
+                                 PCUNICODE_STRING DeviceLocation, LCID LocaleId)
+{
+    HostPdoInit(DeviceInit);
+    UNREFERENCED_PARAMETER(LocaleId);
+    return DeviceDescription && DeviceLocation ? STATUS_SUCCESS : STATUS_INVALID_PARAMETER;
+}
+
+VOID WdfPdoInitSetDefaultLocale(PWDFDEVICE_INIT DeviceInit, LCID LocaleId)
+{
+    HostPdoInit(DeviceInit);
+    UNREFERENCED_PARAMETER(LocaleId);
+}
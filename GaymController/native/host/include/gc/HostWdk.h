@@ -0,0 +1,79 @@
+#pragma once
+
+/* Host WDK: runs reference/k's func and bus drivers in a user-mode
+   process so benches, tests and fuzzers can drive their dispatch code on
+   Linux (GC-PAR-030, GC-PAR-029).
+
+   The driver sources build unchanged with -D_NTDDK_ against the stand-in
+   WDK headers in host/wdk; both DriverEntry symbols are renamed at build
+   time (GcVPadFuncDriverEntry, GcVPadBusDriverEntry). What is modelled:
+
+   - objects: devices, queues, timers and spin locks own a context sized
+     by their attributes and are freed with their device;
+   - IOCTLs: METHOD_BUFFERED, one heap system buffer of exactly
+     max(in, out) bytes per request, so a read past the caller's lengths
+     is a heap overflow under ASan. Each request must be completed exactly
+     once before the callback returns; anything else aborts, as a double
+     completion bugchecks on Windows;
+   - VHF: VhfReadReportSubmit records the report; output reports are
+     delivered with GcHostVhfWrite;
+   - timers: WdfTimerStart arms, GcHostFireTimers runs what is armed
+     (there is no timer thread);
+   - power: EvtDeviceD0Exit runs on GcHostPowerDown (to D3) and on
+     removal (to D3Final);
+   - registry: one process-wide ULONG value table;
+   - the default child list calls EvtChildListCreateDevice for each new
+     distinct identification description at EndScan.
+
+   Not thread-safe: one thread drives all devices. Not modelled: other PnP
+   and power callbacks, file objects, request cancellation, access checks. */
+
+#include <wdf.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef NTSTATUS GC_HOST_DRIVER_ENTRY(PDRIVER_OBJECT DriverObject, PUNICODE_STRING RegistryPath);
+
+GC_HOST_DRIVER_ENTRY GcVPadFuncDriverEntry;
+GC_HOST_DRIVER_ENTRY GcVPadBusDriverEntry;
+
+/* Runs driverEntry and then its EvtDriverDeviceAdd once. On success
+   *device is the new FDO; release it with GcHostRemoveDevice. */
+NTSTATUS GcHostAddDevice(GC_HOST_DRIVER_ENTRY* driverEntry, WDFDEVICE* device);
+void GcHostRemoveDevice(WDFDEVICE device);
+/* Runs the device's EvtDeviceD0Exit as a power-down to D3 would; the
+   device stays allocated. STATUS_SUCCESS when it has none. */
+NTSTATUS GcHostPowerDown(WDFDEVICE device);
+
+/* DeviceIoControl through the device's default queue. out may be NULL
+   when outLen is 0; *information is what the driver set (0 on failure). */
+NTSTATUS GcHostIoctl(WDFDEVICE device, ULONG code, const void* in, size_t inLen,
+                     void* out, size_t outLen, size_t* information);
+
+/* Delivers a HID output report to the device's EvtVhfProcessOutputReport. */
+void GcHostVhfWrite(WDFDEVICE device, UCHAR reportId, const void* report, ULONG len);
+/* Input reports submitted so far, and a copy of the last one. */
+uint64_t GcHostVhfSubmits(WDFDEVICE device);
+ULONG GcHostVhfLastReport(WDFDEVICE device, UCHAR* out, ULONG cap);
+/* Status VhfReadReportSubmit returns from now on (STATUS_SUCCESS by default). */
+void GcHostVhfSetSubmitStatus(WDFDEVICE device, NTSTATUS status);
+
+/* Runs every armed timer owned by device once; returns how many ran. */
+ULONG GcHostFireTimers(WDFDEVICE device);
+/* Relative due time (100 ns units, negative) of an armed timer owned by
+   device, 0 when none is armed. */
+LONGLONG GcHostTimerDue(WDFDEVICE device);
+
+/* Children the device's default child list has created. */
+ULONG GcHostChildCount(WDFDEVICE device);
+
+/* Process-wide registry values read by WdfRegistryQueryULong. */
+void GcHostRegistrySetULong(const wchar_t* name, ULONG value);
+int GcHostRegistryGetULong(const wchar_t* name, ULONG* value);
+void GcHostRegistryClear(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,124 @@
+#pragma once
+
+/* Host (gcc/clang, user mode) stand-in for the WDK's ntddk.h.
+   Together with wdf.h, vhf.h, wdm.h, ntstrsafe.h and guiddef.h in this
+   directory it declares exactly what reference/k's func and bus drivers
+   use, so their sources build unchanged with -D_NTDDK_ against the
+   emulation in host/HostWdk.c. Types keep their Windows widths (ULONG and
+   LONG are 32-bit). Nothing here is a kernel; see gc/HostWdk.h for what
+   the emulation does and does not model. */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <wchar.h>
+
+#include "guiddef.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void VOID;
+typedef void* PVOID;
+typedef uint8_t UCHAR, *PUCHAR;
+typedef uint8_t BOOLEAN;
+typedef int16_t SHORT;
+typedef uint16_t USHORT;
+typedef int32_t LONG;
+typedef uint32_t ULONG, *PULONG;
+typedef int64_t LONGLONG;
+typedef uint64_t ULONGLONG;
+typedef uintptr_t ULONG_PTR;
+typedef size_t SIZE_T;
+typedef int32_t NTSTATUS;
+typedef uint32_t ACCESS_MASK;
+typedef uint32_t DEVICE_TYPE;
+typedef uint32_t LCID;
+typedef wchar_t WCHAR, *PWCH, *PWSTR;
+typedef const wchar_t* PCWSTR;
+
+typedef union _LARGE_INTEGER {
+    struct { ULONG LowPart; LONG HighPart; } u;
+    LONGLONG QuadPart;
+} LARGE_INTEGER, *PLARGE_INTEGER;
+
+typedef struct _UNICODE_STRING {
+    USHORT Length;
+    USHORT MaximumLength;
+    PWCH   Buffer;
+} UNICODE_STRING, *PUNICODE_STRING;
+typedef const UNICODE_STRING* PCUNICODE_STRING;
+
+typedef struct _DRIVER_OBJECT* PDRIVER_OBJECT;
+typedef struct _DEVICE_OBJECT* PDEVICE_OBJECT;
+
+#ifndef TRUE
+#define TRUE 1
+#endif
+#ifndef FALSE
+#define FALSE 0
+#endif
+
+#define NT_SUCCESS(Status) (((NTSTATUS)(Status)) >= 0)
+#define STATUS_SUCCESS                ((NTSTATUS)0x00000000L)
+#define STATUS_BUFFER_OVERFLOW        ((NTSTATUS)0x80000005L)
+#define STATUS_UNSUCCESSFUL           ((NTSTATUS)0xC0000001L)
+#define STATUS_INVALID_PARAMETER      ((NTSTATUS)0xC000000DL)
+#define STATUS_INVALID_DEVICE_REQUEST ((NTSTATUS)0xC0000010L)
+#define STATUS_ACCESS_DENIED          ((NTSTATUS)0xC0000022L)
+#define STATUS_BUFFER_TOO_SMALL       ((NTSTATUS)0xC0000023L)
+#define STATUS_OBJECT_NAME_NOT_FOUND  ((NTSTATUS)0xC0000034L)
+#define STATUS_INSUFFICIENT_RESOURCES ((NTSTATUS)0xC000009AL)
+#define STATUS_DEVICE_NOT_READY       ((NTSTATUS)0xC00000A3L)
+
+#define UNREFERENCED_PARAMETER(P) ((void)(P))
+
+/* minwindef.h's; C only, it would break <algorithm> in C++ users. */
+#ifndef __cplusplus
+#ifndef min
+#define min(a, b) (((a) < (b)) ? (a) : (b))
+#endif
+#ifndef max
+#define max(a, b) (((a) > (b)) ? (a) : (b))
+#endif
+#endif
+
+#define FILE_DEVICE_UNKNOWN       0x00000022
+#define FILE_DEVICE_BUS_EXTENDER  0x0000002a
+#define METHOD_BUFFERED           0
+#define FILE_ANY_ACCESS           0
+#define FILE_READ_DATA            0x0001
+#define FILE_WRITE_DATA           0x0002
+/* Unsigned: the VPad device types reach bit 31, and a signed shift there
+   is not a constant expression under -fsanitize=undefined. */
+#define CTL_CODE(DeviceType, Function, Method, Access) \
+    (((ULONG)(DeviceType) << 16) | ((ULONG)(Access) << 14) | ((ULONG)(Function) << 2) | (ULONG)(Method))
+
+#define KEY_READ  0x20019
+#define KEY_WRITE 0x20006
+
+#define RtlZeroMemory(Destination, Length) memset((Destination), 0, (Length))
+#define RtlCopyMemory(Destination, Source, Length) memcpy((Destination), (Source), (Length))
+
+#define DECLARE_CONST_UNICODE_STRING(_var, _string) \
+    const WCHAR _var##_buffer[] = _string; \
+    const UNICODE_STRING _var = { sizeof(_string) - sizeof(WCHAR), sizeof(_string), (PWCH)_var##_buffer }
+#define DECLARE_UNICODE_STRING_SIZE(_var, _size) \
+    WCHAR _var##_buffer[_size]; \
+    UNICODE_STRING _var = { 0, (USHORT)((_size) * sizeof(WCHAR)), _var##_buffer }
+
+VOID RtlInitUnicodeString(PUNICODE_STRING DestinationString, PCWSTR SourceString);
+NTSTATUS RtlAppendUnicodeToString(PUNICODE_STRING Destination, PCWSTR Source);
+
+static inline LONG InterlockedIncrement(LONG volatile* Addend)
+{
+    return __atomic_add_fetch(Addend, 1, __ATOMIC_SEQ_CST);
+}
+
+/* CLOCK_MONOTONIC at a 10 MHz frequency, like most Windows hosts. */
+LARGE_INTEGER KeQueryPerformanceCounter(PLARGE_INTEGER PerformanceFrequency);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,19 @@
+#pragma once
+
+/* Host stand-in for the WDK's ntstrsafe.h (see ntddk.h). */
+
+#include <stdarg.h>
+#include <wchar.h>
+
+#include "ntddk.h"
+
+static inline NTSTATUS RtlStringCchPrintfW(PWSTR dst, size_t cch, PCWSTR fmt, ...)
+{
+    if (!cch) return STATUS_INVALID_PARAMETER;
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vswprintf(dst, cch, fmt, ap);
+    va_end(ap);
+    if (n < 0) { dst[cch - 1] = 0; return STATUS_BUFFER_OVERFLOW; }
+    return STATUS_SUCCESS;
+}
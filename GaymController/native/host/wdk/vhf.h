@@ -0,0 +1,49 @@
+#pragma once
+
+/* Host stand-in for the WDK's vhf.h (see ntddk.h). Field and callback
+   names follow reference/k's func driver. */
+
+#include "ntddk.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct _HID_XFER_PACKET {
+    PUCHAR reportBuffer;
+    ULONG  reportBufferLen;
+    UCHAR  reportId;
+} HID_XFER_PACKET, *PHID_XFER_PACKET;
+
+typedef void* VHFHANDLE;
+
+typedef VOID EVT_VHF_READY_FOR_WRITE(PVOID VhfClientContext);
+typedef VOID EVT_VHF_PROCESS_OUTPUT_REPORT(PVOID VhfClientContext, PHID_XFER_PACKET OutputPacket);
+
+typedef struct _VHF_CONFIG {
+    ULONG Size;
+    PVOID VhfClientContext;
+    PDEVICE_OBJECT DeviceObject;
+    const UCHAR* ReportDescriptor;
+    ULONG ReportDescriptorLength;
+    EVT_VHF_READY_FOR_WRITE* EvtVhfReadyForWrite;
+    EVT_VHF_PROCESS_OUTPUT_REPORT* EvtVhfProcessOutputReport;
+} VHF_CONFIG, *PVHF_CONFIG;
+
+static inline VOID VHF_CONFIG_INIT(PVHF_CONFIG Config, PDEVICE_OBJECT DeviceObject,
+                                   const UCHAR* ReportDescriptor, size_t ReportDescriptorLength)
+{
+    memset(Config, 0, sizeof(*Config));
+    Config->Size = sizeof(*Config);
+    Config->DeviceObject = DeviceObject;
+    Config->ReportDescriptor = ReportDescriptor;
+    Config->ReportDescriptorLength = (ULONG)ReportDescriptorLength;
+}
+
+NTSTATUS VhfCreate(PVHF_CONFIG VhfConfig, VHFHANDLE* VhfHandle);
+NTSTATUS VhfStart(VHFHANDLE VhfHandle);
+NTSTATUS VhfReadReportSubmit(VHFHANDLE VhfHandle, PHID_XFER_PACKET HidTransferPacket);
+
+#ifdef __cplusplus
+}
+#endif
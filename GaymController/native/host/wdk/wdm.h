@@ -0,0 +1,5 @@
+#pragma once
+
+/* Host stand-in for the WDK's wdm.h (see ntddk.h). */
+
+#include "ntddk.h"
@@ -0,0 +1,89 @@
+#pragma once
+
+/* Process allow-list for the HID cloaking filter (spec/61_HID_CLOAKING.md).
+
+   Every IRP_MJ_CREATE on a cloaked HID device asks "may this process open
+   it?". The answer comes from an immutable GC_ALLOW_SET: an open-addressed
+   table of (image digest, PID) identities built once from the list the
+   broker pushes, in memory the caller owns (pool or malloc), so the module
+   never allocates.
+
+   A GC_ALLOW_LIST publishes one set at a time. Lookups never lock, never
+   allocate and never wait for the writer: a reader announces itself in a
+   per-slot counter (striped by PID across cache lines), rechecks that the
+   slot is still current and reads the set. Publish flips the current slot
+   and waits for the old slot's readers to drain, after which the old set is
+   handed back to the caller to free or reuse.
+
+   Identities: Digest is the SHA-256 of the process image or of its
+   upcased NT image path (the broker and filter must agree); the module
+   only requires it to be well mixed. Pid 0 matches any process with that
+   digest, a non-zero Pid only that process. */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GC_ALLOW_DIGEST_BYTES 32
+#define GC_ALLOW_ANY_PID      0u
+#define GC_ALLOW_MAX_ENTRIES  (1u << 20)
+#define GC_ALLOW_STRIPES      16
+
+typedef struct _GC_ALLOW_ENTRY
+{
+    uint8_t  Digest[GC_ALLOW_DIGEST_BYTES];
+    uint32_t Pid;        /* GC_ALLOW_ANY_PID or one process */
+    uint32_t Reserved;   /* zero */
+} GC_ALLOW_ENTRY, *PGC_ALLOW_ENTRY;
+
+typedef struct _GC_ALLOW_SET GC_ALLOW_SET, *PGC_ALLOW_SET;
+
+/* Bytes needed for a set of up to count entries; 0 if count is too large. */
+size_t GcAllowSetBytes(uint32_t count);
+
+/* Builds a set in mem (8-byte aligned, GcAllowSetBytes(count) bytes).
+   Duplicate identities collapse. Returns NULL if mem is too small or
+   count exceeds GC_ALLOW_MAX_ENTRIES. */
+PGC_ALLOW_SET GcAllowSetBuild(void* mem, size_t bytes, const GC_ALLOW_ENTRY* entries, uint32_t count,
+                              uint32_t generation);
+
+uint32_t GcAllowSetCount(const GC_ALLOW_SET* s);        /* unique identities */
+uint32_t GcAllowSetGeneration(const GC_ALLOW_SET* s);   /* as passed to Build */
+
+/* 1 if (digest, pid) or (digest, any) is in the set. */
+int GcAllowSetContains(const GC_ALLOW_SET* s, const uint8_t* digest, uint32_t pid);
+
+typedef struct _GC_ALLOW_STRIPE
+{
+    volatile uint32_t Readers;
+    uint8_t Pad[60];   /* one counter per cache line */
+} GC_ALLOW_STRIPE;
+
+typedef struct _GC_ALLOW_LIST
+{
+    GC_ALLOW_STRIPE Slots[2][GC_ALLOW_STRIPES];
+    PGC_ALLOW_SET volatile Sets[2];
+    volatile uint32_t Current;   /* index into Sets */
+} GC_ALLOW_LIST, *PGC_ALLOW_LIST;
+
+/* Starts with no set published. */
+void GcAllowListInit(PGC_ALLOW_LIST l);
+
+/* Makes s (NULL to clear) the current set and returns the previous one
+   once no lookup can still be reading it. Publish calls must be
+   serialised by the caller (the broker IOCTL handler holds its lock). */
+PGC_ALLOW_SET GcAllowListPublish(PGC_ALLOW_LIST l, PGC_ALLOW_SET s);
+
+/* 1 = allow the open, 0 = deny. With no set published the filter is a
+   pass-through and every process is allowed (fail-safe). */
+int GcAllowListCheck(PGC_ALLOW_LIST l, const uint8_t* digest, uint32_t pid);
+
+/* Generation of the current set, 0 when none is published. */
+uint32_t GcAllowListGeneration(PGC_ALLOW_LIST l);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,71 @@
+#pragma once
+
+/* Ring-buffered history of 8-bit analog key/axis values.
+
+   Every Append stores one frame: one quantised value per key, all keys
+   sampled at the same instant (one 8 kHz HID report). Axes are stored
+   offset-binary (128 == centre). Frames are grouped into blocks of
+   FramesPerBlock; the open block and the one behind it stay raw, older
+   blocks are delta/run-length coded per key into a shared byte ring, a
+   few keys per Append so the HID thread never pays for a whole block.
+
+   Each coded key-block keeps min/max/sum/first/last, so windowed queries
+   only decode the blocks at the window edges (or those straddling the
+   crossing threshold). Oldest blocks are dropped when either MaxBlocks or
+   the DataBytes ring runs out.
+
+   Single writer; queries must not run concurrently with Append. */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GC_HISTORY_MAX_BLOCK 4096
+
+typedef struct _GC_HISTORY_CONFIG
+{
+    uint32_t Keys;            /* values per frame, >= 1 */
+    uint32_t FramesPerBlock;  /* multiple of 16, 64..GC_HISTORY_MAX_BLOCK */
+    uint32_t MaxBlocks;       /* coded blocks kept, >= 1 */
+    uint32_t DataBytes;       /* coded ring, >= 2 * FramesPerBlock * (Keys + 1) */
+} GC_HISTORY_CONFIG;
+
+typedef struct _GC_HISTORY GC_HISTORY, *PGC_HISTORY;
+
+typedef struct _GC_HISTORY_STATS
+{
+    uint64_t Count;       /* samples in the clamped window */
+    uint64_t Sum;         /* mean = Sum / Count */
+    uint32_t Crossings;   /* transitions across the threshold, either direction */
+    uint8_t  Min;
+    uint8_t  Max;
+} GC_HISTORY_STATS;
+
+/* Returns NULL on an invalid config or allocation failure. */
+PGC_HISTORY GcHistoryCreate(const GC_HISTORY_CONFIG* cfg);
+void GcHistoryDestroy(PGC_HISTORY h);
+
+/* frame holds Keys values. */
+void GcHistoryAppend(PGC_HISTORY h, const uint8_t* frame);
+
+uint64_t GcHistoryFrames(const GC_HISTORY* h);        /* frames appended so far */
+uint64_t GcHistoryOldestFrame(const GC_HISTORY* h);   /* first frame still stored */
+size_t   GcHistoryMemoryBytes(const GC_HISTORY* h);   /* total footprint */
+size_t   GcHistoryCodedBytes(const GC_HISTORY* h);    /* coded bytes of live blocks */
+
+/* Window [first, end) in absolute frame numbers, clamped to what is
+   stored. A sample counts as above the threshold when value >= threshold.
+   Returns 0 and zeroed stats when the clamped window is empty. */
+int GcHistoryQuery(const GC_HISTORY* h, uint32_t key, uint64_t first, uint64_t end,
+                   uint8_t threshold, GC_HISTORY_STATS* out);
+
+/* Copies the clamped window into out (capacity end - first); returns the
+   number of samples written, the first of which is frame max(first, oldest). */
+size_t GcHistoryRead(const GC_HISTORY* h, uint32_t key, uint64_t first, uint64_t end, uint8_t* out);
+
+#ifdef __cplusplus
+}
+#endif
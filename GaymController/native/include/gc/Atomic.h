@@ -0,0 +1,139 @@
+#pragma once
+
+/* Minimal atomics shared by the portable C modules. MSVC (user and kernel
+   mode) maps onto the Interlocked intrinsics, everything else onto the
+   GCC/Clang __atomic builtins. Counters use relaxed ordering; publish/consume
+   pairs use the Release/Acquire variants. */
+
+#include <stdint.h>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define GC_INLINE static __forceinline
+#else
+#define GC_INLINE static inline
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(_MSC_VER)
+
+GC_INLINE uint64_t GcAtomicAddU64(volatile uint64_t* p, uint64_t v)
+{
+    return (uint64_t)_InterlockedExchangeAdd64((volatile __int64*)p, (__int64)v);
+}
+
+GC_INLINE uint32_t GcAtomicAddU32(volatile uint32_t* p, uint32_t v)
+{
+    return (uint32_t)_InterlockedExchangeAdd((volatile long*)p, (long)v);
+}
+
+GC_INLINE int GcAtomicCasU64(volatile uint64_t* p, uint64_t* expected, uint64_t desired)
+{
+    uint64_t prev = (uint64_t)_InterlockedCompareExchange64((volatile __int64*)p, (__int64)desired, (__int64)*expected);
+    if (prev == *expected) return 1;
+    *expected = prev;
+    return 0;
+}
+
+/* Interlocked operations are full barriers. */
+GC_INLINE uint32_t GcAtomicAddFullU32(volatile uint32_t* p, uint32_t v)
+{
+    return (uint32_t)_InterlockedExchangeAdd((volatile long*)p, (long)v);
+}
+
+GC_INLINE uint32_t GcAtomicExchangeU32(volatile uint32_t* p, uint32_t v)
+{
+    return (uint32_t)_InterlockedExchange((volatile long*)p, (long)v);
+}
+
+GC_INLINE int GcAtomicCasFullU64(volatile uint64_t* p, uint64_t* expected, uint64_t desired)
+{
+    return GcAtomicCasU64(p, expected, desired);
+}
+
+/* x64 aligned loads/stores are atomic; the barrier keeps the compiler honest. */
+GC_INLINE uint64_t GcAtomicLoadU64(const volatile uint64_t* p) { uint64_t v = *p; _ReadWriteBarrier(); return v; }
+GC_INLINE uint32_t GcAtomicLoadU32(const volatile uint32_t* p) { uint32_t v = *p; _ReadWriteBarrier(); return v; }
+GC_INLINE void GcAtomicStoreU64(volatile uint64_t* p, uint64_t v) { _ReadWriteBarrier(); *p = v; }
+GC_INLINE void GcAtomicStoreU32(volatile uint32_t* p, uint32_t v) { _ReadWriteBarrier(); *p = v; }
+
+#else
+
+GC_INLINE uint64_t GcAtomicAddU64(volatile uint64_t* p, uint64_t v)
+{
+    return __atomic_fetch_add(p, v, __ATOMIC_RELAXED);
+}
+
+GC_INLINE uint32_t GcAtomicAddU32(volatile uint32_t* p, uint32_t v)
+{
+    return __atomic_fetch_add(p, v, __ATOMIC_RELAXED);
+}
+
+GC_INLINE int GcAtomicCasU64(volatile uint64_t* p, uint64_t* expected, uint64_t desired)
+{
+    return __atomic_compare_exchange_n(p, expected, desired, 0, __ATOMIC_RELAXED, __ATOMIC_RELAXED);
+}
+
+/* Full-barrier variants, for protocols that need store->load ordering. */
+GC_INLINE uint32_t GcAtomicAddFullU32(volatile uint32_t* p, uint32_t v)
+{
+    return __atomic_fetch_add(p, v, __ATOMIC_SEQ_CST);
+}
+
+GC_INLINE uint32_t GcAtomicExchangeU32(volatile uint32_t* p, uint32_t v)
+{
+    return __atomic_exchange_n(p, v, __ATOMIC_SEQ_CST);
+}
+
+GC_INLINE int GcAtomicCasFullU64(volatile uint64_t* p, uint64_t* expected, uint64_t desired)
+{
+    return __atomic_compare_exchange_n(p, expected, desired, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+}
+
+GC_INLINE uint64_t GcAtomicLoadU64(const volatile uint64_t* p) { return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+GC_INLINE uint32_t GcAtomicLoadU32(const volatile uint32_t* p) { return __atomic_load_n(p, __ATOMIC_ACQUIRE); }
+GC_INLINE void GcAtomicStoreU64(volatile uint64_t* p, uint64_t v) { __atomic_store_n(p, v, __ATOMIC_RELEASE); }
+GC_INLINE void GcAtomicStoreU32(volatile uint32_t* p, uint32_t v) { __atomic_store_n(p, v, __ATOMIC_RELEASE); }
+
+#endif
+
+/* Lock-free running maximum. */
+GC_INLINE void GcAtomicMaxU64(volatile uint64_t* p, uint64_t v)
+{
+    uint64_t cur = GcAtomicLoadU64(p);
+    while (v > cur && !GcAtomicCasU64(p, &cur, v)) { }
+}
+
+/* Spin-wait hint. */
+GC_INLINE void GcCpuRelax(void)
+{
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#elif defined(_M_ARM64)
+    __yield();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+/* Index of the highest set bit; v must be non-zero. */
+GC_INLINE int GcHighBitU64(uint64_t v)
+{
+#if defined(_MSC_VER)
+    unsigned long i;
+    _BitScanReverse64(&i, v);
+    return (int)i;
+#else
+    return 63 - __builtin_clzll(v);
+#endif
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,177 @@
+#pragma once
+
+// Compiled hotkey matcher (user mode).
+//
+// The legacy app matches hotkeys and toggles one handler at a time
+// (HotkeyManager, ModeManager, the AutoSprintNode toggle), so the cost of
+// each input report grows with the profile. Program::Compile turns every
+// chord, tap/hold rule, toggle and key sequence of a profile into one
+// lookup structure over the GC_KEY_STATE pressed set, and a Matcher
+// evaluates it once per input report:
+//   - chords: a hash of key sets. On a key press the matcher looks up the
+//     subsets of held keys that share a chord with the pressed key, so the
+//     work depends on how many related keys are down, not on how many
+//     bindings exist;
+//   - sequences: one Aho-Corasick automaton over key presses, one
+//     transition per press;
+//   - tap/hold deadlines and releases: only bindings currently active.
+//
+// Tie-breaking is deterministic. When several chords are completed by the
+// same press, the one with the most keys wins, then the one declared first;
+// the losers do not fire. Keys pressed in the same report are handled in
+// ascending key order. A chord that wins also swallows a pending tap/hold on
+// a subset of its keys (Ctrl as tap/hold does not also tap after Ctrl+C).
+// Overlapping sequences fire the longest match: a sequence that is a prefix
+// of a longer one is held back until the next press does not extend it or
+// the gap runs out, then fires and matching starts over.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "gc/KeyState.h"
+
+namespace gc::bind {
+
+constexpr uint32_t kMaxChordKeys = 8;
+constexpr uint32_t kMaxSequenceKeys = 16;
+constexpr uint32_t kMaxBindings = 1u << 16;
+constexpr uint32_t kNone = 0xFFFFFFFFu;
+
+enum class Kind : uint8_t {
+    Hold,      // Action is on while every key of the chord is down
+    Toggle,    // every activation of the chord flips Action's latch
+    TapHold,   // released within HoldUs: Action taps; else HoldAction is on until release
+    Sequence,  // Keys pressed in this order, each within the sequence gap: Action taps
+};
+
+struct Binding {
+    Kind Type = Kind::Hold;
+    std::vector<uint8_t> Keys;   // chord keys in any order, or the sequence
+    uint8_t Action = 0;
+    uint8_t HoldAction = 0;      // TapHold only
+    uint32_t HoldUs = 200000;    // TapHold only
+};
+
+enum class CompileStatus : uint8_t {
+    Ok,
+    NoKeys,            // a binding without keys
+    TooManyKeys,       // chord > kMaxChordKeys or sequence > kMaxSequenceKeys
+    DuplicateKey,      // a chord lists the same key twice
+    TooManyBindings,   // more than kMaxBindings
+};
+
+const char* StatusName(CompileStatus s);
+
+// Output of one Evaluate. Taps (TapHold taps, sequences) are a Down and an
+// Up for the same action in the same Evaluate.
+struct Event {
+    uint32_t Binding;   // index into the compiled binding list
+    uint8_t Action;
+    bool Down;
+};
+
+class Program {
+public:
+    // On failure the program is left empty and *bad (if given) is the
+    // index of the offending binding.
+    CompileStatus Compile(const std::vector<Binding>& bindings, uint32_t sequenceGapUs = 500000,
+                          uint32_t* bad = nullptr);
+
+    size_t Count() const { return Triggers.size(); }
+
+private:
+    friend class Matcher;
+
+    struct Mask {
+        uint64_t W[4];
+    };
+    struct Trigger {
+        Mask Keys;
+        uint8_t KeyCount;   // 0 for sequences
+        Kind Type;
+        uint8_t Action;
+        uint8_t HoldAction;
+        uint32_t HoldUs;
+    };
+    struct ChordSlot {
+        Mask Keys;
+        uint32_t Binding;   // kNone = empty; lowest index among identical chords
+    };
+    struct Node {
+        uint32_t Fail;
+        uint32_t Output;    // longest sequence ending here, or kNone
+        bool Leaf;          // no goto edges: an output here cannot grow
+    };
+    struct Edge {
+        uint32_t From;      // node + 1, 0 = empty slot
+        uint32_t To;
+        uint8_t Key;
+    };
+
+    uint32_t FindChord(const Mask& m) const;
+    uint32_t Child(uint32_t node, uint8_t key) const;   // goto edge only, kNone if absent
+    uint32_t Step(uint32_t node, uint8_t key) const;
+
+    std::vector<Trigger> Triggers;   // one per binding
+    std::vector<Mask> Partners;      // [key]: keys sharing a chord with it, itself excluded
+    std::vector<ChordSlot> Chords;   // open addressing on the key set
+    std::vector<uint32_t> ByKeyStart, ByKey;   // fallback lists: (KeyCount desc, index asc)
+    std::vector<Node> Nodes;         // sequence automaton, 0 = root
+    std::vector<Edge> Edges;         // open addressing on (node, key)
+    uint32_t SequenceGapUs = 0;
+};
+
+// Per-input matching state for one Program, which must outlive it. After
+// recompiling the Program, call Reset before the next Evaluate. Not
+// thread-safe: evaluate from the input thread only.
+class Matcher {
+public:
+    explicit Matcher(const Program& program);
+
+    // Forget held chords, latches and sequence progress (profile switch),
+    // and size the per-binding state for the Program as it is now.
+    void Reset();
+
+    // Diffs pressed against the previous call and fills out (cleared
+    // first; no allocation once it has grown to the burst size).
+    void Evaluate(const uint64_t (&pressed)[4], uint64_t nowUs, std::vector<Event>& out);
+    void Evaluate(const GC_KEY_STATE& keys, uint64_t nowUs, std::vector<Event>& out) {
+        Evaluate(keys.Pressed, nowUs, out);
+    }
+
+    // True while a Hold/TapHold binding holds the action or a Toggle latched it.
+    bool ActionOn(uint8_t action) const;
+
+    // Earliest pending tap/hold or held-back sequence deadline, 0 if none:
+    // evaluate again by then even without a new report so holds start and
+    // prefix sequences fire on time.
+    uint64_t NextDeadlineUs() const;
+
+private:
+    struct Active {
+        uint32_t Binding;
+        bool Pending;     // TapHold still deciding
+        bool Swallowed;   // TapHold consumed by a bigger chord
+        uint64_t DeadlineUs;
+    };
+
+    void Press(uint8_t key, const uint64_t (&pressed)[4], uint64_t nowUs, std::vector<Event>& out);
+    void Release(uint8_t key, std::vector<Event>& out);
+    void FireSequence(uint32_t binding, std::vector<Event>& out);
+    uint32_t BestChord(uint8_t key, const uint64_t (&pressed)[4]) const;
+    void Activate(uint32_t binding, uint64_t nowUs, std::vector<Event>& out);
+    void Emit(std::vector<Event>& out, uint32_t binding, uint8_t action, bool down);
+
+    const Program& P;
+    uint64_t Prev[4] = {};
+    std::vector<Active> Actives;
+    std::vector<uint8_t> IsActive;   // per binding
+    uint16_t Held[256] = {};
+    uint64_t Latched[4] = {};
+    uint32_t SeqNode = 0;
+    uint32_t SeqPending = kNone;   // matched prefix sequence waiting for a longer one
+    uint64_t SeqLastUs = 0;
+};
+
+} // namespace gc::bind
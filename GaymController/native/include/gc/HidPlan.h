@@ -0,0 +1,126 @@
+#pragma once
+
+// HID report-descriptor parser and compiled field extractor (user mode).
+//
+// Parse walks a report descriptor once and produces a Plan: every data
+// field of every report with its bit offset, size, logical range and usage.
+// An Extractor compiled from the Plan for one report then decodes incoming
+// reports with a fixed per-field load/shift/mask/sign-extend sequence, no
+// item walking and no per-field branches, so raw devices (spec/70) no longer
+// need a hand-made byte offset map.
+//
+// Offsets count from the first byte of the report as delivered by the
+// device: reports with a non-zero ID start with the ID byte, reports
+// declared before any Report ID item have no prefix.
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace gc::hid {
+
+enum class ReportKind : uint8_t { Input, Output, Feature };
+
+enum class ParseStatus : uint8_t {
+    Ok,
+    Truncated,           // item data runs past the end of the descriptor
+    BadItem,             // reserved item type, unknown main tag, or report ID 0
+    BadReportSize,       // report size 0 or > 32 bits on a data field
+    ReportTooLong,       // a report exceeds kMaxReportBytes
+    TooManyFields,       // more than kMaxFields fields
+    StackOverflow,       // collection or push nesting too deep
+    StackUnderflow,      // End Collection or Pop without a match
+    UnclosedCollection,  // descriptor ended inside a collection
+};
+
+constexpr uint32_t kMaxReportBytes = 1024;
+constexpr uint32_t kMaxFields = 4096;
+
+// Main item data bits (HID 1.11, 6.2.2.5).
+constexpr uint16_t kFieldConstant = 0x01;
+constexpr uint16_t kFieldVariable = 0x02;   // clear: array of usage indices
+constexpr uint16_t kFieldRelative = 0x04;
+
+struct Field {
+    ReportKind Kind;
+    uint8_t ReportId;
+    uint8_t BitSize;      // 1..32
+    uint16_t Flags;       // main item data bits
+    uint16_t UsagePage;
+    uint16_t Usage;       // variable: the usage; array: first usage of the range
+    uint16_t UsageMax;    // variable: == Usage; array: last usage of the range
+    uint32_t BitOffset;   // from the start of the report, ID byte included
+    int32_t LogicalMin;
+    int32_t LogicalMax;
+
+    bool Signed() const { return LogicalMin < 0; }
+};
+
+struct Report {
+    ReportKind Kind;
+    uint8_t Id;
+    uint32_t Bits;        // ID byte included, before rounding up to bytes
+
+    uint32_t Bytes() const { return (Bits + 7) / 8; }
+};
+
+struct Plan {
+    std::vector<Field> Fields;     // descriptor order; constant padding is omitted
+    std::vector<Report> Reports;   // first-declaration order
+
+    const Report* Find(ReportKind kind, uint8_t id) const;
+};
+
+// On failure out is cleared. Never reads past len.
+ParseStatus Parse(const uint8_t* desc, size_t len, Plan& out);
+const char* StatusName(ParseStatus s);
+
+// Decodes the data fields of one report.
+class Extractor {
+public:
+    // value = sext((load64(base + Byte) >> Shift) & Mask); ExtractUnit then
+    // clamps to [Min, Max] and scales by 65535 / (Max - Min) in Q32.
+    struct Op {
+        uint32_t Byte;
+        uint32_t Shift;
+        uint32_t Mask;
+        uint32_t SignBit;
+        int32_t Min;
+        int32_t Max;
+        uint64_t Scale;
+    };
+
+    // False if the plan has no such report.
+    bool Compile(const Plan& plan, ReportKind kind, uint8_t id);
+
+    size_t Count() const { return Ops.size(); }
+    uint32_t ReportBytes() const { return Bytes; }
+
+    // Logical values, sign-extended when the field's LogicalMin < 0.
+    // False (out untouched) if len < ReportBytes() or the ID byte differs.
+    bool Extract(const uint8_t* report, size_t len, int32_t* out) const;
+
+    // Values clamped to the logical range and scaled to 0..65535.
+    bool ExtractUnit(const uint8_t* report, size_t len, uint16_t* out) const;
+
+private:
+    bool StageTail(const uint8_t* report, size_t len, uint8_t* tail) const;
+
+    uint32_t Bytes = 0;
+    uint8_t Id = 0;
+    // Ops[0, Body) load straight from the report; the rest sit in its last
+    // 8 bytes and load from a zero-padded copy starting at TailBase.
+    uint32_t Body = 0;
+    uint32_t TailBase = 0;
+    std::vector<Op> Ops;
+};
+
+// "X", "Button 3", "Key A", ... or "Page 0xFF00 Usage 0x05" for pages without names.
+std::string UsageName(uint16_t page, uint16_t usage);
+
+// Offset map in the format RawHidProvider.FromMapping loads: {"<byte>": "<name>"}
+// for every byte-aligned 8-bit variable input field of the given report.
+std::string MappingJson(const Plan& plan, uint8_t reportId);
+
+} // namespace gc::hid
@@ -0,0 +1,78 @@
+#pragma once
+
+/* Keyboard state for the mapping path: a 256-bit pressed set plus one
+   8-bit analog depth per key, indexed by key code (Windows VK or HID
+   usage; the caller picks one scheme per store).
+
+   Digital keys read as depth 255 while down. Analog keys (Wooting reports,
+   RawHidProvider) set the depth directly; the pressed bit follows it with
+   hysteresis: it sets at Actuation and clears below Release.
+
+   On top of the store sit SOCD resolution (what a pair of opposing keys
+   such as A/D means while both are down) and the WASD-to-stick mapping that
+   replaces the legacy StickMapper.WasdToLeftStick:
+     - LAST_WINS  : the most recently pressed key wins; releasing it hands
+                    back to the other one if still held.
+     - NEUTRAL    : both held cancel to centre.
+     - FIRST_WINS : the key held first keeps the axis until released.
+   Resolution is branch-free. The stick magnitude is the winning keys'
+   depth, normalised onto the circle with a precomputed table (no sqrt):
+   a full diagonal reaches the rim like the legacy mapper, half travel
+   gives half deflection in any direction.
+
+   Single writer; readers on other threads need their own synchronisation. */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GC_KEY_COUNT         256
+#define GC_KEY_FULL_DEPTH    255
+
+typedef enum _GC_SOCD_MODE
+{
+    GC_SOCD_LAST_WINS = 0,
+    GC_SOCD_NEUTRAL,
+    GC_SOCD_FIRST_WINS
+} GC_SOCD_MODE;
+
+typedef struct _GC_KEY_STATE
+{
+    uint64_t Pressed[GC_KEY_COUNT / 64];
+    uint8_t  Depth[GC_KEY_COUNT];
+    uint32_t PressedAt[GC_KEY_COUNT];   /* Clock value of the last press */
+    uint32_t Clock;                     /* bumped on every press */
+    uint8_t  Actuation;                 /* analog press point, >= 1 */
+    uint8_t  Release;                   /* analog release point, <= Actuation */
+    uint16_t Reserved;
+} GC_KEY_STATE, *PGC_KEY_STATE;
+
+typedef struct _GC_WASD_MAP
+{
+    uint8_t Up, Left, Down, Right;   /* key codes */
+    GC_SOCD_MODE ModeX;
+    GC_SOCD_MODE ModeY;
+} GC_WASD_MAP;
+
+/* All keys up. actuation/release apply to GcKeySetDepth; 0 picks 1 and
+   the release point is clamped to the actuation point. */
+void GcKeyInit(PGC_KEY_STATE k, uint8_t actuation, uint8_t release);
+
+void GcKeyDown(PGC_KEY_STATE k, uint8_t key);   /* digital: depth 255 */
+void GcKeyUp(PGC_KEY_STATE k, uint8_t key);
+void GcKeySetDepth(PGC_KEY_STATE k, uint8_t key, uint8_t depth);
+
+int GcKeyIsDown(const GC_KEY_STATE* k, uint8_t key);
+
+/* One axis from an opposing pair: the winner's depth, negative when neg
+   wins, 0 when neither is down or NEUTRAL cancels. */
+int32_t GcSocdAxis(const GC_KEY_STATE* k, uint8_t neg, uint8_t pos, GC_SOCD_MODE mode);
+
+/* Left stick in XInput convention (Up = +Y), Q15. */
+void GcWasdToStick(const GC_KEY_STATE* k, const GC_WASD_MAP* map, int16_t* x, int16_t* y);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,82 @@
+#pragma once
+
+/* End-to-end latency probe.
+
+   A GC_TRACE is created where a raw HID report is read and then travels
+   with the data: through the mapping graph, inside the SET_STATE wire frame
+   (GC_WIRE_FLAG_TRACE) and into IOCTL_VPAD_SET_STATE as VPAD_TRACE. Every
+   hop stamps it into two histograms: Total (now - origin) and Stage (now -
+   previous hop). Recording is lock-free and allocation-free so it can run
+   on the HID read thread and in the func driver.
+
+   Histograms are log-linear: exact below 16 ns, then 16 buckets per power
+   of two (~6% resolution) up to 2^37 ns (~137 s); larger values saturate. */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum _GC_HOP
+{
+    GC_HOP_HID_READ = 0,   /* raw report handed to the provider */
+    GC_HOP_GRAPH_OUT,      /* mapping graph produced a GamepadState */
+    GC_HOP_WIRE_TX,        /* SET_STATE frame written by the app */
+    GC_HOP_BROKER_RX,      /* SET_STATE frame parsed by the broker */
+    GC_HOP_DRIVER_SUBMIT,  /* func driver submitted the HID input report */
+    GC_HOP_COUNT
+} GC_HOP;
+
+/* Same layout as VPAD_TRACE and the wire trace block (16 bytes, LE). */
+typedef struct _GC_TRACE
+{
+    uint32_t Sequence;
+    uint32_t LastOffsetNs;  /* offset of the previous hop from OriginNs, saturating */
+    uint64_t OriginNs;      /* QPC/CLOCK_MONOTONIC time of the raw read, in ns */
+} GC_TRACE, *PGC_TRACE;
+
+#define GC_LATENCY_SUB_BITS 4
+#define GC_LATENCY_SUB      (1u << GC_LATENCY_SUB_BITS)
+#define GC_LATENCY_MAX_BIT  36
+#define GC_LATENCY_BUCKETS  ((GC_LATENCY_MAX_BIT - GC_LATENCY_SUB_BITS + 2) * GC_LATENCY_SUB)
+
+typedef struct _GC_LATENCY_HISTOGRAM
+{
+    volatile uint64_t Buckets[GC_LATENCY_BUCKETS];
+    volatile uint64_t Count;
+    volatile uint64_t SumNs;
+    volatile uint64_t MaxNs;
+} GC_LATENCY_HISTOGRAM, *PGC_LATENCY_HISTOGRAM;
+
+typedef struct _GC_LATENCY_PROBE
+{
+    GC_LATENCY_HISTOGRAM Total[GC_HOP_COUNT];
+    GC_LATENCY_HISTOGRAM Stage[GC_HOP_COUNT];
+    volatile uint32_t NextSequence;
+} GC_LATENCY_PROBE, *PGC_LATENCY_PROBE;
+
+void GcLatencyReset(PGC_LATENCY_HISTOGRAM h);
+void GcLatencyRecord(PGC_LATENCY_HISTOGRAM h, uint64_t ns);
+
+/* Value at the given quantile in parts per 10000 (5000 = p50, 9900 = p99),
+   reported as the upper edge of its bucket and never above MaxNs. */
+uint64_t GcLatencyPercentile(const GC_LATENCY_HISTOGRAM* h, uint32_t perTenThousand);
+uint64_t GcLatencyMeanNs(const GC_LATENCY_HISTOGRAM* h);
+
+/* Bucket mapping, exposed for tests. */
+uint32_t GcLatencyBucketOf(uint64_t ns);
+uint64_t GcLatencyBucketUpper(uint32_t bucket);
+
+void GcProbeReset(PGC_LATENCY_PROBE p);
+void GcTraceBegin(PGC_LATENCY_PROBE p, uint64_t originNs, PGC_TRACE t);
+
+/* Records one hop into total/stage and advances t->LastOffsetNs. */
+void GcTraceStampInto(PGC_LATENCY_HISTOGRAM total, PGC_LATENCY_HISTOGRAM stage, PGC_TRACE t, uint64_t nowNs);
+void GcTraceStamp(PGC_LATENCY_PROBE p, GC_HOP hop, PGC_TRACE t, uint64_t nowNs);
+
+const char* GcHopName(GC_HOP hop);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,93 @@
+#pragma once
+
+/* Live per-pad state mirror for the HUD, visualizers and CLI (GC-PAR-013).
+
+   The broker owns one shared-memory page per pad and republishes it on
+   every SET_STATE, rumble or LED change and once per second with fresh
+   rate/latency figures. Readers map the page read-only and copy the
+   snapshot out under a seqlock: no IPC round trip, no lock, and nothing
+   a reader does can slow the writer down.
+
+   Seqlock: Sequence is odd while a publish is in progress. A reader loads
+   Sequence, copies the snapshot words, loads Sequence again and retries if
+   it was odd or changed. All words are accessed with acquire/release
+   atomics so the copy is race-free in C11 and C++.
+
+   Layout is little-endian and fixed; readers check Magic, Version and
+   SnapshotBytes before trusting the page. Mirrored by
+   shared/Contracts/PadMirror.cs. Page names: "Global\GaymController.Pad<slot>"
+   on Windows (the broker service writes from session 0, readers are in
+   the desktop session; see gc::mirror::kPageSddl), and
+   "/GaymController.Pad<slot>" (POSIX shm) elsewhere. */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "VPadShared.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GC_MIRROR_MAGIC     0x524D4347u   /* "GCMR" */
+#define GC_MIRROR_VERSION   1u
+#define GC_MIRROR_MAP_BYTES 4096u         /* size of each shared mapping */
+
+typedef struct _GC_MIRROR_SNAPSHOT
+{
+    VPAD_STATE State;          /* last report submitted to the func driver */
+    uint8_t  RumbleLeft;
+    uint8_t  RumbleRight;
+    uint8_t  LedR, LedG, LedB;
+    uint8_t  Connected;        /* 1 while a client holds the pad open */
+    uint16_t Reserved0;
+    uint32_t RumbleSequence;
+    uint64_t UpdatedNs;        /* writer clock (QPC/CLOCK_MONOTONIC ns) at publish */
+    uint64_t Reports;          /* SET_STATE reports submitted since open */
+    uint32_t RateHz;           /* reports in the last second */
+    uint32_t TargetRateHz;     /* rate controller setting, 0 if not paced */
+    uint32_t LatencyP50Ns;     /* origin->broker receive (traced reports) over the
+                                  last second; the driver's submit hop is
+                                  IOCTL_VPAD_GET_LATENCY */
+    uint32_t LatencyP99Ns;
+    uint32_t LatencyMaxNs;
+    uint32_t Reserved1;
+} GC_MIRROR_SNAPSHOT, *PGC_MIRROR_SNAPSHOT;
+
+#define GC_MIRROR_WORDS (sizeof(GC_MIRROR_SNAPSHOT) / sizeof(uint64_t))
+
+typedef struct _GC_MIRROR_PAGE
+{
+    uint32_t Magic;
+    uint32_t Version;
+    uint32_t SnapshotBytes;    /* sizeof(GC_MIRROR_SNAPSHOT) */
+    uint32_t Slot;
+    uint32_t WriterPid;
+    uint32_t Reserved0;
+    uint64_t CreatedNs;
+    uint8_t  Reserved1[32];
+    volatile uint32_t Sequence;   /* odd = publish in progress; publishes = Sequence / 2 */
+    uint32_t Reserved2;
+    volatile uint64_t Words[GC_MIRROR_WORDS];   /* GC_MIRROR_SNAPSHOT */
+} GC_MIRROR_PAGE, *PGC_MIRROR_PAGE;
+
+VPAD_STATIC_ASSERT(sizeof(GC_MIRROR_SNAPSHOT) == 64, "GC_MIRROR_SNAPSHOT must be 64 bytes");
+VPAD_STATIC_ASSERT(offsetof(GC_MIRROR_SNAPSHOT, UpdatedNs) == 24, "GC_MIRROR_SNAPSHOT layout");
+VPAD_STATIC_ASSERT(offsetof(GC_MIRROR_PAGE, Sequence) == 64, "GC_MIRROR_PAGE layout");
+VPAD_STATIC_ASSERT(offsetof(GC_MIRROR_PAGE, Words) == 72, "GC_MIRROR_PAGE layout");
+VPAD_STATIC_ASSERT(sizeof(GC_MIRROR_PAGE) <= GC_MIRROR_MAP_BYTES, "GC_MIRROR_PAGE must fit the mapping");
+
+/* Writer side. Init stamps the header and an all-zero snapshot. */
+void GcMirrorInit(PGC_MIRROR_PAGE p, uint32_t slot, uint32_t writerPid, uint64_t nowNs);
+void GcMirrorPublish(PGC_MIRROR_PAGE p, const GC_MIRROR_SNAPSHOT* s);
+
+/* 1 if the header describes a layout this reader understands. */
+int GcMirrorValid(const GC_MIRROR_PAGE* p);
+
+/* Copies a consistent snapshot. Returns 1 on success, 0 if the page is
+   invalid or every one of maxAttempts found a publish in progress. */
+int GcMirrorRead(const GC_MIRROR_PAGE* p, GC_MIRROR_SNAPSHOT* out, uint32_t maxAttempts);
+
+#ifdef __cplusplus
+}
+#endif
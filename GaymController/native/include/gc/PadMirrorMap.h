@@ -0,0 +1,74 @@
+#pragma once
+
+// Shared-memory mapping of a GC_MIRROR_PAGE (user mode).
+//
+// The broker creates one writable mapping per pad; HUDs and tools open it
+// read-only and poll Read(), which only copies 64 bytes under the seqlock.
+// Windows uses a named file mapping, everything else POSIX shm.
+
+#include "gc/Atomic.h"
+#include "gc/PadMirror.h"
+
+#include <cstdint>
+#include <string>
+
+namespace gc::mirror {
+
+enum class MapStatus : uint8_t {
+    Ok,
+    NotFound,      // no writer has created the page
+    AccessDenied,
+    BadLayout,     // magic/version/size mismatch
+    SystemError,
+};
+
+const char* MapStatusName(MapStatus s);
+
+// "Global\GaymController.Pad<slot>" on Windows, "/GaymController.Pad<slot>" otherwise.
+// The Windows writer is the broker service in session 0 and readers run in
+// the user's desktop session, so the name must live in the global
+// namespace (creating it needs SeCreateGlobalPrivilege, which services hold).
+std::string PageName(uint32_t slot);
+
+// DACL the Windows page is created with: full access for SYSTEM and
+// administrators, read-only for interactive users. Without it the default
+// DACL of a LocalSystem object denies the desktop-session reader.
+constexpr char kPageSddl[] = "D:P(A;;GA;;;SY)(A;;GA;;;BA)(A;;GR;;;IU)";
+
+class PadMirrorMap {
+public:
+    PadMirrorMap() = default;
+    ~PadMirrorMap();
+    PadMirrorMap(PadMirrorMap&& other) noexcept;
+    PadMirrorMap& operator=(PadMirrorMap&& other) noexcept;
+    PadMirrorMap(const PadMirrorMap&) = delete;
+    PadMirrorMap& operator=(const PadMirrorMap&) = delete;
+
+    // Writer: creates (or takes over) the page for slot and initialises it.
+    MapStatus Create(uint32_t slot, uint64_t nowNs);
+    // Reader: maps an existing page read-only and checks its layout.
+    MapStatus Open(uint32_t slot);
+    void Close();
+
+    bool IsOpen() const { return Page_ != nullptr; }
+    bool Writable() const { return Writable_; }
+    const GC_MIRROR_PAGE* Page() const { return Page_; }
+
+    void Publish(const GC_MIRROR_SNAPSHOT& s) { GcMirrorPublish(Page_, &s); }
+    bool Read(GC_MIRROR_SNAPSHOT& out, uint32_t maxAttempts = 64) const {
+        return Page_ && GcMirrorRead(Page_, &out, maxAttempts) != 0;
+    }
+    // Publishes seen so far; a reader can skip redraws while it is unchanged.
+    uint32_t Publishes() const { return Page_ ? GcAtomicLoadU32(&Page_->Sequence) / 2 : 0; }
+
+    // Writer only: removes the name so new readers fail with NotFound
+    // (POSIX; on Windows the mapping goes away with its last handle).
+    static void Unlink(uint32_t slot);
+
+private:
+    GC_MIRROR_PAGE* Page_ = nullptr;
+    void* Handle_ = nullptr;   // Windows mapping handle
+    bool Writable_ = false;
+};
+
+} // namespace gc::mirror
@@ -0,0 +1,81 @@
+#pragma once
+
+/* Closed-loop report rate control (AIMD).
+
+   The sender (app -> broker -> driver) feeds back what the consumer reports
+   per submit: its queue depth (VPAD_PRESSURE.InFlight, or the broker's own
+   pending SET_STATE count) and the submit latency (IOCTL round trip or the
+   trace's DRIVER_SUBMIT stage). Once per control period the controller
+   looks at the worst sample of that period:
+
+     latency > TargetLatencyNs or depth > MaxQueueDepth
+         -> rate = min(rate, drained) * DecreaseQ16 / 65536
+     otherwise
+         -> rate += IncreaseHz
+
+   where drained is the completion rate seen during the period, i.e. the
+   consumer's real capacity while it is backlogged.
+
+   clamped to [MinRateHz, MaxRateHz]. The rate sets the coalescing window:
+   the sender keeps only the newest state and sends it when GcRateShouldSend
+   says the window has elapsed, so a slow consumer sees fewer, fresher
+   reports instead of a growing backlog.
+
+   Integer-only and allocation-free; single-threaded per sender. */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct _GC_RATE_CONFIG
+{
+    uint32_t MinRateHz;       /* floor, >= 1 */
+    uint32_t MaxRateHz;       /* ceiling and starting rate */
+    uint32_t TargetLatencyNs; /* per-submit latency budget */
+    uint32_t MaxQueueDepth;   /* consumer backlog tolerated before backing off */
+    uint32_t IncreaseHz;      /* additive step per clean period */
+    uint32_t DecreaseQ16;     /* multiplicative factor, e.g. 0.75 * 65536 */
+    uint32_t PeriodNs;        /* control period; >= a few consumer round trips */
+} GC_RATE_CONFIG;
+
+typedef struct _GC_RATE_CONTROL
+{
+    GC_RATE_CONFIG Cfg;
+    uint32_t RateHz;
+    uint32_t IntervalNs;       /* coalescing window, 1e9 / RateHz */
+    uint64_t PeriodStartNs;
+    uint64_t NextSendNs;
+    uint64_t LastDecreaseNs;
+    uint32_t PeriodSamples;      /* fresh samples (sent after the last decrease) */
+    uint32_t PeriodCompletions;  /* all samples */
+    uint32_t PeriodMaxLatencyNs;
+    uint32_t PeriodMaxDepth;
+    uint32_t Decreases;
+    uint32_t Increases;
+} GC_RATE_CONTROL, *PGC_RATE_CONTROL;
+
+/* 250 Hz..8 kHz, 1 ms target, depth 4, +100 Hz / x0.75 per 10 ms. */
+void GcRateDefaultConfig(GC_RATE_CONFIG* cfg);
+
+/* Returns 0 on an invalid config. */
+int GcRateInit(PGC_RATE_CONTROL rc, const GC_RATE_CONFIG* cfg, uint64_t nowNs);
+
+/* One feedback sample per completed report; latencyNs is measured from
+   the send, so nowNs - latencyNs is when the report left. Latency of
+   reports sent before the last decrease is ignored. Closes the control period
+   (and may change the rate) when nowNs has moved past it. */
+void GcRateObserve(PGC_RATE_CONTROL rc, uint64_t nowNs, uint32_t queueDepth, uint32_t latencyNs);
+
+/* Closes the period without a new sample; a period with no samples leaves
+   the rate unchanged. Call from the send path when the consumer is silent. */
+void GcRateTick(PGC_RATE_CONTROL rc, uint64_t nowNs);
+
+/* 1 if the coalescing window has elapsed: send the newest state now.
+   Windows are scheduled back to back, skipping any that were missed. */
+int GcRateShouldSend(PGC_RATE_CONTROL rc, uint64_t nowNs);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,131 @@
+#pragma once
+
+// Deterministic sender/consumer simulation for GC_RATE_CONTROL.
+//
+// The graph produces a new state every InputPeriodNs; the sender coalesces
+// and sends when GcRateShouldSend allows. The consumer (driver submit path)
+// is a single FIFO server whose per-report service time follows a step
+// schedule. Completions feed back queue depth and send->done latency.
+// No clocks, threads or randomness: same inputs, same trace.
+
+#include "gc/RateControl.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace gc::sim {
+
+struct Step {
+    uint64_t AtNs;        // schedule entry takes effect at this time
+    uint32_t ServiceNs;   // consumer cost per report
+};
+
+struct Sample {
+    uint64_t DoneNs;
+    uint32_t LatencyNs;
+    uint32_t RateHz;      // controller rate when the sample arrived
+};
+
+struct Phase {
+    uint64_t StartNs, EndNs;
+    uint32_t ServiceNs;
+    double CapacityHz;     // 1e9 / ServiceNs
+    double DeliveredHz;    // steady half of the phase
+    double SteadyRateHz;   // mean controller rate, steady half
+    uint32_t P50Ns, P99Ns, MaxNs;   // latency, steady half
+    double ConvergeMs;     // step -> rate stays inside the steady band
+};
+
+class RateSim {
+public:
+    RateSim(const GC_RATE_CONFIG& cfg, std::vector<Step> schedule, uint64_t inputPeriodNs = 125000)
+        : Schedule(std::move(schedule)), InputPeriodNs(inputPeriodNs) {
+        GcRateInit(&Rc, &cfg, 0);
+    }
+
+    void Run(uint64_t endNs) {
+        size_t step = 0;
+        for (uint64_t t = 0; t < endNs; t += InputPeriodNs) {
+            while (step + 1 < Schedule.size() && Schedule[step + 1].AtNs <= t) ++step;
+            Deliver(t);
+            if (GcRateShouldSend(&Rc, t)) {
+                uint64_t start = std::max(t, ServerFreeNs);
+                ServerFreeNs = start + Schedule[step].ServiceNs;
+                InFlight.push_back({t, ServerFreeNs});
+            }
+            Rates.push_back(Rc.RateHz);
+        }
+        EndNs = endNs;
+    }
+
+    // Per schedule step; the second half of each step is its steady state.
+    std::vector<Phase> Phases() const {
+        std::vector<Phase> out;
+        for (size_t i = 0; i < Schedule.size(); ++i) {
+            Phase p{};
+            p.StartNs = Schedule[i].AtNs;
+            p.EndNs = i + 1 < Schedule.size() ? Schedule[i + 1].AtNs : EndNs;
+            p.ServiceNs = Schedule[i].ServiceNs;
+            p.CapacityHz = 1e9 / p.ServiceNs;
+            uint64_t mid = p.StartNs + (p.EndNs - p.StartNs) / 2;
+
+            std::vector<uint32_t> lat;
+            for (const auto& s : Samples)
+                if (s.DoneNs >= mid && s.DoneNs < p.EndNs) lat.push_back(s.LatencyNs);
+            std::sort(lat.begin(), lat.end());
+            if (!lat.empty()) {
+                p.P50Ns = lat[lat.size() / 2];
+                p.P99Ns = lat[lat.size() * 99 / 100];
+                p.MaxNs = lat.back();
+            }
+            p.DeliveredHz = lat.size() * 1e9 / double(p.EndNs - mid);
+
+            double sum = 0;
+            size_t n = 0;
+            for (uint64_t t = mid; t < p.EndNs; t += InputPeriodNs, ++n) sum += Rates[t / InputPeriodNs];
+            p.SteadyRateHz = n ? sum / n : 0;
+
+            // Converged once the rate enters the steady band and never leaves it
+            // (AIMD saws between ~DecreaseQ16 x peak and peak).
+            double lo = p.SteadyRateHz * 0.6, hi = p.SteadyRateHz * 1.4;
+            uint64_t since = p.StartNs;
+            for (uint64_t t = p.StartNs; t < p.EndNs; t += InputPeriodNs) {
+                double r = Rates[t / InputPeriodNs];
+                if (r < lo || r > hi) since = t + InputPeriodNs;
+            }
+            p.ConvergeMs = (since - p.StartNs) / 1e6;
+            out.push_back(p);
+        }
+        return out;
+    }
+
+    const std::vector<Sample>& Trace() const { return Samples; }
+    const std::vector<uint32_t>& RateTrace() const { return Rates; }   // per input period
+    const GC_RATE_CONTROL& Controller() const { return Rc; }
+
+private:
+    struct Pending { uint64_t SentNs, DoneNs; };
+
+    void Deliver(uint64_t now) {
+        while (!InFlight.empty() && InFlight.front().DoneNs <= now) {
+            Pending p = InFlight.front();
+            InFlight.pop_front();
+            uint32_t lat = uint32_t(p.DoneNs - p.SentNs);
+            GcRateObserve(&Rc, p.DoneNs, uint32_t(InFlight.size()), lat);
+            Samples.push_back({p.DoneNs, lat, Rc.RateHz});
+        }
+    }
+
+    GC_RATE_CONTROL Rc;
+    std::vector<Step> Schedule;
+    uint64_t InputPeriodNs;
+    uint64_t ServerFreeNs = 0;
+    uint64_t EndNs = 0;
+    std::deque<Pending> InFlight;
+    std::vector<Sample> Samples;
+    std::vector<uint32_t> Rates;
+};
+
+} // namespace gc::sim
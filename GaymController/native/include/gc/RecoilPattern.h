@@ -0,0 +1,101 @@
+#pragma once
+
+/* Time-indexed recoil compensation patterns (replaces the single
+   exponential AntiRecoilNode offset in shared/Mapping/Nodes.cs).
+
+   A profile authors each weapon's pattern as x/y stick offsets at key
+   times (microseconds since the trigger went down) or at shot indices
+   (converted to times with the weapon's shot interval). Between keys the
+   pattern is linear; before the first key it ramps from rest at t = 0, and
+   after the last key it holds the last offset for as long as the trigger
+   stays down.
+
+   GcRecoilBake samples the authored pattern once into a fixed-step table
+   (2^StepShift us per step) in caller-owned memory. Playback only indexes
+   the table and interpolates between two neighbouring samples: no
+   division, no libm, no allocation, so a tick of many concurrent
+   instances costs a few integer operations each.
+
+   A GC_RECOIL_MIXER plays up to GC_RECOIL_MAX_INSTANCES patterns at once
+   (several weapons, a fire mode and its ADS variant, a crossfade on
+   weapon swap) and sums them, each scaled by its own Q15 weight. Values are
+   Q15 stick units like gc/StickDsp.h; the sum saturates to int16. */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GC_RECOIL_MAX_STEPS      65536u
+#define GC_RECOIL_MAX_INSTANCES  128
+#define GC_RECOIL_DEFAULT_SHIFT  10      /* 1.024 ms steps */
+
+typedef enum _GC_RECOIL_KEY
+{
+    GC_RECOIL_KEY_TIME_US = 0,   /* Key = microseconds since trigger down */
+    GC_RECOIL_KEY_SHOT           /* Key = shot index, 0 = first shot */
+} GC_RECOIL_KEY;
+
+typedef struct _GC_RECOIL_POINT
+{
+    uint32_t Key;    /* strictly increasing */
+    int16_t  X, Y;   /* Q15 compensation offset */
+} GC_RECOIL_POINT;
+
+typedef struct _GC_RECOIL_DESC
+{
+    const GC_RECOIL_POINT* Points;
+    uint32_t Count;
+    GC_RECOIL_KEY KeyKind;
+    uint32_t ShotIntervalUs;   /* GC_RECOIL_KEY_SHOT: 60e6 / RPM */
+    uint32_t StepShift;        /* 0 = GC_RECOIL_DEFAULT_SHIFT; at most 15 */
+} GC_RECOIL_DESC;
+
+typedef struct _GC_RECOIL_TABLE GC_RECOIL_TABLE, *PGC_RECOIL_TABLE;
+
+/* Bytes needed to bake d; 0 if d is invalid (no points, keys not
+   increasing, zero shot interval, or longer than GC_RECOIL_MAX_STEPS). */
+size_t GcRecoilBakeBytes(const GC_RECOIL_DESC* d);
+
+/* Bakes d into mem (4-byte aligned, GcRecoilBakeBytes(d) bytes). Returns
+   NULL if d is invalid or mem too small. */
+PGC_RECOIL_TABLE GcRecoilBake(void* mem, size_t bytes, const GC_RECOIL_DESC* d);
+
+/* Last key time rounded up to a whole step; playback holds from here on. */
+uint32_t GcRecoilDurationUs(const GC_RECOIL_TABLE* t);
+
+/* Table playback at tUs since trigger down. */
+void GcRecoilSample(const GC_RECOIL_TABLE* t, uint32_t tUs, int16_t* x, int16_t* y);
+
+typedef struct _GC_RECOIL_INSTANCE
+{
+    const GC_RECOIL_TABLE* Table;
+    uint32_t ElapsedUs;   /* saturates at the table's DurationUs */
+    int32_t  Weight;      /* Q15, 32768 == 1.0; may be negative */
+} GC_RECOIL_INSTANCE;
+
+typedef struct _GC_RECOIL_MIXER
+{
+    GC_RECOIL_INSTANCE Instances[GC_RECOIL_MAX_INSTANCES];
+    uint64_t Active[GC_RECOIL_MAX_INSTANCES / 64];   /* bit per playing instance */
+} GC_RECOIL_MIXER, *PGC_RECOIL_MIXER;
+
+void GcRecoilMixerInit(PGC_RECOIL_MIXER m);
+
+/* Starts t from its first sample (trigger down). Returns the instance id,
+   or -1 if all instances are playing. */
+int GcRecoilStart(PGC_RECOIL_MIXER m, const GC_RECOIL_TABLE* t, int32_t weight);
+
+/* Trigger up / crossfade. Ids of stopped instances are reused. */
+void GcRecoilStop(PGC_RECOIL_MIXER m, int id);
+void GcRecoilSetWeight(PGC_RECOIL_MIXER m, int id, int32_t weight);
+
+/* Advances every playing instance by dtUs and returns the weighted sum of
+   their offsets at the new time (0, 0 when nothing plays). */
+void GcRecoilTick(PGC_RECOIL_MIXER m, uint32_t dtUs, int16_t* x, int16_t* y);
+
+#ifdef __cplusplus
+}
+#endif
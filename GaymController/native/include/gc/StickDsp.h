@@ -0,0 +1,120 @@
+#pragma once
+
+/* Composable stick signal-processing stages.
+
+   Every stage works in place on a struct-of-arrays batch of sticks so one
+   call processes all pads (or all samples of one pad) in a tight loop.
+   Each stage has two flavours:
+     - *F   : float, 1.0 == full deflection, SSE2 when available.
+     - *Q15 : int16 Q15, 32767 == full deflection, integer-only so it can
+              run in the func driver without saving FPU state.
+
+   Chaining RadialDeadzone -> VelocityGain -> RadialCurve -> AntiDeadzone ->
+   Ema -> CircularClamp reproduces the legacy CurveProcessor.ToStick
+   (reference/PERFECT/Processing/CurveProcessor.cs). Stateful stages keep
+   their state in caller-owned arrays of Count elements; zero-initialise
+   them (or call the matching Reset) before first use. */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GC_Q15_ONE 32767
+
+typedef struct _GC_STICKS_F
+{
+    float* X;
+    float* Y;
+    size_t Count;
+} GC_STICKS_F, *PGC_STICKS_F;
+
+typedef struct _GC_STICKS_Q15
+{
+    int16_t* X;
+    int16_t* Y;
+    size_t   Count;
+} GC_STICKS_Q15, *PGC_STICKS_Q15;
+
+/* Deadzones. With Rescale the live zone is stretched back to full range;
+   without it values below Inner snap to zero and the rest pass through
+   (the legacy JitterFloor behaviour). */
+void GcDspRadialDeadzoneF(GC_STICKS_F s, float inner, int rescale);
+void GcDspRadialDeadzoneQ15(GC_STICKS_Q15 s, int16_t inner, int rescale);
+void GcDspAxialDeadzoneF(GC_STICKS_F s, float inner, int rescale);
+void GcDspAxialDeadzoneQ15(GC_STICKS_Q15 s, int16_t inner, int rescale);
+
+/* Radial anti-deadzone: any non-zero magnitude r (normalised to maxR and
+   clamped to 1) becomes adz + (1 - adz) * r. */
+void GcDspAntiDeadzoneF(GC_STICKS_F s, float adz, float maxR);
+void GcDspAntiDeadzoneQ15(GC_STICKS_Q15 s, int16_t adz, int16_t maxR);
+
+/* Radial response curve: r' = maxR * pow(clamp(r / maxR, 0, 1), 1 - expo).
+   Evaluated with polynomial log2/exp2, no libm calls. */
+void GcDspRadialCurveF(GC_STICKS_F s, float expo, float maxR);
+void GcDspRadialCurveQ15(GC_STICKS_Q15 s, int16_t expo, int16_t maxR);
+
+/* Velocity gain: r *= 1 + gain * clamp(|r - lastR|, 0, 1.5), lastR keeps
+   the post-gain magnitude. Q15 gain is Q15 as well (32768 == 1.0) and may
+   exceed 1.0; the Q15 result saturates at the unit circle. */
+void GcDspVelocityGainF(GC_STICKS_F s, float gain, float* lastR);
+void GcDspVelocityGainQ15(GC_STICKS_Q15 s, int32_t gain, int32_t* lastR);
+
+/* Vector EMA: state += alpha * (in - state); out = state. The Q15 state is
+   kept as stick units << 16 so small alphas do not stall on rounding. */
+void GcDspEmaF(GC_STICKS_F s, float alpha, float* stateX, float* stateY);
+void GcDspEmaQ15(GC_STICKS_Q15 s, int16_t alpha, int32_t* stateX, int32_t* stateY);
+
+/* One-euro filter on the stick vector: the cutoff rises with the filtered
+   speed so slow aim is smoothed and flicks pass through. */
+typedef struct _GC_ONE_EURO_PARAMS
+{
+    float MinCutoffHz;
+    float Beta;          /* Hz of extra cutoff per full-scale/s of speed */
+    float DCutoffHz;
+    float RateHz;        /* sample rate of the batch stream */
+} GC_ONE_EURO_PARAMS;
+
+typedef struct _GC_ONE_EURO_STATE_F
+{
+    float* FiltX;
+    float* FiltY;
+    float* DerivX;
+    float* DerivY;
+} GC_ONE_EURO_STATE_F;
+
+typedef struct _GC_ONE_EURO_STATE_Q15
+{
+    int32_t* FiltX;      /* stick units << 16 */
+    int32_t* FiltY;
+    int32_t* DerivX;     /* stick units per second */
+    int32_t* DerivY;
+} GC_ONE_EURO_STATE_Q15;
+
+/* Integer mirror of GC_ONE_EURO_PARAMS for driver-side callers. */
+typedef struct _GC_ONE_EURO_PARAMS_Q15
+{
+    uint32_t MinCutoffMilliHz;
+    uint32_t BetaMilliHz;    /* per full-scale/s */
+    uint32_t DCutoffMilliHz;
+    uint32_t RateHz;         /* <= 16000 so the derivative fits in 32 bits */
+} GC_ONE_EURO_PARAMS_Q15;
+
+void GcDspOneEuroResetF(GC_STICKS_F s, GC_ONE_EURO_STATE_F st);
+void GcDspOneEuroF(GC_STICKS_F s, const GC_ONE_EURO_PARAMS* p, GC_ONE_EURO_STATE_F st);
+void GcDspOneEuroResetQ15(GC_STICKS_Q15 s, GC_ONE_EURO_STATE_Q15 st);
+void GcDspOneEuroQ15(GC_STICKS_Q15 s, const GC_ONE_EURO_PARAMS_Q15* p, GC_ONE_EURO_STATE_Q15 st);
+
+/* Scale vectors longer than maxR back onto the circle. */
+void GcDspCircularClampF(GC_STICKS_F s, float maxR);
+void GcDspCircularClampQ15(GC_STICKS_Q15 s, int16_t maxR);
+
+/* Conversions between the two domains (round to nearest, saturating). */
+void GcDspToQ15(const float* in, int16_t* out, size_t count);
+void GcDspFromQ15(const int16_t* in, float* out, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,66 @@
+#pragma once
+
+/* Per-pad safe-mode watchdog (GC-PAR-010).
+
+   Every IOCTL_VPAD_SET_STATE feeds the watchdog. If nothing arrives for
+   TimeoutNs the pad is declared stale: the owner submits a neutral
+   VPAD_STATE exactly once and reports the stale flag until the next feed.
+   Feeding does not touch a timer. The owner runs one one-shot timer: Feed
+   says when to start it, Poll says whether the deadline passed and, if
+   not, when to fire next, so a steady feeder costs one timer expiry per
+   TimeoutNs instead of one per report.
+
+   Pure state machine on caller-supplied nanosecond times (virtual clock
+   in tests). Not thread-safe: the driver serialises Feed, Poll and the
+   submits they gate under one lock, otherwise a neutral report could land
+   after a fresh one. */
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum _GC_WATCHDOG_STATE
+{
+    GC_WATCHDOG_IDLE = 0,   /* disabled or never fed */
+    GC_WATCHDOG_ARMED,      /* fed within the timeout */
+    GC_WATCHDOG_STALE       /* timed out; neutral submitted */
+} GC_WATCHDOG_STATE;
+
+typedef struct _GC_WATCHDOG
+{
+    uint64_t TimeoutNs;      /* 0 = disabled */
+    uint64_t LastFeedNs;
+    uint64_t StaleSinceNs;
+    uint64_t Expirations;    /* ARMED -> STALE transitions */
+    uint64_t Recoveries;     /* STALE -> ARMED transitions */
+    GC_WATCHDOG_STATE State;
+} GC_WATCHDOG, *PGC_WATCHDOG;
+
+void GcWatchdogInit(PGC_WATCHDOG w, uint64_t timeoutNs);
+
+/* Records a fresh state. Returns 1 when the owner must start its timer
+   to fire in TimeoutNs (first feed, or recovery from stale). */
+int GcWatchdogFeed(PGC_WATCHDOG w, uint64_t nowNs);
+
+/* Timer callback. Returns 1 exactly once per stale episode: the caller
+   submits the neutral state. *nextNs is the absolute time to poll again,
+   0 when no timer is needed (idle, disabled or already stale). */
+int GcWatchdogPoll(PGC_WATCHDOG w, uint64_t nowNs, uint64_t* nextNs);
+
+/* Changes the timeout (0 disables and clears a stale flag). Returns 1 when
+   the owner must (re)start its timer to fire in the new TimeoutNs. */
+int GcWatchdogSetTimeout(PGC_WATCHDOG w, uint64_t timeoutNs, uint64_t nowNs);
+
+/* The feeder let go on purpose (IOCTL_VPAD_DESTROY, power-down): back to
+   IDLE without an expiry and with any stale flag cleared. The timeout is
+   kept; the next feed arms again. A timer already pending polls IDLE and
+   does nothing. */
+void GcWatchdogStop(PGC_WATCHDOG w);
+
+int GcWatchdogStale(const GC_WATCHDOG* w);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,91 @@
+#pragma once
+
+/* Native codec for the broker wire protocol (interfaces/wire.json,
+   shared/Contracts/Wire.cs). Frames are little-endian: u32 len (including
+   the 8-byte header), u16 type, u16 flags, payload.
+
+   Pack* write a whole frame and return its length, or 0 if cap is too
+   small. Parsers never read past the given length. */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "gc/LatencyProbe.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define GC_WIRE_HEADER_BYTES 8
+#define GC_WIRE_MAX_FRAME    4096
+
+/* SET_STATE carries a 16-byte GC_TRACE after the state. */
+#define GC_WIRE_FLAG_TRACE   0x0001
+
+typedef enum _GC_MSG
+{
+    GC_MSG_HELLO = 1,
+    GC_MSG_HELLO_OK = 2,
+    GC_MSG_OPEN_CONTROLLER = 10,
+    GC_MSG_OPEN_OK = 11,
+    GC_MSG_SET_STATE = 20,
+    GC_MSG_ACK = 21,
+    GC_MSG_CLOSE_CONTROLLER = 30,
+    GC_MSG_RUMBLE_SUBSCRIBE = 40,
+    GC_MSG_RUMBLE_EVENT = 41,
+    GC_MSG_ERROR = 255
+} GC_MSG;
+
+typedef enum _GC_WIRE_STATUS
+{
+    GC_WIRE_OK = 0,
+    GC_WIRE_NEED_MORE,      /* fewer bytes than the header/declared length */
+    GC_WIRE_BAD_LENGTH,     /* len < header or > GC_WIRE_MAX_FRAME */
+    GC_WIRE_BAD_PAYLOAD     /* payload size does not match the type */
+} GC_WIRE_STATUS;
+
+/* Mirrors GaymController.Shared.Contracts.GamepadState (sticks centred on 32767). */
+typedef struct _GC_GAMEPAD_STATE
+{
+    uint16_t LX, LY, RX, RY;
+    uint16_t LT, RT;
+    uint32_t Buttons;
+} GC_GAMEPAD_STATE, *PGC_GAMEPAD_STATE;
+
+typedef struct _GC_WIRE_FRAME
+{
+    uint32_t Length;
+    uint16_t Type;
+    uint16_t Flags;
+    const uint8_t* Payload;
+    uint32_t PayloadLength;
+} GC_WIRE_FRAME;
+
+typedef struct _GC_WIRE_SET_STATE
+{
+    uint64_t Handle;
+    GC_GAMEPAD_STATE State;
+    int HasTrace;
+    GC_TRACE Trace;
+} GC_WIRE_SET_STATE;
+
+size_t GcWirePackHello(uint8_t* dst, size_t cap);
+size_t GcWirePackHelloOk(uint8_t* dst, size_t cap, uint32_t caps);
+size_t GcWirePackOpenController(uint8_t* dst, size_t cap, uint32_t slot);
+size_t GcWirePackOpenOk(uint8_t* dst, size_t cap, uint64_t handle);
+size_t GcWirePackSetState(uint8_t* dst, size_t cap, uint64_t handle, const GC_GAMEPAD_STATE* state,
+                          const GC_TRACE* trace /* optional */);
+size_t GcWirePackAck(uint8_t* dst, size_t cap, uint32_t echoType);
+size_t GcWirePackCloseController(uint8_t* dst, size_t cap, uint64_t handle);
+size_t GcWirePackRumbleSubscribe(uint8_t* dst, size_t cap, uint64_t handle);
+size_t GcWirePackRumbleEvent(uint8_t* dst, size_t cap, uint64_t handle, uint16_t low, uint16_t high);
+size_t GcWirePackError(uint8_t* dst, size_t cap, uint32_t code, uint32_t detail);
+
+/* Splits the first frame off src. On GC_WIRE_OK, frame->Length bytes were
+   consumed; GC_WIRE_NEED_MORE means wait for more input. */
+GC_WIRE_STATUS GcWireParseFrame(const uint8_t* src, size_t len, GC_WIRE_FRAME* frame);
+GC_WIRE_STATUS GcWireReadSetState(const GC_WIRE_FRAME* frame, GC_WIRE_SET_STATE* out);
+
+#ifdef __cplusplus
+}
+#endif
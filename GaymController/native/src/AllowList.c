@@ -0,0 +1,181 @@
+#include "gc/AllowList.h"
+#include "gc/Atomic.h"
+
+#include <string.h>
+
+/* Set layout, one block: header | Slots[Mask + 1] | Entries[Count].
+   Slots hold a 32-bit hash tag and 1-based entry index (0 = empty) so
+   probing touches 8 bytes per slot and only compares a full entry on a
+   tag match. Load factor stays <= 2/3. */
+typedef struct _GC_ALLOW_SLOT
+{
+    uint32_t Tag;
+    uint32_t Index;
+} GC_ALLOW_SLOT;
+
+struct _GC_ALLOW_SET
+{
+    uint32_t Count;
+    uint32_t Mask;
+    uint32_t Generation;
+    uint32_t Reserved;
+};
+
+static uint32_t Capacity(uint32_t count)
+{
+    uint32_t want = count + count / 2, cap = 8;
+    while (cap < want) cap <<= 1;
+    return cap;
+}
+
+static GC_ALLOW_SLOT* SlotsOf(const GC_ALLOW_SET* s)
+{
+    return (GC_ALLOW_SLOT*)(s + 1);
+}
+
+static GC_ALLOW_ENTRY* EntriesOf(const GC_ALLOW_SET* s)
+{
+    return (GC_ALLOW_ENTRY*)(SlotsOf(s) + s->Mask + 1);
+}
+
+static uint64_t Hash(const uint8_t* digest, uint32_t pid)
+{
+    uint64_t x;
+    memcpy(&x, digest, sizeof(x));
+    x ^= (uint64_t)pid * 0x9E3779B97F4A7C15ull;
+    x ^= x >> 33;
+    x *= 0xFF51AFD7ED558CCDull;
+    x ^= x >> 33;
+    x *= 0xC4CEB9FE1A85EC53ull;
+    x ^= x >> 33;
+    return x;
+}
+
+static int Find(const GC_ALLOW_SET* s, const uint8_t* digest, uint32_t pid)
+{
+    const GC_ALLOW_SLOT* slots = SlotsOf(s);
+    const GC_ALLOW_ENTRY* entries = EntriesOf(s);
+    uint64_t h = Hash(digest, pid);
+    uint32_t tag = (uint32_t)(h >> 32);
+    for (uint32_t i = (uint32_t)h & s->Mask;; i = (i + 1) & s->Mask)
+    {
+        GC_ALLOW_SLOT slot = slots[i];
+        if (slot.Index == 0) return 0;
+        if (slot.Tag == tag)
+        {
+            const GC_ALLOW_ENTRY* e = &entries[slot.Index - 1];
+            if (e->Pid == pid && memcmp(e->Digest, digest, GC_ALLOW_DIGEST_BYTES) == 0) return 1;
+        }
+    }
+}
+
+size_t GcAllowSetBytes(uint32_t count)
+{
+    if (count > GC_ALLOW_MAX_ENTRIES) return 0;
+    return sizeof(GC_ALLOW_SET) + (size_t)Capacity(count) * sizeof(GC_ALLOW_SLOT) +
+           (size_t)count * sizeof(GC_ALLOW_ENTRY);
+}
+
+PGC_ALLOW_SET GcAllowSetBuild(void* mem, size_t bytes, const GC_ALLOW_ENTRY* entries, uint32_t count,
+                              uint32_t generation)
+{
+    size_t need = GcAllowSetBytes(count);
+    if (!mem || need == 0 || bytes < need || ((uintptr_t)mem & 7) != 0) return NULL;
+
+    PGC_ALLOW_SET s = (PGC_ALLOW_SET)mem;
+    s->Count = 0;
+    s->Mask = Capacity(count) - 1;
+    s->Generation = generation;
+    s->Reserved = 0;
+    GC_ALLOW_SLOT* slots = SlotsOf(s);
+    GC_ALLOW_ENTRY* out = EntriesOf(s);
+    memset(slots, 0, (size_t)(s->Mask + 1) * sizeof(GC_ALLOW_SLOT));
+
+    for (uint32_t n = 0; n < count; ++n)
+    {
+        const GC_ALLOW_ENTRY* e = &entries[n];
+        if (Find(s, e->Digest, e->Pid)) continue;
+        uint64_t h = Hash(e->Digest, e->Pid);
+        uint32_t i = (uint32_t)h & s->Mask;
+        while (slots[i].Index != 0) i = (i + 1) & s->Mask;
+        memcpy(out[s->Count].Digest, e->Digest, GC_ALLOW_DIGEST_BYTES);
+        out[s->Count].Pid = e->Pid;
+        out[s->Count].Reserved = 0;
+        slots[i].Tag = (uint32_t)(h >> 32);
+        slots[i].Index = ++s->Count;
+    }
+    return s;
+}
+
+uint32_t GcAllowSetCount(const GC_ALLOW_SET* s)
+{
+    return s->Count;
+}
+
+uint32_t GcAllowSetGeneration(const GC_ALLOW_SET* s)
+{
+    return s->Generation;
+}
+
+int GcAllowSetContains(const GC_ALLOW_SET* s, const uint8_t* digest, uint32_t pid)
+{
+    return Find(s, digest, pid) || (pid != GC_ALLOW_ANY_PID && Find(s, digest, GC_ALLOW_ANY_PID));
+}
+
+void GcAllowListInit(PGC_ALLOW_LIST l)
+{
+    memset((void*)l, 0, sizeof(*l));
+}
+
+/* Reader side of the swap. The counter increment and the recheck of
+   Current are both full barriers, so either Publish sees this reader in
+   the old slot and waits for it, or the reader sees the new Current and
+   moves to the other slot without touching the old set. */
+static volatile uint32_t* Enter(PGC_ALLOW_LIST l, uint32_t pid, uint32_t* slot)
+{
+    uint32_t stripe = (pid >> 2) & (GC_ALLOW_STRIPES - 1);   /* Windows PIDs are multiples of 4 */
+    for (;;)
+    {
+        uint32_t i = GcAtomicLoadU32(&l->Current);
+        volatile uint32_t* readers = &l->Slots[i][stripe].Readers;
+        GcAtomicAddFullU32(readers, 1);
+        if (GcAtomicLoadU32(&l->Current) == i)
+        {
+            *slot = i;
+            return readers;
+        }
+        GcAtomicAddFullU32(readers, (uint32_t)-1);
+    }
+}
+
+int GcAllowListCheck(PGC_ALLOW_LIST l, const uint8_t* digest, uint32_t pid)
+{
+    uint32_t i;
+    volatile uint32_t* readers = Enter(l, pid, &i);
+    const GC_ALLOW_SET* s = l->Sets[i];
+    int allow = s ? GcAllowSetContains(s, digest, pid) : 1;
+    GcAtomicAddFullU32(readers, (uint32_t)-1);
+    return allow;
+}
+
+uint32_t GcAllowListGeneration(PGC_ALLOW_LIST l)
+{
+    uint32_t i;
+    volatile uint32_t* readers = Enter(l, 0, &i);
+    const GC_ALLOW_SET* s = l->Sets[i];
+    uint32_t gen = s ? s->Generation : 0;
+    GcAtomicAddFullU32(readers, (uint32_t)-1);
+    return gen;
+}
+
+PGC_ALLOW_SET GcAllowListPublish(PGC_ALLOW_LIST l, PGC_ALLOW_SET s)
+{
+    uint32_t cur = l->Current, next = cur ^ 1;
+    l->Sets[next] = s;
+    GcAtomicExchangeU32(&l->Current, next);
+    for (uint32_t k = 0; k < GC_ALLOW_STRIPES; ++k)
+        while (GcAtomicLoadU32(&l->Slots[cur][k].Readers) != 0) GcCpuRelax();
+    PGC_ALLOW_SET old = l->Sets[cur];
+    l->Sets[cur] = NULL;
+    return old;
+}
@@ -0,0 +1,454 @@
+#include "gc/AnalogHistory.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#if !defined(GC_DSP_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define GC_HISTORY_SSE2 1
+#include <emmintrin.h>
+#else
+#define GC_HISTORY_SSE2 0
+#endif
+
+/* Key-block coding, prev starts at 0 for every block:
+     0x00..0x7F  repeat prev (t + 1) times
+     0x80..0xBF  prev += t - 0xA0            (delta -32..31)
+     0xC0..0xDA  three deltas in {-1, 0, 1}  (t - 0xC0 in base 3, first delta lowest)
+     0xFF v      literal
+   Worst case is two bytes per sample. */
+#define TOK_DELTA   0x80
+#define TOK_DELTA0  0xA0
+#define TOK_TRIPLE  0xC0
+#define TOK_LITERAL 0xFF
+
+typedef struct _GC_KEY_BLOCK
+{
+    uint32_t Offset;    /* physical offset in Data */
+    uint16_t Length;
+    uint8_t  Min, Max, First, Last;
+    uint16_t Reserved;
+    uint32_t Sum;
+} GC_KEY_BLOCK;
+
+typedef struct _GC_BLOCK_SPAN
+{
+    uint64_t Start;     /* absolute Data positions */
+    uint64_t End;
+} GC_BLOCK_SPAN;
+
+struct _GC_HISTORY
+{
+    GC_HISTORY_CONFIG Cfg;
+    uint64_t Frames;
+    uint64_t OldestBlock;   /* blocks [OldestBlock, CodedBlocks) are coded */
+    uint64_t CodedBlocks;   /* block CodedBlocks onwards is raw */
+    uint32_t SealKey;       /* next key to code in block CodedBlocks */
+    uint32_t KeysPerStep;
+    uint64_t Head;          /* absolute write position in Data */
+    uint8_t* Raw[2];        /* key-major: Raw[block & 1][key * FramesPerBlock + pos] */
+    uint8_t* Tile;          /* frame-major: last Frames % 16 frames, not yet in Raw */
+    uint8_t* Data;
+    GC_KEY_BLOCK* Blocks;   /* [slot * Keys + key] */
+    GC_BLOCK_SPAN* Spans;   /* [slot] */
+};
+
+static inline uint32_t PopCount32(uint32_t v)
+{
+    v = v - ((v >> 1) & 0x55555555u);
+    v = (v & 0x33333333u) + ((v >> 2) & 0x33333333u);
+    return (((v + (v >> 4)) & 0x0F0F0F0Fu) * 0x01010101u) >> 24;
+}
+
+/* ---- transpose ---------------------------------------------------------- */
+
+/* Moves TILE frames of every key from the frame-major tile into the key-major
+   raw rows. Scattering each Append straight into K rows a block apart costs
+   one cache set conflict per key; a 16x16 byte transpose writes 16 bytes
+   per key once every 16 frames instead. */
+#define TILE 16
+
+static void FlushTile(const uint8_t* tile, uint32_t keys, uint8_t* raw, uint32_t stride)
+{
+    uint32_t k = 0;
+#if GC_HISTORY_SSE2
+    for (; k + 16 <= keys; k += 16)
+    {
+        __m128i r[16], t[16];
+        for (int i = 0; i < 16; ++i) r[i] = _mm_loadu_si128((const __m128i*)(tile + (size_t)i * keys + k));
+        for (int i = 0; i < 8; ++i)
+        {
+            t[i] = _mm_unpacklo_epi8(r[2 * i], r[2 * i + 1]);
+            t[i + 8] = _mm_unpackhi_epi8(r[2 * i], r[2 * i + 1]);
+        }
+        for (int i = 0; i < 8; ++i)
+        {
+            r[i] = _mm_unpacklo_epi16(t[2 * i], t[2 * i + 1]);
+            r[i + 8] = _mm_unpackhi_epi16(t[2 * i], t[2 * i + 1]);
+        }
+        for (int i = 0; i < 8; ++i)
+        {
+            t[i] = _mm_unpacklo_epi32(r[2 * i], r[2 * i + 1]);
+            t[i + 8] = _mm_unpackhi_epi32(r[2 * i], r[2 * i + 1]);
+        }
+        for (int i = 0; i < 8; ++i)
+        {
+            r[i] = _mm_unpacklo_epi64(t[2 * i], t[2 * i + 1]);
+            r[i + 8] = _mm_unpackhi_epi64(t[2 * i], t[2 * i + 1]);
+        }
+        /* After four interleave rounds lane j of the output order is the
+           bit-reversal of key j. */
+        static const uint8_t rev[16] = {0, 8, 4, 12, 2, 10, 6, 14, 1, 9, 5, 13, 3, 11, 7, 15};
+        for (int i = 0; i < 16; ++i) _mm_storeu_si128((__m128i*)(raw + (size_t)(k + rev[i]) * stride), r[i]);
+    }
+#endif
+    for (; k < keys; ++k)
+        for (uint32_t i = 0; i < TILE; ++i) raw[(size_t)k * stride + i] = tile[(size_t)i * keys + k];
+}
+
+/* ---- coding ------------------------------------------------------------- */
+
+/* Length of the run of value at v[0..limit). Idle keys are all runs, so this
+   is where the append path spends its time. */
+static uint32_t RunLength(const uint8_t* v, uint32_t limit, int value)
+{
+    uint32_t n = 0;
+#if GC_HISTORY_SSE2
+    __m128i vv = _mm_set1_epi8((char)value);
+    for (; n + 16 <= limit; n += 16)
+    {
+        uint32_t ne = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)(v + n)), vv)) ^ 0xFFFFu;
+        if (ne)
+        {
+            while (!(ne & 1)) { ne >>= 1; ++n; }
+            return n;
+        }
+    }
+#endif
+    while (n < limit && v[n] == value) ++n;
+    return n;
+}
+
+static uint32_t EncodeRow(const uint8_t* v, uint32_t n, uint8_t* out)
+{
+    uint8_t* o = out;
+    int prev = 0;
+    uint32_t i = 0;
+    while (i < n)
+    {
+        uint32_t run = RunLength(v + i, n - i < 128 ? n - i : 128, prev);
+        if (run >= 3) { *o++ = (uint8_t)(run - 1); i += run; continue; }
+        if (i + 3 <= n)
+        {
+            int d0 = v[i] - prev, d1 = v[i + 1] - v[i], d2 = v[i + 2] - v[i + 1];
+            if ((unsigned)(d0 + 1) <= 2 && (unsigned)(d1 + 1) <= 2 && (unsigned)(d2 + 1) <= 2)
+            {
+                *o++ = (uint8_t)(TOK_TRIPLE + (d0 + 1) + 3 * (d1 + 1) + 9 * (d2 + 1));
+                prev = v[i + 2];
+                i += 3;
+                continue;
+            }
+        }
+        if (run > 0) { *o++ = (uint8_t)(run - 1); i += run; continue; }
+        int d = v[i] - prev;
+        if (d >= -32 && d <= 31) *o++ = (uint8_t)(TOK_DELTA0 + d);
+        else { *o++ = TOK_LITERAL; *o++ = v[i]; }
+        prev = v[i++];
+    }
+    return (uint32_t)(o - out);
+}
+
+/* Decodes the first n samples of a key-block. */
+static void DecodeRow(const uint8_t* in, uint32_t n, uint8_t* out)
+{
+    int prev = 0;
+    uint32_t i = 0;
+    while (i < n)
+    {
+        uint32_t t = *in++;
+        if (t < TOK_DELTA)
+        {
+            uint32_t r = t + 1 < n - i ? t + 1 : n - i;
+            memset(out + i, prev, r);
+            i += r;
+        }
+        else if (t < TOK_TRIPLE)
+        {
+            prev += (int)t - TOK_DELTA0;
+            out[i++] = (uint8_t)prev;
+        }
+        else if (t < TOK_LITERAL)
+        {
+            uint32_t c = t - TOK_TRIPLE;
+            for (int k = 0; k < 3 && i < n; ++k, c /= 3)
+            {
+                prev += (int)(c % 3) - 1;
+                out[i++] = (uint8_t)prev;
+            }
+        }
+        else
+        {
+            prev = *in++;
+            out[i++] = (uint8_t)prev;
+        }
+    }
+}
+
+/* ---- scans -------------------------------------------------------------- */
+
+static void ScanMinMaxSum(const uint8_t* p, uint32_t n, uint8_t* mnOut, uint8_t* mxOut, uint64_t* sumOut)
+{
+    uint32_t mn = 255, mx = 0, i = 0;
+    uint64_t sum = 0;
+#if GC_HISTORY_SSE2
+    if (n >= 16)
+    {
+        __m128i zero = _mm_setzero_si128();
+        __m128i vmin = _mm_set1_epi8((char)0xFF), vmax = zero, vsum = zero;
+        for (; i + 16 <= n; i += 16)
+        {
+            __m128i v = _mm_loadu_si128((const __m128i*)(p + i));
+            vmin = _mm_min_epu8(vmin, v);
+            vmax = _mm_max_epu8(vmax, v);
+            vsum = _mm_add_epi64(vsum, _mm_sad_epu8(v, zero));
+        }
+        uint8_t lo[16], hi[16];
+        _mm_storeu_si128((__m128i*)lo, vmin);
+        _mm_storeu_si128((__m128i*)hi, vmax);
+        for (int k = 0; k < 16; ++k)
+        {
+            if (lo[k] < mn) mn = lo[k];
+            if (hi[k] > mx) mx = hi[k];
+        }
+        sum = (uint64_t)_mm_cvtsi128_si32(vsum) + (uint64_t)_mm_cvtsi128_si32(_mm_srli_si128(vsum, 8));
+    }
+#endif
+    for (; i < n; ++i)
+    {
+        if (p[i] < mn) mn = p[i];
+        if (p[i] > mx) mx = p[i];
+        sum += p[i];
+    }
+    *mnOut = (uint8_t)mn;
+    *mxOut = (uint8_t)mx;
+    *sumOut = sum;
+}
+
+/* Transitions across thr inside p[0..n), i.e. between p[j-1] and p[j]. */
+static uint32_t ScanCrossings(const uint8_t* p, uint32_t n, uint8_t thr)
+{
+    uint32_t cross = 0, j = 1;
+#if GC_HISTORY_SSE2
+    __m128i vthr = _mm_set1_epi8((char)thr);
+    for (; j + 16 <= n; j += 16)
+    {
+        __m128i a = _mm_loadu_si128((const __m128i*)(p + j));
+        __m128i b = _mm_loadu_si128((const __m128i*)(p + j - 1));
+        __m128i ma = _mm_cmpeq_epi8(_mm_max_epu8(a, vthr), a);
+        __m128i mb = _mm_cmpeq_epi8(_mm_max_epu8(b, vthr), b);
+        cross += PopCount32((uint32_t)_mm_movemask_epi8(_mm_xor_si128(ma, mb)));
+    }
+#endif
+    for (; j < n; ++j) cross += (p[j] >= thr) != (p[j - 1] >= thr);
+    return cross;
+}
+
+static void Accumulate(const uint8_t* p, uint32_t n, uint8_t thr, int* prevAbove, GC_HISTORY_STATS* st)
+{
+    uint8_t mn, mx;
+    uint64_t sum;
+    ScanMinMaxSum(p, n, &mn, &mx, &sum);
+    if (mn < st->Min) st->Min = mn;
+    if (mx > st->Max) st->Max = mx;
+    st->Sum += sum;
+    st->Count += n;
+    int firstAbove = p[0] >= thr;
+    if (*prevAbove >= 0 && *prevAbove != firstAbove) st->Crossings++;
+    st->Crossings += ScanCrossings(p, n, thr);
+    *prevAbove = p[n - 1] >= thr;
+}
+
+/* ---- store -------------------------------------------------------------- */
+
+PGC_HISTORY GcHistoryCreate(const GC_HISTORY_CONFIG* cfg)
+{
+    uint32_t B = cfg->FramesPerBlock, K = cfg->Keys;
+    if (K == 0 || B < 64 || B > GC_HISTORY_MAX_BLOCK || (B % 16) != 0 || cfg->MaxBlocks == 0) return NULL;
+    if ((uint64_t)cfg->DataBytes < 2ull * B * (K + 1ull)) return NULL;
+
+    PGC_HISTORY h = (PGC_HISTORY)calloc(1, sizeof(*h));
+    if (!h) return NULL;
+    h->Cfg = *cfg;
+    h->KeysPerStep = (K + B - 1) / B;
+    h->Raw[0] = (uint8_t*)malloc((size_t)B * K);
+    h->Raw[1] = (uint8_t*)malloc((size_t)B * K);
+    h->Tile = (uint8_t*)malloc((size_t)TILE * K);
+    h->Data = (uint8_t*)malloc(cfg->DataBytes);
+    h->Blocks = (GC_KEY_BLOCK*)calloc((size_t)cfg->MaxBlocks * K, sizeof(GC_KEY_BLOCK));
+    h->Spans = (GC_BLOCK_SPAN*)calloc(cfg->MaxBlocks, sizeof(GC_BLOCK_SPAN));
+    if (!h->Raw[0] || !h->Raw[1] || !h->Tile || !h->Data || !h->Blocks || !h->Spans)
+    {
+        GcHistoryDestroy(h);
+        return NULL;
+    }
+    return h;
+}
+
+void GcHistoryDestroy(PGC_HISTORY h)
+{
+    if (!h) return;
+    free(h->Raw[0]);
+    free(h->Raw[1]);
+    free(h->Tile);
+    free(h->Data);
+    free(h->Blocks);
+    free(h->Spans);
+    free(h);
+}
+
+static void CodeKey(PGC_HISTORY h, uint64_t block, uint32_t key)
+{
+    const uint32_t B = h->Cfg.FramesPerBlock, K = h->Cfg.Keys, R = h->Cfg.DataBytes;
+    uint32_t slot = (uint32_t)(block % h->Cfg.MaxBlocks);
+
+    if (key == 0 && block - h->OldestBlock >= h->Cfg.MaxBlocks)
+        h->OldestBlock = block - h->Cfg.MaxBlocks + 1;
+
+    /* Reserve a worst-case contiguous run; skip the ring tail if short. */
+    uint32_t phys = (uint32_t)(h->Head % R);
+    if (R - phys < 2 * B) { h->Head += R - phys; phys = 0; }
+    while (h->OldestBlock < h->CodedBlocks &&
+           h->Head + 2 * B - h->Spans[h->OldestBlock % h->Cfg.MaxBlocks].Start > R)
+        h->OldestBlock++;
+    if (key == 0) h->Spans[slot].Start = h->Head;
+
+    const uint8_t* row = h->Raw[block & 1] + (size_t)key * B;
+    GC_KEY_BLOCK* kb = &h->Blocks[(size_t)slot * K + key];
+    uint64_t sum;
+    ScanMinMaxSum(row, B, &kb->Min, &kb->Max, &sum);
+    kb->Sum = (uint32_t)sum;
+    kb->First = row[0];
+    kb->Last = row[B - 1];
+    kb->Offset = phys;
+    kb->Length = (uint16_t)EncodeRow(row, B, h->Data + phys);
+    h->Head += kb->Length;
+    h->Spans[slot].End = h->Head;
+}
+
+void GcHistoryAppend(PGC_HISTORY h, const uint8_t* frame)
+{
+    const uint32_t B = h->Cfg.FramesPerBlock, K = h->Cfg.Keys;
+    uint64_t block = h->Frames / B;
+    memcpy(h->Tile + (size_t)(h->Frames % TILE) * K, frame, K);
+    if (++h->Frames % TILE == 0)
+        FlushTile(h->Tile, K, h->Raw[block & 1] + (h->Frames - TILE) % B, B);
+
+    /* The previous block is coded a few keys per frame, always finishing
+       before its raw buffer is reused two blocks later. */
+    for (uint32_t n = 0; n < h->KeysPerStep && h->CodedBlocks < block; ++n)
+    {
+        CodeKey(h, h->CodedBlocks, h->SealKey);
+        if (++h->SealKey == K) { h->SealKey = 0; h->CodedBlocks++; }
+    }
+}
+
+uint64_t GcHistoryFrames(const GC_HISTORY* h) { return h->Frames; }
+
+uint64_t GcHistoryOldestFrame(const GC_HISTORY* h) { return h->OldestBlock * h->Cfg.FramesPerBlock; }
+
+size_t GcHistoryMemoryBytes(const GC_HISTORY* h)
+{
+    const GC_HISTORY_CONFIG* c = &h->Cfg;
+    return sizeof(*h) + (2 * (size_t)c->FramesPerBlock + TILE) * c->Keys + c->DataBytes +
+           (size_t)c->MaxBlocks * (c->Keys * sizeof(GC_KEY_BLOCK) + sizeof(GC_BLOCK_SPAN));
+}
+
+size_t GcHistoryCodedBytes(const GC_HISTORY* h)
+{
+    uint64_t start = h->Head;
+    if (h->OldestBlock < h->CodedBlocks) start = h->Spans[h->OldestBlock % h->Cfg.MaxBlocks].Start;
+    else if (h->SealKey > 0) start = h->Spans[h->CodedBlocks % h->Cfg.MaxBlocks].Start;
+    return (size_t)(h->Head - start);
+}
+
+/* Materialises samples [s, e) of one key-block into buf; returns the pointer to sample s. */
+static const uint8_t* BlockSamples(const GC_HISTORY* h, uint64_t block, uint32_t key, uint32_t s, uint32_t e,
+                                   uint8_t* buf)
+{
+    if (block < h->CodedBlocks)
+    {
+        const GC_KEY_BLOCK* kb = &h->Blocks[(size_t)(block % h->Cfg.MaxBlocks) * h->Cfg.Keys + key];
+        DecodeRow(h->Data + kb->Offset, e, buf);
+        return buf + s;
+    }
+    const uint32_t B = h->Cfg.FramesPerBlock;
+    const uint8_t* raw = h->Raw[block & 1] + (size_t)key * B;
+    uint64_t tileStart = h->Frames - h->Frames % TILE;
+    if (block * B + e <= tileStart) return raw + s;
+
+    /* Window reaches into the frames still in the tile. */
+    uint32_t t = (uint32_t)(tileStart - block * B);
+    for (uint32_t i = s; i < e; ++i) buf[i] = i < t ? raw[i] : h->Tile[(size_t)(i - t) * h->Cfg.Keys + key];
+    return buf + s;
+}
+
+static int ClampWindow(const GC_HISTORY* h, uint32_t key, uint64_t* first, uint64_t* end)
+{
+    uint64_t oldest = GcHistoryOldestFrame(h);
+    if (key >= h->Cfg.Keys) return 0;
+    if (*first < oldest) *first = oldest;
+    if (*end > h->Frames) *end = h->Frames;
+    return *first < *end;
+}
+
+int GcHistoryQuery(const GC_HISTORY* h, uint32_t key, uint64_t first, uint64_t end,
+                   uint8_t threshold, GC_HISTORY_STATS* out)
+{
+    const uint32_t B = h->Cfg.FramesPerBlock;
+    memset(out, 0, sizeof(*out));
+    if (!ClampWindow(h, key, &first, &end)) return 0;
+    out->Min = 255;
+
+    uint8_t buf[GC_HISTORY_MAX_BLOCK];
+    int prevAbove = -1;
+    for (uint64_t b = first / B; b * B < end; ++b)
+    {
+        uint64_t base = b * B;
+        uint32_t s = first > base ? (uint32_t)(first - base) : 0;
+        uint32_t e = end - base < B ? (uint32_t)(end - base) : B;
+        if (b < h->CodedBlocks && s == 0 && e == B)
+        {
+            const GC_KEY_BLOCK* kb = &h->Blocks[(size_t)(b % h->Cfg.MaxBlocks) * h->Cfg.Keys + key];
+            if (threshold <= kb->Min || threshold > kb->Max)
+            {
+                /* Whole block on one side of the threshold: summary only. */
+                int above = kb->First >= threshold;
+                if (prevAbove >= 0 && prevAbove != above) out->Crossings++;
+                prevAbove = above;
+                if (kb->Min < out->Min) out->Min = kb->Min;
+                if (kb->Max > out->Max) out->Max = kb->Max;
+                out->Sum += kb->Sum;
+                out->Count += B;
+                continue;
+            }
+        }
+        Accumulate(BlockSamples(h, b, key, s, e, buf), e - s, threshold, &prevAbove, out);
+    }
+    return 1;
+}
+
+size_t GcHistoryRead(const GC_HISTORY* h, uint32_t key, uint64_t first, uint64_t end, uint8_t* out)
+{
+    const uint32_t B = h->Cfg.FramesPerBlock;
+    if (!ClampWindow(h, key, &first, &end)) return 0;
+    uint8_t buf[GC_HISTORY_MAX_BLOCK];
+    size_t n = 0;
+    for (uint64_t b = first / B; b * B < end; ++b)
+    {
+        uint64_t base = b * B;
+        uint32_t s = first > base ? (uint32_t)(first - base) : 0;
+        uint32_t e = end - base < B ? (uint32_t)(end - base) : B;
+        memcpy(out + n, BlockSamples(h, b, key, s, e, buf), e - s);
+        n += e - s;
+    }
+    return n;
+}
@@ -0,0 +1,384 @@
+#include "gc/Bindings.h"
+
+#include <algorithm>
+#include <map>
+
+#include "gc/Atomic.h"
+
+namespace gc::bind {
+
+namespace {
+
+// Subset enumeration covers up to this many held partner keys (2^n
+// lookups); more than that falls back to the per-key candidate list.
+constexpr uint32_t kMaxSubsetKeys = 8;
+
+inline uint64_t Mix(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+inline int PopCount(uint64_t v) {
+    int n = 0;
+    for (; v; v &= v - 1) n++;
+    return n;
+}
+
+inline int LowBit(uint64_t v) {
+    return GcHighBitU64(v & (~v + 1));
+}
+
+size_t TableSize(size_t entries) {
+    size_t n = 16;
+    while (n < entries * 2) n <<= 1;
+    return n;
+}
+
+} // namespace
+
+const char* StatusName(CompileStatus s) {
+    switch (s) {
+    case CompileStatus::Ok: return "Ok";
+    case CompileStatus::NoKeys: return "NoKeys";
+    case CompileStatus::TooManyKeys: return "TooManyKeys";
+    case CompileStatus::DuplicateKey: return "DuplicateKey";
+    case CompileStatus::TooManyBindings: return "TooManyBindings";
+    }
+    return "?";
+}
+
+// ---- compiler --------------------------------------------------------------
+
+CompileStatus Program::Compile(const std::vector<Binding>& bindings, uint32_t sequenceGapUs, uint32_t* bad) {
+    *this = Program();
+    auto fail = [&](CompileStatus s, size_t i) {
+        *this = Program();
+        if (bad) *bad = uint32_t(i);
+        return s;
+    };
+    if (bindings.size() > kMaxBindings) return fail(CompileStatus::TooManyBindings, kMaxBindings);
+
+    SequenceGapUs = sequenceGapUs;
+    Partners.assign(256, Mask{});
+    size_t chords = 0;
+    // Sequence trie: children by (node, key), built with a map, flattened below.
+    std::map<std::pair<uint32_t, uint8_t>, uint32_t> children;
+    std::vector<uint32_t> own(1, kNone);
+
+    for (size_t i = 0; i < bindings.size(); ++i) {
+        const Binding& b = bindings[i];
+        Trigger t{};
+        t.Type = b.Type;
+        t.Action = b.Action;
+        t.HoldAction = b.HoldAction;
+        t.HoldUs = b.HoldUs;
+        if (b.Keys.empty()) return fail(CompileStatus::NoKeys, i);
+
+        if (b.Type == Kind::Sequence) {
+            if (b.Keys.size() > kMaxSequenceKeys) return fail(CompileStatus::TooManyKeys, i);
+            uint32_t node = 0;
+            for (uint8_t k : b.Keys) {
+                auto it = children.find({node, k});
+                if (it == children.end()) {
+                    it = children.emplace(std::make_pair(node, k), uint32_t(own.size())).first;
+                    own.push_back(kNone);
+                }
+                node = it->second;
+            }
+            if (own[node] == kNone) own[node] = uint32_t(i);   // first declared wins
+        } else {
+            if (b.Keys.size() > kMaxChordKeys) return fail(CompileStatus::TooManyKeys, i);
+            for (uint8_t k : b.Keys) {
+                uint64_t bit = 1ull << (k & 63);
+                if (t.Keys.W[k >> 6] & bit) return fail(CompileStatus::DuplicateKey, i);
+                t.Keys.W[k >> 6] |= bit;
+            }
+            t.KeyCount = uint8_t(b.Keys.size());
+            for (uint8_t k : b.Keys)
+                for (int w = 0; w < 4; ++w) Partners[k].W[w] |= t.Keys.W[w];
+            chords++;
+        }
+        Triggers.push_back(t);
+    }
+    for (int k = 0; k < 256; ++k) Partners[k].W[k >> 6] &= ~(1ull << (k & 63));
+
+    // Chord set: identical key sets keep the lowest index.
+    Chords.assign(TableSize(chords), ChordSlot{Mask{}, kNone});
+    std::vector<std::vector<uint32_t>> byKey(256);
+    for (uint32_t i = 0; i < Triggers.size(); ++i) {
+        const Trigger& t = Triggers[i];
+        if (!t.KeyCount) continue;
+        size_t mask = Chords.size() - 1;
+        for (size_t s = Mix(t.Keys.W[0] ^ Mix(t.Keys.W[1] ^ Mix(t.Keys.W[2] ^ Mix(t.Keys.W[3])))) & mask;;
+             s = (s + 1) & mask) {
+            ChordSlot& slot = Chords[s];
+            if (slot.Binding == kNone) {
+                slot = {t.Keys, i};
+                break;
+            }
+            if (std::equal(slot.Keys.W, slot.Keys.W + 4, t.Keys.W)) break;
+        }
+        for (const uint8_t k : bindings[i].Keys) byKey[k].push_back(i);
+    }
+    ByKeyStart.assign(257, 0);
+    for (int k = 0; k < 256; ++k) {
+        auto& v = byKey[k];
+        std::stable_sort(v.begin(), v.end(),
+                         [&](uint32_t a, uint32_t b) { return Triggers[a].KeyCount > Triggers[b].KeyCount; });
+        ByKey.insert(ByKey.end(), v.begin(), v.end());
+        ByKeyStart[k + 1] = uint32_t(ByKey.size());
+    }
+
+    // Sequence automaton: goto edges, failure links by BFS, and each node's
+    // output is its own sequence or else the longest one ending at a suffix.
+    Nodes.assign(own.size(), Node{0, kNone, true});
+    Edges.assign(TableSize(children.size()), Edge{0, 0, 0});
+    std::vector<std::vector<std::pair<uint8_t, uint32_t>>> kids(own.size());
+    for (const auto& [from, to] : children) {
+        kids[from.first].push_back({from.second, to});
+        Nodes[from.first].Leaf = false;
+        size_t mask = Edges.size() - 1;
+        size_t s = Mix(uint64_t(from.first) << 8 | from.second) & mask;
+        while (Edges[s].From) s = (s + 1) & mask;
+        Edges[s] = {from.first + 1, to, from.second};
+    }
+    std::vector<uint32_t> queue(1, 0);
+    for (size_t q = 0; q < queue.size(); ++q) {
+        uint32_t n = queue[q];
+        Nodes[n].Output = own[n] != kNone ? own[n] : n ? Nodes[Nodes[n].Fail].Output : kNone;
+        for (const auto& [k, child] : kids[n]) {
+            Nodes[child].Fail = n ? Step(Nodes[n].Fail, k) : 0;
+            queue.push_back(child);
+        }
+    }
+    return CompileStatus::Ok;
+}
+
+uint32_t Program::FindChord(const Mask& m) const {
+    size_t mask = Chords.size() - 1;
+    for (size_t s = Mix(m.W[0] ^ Mix(m.W[1] ^ Mix(m.W[2] ^ Mix(m.W[3])))) & mask;; s = (s + 1) & mask) {
+        const ChordSlot& slot = Chords[s];
+        if (slot.Binding == kNone) return kNone;
+        if (slot.Keys.W[0] == m.W[0] && slot.Keys.W[1] == m.W[1] && slot.Keys.W[2] == m.W[2] &&
+            slot.Keys.W[3] == m.W[3])
+            return slot.Binding;
+    }
+}
+
+uint32_t Program::Child(uint32_t node, uint8_t key) const {
+    if (Edges.empty()) return kNone;
+    size_t mask = Edges.size() - 1;
+    for (size_t s = Mix(uint64_t(node) << 8 | key) & mask; Edges[s].From; s = (s + 1) & mask)
+        if (Edges[s].From == node + 1 && Edges[s].Key == key) return Edges[s].To;
+    return kNone;
+}
+
+uint32_t Program::Step(uint32_t node, uint8_t key) const {
+    for (;;) {
+        uint32_t to = Child(node, key);
+        if (to != kNone) return to;
+        if (node == 0) return 0;
+        node = Nodes[node].Fail;
+    }
+}
+
+// ---- matcher ---------------------------------------------------------------
+
+Matcher::Matcher(const Program& program) : P(program), IsActive(program.Count(), 0) {
+    Actives.reserve(64);
+}
+
+void Matcher::Reset() {
+    std::fill(Prev, Prev + 4, 0);
+    Actives.clear();
+    IsActive.assign(P.Count(), 0);   // the program may have been recompiled
+    std::fill(Held, Held + 256, 0);
+    std::fill(Latched, Latched + 4, 0);
+    SeqNode = 0;
+    SeqPending = kNone;
+    SeqLastUs = 0;
+}
+
+void Matcher::Emit(std::vector<Event>& out, uint32_t binding, uint8_t action, bool down) {
+    out.push_back({binding, action, down});
+}
+
+void Matcher::FireSequence(uint32_t binding, std::vector<Event>& out) {
+    uint8_t action = P.Triggers[binding].Action;
+    Emit(out, binding, action, true);
+    Emit(out, binding, action, false);
+    SeqPending = kNone;
+    SeqNode = 0;   // a completed sequence starts over
+}
+
+void Matcher::Evaluate(const uint64_t (&pressed)[4], uint64_t nowUs, std::vector<Event>& out) {
+    out.clear();
+    if (SeqNode && nowUs - SeqLastUs > P.SequenceGapUs) {
+        // Too slow for anything longer: a held-back prefix fires now.
+        if (SeqPending != kNone) FireSequence(SeqPending, out);
+        SeqNode = 0;
+    }
+    for (Active& a : Actives) {
+        if (!a.Pending || nowUs < a.DeadlineUs) continue;
+        a.Pending = false;   // held long enough: the hold action starts
+        const auto& t = P.Triggers[a.Binding];
+        Held[t.HoldAction]++;
+        Emit(out, a.Binding, t.HoldAction, true);
+    }
+    for (int w = 0; w < 4; ++w)
+        for (uint64_t up = Prev[w] & ~pressed[w]; up; up &= up - 1) Release(uint8_t(w * 64 + LowBit(up)), out);
+    for (int w = 0; w < 4; ++w)
+        for (uint64_t down = pressed[w] & ~Prev[w]; down; down &= down - 1)
+            Press(uint8_t(w * 64 + LowBit(down)), pressed, nowUs, out);
+    std::copy(pressed, pressed + 4, Prev);
+}
+
+void Matcher::Release(uint8_t key, std::vector<Event>& out) {
+    uint64_t bit = 1ull << (key & 63);
+    for (size_t i = 0; i < Actives.size();) {
+        const Active a = Actives[i];
+        const auto& t = P.Triggers[a.Binding];
+        if (!(t.Keys.W[key >> 6] & bit)) {
+            ++i;
+            continue;
+        }
+        switch (t.Type) {
+        case Kind::Hold:
+            Held[t.Action]--;
+            Emit(out, a.Binding, t.Action, false);
+            break;
+        case Kind::TapHold:
+            if (a.Swallowed) break;
+            if (a.Pending) {
+                Emit(out, a.Binding, t.Action, true);
+                Emit(out, a.Binding, t.Action, false);
+            } else {
+                Held[t.HoldAction]--;
+                Emit(out, a.Binding, t.HoldAction, false);
+            }
+            break;
+        default:
+            break;
+        }
+        IsActive[a.Binding] = 0;
+        Actives.erase(Actives.begin() + i);   // keep activation order for determinism
+    }
+}
+
+void Matcher::Press(uint8_t key, const uint64_t (&pressed)[4], uint64_t nowUs, std::vector<Event>& out) {
+    if (P.Nodes.size() > 1) {
+        SeqLastUs = nowUs;
+        uint32_t next = P.Child(SeqNode, key);
+        if (next == kNone) {
+            // Not extending: a held-back prefix was the longest match.
+            if (SeqPending != kNone) FireSequence(SeqPending, out);
+            next = P.Step(SeqNode, key);
+        }
+        SeqNode = next;
+        uint32_t hit = P.Nodes[SeqNode].Output;
+        if (hit != kNone) {
+            if (P.Nodes[SeqNode].Leaf)
+                FireSequence(hit, out);
+            else
+                SeqPending = hit;   // a longer sequence may still follow
+        }
+    }
+    uint32_t best = BestChord(key, pressed);
+    if (best != kNone && !IsActive[best]) Activate(best, nowUs, out);
+}
+
+uint32_t Matcher::BestChord(uint8_t key, const uint64_t (&pressed)[4]) const {
+    if (P.Chords.empty()) return kNone;
+    const Program::Mask& partners = P.Partners[key];
+    uint8_t held[kMaxSubsetKeys];
+    uint32_t n = 0;
+    for (int w = 0; w < 4; ++w) {
+        for (uint64_t m = partners.W[w] & pressed[w]; m; m &= m - 1) {
+            if (n == kMaxSubsetKeys) {
+                // Unusually many related keys down: walk the candidate list.
+                for (uint32_t i = P.ByKeyStart[key]; i < P.ByKeyStart[key + 1]; ++i) {
+                    const auto& t = P.Triggers[P.ByKey[i]];
+                    if ((t.Keys.W[0] & ~pressed[0]) == 0 && (t.Keys.W[1] & ~pressed[1]) == 0 &&
+                        (t.Keys.W[2] & ~pressed[2]) == 0 && (t.Keys.W[3] & ~pressed[3]) == 0)
+                        return P.ByKey[i];
+                }
+                return kNone;
+            }
+            held[n++] = uint8_t(w * 64 + LowBit(m));
+        }
+    }
+    uint32_t best = kNone;
+    int bestKeys = 0;
+    for (uint32_t sub = 0; sub < (1u << n); ++sub) {
+        int keys = PopCount(sub) + 1;
+        if (keys < bestKeys || keys > int(kMaxChordKeys)) continue;
+        Program::Mask m{};
+        m.W[key >> 6] = 1ull << (key & 63);
+        for (uint32_t s = sub; s; s &= s - 1) {
+            uint8_t k = held[LowBit(s)];
+            m.W[k >> 6] |= 1ull << (k & 63);
+        }
+        uint32_t b = P.FindChord(m);
+        if (b != kNone && (keys > bestKeys || b < best)) {
+            best = b;
+            bestKeys = keys;
+        }
+    }
+    return best;
+}
+
+void Matcher::Activate(uint32_t binding, uint64_t nowUs, std::vector<Event>& out) {
+    const auto& t = P.Triggers[binding];
+    // A pending tap/hold whose keys are all part of this chord was only a
+    // modifier for it: it neither taps nor holds.
+    for (Active& a : Actives) {
+        const auto& o = P.Triggers[a.Binding];
+        if (a.Pending && (o.Keys.W[0] & ~t.Keys.W[0]) == 0 && (o.Keys.W[1] & ~t.Keys.W[1]) == 0 &&
+            (o.Keys.W[2] & ~t.Keys.W[2]) == 0 && (o.Keys.W[3] & ~t.Keys.W[3]) == 0) {
+            a.Pending = false;
+            a.Swallowed = true;
+        }
+    }
+    Active a{binding, false, false, 0};
+    switch (t.Type) {
+    case Kind::Hold:
+        Held[t.Action]++;
+        Emit(out, binding, t.Action, true);
+        break;
+    case Kind::Toggle: {
+        uint64_t bit = 1ull << (t.Action & 63);
+        Latched[t.Action >> 6] ^= bit;
+        Emit(out, binding, t.Action, (Latched[t.Action >> 6] & bit) != 0);
+        break;
+    }
+    case Kind::TapHold:
+        a.Pending = true;
+        a.DeadlineUs = nowUs + t.HoldUs;
+        break;
+    default:
+        break;
+    }
+    IsActive[binding] = 1;
+    Actives.push_back(a);
+}
+
+bool Matcher::ActionOn(uint8_t action) const {
+    return Held[action] != 0 || (Latched[action >> 6] >> (action & 63) & 1);
+}
+
+uint64_t Matcher::NextDeadlineUs() const {
+    uint64_t next = 0;
+    for (const Active& a : Actives)
+        if (a.Pending && (next == 0 || a.DeadlineUs < next)) next = a.DeadlineUs;
+    if (SeqPending != kNone) {
+        uint64_t due = SeqLastUs + P.SequenceGapUs + 1;
+        if (next == 0 || due < next) next = due;
+    }
+    return next;
+}
+
+} // namespace gc::bind
@@ -0,0 +1,337 @@
+#include "gc/HidPlan.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace gc::hid {
+
+namespace {
+
+constexpr int kMaxDepth = 32;
+constexpr int kMaxPush = 8;
+constexpr size_t kMaxUsageRanges = 256;
+
+enum ItemType : uint8_t { Main = 0, Global = 1, Local = 2, Reserved = 3 };
+
+struct Globals {
+    uint16_t Page = 0;
+    int32_t LogicalMin = 0;
+    int32_t LogicalMax = 0;
+    uint32_t LogicalMaxRaw = 0;
+    uint32_t Size = 0;
+    uint32_t Count = 0;
+    uint8_t Id = 0;
+};
+
+// Usages are kept as (page << 16 | id); single Usage items are one-element ranges.
+struct UsageRange { uint32_t Lo, Hi; };
+
+struct Locals {
+    std::vector<UsageRange> Ranges;
+    uint32_t PendingMin = 0;
+    bool HaveMin = false;
+
+    void Clear() { Ranges.clear(); HaveMin = false; }
+    void Add(uint32_t lo, uint32_t hi) {
+        if (Ranges.size() < kMaxUsageRanges) Ranges.push_back({lo, hi < lo ? lo : hi});
+    }
+    uint32_t Nth(uint32_t n) const {
+        if (Ranges.empty()) return 0;
+        for (const auto& r : Ranges) {
+            uint32_t span = r.Hi - r.Lo;
+            if (n <= span) return r.Lo + n;
+            n -= span + 1;
+        }
+        return Ranges.back().Hi;   // fewer usages than fields: the last one repeats
+    }
+};
+
+int32_t SignExtend(uint32_t v, uint32_t bytes) {
+    switch (bytes) {
+    case 1: return int8_t(v);
+    case 2: return int16_t(v);
+    default: return int32_t(v);
+    }
+}
+
+Report* FindOrAdd(std::vector<Report>& reports, ReportKind kind, uint8_t id) {
+    for (auto& r : reports)
+        if (r.Kind == kind && r.Id == id) return &r;
+    reports.push_back({kind, id, id ? 8u : 0u});
+    return &reports.back();
+}
+
+ParseStatus AddMain(Plan& plan, const Globals& g, const Locals& l, ReportKind kind, uint16_t flags) {
+    Report* r = FindOrAdd(plan.Reports, kind, g.Id);
+    uint64_t bits = uint64_t(g.Size) * g.Count;
+    if (r->Bits + bits > kMaxReportBytes * 8ull) return ParseStatus::ReportTooLong;
+    if (!(flags & kFieldConstant) && g.Count) {
+        if (g.Size == 0 || g.Size > 32) return ParseStatus::BadReportSize;
+        if (plan.Fields.size() + g.Count > kMaxFields) return ParseStatus::TooManyFields;
+
+        // LogicalMax is commonly written as an unsigned byte/word (0x25 0xFF).
+        int32_t lmin = g.LogicalMin, lmax = g.LogicalMax;
+        if (lmin >= 0 && lmax < lmin) lmax = int32_t(g.LogicalMaxRaw);
+
+        uint32_t first = l.Nth(0), last = l.Ranges.empty() ? 0 : l.Ranges.back().Hi;
+        for (uint32_t n = 0; n < g.Count; ++n) {
+            Field f{};
+            f.Kind = kind;
+            f.ReportId = g.Id;
+            f.BitSize = uint8_t(g.Size);
+            f.Flags = flags;
+            uint32_t u = (flags & kFieldVariable) ? l.Nth(n) : first;
+            f.UsagePage = (u >> 16) ? uint16_t(u >> 16) : g.Page;
+            f.Usage = uint16_t(u);
+            f.UsageMax = (flags & kFieldVariable) ? f.Usage : uint16_t(last);
+            f.BitOffset = r->Bits + n * g.Size;
+            f.LogicalMin = lmin;
+            f.LogicalMax = lmax;
+            plan.Fields.push_back(f);
+        }
+    }
+    r->Bits += uint32_t(bits);
+    return ParseStatus::Ok;
+}
+
+ParseStatus ParseItems(const uint8_t* desc, size_t len, Plan& plan) {
+    Globals g, stack[kMaxPush];
+    int sp = 0, depth = 0;
+    Locals l;
+
+    size_t i = 0;
+    while (i < len) {
+        uint8_t prefix = desc[i++];
+        if (prefix == 0xFE) {   // long item: size, tag, data; no long tags are defined
+            if (len - i < 2) return ParseStatus::Truncated;
+            size_t n = desc[i];
+            i += 2;
+            if (n > len - i) return ParseStatus::Truncated;
+            i += n;
+            continue;
+        }
+        uint32_t size = prefix & 3;
+        if (size == 3) size = 4;
+        if (size > len - i) return ParseStatus::Truncated;
+        uint32_t data = 0;
+        for (uint32_t k = 0; k < size; ++k) data |= uint32_t(desc[i + k]) << (8 * k);
+        i += size;
+
+        uint8_t tag = prefix >> 4;
+        switch (ItemType((prefix >> 2) & 3)) {
+        case Main: {
+            ParseStatus s = ParseStatus::Ok;
+            switch (tag) {
+            case 0x8: s = AddMain(plan, g, l, ReportKind::Input, uint16_t(data)); break;
+            case 0x9: s = AddMain(plan, g, l, ReportKind::Output, uint16_t(data)); break;
+            case 0xB: s = AddMain(plan, g, l, ReportKind::Feature, uint16_t(data)); break;
+            case 0xA:
+                if (++depth > kMaxDepth) return ParseStatus::StackOverflow;
+                break;
+            case 0xC:
+                if (--depth < 0) return ParseStatus::StackUnderflow;
+                break;
+            default: return ParseStatus::BadItem;
+            }
+            if (s != ParseStatus::Ok) return s;
+            l.Clear();
+            break;
+        }
+        case Global:
+            switch (tag) {
+            case 0x0: g.Page = uint16_t(data); break;
+            case 0x1: g.LogicalMin = SignExtend(data, size); break;
+            case 0x2: g.LogicalMax = SignExtend(data, size); g.LogicalMaxRaw = data; break;
+            case 0x7: g.Size = data; break;
+            case 0x8:
+                if (data == 0 || data > 0xFF) return ParseStatus::BadItem;
+                g.Id = uint8_t(data);
+                break;
+            case 0x9: g.Count = data; break;
+            case 0xA:
+                if (sp == kMaxPush) return ParseStatus::StackOverflow;
+                stack[sp++] = g;
+                break;
+            case 0xB:
+                if (sp == 0) return ParseStatus::StackUnderflow;
+                g = stack[--sp];
+                break;
+            default: break;   // physical range, units
+            }
+            break;
+        case Local: {
+            // 1- and 2-byte usages take the current page, 4-byte ones carry their own.
+            uint32_t u = size == 4 ? data : (uint32_t(g.Page) << 16) | (data & 0xFFFF);
+            switch (tag) {
+            case 0x0: l.Add(u, u); break;
+            case 0x1: l.PendingMin = u; l.HaveMin = true; break;
+            case 0x2:
+                if (l.HaveMin) l.Add(l.PendingMin, u);
+                l.HaveMin = false;
+                break;
+            default: break;   // designators, strings, delimiters
+            }
+            break;
+        }
+        case Reserved: return ParseStatus::BadItem;
+        }
+    }
+    return depth == 0 ? ParseStatus::Ok : ParseStatus::UnclosedCollection;
+}
+
+} // namespace
+
+const Report* Plan::Find(ReportKind kind, uint8_t id) const {
+    for (const auto& r : Reports)
+        if (r.Kind == kind && r.Id == id) return &r;
+    return nullptr;
+}
+
+ParseStatus Parse(const uint8_t* desc, size_t len, Plan& out) {
+    out.Fields.clear();
+    out.Reports.clear();
+    ParseStatus s = ParseItems(desc, len, out);
+    if (s != ParseStatus::Ok) {
+        out.Fields.clear();
+        out.Reports.clear();
+    }
+    return s;
+}
+
+const char* StatusName(ParseStatus s) {
+    switch (s) {
+    case ParseStatus::Ok: return "Ok";
+    case ParseStatus::Truncated: return "Truncated";
+    case ParseStatus::BadItem: return "BadItem";
+    case ParseStatus::BadReportSize: return "BadReportSize";
+    case ParseStatus::ReportTooLong: return "ReportTooLong";
+    case ParseStatus::TooManyFields: return "TooManyFields";
+    case ParseStatus::StackOverflow: return "StackOverflow";
+    case ParseStatus::StackUnderflow: return "StackUnderflow";
+    case ParseStatus::UnclosedCollection: return "UnclosedCollection";
+    }
+    return "?";
+}
+
+// ---- extractor -------------------------------------------------------------
+
+bool Extractor::Compile(const Plan& plan, ReportKind kind, uint8_t id) {
+    const Report* r = plan.Find(kind, id);
+    if (!r) return false;
+    *this = Extractor{};
+    Bytes = r->Bytes();
+    Id = id;
+    TailBase = Bytes > 8 ? Bytes - 8 : 0;
+    // Fields of one report are in ascending offset order, so the ops that
+    // need the padded tail form a suffix.
+    for (const auto& f : plan.Fields) {
+        if (f.Kind != kind || f.ReportId != id) continue;
+        Op op{};
+        op.Byte = f.BitOffset / 8;
+        op.Shift = f.BitOffset % 8;
+        op.Mask = f.BitSize == 32 ? 0xFFFFFFFFu : (1u << f.BitSize) - 1;
+        op.SignBit = f.Signed() ? 1u << (f.BitSize - 1) : 0;
+        op.Min = f.LogicalMin;
+        op.Max = std::max(f.LogicalMin, f.LogicalMax);
+        uint64_t range = uint64_t(int64_t(op.Max) - op.Min);
+        op.Scale = range ? ((65535ull << 32) + range / 2) / range : 0;
+        if (op.Byte + 8 <= Bytes) Body = uint32_t(Ops.size() + 1);
+        else op.Byte -= TailBase;
+        Ops.push_back(op);
+    }
+    return true;
+}
+
+bool Extractor::StageTail(const uint8_t* report, size_t len, uint8_t* tail) const {
+    if (len < Bytes || (Id && report[0] != Id)) return false;
+    std::memset(tail, 0, 16);
+    std::memcpy(tail, report + TailBase, Bytes - TailBase);
+    return true;
+}
+
+// Little-endian hosts only (x86, ARM), like the rest of the hot path.
+static inline int32_t Load(const uint8_t* p, const Extractor::Op& op) {
+    uint64_t w;
+    std::memcpy(&w, p + op.Byte, 8);
+    uint32_t v = uint32_t(w >> op.Shift) & op.Mask;
+    return int32_t((v ^ op.SignBit) - op.SignBit);
+}
+
+static inline uint16_t Unit(int32_t v, const Extractor::Op& op) {
+    v = std::min(std::max(v, op.Min), op.Max);
+    return uint16_t((uint64_t(uint32_t(v) - uint32_t(op.Min)) * op.Scale + (1ull << 31)) >> 32);
+}
+
+bool Extractor::Extract(const uint8_t* report, size_t len, int32_t* out) const {
+    uint8_t tail[16];
+    if (!StageTail(report, len, tail)) return false;
+    const Op* op = Ops.data();
+    const size_t body = Body, n = Ops.size();
+    for (size_t i = 0; i < body; ++i) out[i] = Load(report, op[i]);
+    for (size_t i = body; i < n; ++i) out[i] = Load(tail, op[i]);
+    return true;
+}
+
+bool Extractor::ExtractUnit(const uint8_t* report, size_t len, uint16_t* out) const {
+    uint8_t tail[16];
+    if (!StageTail(report, len, tail)) return false;
+    const Op* op = Ops.data();
+    const size_t body = Body, n = Ops.size();
+    for (size_t i = 0; i < body; ++i) out[i] = Unit(Load(report, op[i]), op[i]);
+    for (size_t i = body; i < n; ++i) out[i] = Unit(Load(tail, op[i]), op[i]);
+    return true;
+}
+
+// ---- naming / auto-mapping -------------------------------------------------
+
+std::string UsageName(uint16_t page, uint16_t usage) {
+    static const char* const kDesktop[] = {"X", "Y", "Z", "Rx", "Ry", "Rz", "Slider", "Dial", "Wheel", "Hat"};
+    static const char* const kKeys[] = {"Enter", "Escape", "Backspace", "Tab", "Space", "-", "=", "[", "]", "\\",
+                                        "#", ";", "'", "`", ",", ".", "/", "CapsLock"};
+    char s[40];
+    switch (page) {
+    case 0x01:
+        if (usage >= 0x30 && usage <= 0x39) return kDesktop[usage - 0x30];
+        break;
+    case 0x02:
+        if (usage == 0xC4) return "Accelerator";
+        if (usage == 0xC5) return "Brake";
+        break;
+    case 0x07:
+        if (usage >= 0x04 && usage <= 0x1D) { std::snprintf(s, sizeof s, "Key %c", 'A' + (usage - 0x04)); return s; }
+        if (usage >= 0x1E && usage <= 0x27) { std::snprintf(s, sizeof s, "Key %c", usage == 0x27 ? '0' : '1' + (usage - 0x1E)); return s; }
+        if (usage >= 0x28 && usage <= 0x39) return std::string("Key ") + kKeys[usage - 0x28];
+        if (usage >= 0x3A && usage <= 0x45) { std::snprintf(s, sizeof s, "Key F%d", usage - 0x3A + 1); return s; }
+        if (usage >= 0xE0 && usage <= 0xE7) {
+            static const char* const kMods[] = {"LCtrl", "LShift", "LAlt", "LGui", "RCtrl", "RShift", "RAlt", "RGui"};
+            return std::string("Key ") + kMods[usage - 0xE0];
+        }
+        break;
+    case 0x09:
+        std::snprintf(s, sizeof s, "Button %u", unsigned(usage));
+        return s;
+    default: break;
+    }
+    std::snprintf(s, sizeof s, "Page 0x%04X Usage 0x%02X", unsigned(page), unsigned(usage));
+    return s;
+}
+
+std::string MappingJson(const Plan& plan, uint8_t reportId) {
+    std::string json = "{";
+    for (const auto& f : plan.Fields) {
+        if (f.Kind != ReportKind::Input || f.ReportId != reportId || !(f.Flags & kFieldVariable) ||
+            f.BitSize != 8 || f.BitOffset % 8)
+            continue;
+        if (json.size() > 1) json += ",";
+        json += "\"" + std::to_string(f.BitOffset / 8) + "\":\"";
+        for (char c : UsageName(f.UsagePage, f.Usage)) {
+            if (c == '"' || c == '\\') json += '\\';
+            json += c;
+        }
+        json += "\"";
+    }
+    return json + "}";
+}
+
+} // namespace gc::hid
@@ -0,0 +1,137 @@
+#include "gc/KeyState.h"
+
+#include <string.h>
+
+/* Circular normalisation. For per-axis depths a >= b (0..255) the stick
+   vector keeps its direction and gets magnitude a / 255:
+       axis' = axis * (32767 / 255) / sqrt(1 + (b / a)^2)
+   kNorm[r] is that factor << 8 for r = round(256 * b / a), rounded up
+   (the final shift floors); kRecip[a] = ceil(2^24 / a) turns the ratio
+   into a multiply. Worst case 0.1% magnitude error over all 65536 pairs;
+   generated with
+       [ceil(32767 / 255 * 256 / sqrt(1 + (r / 256)**2)) for r in range(257)] */
+static const uint16_t kNorm[257] = {
+    32896, 32896, 32895, 32894, 32892, 32890, 32887, 32884, 32880, 32876, 32871, 32866,
+    32860, 32854, 32847, 32840, 32832, 32824, 32815, 32806, 32796, 32786, 32775, 32764,
+    32752, 32740, 32728, 32715, 32701, 32687, 32672, 32657, 32642, 32626, 32610, 32593,
+    32575, 32558, 32539, 32521, 32502, 32482, 32462, 32442, 32421, 32399, 32377, 32355,
+    32333, 32309, 32286, 32262, 32238, 32213, 32188, 32162, 32136, 32110, 32083, 32056,
+    32028, 32000, 31972, 31943, 31914, 31884, 31854, 31824, 31794, 31763, 31731, 31699,
+    31667, 31635, 31602, 31569, 31536, 31502, 31468, 31433, 31399, 31364, 31328, 31292,
+    31256, 31220, 31183, 31147, 31109, 31072, 31034, 30996, 30958, 30919, 30880, 30841,
+    30802, 30762, 30722, 30682, 30641, 30601, 30560, 30518, 30477, 30435, 30394, 30352,
+    30309, 30267, 30224, 30181, 30138, 30095, 30051, 30007, 29963, 29919, 29875, 29831,
+    29786, 29741, 29696, 29651, 29606, 29560, 29515, 29469, 29423, 29377, 29331, 29285,
+    29238, 29192, 29145, 29098, 29051, 29004, 28957, 28909, 28862, 28815, 28767, 28719,
+    28671, 28624, 28576, 28527, 28479, 28431, 28383, 28334, 28286, 28237, 28189, 28140,
+    28091, 28043, 27994, 27945, 27896, 27847, 27798, 27749, 27700, 27650, 27601, 27552,
+    27503, 27453, 27404, 27355, 27305, 27256, 27207, 27157, 27108, 27058, 27009, 26959,
+    26910, 26861, 26811, 26762, 26712, 26663, 26613, 26564, 26514, 26465, 26416, 26366,
+    26317, 26268, 26218, 26169, 26120, 26070, 26021, 25972, 25923, 25874, 25825, 25776,
+    25727, 25678, 25629, 25580, 25531, 25482, 25434, 25385, 25336, 25288, 25239, 25191,
+    25142, 25094, 25046, 24997, 24949, 24901, 24853, 24805, 24757, 24709, 24661, 24613,
+    24566, 24518, 24471, 24423, 24376, 24328, 24281, 24234, 24187, 24140, 24093, 24046,
+    23999, 23952, 23906, 23859, 23813, 23766, 23720, 23674, 23627, 23581, 23535, 23489,
+    23444, 23398, 23352, 23307, 23261,
+};
+
+static const uint32_t kRecip[256] = {
+    0, 16777216, 8388608, 5592406, 4194304, 3355444, 2796203, 2396746,
+    2097152, 1864136, 1677722, 1525202, 1398102, 1290556, 1198373, 1118482,
+    1048576, 986896, 932068, 883012, 838861, 798916, 762601, 729445,
+    699051, 671089, 645278, 621379, 599187, 578525, 559241, 541201,
+    524288, 508401, 493448, 479350, 466034, 453439, 441506, 430186,
+    419431, 409201, 399458, 390168, 381301, 372828, 364723, 356963,
+    349526, 342393, 335545, 328966, 322639, 316552, 310690, 305041,
+    299594, 294338, 289263, 284360, 279621, 275037, 270601, 266306,
+    262144, 258112, 254201, 250407, 246724, 243149, 239675, 236299,
+    233017, 229825, 226720, 223697, 220753, 217886, 215093, 212370,
+    209716, 207127, 204601, 202136, 199729, 197380, 195084, 192842,
+    190651, 188509, 186414, 184366, 182362, 180401, 178482, 176603,
+    174763, 172961, 171197, 169467, 167773, 166112, 164483, 162886,
+    161320, 159784, 158276, 156797, 155345, 153920, 152521, 151147,
+    149797, 148471, 147169, 145889, 144632, 143396, 142180, 140986,
+    139811, 138655, 137519, 136401, 135301, 134218, 133153, 132105,
+    131072, 130056, 129056, 128071, 127101, 126145, 125204, 124276,
+    123362, 122462, 121575, 120700, 119838, 118988, 118150, 117324,
+    116509, 115705, 114913, 114131, 113360, 112599, 111849, 111108,
+    110377, 109656, 108943, 108241, 107547, 106862, 106185, 105518,
+    104858, 104207, 103564, 102928, 102301, 101681, 101068, 100463,
+    99865, 99274, 98690, 98113, 97542, 96979, 96421, 95870,
+    95326, 94787, 94255, 93728, 93207, 92692, 92183, 91679,
+    91181, 90688, 90201, 89718, 89241, 88769, 88302, 87839,
+    87382, 86929, 86481, 86038, 85599, 85164, 84734, 84308,
+    83887, 83469, 83056, 82647, 82242, 81841, 81443, 81050,
+    80660, 80274, 79892, 79513, 79138, 78767, 78399, 78034,
+    77673, 77315, 76960, 76609, 76261, 75916, 75574, 75235,
+    74899, 74566, 74236, 73909, 73585, 73263, 72945, 72629,
+    72316, 72006, 71698, 71393, 71090, 70790, 70493, 70198,
+    69906, 69616, 69328, 69043, 68760, 68479, 68201, 67924,
+    67651, 67379, 67109, 66842, 66577, 66314, 66053, 65794,
+};
+
+void GcKeyInit(PGC_KEY_STATE k, uint8_t actuation, uint8_t release)
+{
+    memset(k, 0, sizeof(*k));
+    k->Actuation = actuation ? actuation : 1;
+    k->Release = release < k->Actuation ? release : k->Actuation;
+}
+
+static void Set(PGC_KEY_STATE k, uint8_t key, int down)
+{
+    uint64_t bit = 1ull << (key & 63);
+    uint64_t* word = &k->Pressed[key >> 6];
+    if (down && !(*word & bit)) k->PressedAt[key] = ++k->Clock;
+    *word = down ? *word | bit : *word & ~bit;
+}
+
+void GcKeyDown(PGC_KEY_STATE k, uint8_t key)
+{
+    k->Depth[key] = GC_KEY_FULL_DEPTH;
+    Set(k, key, 1);
+}
+
+void GcKeyUp(PGC_KEY_STATE k, uint8_t key)
+{
+    k->Depth[key] = 0;
+    Set(k, key, 0);
+}
+
+void GcKeySetDepth(PGC_KEY_STATE k, uint8_t key, uint8_t depth)
+{
+    k->Depth[key] = depth;
+    Set(k, key, GcKeyIsDown(k, key) ? depth >= k->Release && depth > 0 : depth >= k->Actuation);
+}
+
+int GcKeyIsDown(const GC_KEY_STATE* k, uint8_t key)
+{
+    return (int)(k->Pressed[key >> 6] >> (key & 63) & 1);
+}
+
+int32_t GcSocdAxis(const GC_KEY_STATE* k, uint8_t neg, uint8_t pos, GC_SOCD_MODE mode)
+{
+    /* Both held: +1 if pos was pressed later. LAST_WINS keeps that sign,
+       FIRST_WINS flips it, NEUTRAL zeroes it. */
+    static const int32_t kBoth[3] = {1, 0, -1};
+    int32_t a = GcKeyIsDown(k, neg);
+    int32_t b = GcKeyIsDown(k, pos);
+    int32_t posLater = (int32_t)(k->PressedAt[pos] - k->PressedAt[neg]) > 0;
+    int32_t s = (b - a) + (a & b) * (2 * posLater - 1) * kBoth[(uint32_t)mode % 3];
+    return (s > 0) * (int32_t)k->Depth[pos] - (s < 0) * (int32_t)k->Depth[neg];
+}
+
+void GcWasdToStick(const GC_KEY_STATE* k, const GC_WASD_MAP* map, int16_t* x, int16_t* y)
+{
+    int32_t dx = GcSocdAxis(k, map->Left, map->Right, map->ModeX);
+    int32_t dy = GcSocdAxis(k, map->Down, map->Up, map->ModeY);
+    uint32_t ax = (uint32_t)(dx < 0 ? -dx : dx);
+    uint32_t ay = (uint32_t)(dy < 0 ? -dy : dy);
+    uint32_t hi = ax > ay ? ax : ay;
+    uint32_t lo = ax ^ ay ^ hi;
+    uint32_t scale = kNorm[(lo * kRecip[hi] + (1u << 15)) >> 16];
+    /* Scale magnitudes and reapply the sign so left and right are symmetric. */
+    int32_t mx = (int32_t)(ax * scale >> 8), my = (int32_t)(ay * scale >> 8);
+    int32_t sx = -(dx < 0), sy = -(dy < 0);
+    *x = (int16_t)((mx ^ sx) - sx);
+    *y = (int16_t)((my ^ sy) - sy);
+}
@@ -0,0 +1,111 @@
+#include "gc/LatencyProbe.h"
+#include "gc/Atomic.h"
+
+#define GC_LATENCY_SATURATE ((1ULL << (GC_LATENCY_MAX_BIT + 1)) - 1)
+
+uint32_t GcLatencyBucketOf(uint64_t ns)
+{
+    if (ns > GC_LATENCY_SATURATE) ns = GC_LATENCY_SATURATE;
+    if (ns < GC_LATENCY_SUB) return (uint32_t)ns;
+    int k = GcHighBitU64(ns);
+    int shift = k - GC_LATENCY_SUB_BITS;
+    return (uint32_t)(shift * GC_LATENCY_SUB) + (uint32_t)(ns >> shift);
+}
+
+uint64_t GcLatencyBucketUpper(uint32_t bucket)
+{
+    if (bucket < GC_LATENCY_SUB) return bucket;
+    uint32_t shift = bucket / GC_LATENCY_SUB - 1;
+    uint64_t m = bucket % GC_LATENCY_SUB + GC_LATENCY_SUB;
+    return ((m + 1) << shift) - 1;
+}
+
+void GcLatencyReset(PGC_LATENCY_HISTOGRAM h)
+{
+    for (uint32_t i = 0; i < GC_LATENCY_BUCKETS; ++i) GcAtomicStoreU64(&h->Buckets[i], 0);
+    GcAtomicStoreU64(&h->Count, 0);
+    GcAtomicStoreU64(&h->SumNs, 0);
+    GcAtomicStoreU64(&h->MaxNs, 0);
+}
+
+void GcLatencyRecord(PGC_LATENCY_HISTOGRAM h, uint64_t ns)
+{
+    GcAtomicAddU64(&h->Buckets[GcLatencyBucketOf(ns)], 1);
+    GcAtomicAddU64(&h->SumNs, ns);
+    GcAtomicMaxU64(&h->MaxNs, ns);
+    GcAtomicAddU64(&h->Count, 1);
+}
+
+uint64_t GcLatencyPercentile(const GC_LATENCY_HISTOGRAM* h, uint32_t perTenThousand)
+{
+    /* Count is bumped last by writers, so walking the buckets can only see
+       more samples than Count; clamp to the last bucket reached. */
+    uint64_t count = GcAtomicLoadU64(&h->Count);
+    if (count == 0) return 0;
+    if (perTenThousand > 10000) perTenThousand = 10000;
+    uint64_t rank = (count * perTenThousand + 9999) / 10000;
+    if (rank == 0) rank = 1;
+    uint64_t seen = 0, maxNs = GcAtomicLoadU64(&h->MaxNs);
+    uint32_t i = 0;
+    for (; i < GC_LATENCY_BUCKETS; ++i)
+    {
+        seen += GcAtomicLoadU64(&h->Buckets[i]);
+        if (seen >= rank) break;
+    }
+    if (i == GC_LATENCY_BUCKETS) return maxNs;
+    uint64_t upper = GcLatencyBucketUpper(i);
+    return upper < maxNs ? upper : maxNs;
+}
+
+uint64_t GcLatencyMeanNs(const GC_LATENCY_HISTOGRAM* h)
+{
+    uint64_t count = GcAtomicLoadU64(&h->Count);
+    return count ? GcAtomicLoadU64(&h->SumNs) / count : 0;
+}
+
+void GcProbeReset(PGC_LATENCY_PROBE p)
+{
+    for (int i = 0; i < GC_HOP_COUNT; ++i)
+    {
+        GcLatencyReset(&p->Total[i]);
+        GcLatencyReset(&p->Stage[i]);
+    }
+    GcAtomicStoreU32(&p->NextSequence, 0);
+}
+
+void GcTraceBegin(PGC_LATENCY_PROBE p, uint64_t originNs, PGC_TRACE t)
+{
+    t->Sequence = GcAtomicAddU32(&p->NextSequence, 1);
+    t->LastOffsetNs = 0;
+    t->OriginNs = originNs;
+}
+
+void GcTraceStampInto(PGC_LATENCY_HISTOGRAM total, PGC_LATENCY_HISTOGRAM stage, PGC_TRACE t, uint64_t nowNs)
+{
+    /* Clocks are monotonic per host but hops may straddle cores, so a
+       stamp earlier than the previous one counts as zero, not a wrap. */
+    uint64_t since = nowNs > t->OriginNs ? nowNs - t->OriginNs : 0;
+    uint64_t step = since > t->LastOffsetNs ? since - t->LastOffsetNs : 0;
+    GcLatencyRecord(total, since);
+    GcLatencyRecord(stage, step);
+    t->LastOffsetNs = since > 0xFFFFFFFFu ? 0xFFFFFFFFu : (uint32_t)since;
+}
+
+void GcTraceStamp(PGC_LATENCY_PROBE p, GC_HOP hop, PGC_TRACE t, uint64_t nowNs)
+{
+    if ((unsigned)hop >= GC_HOP_COUNT) return;
+    GcTraceStampInto(&p->Total[hop], &p->Stage[hop], t, nowNs);
+}
+
+const char* GcHopName(GC_HOP hop)
+{
+    switch (hop)
+    {
+    case GC_HOP_HID_READ:      return "hid_read";
+    case GC_HOP_GRAPH_OUT:     return "graph_out";
+    case GC_HOP_WIRE_TX:       return "wire_tx";
+    case GC_HOP_BROKER_RX:     return "broker_rx";
+    case GC_HOP_DRIVER_SUBMIT: return "driver_submit";
+    default:                   return "?";
+    }
+}
@@ -0,0 +1,58 @@
+#include "gc/PadMirror.h"
+#include "gc/Atomic.h"
+
+#include <string.h>
+
+void GcMirrorInit(PGC_MIRROR_PAGE p, uint32_t slot, uint32_t writerPid, uint64_t nowNs)
+{
+    memset((void*)p, 0, sizeof(*p));
+    p->Version = GC_MIRROR_VERSION;
+    p->SnapshotBytes = (uint32_t)sizeof(GC_MIRROR_SNAPSHOT);
+    p->Slot = slot;
+    p->WriterPid = writerPid;
+    p->CreatedNs = nowNs;
+    /* Magic last: a reader that maps the page mid-init sees it as invalid. */
+    GcAtomicStoreU32((volatile uint32_t*)&p->Magic, GC_MIRROR_MAGIC);
+}
+
+/* Single writer. The odd Sequence store is ordered before the word
+   stores because each of those is a release store; the final even store
+   releases the whole snapshot. */
+void GcMirrorPublish(PGC_MIRROR_PAGE p, const GC_MIRROR_SNAPSHOT* s)
+{
+    uint64_t words[GC_MIRROR_WORDS];
+    memcpy(words, s, sizeof(words));
+    uint32_t seq = p->Sequence;
+    GcAtomicStoreU32(&p->Sequence, seq + 1);
+    for (size_t i = 0; i < GC_MIRROR_WORDS; ++i) GcAtomicStoreU64(&p->Words[i], words[i]);
+    GcAtomicStoreU32(&p->Sequence, seq + 2);
+}
+
+int GcMirrorValid(const GC_MIRROR_PAGE* p)
+{
+    return GcAtomicLoadU32((const volatile uint32_t*)&p->Magic) == GC_MIRROR_MAGIC &&
+           p->Version == GC_MIRROR_VERSION && p->SnapshotBytes == sizeof(GC_MIRROR_SNAPSHOT);
+}
+
+int GcMirrorRead(const GC_MIRROR_PAGE* p, GC_MIRROR_SNAPSHOT* out, uint32_t maxAttempts)
+{
+    if (!GcMirrorValid(p)) return 0;
+    uint64_t words[GC_MIRROR_WORDS];
+    for (uint32_t attempt = 0; attempt < maxAttempts; ++attempt)
+    {
+        uint32_t before = GcAtomicLoadU32(&p->Sequence);
+        if (before & 1)
+        {
+            GcCpuRelax();
+            continue;
+        }
+        /* Acquire loads: the second Sequence load cannot move above them. */
+        for (size_t i = 0; i < GC_MIRROR_WORDS; ++i) words[i] = GcAtomicLoadU64(&p->Words[i]);
+        if (GcAtomicLoadU32(&p->Sequence) == before)
+        {
+            memcpy(out, words, sizeof(words));
+            return 1;
+        }
+    }
+    return 0;
+}
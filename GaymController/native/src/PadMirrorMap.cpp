@@ -0,0 +1,194 @@
+#include "gc/PadMirrorMap.h"
+
+#include <cstdio>
+#include <utility>
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <sddl.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace gc::mirror {
+
+const char* MapStatusName(MapStatus s) {
+    switch (s) {
+    case MapStatus::Ok: return "Ok";
+    case MapStatus::NotFound: return "NotFound";
+    case MapStatus::AccessDenied: return "AccessDenied";
+    case MapStatus::BadLayout: return "BadLayout";
+    case MapStatus::SystemError: return "SystemError";
+    }
+    return "?";
+}
+
+std::string PageName(uint32_t slot) {
+    char buf[64];
+#if defined(_WIN32)
+    std::snprintf(buf, sizeof(buf), "Global\\GaymController.Pad%u", slot);
+#else
+    std::snprintf(buf, sizeof(buf), "/GaymController.Pad%u", slot);
+#endif
+    return buf;
+}
+
+PadMirrorMap::~PadMirrorMap() { Close(); }
+
+PadMirrorMap::PadMirrorMap(PadMirrorMap&& other) noexcept
+    : Page_(std::exchange(other.Page_, nullptr)),
+      Handle_(std::exchange(other.Handle_, nullptr)),
+      Writable_(std::exchange(other.Writable_, false)) {}
+
+PadMirrorMap& PadMirrorMap::operator=(PadMirrorMap&& other) noexcept {
+    if (this != &other) {
+        Close();
+        Page_ = std::exchange(other.Page_, nullptr);
+        Handle_ = std::exchange(other.Handle_, nullptr);
+        Writable_ = std::exchange(other.Writable_, false);
+    }
+    return *this;
+}
+
+#if defined(_WIN32)
+
+namespace {
+
+std::wstring WideName(uint32_t slot) {
+    std::string n = PageName(slot);
+    return std::wstring(n.begin(), n.end());
+}
+
+MapStatus FromLastError() {
+    switch (GetLastError()) {
+    case ERROR_FILE_NOT_FOUND: return MapStatus::NotFound;
+    case ERROR_ACCESS_DENIED: return MapStatus::AccessDenied;
+    default: return MapStatus::SystemError;
+    }
+}
+
+} // namespace
+
+MapStatus PadMirrorMap::Create(uint32_t slot, uint64_t nowNs) {
+    Close();
+    SECURITY_ATTRIBUTES sa = {sizeof(sa), nullptr, FALSE};
+    if (!ConvertStringSecurityDescriptorToSecurityDescriptorA(kPageSddl, SDDL_REVISION_1,
+                                                              &sa.lpSecurityDescriptor, nullptr))
+        return FromLastError();
+    HANDLE h = CreateFileMappingW(INVALID_HANDLE_VALUE, &sa, PAGE_READWRITE, 0, GC_MIRROR_MAP_BYTES,
+                                  WideName(slot).c_str());
+    MapStatus created = h ? MapStatus::Ok : FromLastError();
+    LocalFree(sa.lpSecurityDescriptor);
+    if (!h) return created;
+    void* view = MapViewOfFile(h, FILE_MAP_WRITE, 0, 0, GC_MIRROR_MAP_BYTES);
+    if (!view) {
+        MapStatus s = FromLastError();
+        CloseHandle(h);
+        return s;
+    }
+    Handle_ = h;
+    Page_ = static_cast<GC_MIRROR_PAGE*>(view);
+    Writable_ = true;
+    GcMirrorInit(Page_, slot, GetCurrentProcessId(), nowNs);
+    return MapStatus::Ok;
+}
+
+MapStatus PadMirrorMap::Open(uint32_t slot) {
+    Close();
+    HANDLE h = OpenFileMappingW(FILE_MAP_READ, FALSE, WideName(slot).c_str());
+    if (!h) return FromLastError();
+    void* view = MapViewOfFile(h, FILE_MAP_READ, 0, 0, GC_MIRROR_MAP_BYTES);
+    if (!view) {
+        MapStatus s = FromLastError();
+        CloseHandle(h);
+        return s;
+    }
+    Handle_ = h;
+    Page_ = static_cast<GC_MIRROR_PAGE*>(view);
+    if (!GcMirrorValid(Page_)) {
+        Close();
+        return MapStatus::BadLayout;
+    }
+    return MapStatus::Ok;
+}
+
+void PadMirrorMap::Close() {
+    if (Page_) UnmapViewOfFile(Page_);
+    if (Handle_) CloseHandle(Handle_);
+    Page_ = nullptr;
+    Handle_ = nullptr;
+    Writable_ = false;
+}
+
+void PadMirrorMap::Unlink(uint32_t) {}
+
+#else
+
+namespace {
+
+MapStatus FromErrno() {
+    switch (errno) {
+    case ENOENT: return MapStatus::NotFound;
+    case EACCES:
+    case EPERM: return MapStatus::AccessDenied;
+    default: return MapStatus::SystemError;
+    }
+}
+
+} // namespace
+
+MapStatus PadMirrorMap::Create(uint32_t slot, uint64_t nowNs) {
+    Close();
+    int fd = shm_open(PageName(slot).c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0) return FromErrno();
+    if (ftruncate(fd, GC_MIRROR_MAP_BYTES) != 0) {
+        MapStatus s = FromErrno();
+        close(fd);
+        return s;
+    }
+    void* view = mmap(nullptr, GC_MIRROR_MAP_BYTES, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    MapStatus s = view == MAP_FAILED ? FromErrno() : MapStatus::Ok;
+    close(fd);
+    if (s != MapStatus::Ok) return s;
+    Page_ = static_cast<GC_MIRROR_PAGE*>(view);
+    Writable_ = true;
+    GcMirrorInit(Page_, slot, uint32_t(getpid()), nowNs);
+    return MapStatus::Ok;
+}
+
+MapStatus PadMirrorMap::Open(uint32_t slot) {
+    Close();
+    int fd = shm_open(PageName(slot).c_str(), O_RDONLY, 0);
+    if (fd < 0) return FromErrno();
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size < off_t(sizeof(GC_MIRROR_PAGE))) {
+        close(fd);
+        return MapStatus::BadLayout;
+    }
+    void* view = mmap(nullptr, GC_MIRROR_MAP_BYTES, PROT_READ, MAP_SHARED, fd, 0);
+    MapStatus s = view == MAP_FAILED ? FromErrno() : MapStatus::Ok;
+    close(fd);
+    if (s != MapStatus::Ok) return s;
+    Page_ = static_cast<GC_MIRROR_PAGE*>(view);
+    if (!GcMirrorValid(Page_)) {
+        Close();
+        return MapStatus::BadLayout;
+    }
+    return MapStatus::Ok;
+}
+
+void PadMirrorMap::Close() {
+    if (Page_) munmap(Page_, GC_MIRROR_MAP_BYTES);
+    Page_ = nullptr;
+    Writable_ = false;
+}
+
+void PadMirrorMap::Unlink(uint32_t slot) { shm_unlink(PageName(slot).c_str()); }
+
+#endif
+
+} // namespace gc::mirror
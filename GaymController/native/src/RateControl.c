@@ -0,0 +1,97 @@
+#include "gc/RateControl.h"
+
+#include <string.h>
+
+#define NS_PER_S 1000000000ull
+
+void GcRateDefaultConfig(GC_RATE_CONFIG* cfg)
+{
+    cfg->MinRateHz = 250;
+    cfg->MaxRateHz = 8000;
+    cfg->TargetLatencyNs = 1000000;
+    cfg->MaxQueueDepth = 4;
+    cfg->IncreaseHz = 100;
+    cfg->DecreaseQ16 = 49152;   /* 0.75 */
+    cfg->PeriodNs = 10000000;
+}
+
+static void SetRate(PGC_RATE_CONTROL rc, uint64_t hz)
+{
+    if (hz < rc->Cfg.MinRateHz) hz = rc->Cfg.MinRateHz;
+    if (hz > rc->Cfg.MaxRateHz) hz = rc->Cfg.MaxRateHz;
+    rc->RateHz = (uint32_t)hz;
+    rc->IntervalNs = (uint32_t)(NS_PER_S / hz);
+}
+
+int GcRateInit(PGC_RATE_CONTROL rc, const GC_RATE_CONFIG* cfg, uint64_t nowNs)
+{
+    if (cfg->MinRateHz == 0 || cfg->MinRateHz > cfg->MaxRateHz || cfg->DecreaseQ16 == 0 ||
+        cfg->DecreaseQ16 >= 65536 || cfg->PeriodNs == 0)
+        return 0;
+    memset(rc, 0, sizeof(*rc));
+    rc->Cfg = *cfg;
+    rc->PeriodStartNs = nowNs;
+    rc->NextSendNs = nowNs;
+    SetRate(rc, cfg->MaxRateHz);
+    return 1;
+}
+
+static void ClosePeriod(PGC_RATE_CONTROL rc, uint64_t nowNs)
+{
+    if (rc->PeriodMaxLatencyNs > rc->Cfg.TargetLatencyNs || rc->PeriodMaxDepth > rc->Cfg.MaxQueueDepth)
+    {
+        /* Cut from what the consumer actually drained this period, not from
+           the send rate: after a capacity drop the send rate can be several
+           times too high and repeated x0.75 steps would keep the queue
+           growing for many periods. */
+        uint64_t elapsed = nowNs - rc->PeriodStartNs;
+        uint64_t base = rc->RateHz;
+        uint64_t drained = elapsed ? (uint64_t)rc->PeriodCompletions * NS_PER_S / elapsed : base;
+        if (drained < base) base = drained;
+        SetRate(rc, (base * rc->Cfg.DecreaseQ16) >> 16);
+        rc->Decreases++;
+        rc->LastDecreaseNs = nowNs;
+    }
+    else if (rc->PeriodSamples && rc->RateHz < rc->Cfg.MaxRateHz)
+    {
+        SetRate(rc, (uint64_t)rc->RateHz + rc->Cfg.IncreaseHz);
+        rc->Increases++;
+    }
+    rc->PeriodStartNs = nowNs;
+    rc->PeriodSamples = 0;
+    rc->PeriodCompletions = 0;
+    rc->PeriodMaxLatencyNs = 0;
+    rc->PeriodMaxDepth = 0;
+}
+
+void GcRateTick(PGC_RATE_CONTROL rc, uint64_t nowNs)
+{
+    if (nowNs - rc->PeriodStartNs >= rc->Cfg.PeriodNs) ClosePeriod(rc, nowNs);
+}
+
+void GcRateObserve(PGC_RATE_CONTROL rc, uint64_t nowNs, uint32_t queueDepth, uint32_t latencyNs)
+{
+    GcRateTick(rc, nowNs);
+    rc->PeriodCompletions++;
+    if (queueDepth > rc->PeriodMaxDepth) rc->PeriodMaxDepth = queueDepth;
+    /* Latency of reports sent before the last decrease reflects the old
+       rate; it neither triggers another cut nor makes a period clean. The
+       depth is current and always counts. */
+    if (nowNs - latencyNs < rc->LastDecreaseNs) return;
+    rc->PeriodSamples++;
+    if (latencyNs > rc->PeriodMaxLatencyNs) rc->PeriodMaxLatencyNs = latencyNs;
+    /* Congestion closes the period early (once a quarter of it has passed,
+       so the drained-rate estimate is not a handful of samples). */
+    if ((latencyNs > rc->Cfg.TargetLatencyNs || queueDepth > rc->Cfg.MaxQueueDepth) &&
+        nowNs - rc->PeriodStartNs >= rc->Cfg.PeriodNs / 4)
+        ClosePeriod(rc, nowNs);
+}
+
+int GcRateShouldSend(PGC_RATE_CONTROL rc, uint64_t nowNs)
+{
+    GcRateTick(rc, nowNs);
+    if ((int64_t)(nowNs - rc->NextSendNs) < 0) return 0;
+    rc->NextSendNs += rc->IntervalNs;
+    if ((int64_t)(nowNs - rc->NextSendNs) >= 0) rc->NextSendNs = nowNs + rc->IntervalNs;
+    return 1;
+}
@@ -0,0 +1,192 @@
+#include "gc/RecoilPattern.h"
+
+#include <string.h>
+
+#include "gc/Atomic.h"
+
+struct _GC_RECOIL_TABLE
+{
+    uint32_t Steps;        /* Samples has Steps + 1 entries */
+    uint32_t StepShift;
+    uint32_t DurationUs;   /* Steps << StepShift */
+    uint32_t Reserved;
+    int16_t  Samples[];    /* x, y interleaved */
+};
+
+static uint32_t Shift(const GC_RECOIL_DESC* d)
+{
+    return d->StepShift ? d->StepShift : GC_RECOIL_DEFAULT_SHIFT;
+}
+
+static uint64_t KeyUs(const GC_RECOIL_DESC* d, uint32_t i)
+{
+    return d->KeyKind == GC_RECOIL_KEY_SHOT ? (uint64_t)d->Points[i].Key * d->ShotIntervalUs : d->Points[i].Key;
+}
+
+/* Steps needed for d, or 0 with *ok cleared if d is unusable. */
+static uint32_t StepsFor(const GC_RECOIL_DESC* d, int* ok)
+{
+    *ok = 0;
+    if (!d || !d->Points || d->Count == 0 || Shift(d) > 15) return 0;
+    if (d->KeyKind == GC_RECOIL_KEY_SHOT && d->ShotIntervalUs == 0) return 0;
+    for (uint32_t i = 1; i < d->Count; ++i)
+        if (d->Points[i].Key <= d->Points[i - 1].Key) return 0;
+    uint64_t last = KeyUs(d, d->Count - 1);
+    uint64_t steps = (last + (1ull << Shift(d)) - 1) >> Shift(d);
+    if (steps > GC_RECOIL_MAX_STEPS) return 0;
+    *ok = 1;
+    return (uint32_t)steps;
+}
+
+size_t GcRecoilBakeBytes(const GC_RECOIL_DESC* d)
+{
+    int ok;
+    uint32_t steps = StepsFor(d, &ok);
+    return ok ? sizeof(GC_RECOIL_TABLE) + ((size_t)steps + 1) * 2 * sizeof(int16_t) : 0;
+}
+
+static int16_t Lerp(int32_t a, int32_t b, int64_t num, int64_t den)
+{
+    int64_t v = (int64_t)a * den + (int64_t)(b - a) * num;
+    /* Round half away from zero so mirrored patterns bake symmetrically. */
+    return (int16_t)(v >= 0 ? (v + den / 2) / den : -((-v + den / 2) / den));
+}
+
+PGC_RECOIL_TABLE GcRecoilBake(void* mem, size_t bytes, const GC_RECOIL_DESC* d)
+{
+    int ok;
+    uint32_t steps = StepsFor(d, &ok);
+    if (!ok || !mem || ((uintptr_t)mem & 3) || bytes < GcRecoilBakeBytes(d)) return NULL;
+
+    PGC_RECOIL_TABLE t = (PGC_RECOIL_TABLE)mem;
+    t->Steps = steps;
+    t->StepShift = Shift(d);
+    t->DurationUs = steps << t->StepShift;
+    t->Reserved = 0;
+
+    /* Segment [k0, k1] with values v0 -> v1; starts at the implicit rest
+       point (0; 0, 0) unless the first key is at t = 0. */
+    uint32_t next = 0;
+    uint64_t k0 = 0, k1 = 0;
+    int32_t x0 = 0, y0 = 0, x1 = 0, y1 = 0;
+    if (KeyUs(d, 0) == 0)
+    {
+        x1 = d->Points[0].X;
+        y1 = d->Points[0].Y;
+        next = 1;
+    }
+    for (uint32_t i = 0; i <= steps; ++i)
+    {
+        uint64_t at = (uint64_t)i << t->StepShift;
+        while (next < d->Count && k1 < at)
+        {
+            k0 = k1; x0 = x1; y0 = y1;
+            k1 = KeyUs(d, next);
+            x1 = d->Points[next].X;
+            y1 = d->Points[next].Y;
+            next++;
+        }
+        if (at >= k1)
+        {
+            t->Samples[2 * i] = (int16_t)x1;
+            t->Samples[2 * i + 1] = (int16_t)y1;
+        }
+        else
+        {
+            t->Samples[2 * i] = Lerp(x0, x1, (int64_t)(at - k0), (int64_t)(k1 - k0));
+            t->Samples[2 * i + 1] = Lerp(y0, y1, (int64_t)(at - k0), (int64_t)(k1 - k0));
+        }
+    }
+    return t;
+}
+
+uint32_t GcRecoilDurationUs(const GC_RECOIL_TABLE* t)
+{
+    return t->DurationUs;
+}
+
+GC_INLINE void Sample(const GC_RECOIL_TABLE* t, uint32_t tUs, int32_t* x, int32_t* y)
+{
+    uint32_t shift = t->StepShift;
+    uint32_t i = tUs >> shift;
+    if (i >= t->Steps)
+    {
+        *x = t->Samples[2 * t->Steps];
+        *y = t->Samples[2 * t->Steps + 1];
+        return;
+    }
+    const int16_t* s = &t->Samples[2 * i];
+    int32_t frac = (int32_t)(tUs & ((1u << shift) - 1));
+    int32_t half = (1 << shift) >> 1;
+    /* |b - a| * frac < 2^16 * 2^15: fits int32 with StepShift <= 15. */
+    *x = s[0] + (((s[2] - s[0]) * frac + half) >> shift);
+    *y = s[1] + (((s[3] - s[1]) * frac + half) >> shift);
+}
+
+static int16_t Saturate(int64_t v)
+{
+    return (int16_t)(v > 32767 ? 32767 : v < -32768 ? -32768 : v);
+}
+
+void GcRecoilSample(const GC_RECOIL_TABLE* t, uint32_t tUs, int16_t* x, int16_t* y)
+{
+    int32_t sx, sy;
+    Sample(t, tUs, &sx, &sy);
+    *x = (int16_t)sx;
+    *y = (int16_t)sy;
+}
+
+void GcRecoilMixerInit(PGC_RECOIL_MIXER m)
+{
+    memset(m, 0, sizeof(*m));
+}
+
+int GcRecoilStart(PGC_RECOIL_MIXER m, const GC_RECOIL_TABLE* t, int32_t weight)
+{
+    for (int w = 0; w < GC_RECOIL_MAX_INSTANCES / 64; ++w)
+    {
+        uint64_t idle = ~m->Active[w];
+        if (!idle) continue;
+        int id = w * 64 + GcHighBitU64(idle & (~idle + 1));
+        m->Instances[id].Table = t;
+        m->Instances[id].ElapsedUs = 0;
+        m->Instances[id].Weight = weight;
+        m->Active[w] |= 1ull << (id & 63);
+        return id;
+    }
+    return -1;
+}
+
+void GcRecoilStop(PGC_RECOIL_MIXER m, int id)
+{
+    if (id < 0 || id >= GC_RECOIL_MAX_INSTANCES) return;
+    m->Active[id >> 6] &= ~(1ull << (id & 63));
+}
+
+void GcRecoilSetWeight(PGC_RECOIL_MIXER m, int id, int32_t weight)
+{
+    if (id < 0 || id >= GC_RECOIL_MAX_INSTANCES) return;
+    m->Instances[id].Weight = weight;
+}
+
+void GcRecoilTick(PGC_RECOIL_MIXER m, uint32_t dtUs, int16_t* x, int16_t* y)
+{
+    int64_t ax = 0, ay = 0;
+    for (int w = 0; w < GC_RECOIL_MAX_INSTANCES / 64; ++w)
+    {
+        for (uint64_t bits = m->Active[w]; bits; bits &= bits - 1)
+        {
+            GC_RECOIL_INSTANCE* in = &m->Instances[w * 64 + GcHighBitU64(bits & (~bits + 1))];
+            const GC_RECOIL_TABLE* t = in->Table;
+            /* Saturate at the end of the table so the clock never wraps. */
+            uint32_t left = t->DurationUs - in->ElapsedUs;
+            in->ElapsedUs += dtUs < left ? dtUs : left;
+            int32_t sx, sy;
+            Sample(t, in->ElapsedUs, &sx, &sy);
+            ax += (int64_t)sx * in->Weight;
+            ay += (int64_t)sy * in->Weight;
+        }
+    }
+    *x = Saturate((ax + (1 << 14)) >> 15);
+    *y = Saturate((ay + (1 << 14)) >> 15);
+}
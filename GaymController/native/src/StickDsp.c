@@ -0,0 +1,644 @@
+#include "gc/StickDsp.h"
+
+#include <math.h>
+
+#if !defined(GC_DSP_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define GC_DSP_SSE2 1
+#include <emmintrin.h>
+#else
+#define GC_DSP_SSE2 0
+#endif
+
+/* ---- float helpers ------------------------------------------------------ */
+
+#define GC_FLT_MIN 1.17549435e-38f
+#define GC_SQRT2   1.41421356f
+
+/* log2 via atanh series on the mantissa folded to [sqrt(1/2), sqrt(2)). */
+#define LOG2_C1 2.88539008f
+#define LOG2_C3 0.961796694f
+#define LOG2_C5 0.577078016f
+#define LOG2_C7 0.412198583f
+#define LOG2_C9 0.320598898f
+
+/* 2^f for f in [-0.5, 0.5]: Taylor coefficients ln2^k / k!. */
+#define EXP2_C1 0.693147181f
+#define EXP2_C2 0.240226507f
+#define EXP2_C3 0.0555041087f
+#define EXP2_C4 0.00961812911f
+#define EXP2_C5 0.00133335581f
+#define EXP2_C6 0.000154035304f
+
+typedef union { float F; uint32_t U; int32_t I; } GC_FBITS;
+
+static inline float Log2F(float v)
+{
+    GC_FBITS b; b.F = v;
+    int32_t e = (int32_t)((b.U >> 23) & 0xFF) - 127;
+    b.U = (b.U & 0x007FFFFFu) | 0x3F800000u;
+    float m = b.F;
+    if (m > GC_SQRT2) { m *= 0.5f; e += 1; }
+    float s = (m - 1.0f) / (m + 1.0f);
+    float s2 = s * s;
+    float p = LOG2_C9;
+    p = p * s2 + LOG2_C7;
+    p = p * s2 + LOG2_C5;
+    p = p * s2 + LOG2_C3;
+    p = p * s2 + LOG2_C1;
+    return (float)e + s * p;
+}
+
+static inline float Exp2F(float p)
+{
+    if (p < -126.0f) p = -126.0f;
+    int32_t n = (int32_t)(p < 0.0f ? p - 0.5f : p + 0.5f);
+    float f = p - (float)n;
+    float q = EXP2_C6;
+    q = q * f + EXP2_C5;
+    q = q * f + EXP2_C4;
+    q = q * f + EXP2_C3;
+    q = q * f + EXP2_C2;
+    q = q * f + EXP2_C1;
+    q = q * f + 1.0f;
+    GC_FBITS b; b.U = (uint32_t)(n + 127) << 23;
+    return q * b.F;
+}
+
+static inline float MinF(float a, float b) { return a < b ? a : b; }
+static inline float AbsF(float a) { return a < 0.0f ? -a : a; }
+
+#define GC_TWO_PI 6.28318531f
+
+#if GC_DSP_SSE2
+static inline __m128 AbsPs(__m128 v)
+{
+    return _mm_and_ps(v, _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF)));
+}
+
+static inline __m128 Log2Ps(__m128 v)
+{
+    __m128i bits = _mm_castps_si128(v);
+    __m128i e = _mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127));
+    __m128 m = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007FFFFF)),
+                                             _mm_set1_epi32(0x3F800000)));
+    __m128 big = _mm_cmpgt_ps(m, _mm_set1_ps(GC_SQRT2));
+    m = _mm_or_ps(_mm_and_ps(big, _mm_mul_ps(m, _mm_set1_ps(0.5f))), _mm_andnot_ps(big, m));
+    e = _mm_sub_epi32(e, _mm_castps_si128(big));
+    __m128 one = _mm_set1_ps(1.0f);
+    __m128 s = _mm_div_ps(_mm_sub_ps(m, one), _mm_add_ps(m, one));
+    __m128 s2 = _mm_mul_ps(s, s);
+    __m128 p = _mm_set1_ps(LOG2_C9);
+    p = _mm_add_ps(_mm_mul_ps(p, s2), _mm_set1_ps(LOG2_C7));
+    p = _mm_add_ps(_mm_mul_ps(p, s2), _mm_set1_ps(LOG2_C5));
+    p = _mm_add_ps(_mm_mul_ps(p, s2), _mm_set1_ps(LOG2_C3));
+    p = _mm_add_ps(_mm_mul_ps(p, s2), _mm_set1_ps(LOG2_C1));
+    return _mm_add_ps(_mm_cvtepi32_ps(e), _mm_mul_ps(s, p));
+}
+
+static inline __m128 Exp2Ps(__m128 p)
+{
+    p = _mm_max_ps(p, _mm_set1_ps(-126.0f));
+    __m128i n = _mm_cvtps_epi32(p);
+    __m128 f = _mm_sub_ps(p, _mm_cvtepi32_ps(n));
+    __m128 q = _mm_set1_ps(EXP2_C6);
+    q = _mm_add_ps(_mm_mul_ps(q, f), _mm_set1_ps(EXP2_C5));
+    q = _mm_add_ps(_mm_mul_ps(q, f), _mm_set1_ps(EXP2_C4));
+    q = _mm_add_ps(_mm_mul_ps(q, f), _mm_set1_ps(EXP2_C3));
+    q = _mm_add_ps(_mm_mul_ps(q, f), _mm_set1_ps(EXP2_C2));
+    q = _mm_add_ps(_mm_mul_ps(q, f), _mm_set1_ps(EXP2_C1));
+    q = _mm_add_ps(_mm_mul_ps(q, f), _mm_set1_ps(1.0f));
+    __m128 scale = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23));
+    return _mm_mul_ps(q, scale);
+}
+
+static inline __m128 SelectPs(__m128 mask, __m128 a, __m128 b)
+{
+    return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+#endif
+
+/* ---- Q15 helpers -------------------------------------------------------- */
+
+#define Q30_ONE  (1LL << 30)
+#define Q30_SQRT2 1518500250LL
+
+static const int64_t kLog2Q30[] = { 3098164009LL, 1032721336LL, 619632802LL, 442594858LL, 344240445LL };
+static const int64_t kExp2Q30[] = { 744261118LL, 257941248LL, 59597083LL, 10327387LL,
+                                    1431680LL, 165394LL, 16377LL, 1419LL };
+
+static inline int16_t Sat16(int64_t v)
+{
+    if (v > 32767) return 32767;
+    if (v < -32768) return -32768;
+    return (int16_t)v;
+}
+
+static inline int32_t Sat32(int64_t v)
+{
+    if (v > INT32_MAX) return INT32_MAX;
+    if (v < INT32_MIN) return INT32_MIN;
+    return (int32_t)v;
+}
+
+static inline int64_t DivRound(int64_t num, int64_t den)
+{
+    return num >= 0 ? (num + den / 2) / den : -((-num + den / 2) / den);
+}
+
+/* Rounded integer square root. */
+static uint32_t IsqrtU64(uint64_t v)
+{
+    /* Bit-by-bit root with the compare folded into a mask: stick data makes
+       the per-bit branch unpredictable. */
+    uint64_t res = 0, bit = 1ULL << 62;
+    while (bit > v) bit >>= 2;
+    while (bit)
+    {
+        uint64_t t = res + bit;
+        uint64_t take = (uint64_t)0 - (uint64_t)(v >= t);
+        v -= t & take;
+        res = (res >> 1) + (bit & take);
+        bit >>= 2;
+    }
+    if (v > res) res++;
+    return (uint32_t)res;
+}
+
+static inline uint64_t Mag2Q15(int16_t x, int16_t y)
+{
+    return (uint64_t)((int32_t)x * x) + (uint64_t)((int32_t)y * y);
+}
+
+/* Magnitude in 1/256 stick units: small vectors need the extra bits or the
+   direction x / r is off by tens of percent. */
+#define MAG_FRAC 256
+static inline int64_t Mag8(uint64_t r2)
+{
+    return IsqrtU64(r2 * MAG_FRAC * MAG_FRAC);
+}
+
+static int HighBit(uint32_t v)
+{
+    int n = 0;
+    if (v >= 1u << 16) { v >>= 16; n += 16; }
+    if (v >= 1u << 8)  { v >>= 8;  n += 8; }
+    if (v >= 1u << 4)  { v >>= 4;  n += 4; }
+    if (v >= 1u << 2)  { v >>= 2;  n += 2; }
+    if (v >= 1u << 1)  { n += 1; }
+    return n;
+}
+
+/* log2(v) in Q30 for v > 0. */
+static int64_t Log2Q30(uint32_t v)
+{
+    int k = HighBit(v);
+    int64_t m = k <= 30 ? ((int64_t)v << (30 - k)) : ((int64_t)v >> (k - 30));
+    if (m > Q30_SQRT2) { m >>= 1; k += 1; }
+    int64_t s = (m - Q30_ONE) * Q30_ONE / (m + Q30_ONE);
+    int64_t s2 = (s * s) >> 30;
+    int64_t p = kLog2Q30[4];
+    p = kLog2Q30[3] + ((p * s2) >> 30);
+    p = kLog2Q30[2] + ((p * s2) >> 30);
+    p = kLog2Q30[1] + ((p * s2) >> 30);
+    p = kLog2Q30[0] + ((p * s2) >> 30);
+    return (int64_t)k * Q30_ONE + ((s * p) >> 30);
+}
+
+/* 2^p in Q30 for p <= 0 (Q30). */
+static int64_t Exp2Q30(int64_t p)
+{
+    int64_t n = p >> 30;                 /* floor */
+    int64_t f = p - n * Q30_ONE;         /* [0, 1) */
+    int64_t q = kExp2Q30[7];
+    for (int i = 6; i >= 0; --i) q = kExp2Q30[i] + ((q * f) >> 30);
+    q = Q30_ONE + ((q * f) >> 30);
+    int64_t sh = -n;
+    if (sh >= 62) return 0;
+    return sh == 0 ? q : (q + (1LL << (sh - 1))) >> sh;
+}
+
+static inline void ScaleVecQ15(int16_t* x, int16_t* y, int64_t num, int64_t den)
+{
+    *x = Sat16(DivRound((int64_t)*x * num, den));
+    *y = Sat16(DivRound((int64_t)*y * num, den));
+}
+
+/* ---- deadzones ---------------------------------------------------------- */
+
+static inline float RadialDeadzoneGain(float r, float inner, float invSpan, int rescale)
+{
+    if (r <= 0.0f || r < inner) return 0.0f;
+    return rescale ? (r - inner) * invSpan / r : 1.0f;
+}
+
+void GcDspRadialDeadzoneF(GC_STICKS_F s, float inner, int rescale)
+{
+    float invSpan = inner < 1.0f ? 1.0f / (1.0f - inner) : 0.0f;
+    size_t i = 0;
+#if GC_DSP_SSE2
+    __m128 vin = _mm_set1_ps(inner), vspan = _mm_set1_ps(invSpan), zero = _mm_setzero_ps();
+    for (; i + 4 <= s.Count; i += 4)
+    {
+        __m128 x = _mm_loadu_ps(s.X + i), y = _mm_loadu_ps(s.Y + i);
+        __m128 r = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)));
+        __m128 keep = _mm_and_ps(_mm_cmpge_ps(r, vin), _mm_cmpgt_ps(r, zero));
+        __m128 k = rescale ? _mm_div_ps(_mm_mul_ps(_mm_sub_ps(r, vin), vspan), r) : _mm_set1_ps(1.0f);
+        k = _mm_and_ps(keep, k);
+        _mm_storeu_ps(s.X + i, _mm_mul_ps(x, k));
+        _mm_storeu_ps(s.Y + i, _mm_mul_ps(y, k));
+    }
+#endif
+    for (; i < s.Count; ++i)
+    {
+        float r = sqrtf(s.X[i] * s.X[i] + s.Y[i] * s.Y[i]);
+        float k = RadialDeadzoneGain(r, inner, invSpan, rescale);
+        s.X[i] *= k; s.Y[i] *= k;
+    }
+}
+
+void GcDspRadialDeadzoneQ15(GC_STICKS_Q15 s, int16_t inner, int rescale)
+{
+    int64_t span = GC_Q15_ONE - inner;
+    uint64_t inner2 = inner > 0 ? (uint64_t)((int32_t)inner * inner) : 0;
+    for (size_t i = 0; i < s.Count; ++i)
+    {
+        uint64_t r2 = Mag2Q15(s.X[i], s.Y[i]);
+        if (r2 == 0) continue;
+        if (r2 < inner2) { s.X[i] = 0; s.Y[i] = 0; continue; }
+        if (!rescale || span <= 0) continue;
+        int64_t r8 = Mag8(r2);
+        ScaleVecQ15(&s.X[i], &s.Y[i], (r8 - (int64_t)inner * MAG_FRAC) * GC_Q15_ONE, r8 * span);
+    }
+}
+
+static inline float AxialDeadzone1(float v, float inner, float invSpan, int rescale)
+{
+    float a = AbsF(v);
+    if (a < inner) return 0.0f;
+    if (!rescale) return v;
+    float o = (a - inner) * invSpan;
+    return v < 0.0f ? -o : o;
+}
+
+void GcDspAxialDeadzoneF(GC_STICKS_F s, float inner, int rescale)
+{
+    float invSpan = inner < 1.0f ? 1.0f / (1.0f - inner) : 0.0f;
+    size_t i = 0;
+#if GC_DSP_SSE2
+    __m128 vin = _mm_set1_ps(inner), vspan = _mm_set1_ps(invSpan);
+    __m128 sign = _mm_castsi128_ps(_mm_set1_epi32((int)0x80000000u));
+    for (; i + 4 <= s.Count; i += 4)
+    {
+        for (int axis = 0; axis < 2; ++axis)
+        {
+            float* p = (axis ? s.Y : s.X) + i;
+            __m128 v = _mm_loadu_ps(p);
+            __m128 a = AbsPs(v);
+            __m128 keep = _mm_cmpge_ps(a, vin);
+            __m128 o = rescale ? _mm_or_ps(_mm_mul_ps(_mm_sub_ps(a, vin), vspan), _mm_and_ps(v, sign)) : v;
+            _mm_storeu_ps(p, _mm_and_ps(keep, o));
+        }
+    }
+#endif
+    for (; i < s.Count; ++i)
+    {
+        s.X[i] = AxialDeadzone1(s.X[i], inner, invSpan, rescale);
+        s.Y[i] = AxialDeadzone1(s.Y[i], inner, invSpan, rescale);
+    }
+}
+
+static inline int16_t AxialDeadzone1Q15(int16_t v, int16_t inner, int64_t span, int rescale)
+{
+    int32_t a = v < 0 ? -(int32_t)v : v;
+    if (a < inner) return 0;
+    if (!rescale || span <= 0) return v;
+    int64_t o = DivRound(((int64_t)a - inner) * GC_Q15_ONE, span);
+    return Sat16(v < 0 ? -o : o);
+}
+
+void GcDspAxialDeadzoneQ15(GC_STICKS_Q15 s, int16_t inner, int rescale)
+{
+    int64_t span = GC_Q15_ONE - inner;
+    for (size_t i = 0; i < s.Count; ++i)
+    {
+        s.X[i] = AxialDeadzone1Q15(s.X[i], inner, span, rescale);
+        s.Y[i] = AxialDeadzone1Q15(s.Y[i], inner, span, rescale);
+    }
+}
+
+/* ---- anti-deadzone / curve ---------------------------------------------- */
+
+/* r' = maxR * (adz + (1 - adz) * min(r / maxR, 1)) = adz * maxR + (1 - adz) * min(r, maxR) */
+void GcDspAntiDeadzoneF(GC_STICKS_F s, float adz, float maxR)
+{
+    float base = adz * maxR, slope = 1.0f - adz;
+    size_t i = 0;
+#if GC_DSP_SSE2
+    __m128 vbase = _mm_set1_ps(base), vslope = _mm_set1_ps(slope), vmax = _mm_set1_ps(maxR);
+    __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= s.Count; i += 4)
+    {
+        __m128 x = _mm_loadu_ps(s.X + i), y = _mm_loadu_ps(s.Y + i);
+        __m128 r = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)));
+        __m128 t = _mm_add_ps(vbase, _mm_mul_ps(vslope, _mm_min_ps(r, vmax)));
+        __m128 k = _mm_and_ps(_mm_cmpgt_ps(r, zero), _mm_div_ps(t, r));
+        _mm_storeu_ps(s.X + i, _mm_mul_ps(x, k));
+        _mm_storeu_ps(s.Y + i, _mm_mul_ps(y, k));
+    }
+#endif
+    for (; i < s.Count; ++i)
+    {
+        float r = sqrtf(s.X[i] * s.X[i] + s.Y[i] * s.Y[i]);
+        if (r <= 0.0f) continue;
+        float k = (base + slope * MinF(r, maxR)) / r;
+        s.X[i] *= k; s.Y[i] *= k;
+    }
+}
+
+void GcDspAntiDeadzoneQ15(GC_STICKS_Q15 s, int16_t adz, int16_t maxR)
+{
+    for (size_t i = 0; i < s.Count; ++i)
+    {
+        uint64_t r2 = Mag2Q15(s.X[i], s.Y[i]);
+        if (r2 == 0) continue;
+        int64_t r8 = Mag8(r2), max8 = (int64_t)maxR * MAG_FRAC;
+        int64_t rc8 = r8 < max8 ? r8 : max8;
+        int64_t num = (int64_t)adz * max8 + (32768 - (int64_t)adz) * rc8;
+        ScaleVecQ15(&s.X[i], &s.Y[i], num, r8 * 32768);
+    }
+}
+
+void GcDspRadialCurveF(GC_STICKS_F s, float expo, float maxR)
+{
+    float e = 1.0f - expo;
+    float invMax = maxR > 0.0f ? 1.0f / maxR : 0.0f;
+    size_t i = 0;
+#if GC_DSP_SSE2
+    __m128 ve = _mm_set1_ps(e), vinv = _mm_set1_ps(invMax), vmax = _mm_set1_ps(maxR);
+    __m128 one = _mm_set1_ps(1.0f), tiny = _mm_set1_ps(GC_FLT_MIN), zero = _mm_setzero_ps();
+    for (; i + 4 <= s.Count; i += 4)
+    {
+        __m128 x = _mm_loadu_ps(s.X + i), y = _mm_loadu_ps(s.Y + i);
+        __m128 r = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)));
+        __m128 rn = _mm_max_ps(_mm_min_ps(_mm_mul_ps(r, vinv), one), tiny);
+        __m128 rp = Exp2Ps(_mm_mul_ps(ve, Log2Ps(rn)));
+        __m128 k = _mm_and_ps(_mm_cmpgt_ps(r, zero), _mm_div_ps(_mm_mul_ps(rp, vmax), r));
+        _mm_storeu_ps(s.X + i, _mm_mul_ps(x, k));
+        _mm_storeu_ps(s.Y + i, _mm_mul_ps(y, k));
+    }
+#endif
+    for (; i < s.Count; ++i)
+    {
+        float r = sqrtf(s.X[i] * s.X[i] + s.Y[i] * s.Y[i]);
+        if (r <= 0.0f) continue;
+        float rn = MinF(r * invMax, 1.0f);
+        if (rn < GC_FLT_MIN) rn = GC_FLT_MIN;
+        float k = Exp2F(e * Log2F(rn)) * maxR / r;
+        s.X[i] *= k; s.Y[i] *= k;
+    }
+}
+
+void GcDspRadialCurveQ15(GC_STICKS_Q15 s, int16_t expo, int16_t maxR)
+{
+    if (maxR <= 0) return;
+    uint32_t e = 32768u - (uint32_t)(expo < 0 ? 0 : expo);
+    /* log2 of the squared magnitudes keeps the exponent exact; halve after. */
+    uint32_t max2 = (uint32_t)((int32_t)maxR * maxR);
+    int64_t logMax2 = Log2Q30(max2);
+    for (size_t i = 0; i < s.Count; ++i)
+    {
+        uint64_t r2 = Mag2Q15(s.X[i], s.Y[i]);
+        if (r2 == 0) continue;
+        int64_t l2 = r2 < max2 ? Log2Q30((uint32_t)r2) - logMax2 : 0;
+        int64_t p = Exp2Q30(l2 * (int64_t)e / 65536);
+        ScaleVecQ15(&s.X[i], &s.Y[i], p * maxR, Mag8(r2) * (Q30_ONE / MAG_FRAC));
+    }
+}
+
+/* ---- velocity gain ------------------------------------------------------ */
+
+void GcDspVelocityGainF(GC_STICKS_F s, float gain, float* lastR)
+{
+    size_t i = 0;
+#if GC_DSP_SSE2
+    __m128 vg = _mm_set1_ps(gain), vcap = _mm_set1_ps(1.5f), one = _mm_set1_ps(1.0f);
+    __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= s.Count; i += 4)
+    {
+        __m128 x = _mm_loadu_ps(s.X + i), y = _mm_loadu_ps(s.Y + i);
+        __m128 r = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)));
+        __m128 v = _mm_min_ps(AbsPs(_mm_sub_ps(r, _mm_loadu_ps(lastR + i))), vcap);
+        __m128 g = _mm_add_ps(one, _mm_mul_ps(vg, v));
+        __m128 live = _mm_cmpgt_ps(r, zero);
+        _mm_storeu_ps(lastR + i, _mm_and_ps(live, _mm_mul_ps(r, g)));
+        _mm_storeu_ps(s.X + i, _mm_mul_ps(x, g));
+        _mm_storeu_ps(s.Y + i, _mm_mul_ps(y, g));
+    }
+#endif
+    for (; i < s.Count; ++i)
+    {
+        float r = sqrtf(s.X[i] * s.X[i] + s.Y[i] * s.Y[i]);
+        if (r <= 0.0f) { lastR[i] = 0.0f; continue; }
+        float g = 1.0f + gain * MinF(AbsF(r - lastR[i]), 1.5f);
+        lastR[i] = r * g;
+        s.X[i] *= g; s.Y[i] *= g;
+    }
+}
+
+void GcDspVelocityGainQ15(GC_STICKS_Q15 s, int32_t gain, int32_t* lastR)
+{
+    const int64_t cap = (3 * GC_Q15_ONE) / 2;
+    for (size_t i = 0; i < s.Count; ++i)
+    {
+        uint64_t r2 = Mag2Q15(s.X[i], s.Y[i]);
+        if (r2 == 0) { lastR[i] = 0; continue; }
+        int64_t r8 = Mag8(r2);
+        int64_t v8 = r8 - (int64_t)lastR[i] * MAG_FRAC;
+        if (v8 < 0) v8 = -v8;
+        if (v8 > cap * MAG_FRAC) v8 = cap * MAG_FRAC;
+        int64_t g = 32768 + DivRound((int64_t)gain * v8, (int64_t)GC_Q15_ONE * MAG_FRAC);
+        int64_t rg8 = DivRound(r8 * g, 32768);
+        lastR[i] = (int32_t)DivRound(rg8, MAG_FRAC);
+        if (rg8 > (int64_t)GC_Q15_ONE * MAG_FRAC) rg8 = (int64_t)GC_Q15_ONE * MAG_FRAC;
+        ScaleVecQ15(&s.X[i], &s.Y[i], rg8, r8);
+    }
+}
+
+/* ---- smoothing ---------------------------------------------------------- */
+
+void GcDspEmaF(GC_STICKS_F s, float alpha, float* stateX, float* stateY)
+{
+    size_t i = 0;
+#if GC_DSP_SSE2
+    __m128 va = _mm_set1_ps(alpha);
+    for (; i + 4 <= s.Count; i += 4)
+    {
+        __m128 sx = _mm_loadu_ps(stateX + i), sy = _mm_loadu_ps(stateY + i);
+        sx = _mm_add_ps(sx, _mm_mul_ps(va, _mm_sub_ps(_mm_loadu_ps(s.X + i), sx)));
+        sy = _mm_add_ps(sy, _mm_mul_ps(va, _mm_sub_ps(_mm_loadu_ps(s.Y + i), sy)));
+        _mm_storeu_ps(stateX + i, sx); _mm_storeu_ps(s.X + i, sx);
+        _mm_storeu_ps(stateY + i, sy); _mm_storeu_ps(s.Y + i, sy);
+    }
+#endif
+    for (; i < s.Count; ++i)
+    {
+        stateX[i] += alpha * (s.X[i] - stateX[i]);
+        stateY[i] += alpha * (s.Y[i] - stateY[i]);
+        s.X[i] = stateX[i];
+        s.Y[i] = stateY[i];
+    }
+}
+
+void GcDspEmaQ15(GC_STICKS_Q15 s, int16_t alpha, int32_t* stateX, int32_t* stateY)
+{
+    for (size_t i = 0; i < s.Count; ++i)
+    {
+        stateX[i] += (int32_t)DivRound((int64_t)alpha * (((int64_t)s.X[i] * 65536) - stateX[i]), 32768);
+        stateY[i] += (int32_t)DivRound((int64_t)alpha * (((int64_t)s.Y[i] * 65536) - stateY[i]), 32768);
+        s.X[i] = Sat16(DivRound(stateX[i], 65536));
+        s.Y[i] = Sat16(DivRound(stateY[i], 65536));
+    }
+}
+
+void GcDspOneEuroResetF(GC_STICKS_F s, GC_ONE_EURO_STATE_F st)
+{
+    for (size_t i = 0; i < s.Count; ++i)
+    {
+        st.FiltX[i] = s.X[i]; st.FiltY[i] = s.Y[i];
+        st.DerivX[i] = 0.0f;  st.DerivY[i] = 0.0f;
+    }
+}
+
+void GcDspOneEuroF(GC_STICKS_F s, const GC_ONE_EURO_PARAMS* p, GC_ONE_EURO_STATE_F st)
+{
+    /* alpha = 1 / (1 + tau / Te) with tau = 1 / (2 pi fc) and Te = 1 / rate */
+    float rate = p->RateHz;
+    float wd = GC_TWO_PI * p->DCutoffHz;
+    float ad = wd / (wd + rate);
+    float wmin = GC_TWO_PI * p->MinCutoffHz, wbeta = GC_TWO_PI * p->Beta;
+    size_t i = 0;
+#if GC_DSP_SSE2
+    __m128 vrate = _mm_set1_ps(rate), vad = _mm_set1_ps(ad);
+    __m128 vwmin = _mm_set1_ps(wmin), vwbeta = _mm_set1_ps(wbeta);
+    for (; i + 4 <= s.Count; i += 4)
+    {
+        __m128 x = _mm_loadu_ps(s.X + i), y = _mm_loadu_ps(s.Y + i);
+        __m128 fx = _mm_loadu_ps(st.FiltX + i), fy = _mm_loadu_ps(st.FiltY + i);
+        __m128 ex = _mm_loadu_ps(st.DerivX + i), ey = _mm_loadu_ps(st.DerivY + i);
+        __m128 dx = _mm_sub_ps(x, fx), dy = _mm_sub_ps(y, fy);
+        ex = _mm_add_ps(ex, _mm_mul_ps(vad, _mm_sub_ps(_mm_mul_ps(dx, vrate), ex)));
+        ey = _mm_add_ps(ey, _mm_mul_ps(vad, _mm_sub_ps(_mm_mul_ps(dy, vrate), ey)));
+        __m128 speed = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(ex, ex), _mm_mul_ps(ey, ey)));
+        __m128 w = _mm_add_ps(vwmin, _mm_mul_ps(vwbeta, speed));
+        __m128 a = _mm_div_ps(w, _mm_add_ps(w, vrate));
+        fx = _mm_add_ps(fx, _mm_mul_ps(a, dx));
+        fy = _mm_add_ps(fy, _mm_mul_ps(a, dy));
+        _mm_storeu_ps(st.DerivX + i, ex); _mm_storeu_ps(st.DerivY + i, ey);
+        _mm_storeu_ps(st.FiltX + i, fx);  _mm_storeu_ps(st.FiltY + i, fy);
+        _mm_storeu_ps(s.X + i, fx);       _mm_storeu_ps(s.Y + i, fy);
+    }
+#endif
+    for (; i < s.Count; ++i)
+    {
+        float dx = s.X[i] - st.FiltX[i], dy = s.Y[i] - st.FiltY[i];
+        st.DerivX[i] += ad * (dx * rate - st.DerivX[i]);
+        st.DerivY[i] += ad * (dy * rate - st.DerivY[i]);
+        float speed = sqrtf(st.DerivX[i] * st.DerivX[i] + st.DerivY[i] * st.DerivY[i]);
+        float w = wmin + wbeta * speed;
+        float a = w / (w + rate);
+        st.FiltX[i] += a * dx; st.FiltY[i] += a * dy;
+        s.X[i] = st.FiltX[i];  s.Y[i] = st.FiltY[i];
+    }
+}
+
+void GcDspOneEuroResetQ15(GC_STICKS_Q15 s, GC_ONE_EURO_STATE_Q15 st)
+{
+    for (size_t i = 0; i < s.Count; ++i)
+    {
+        st.FiltX[i] = (int32_t)s.X[i] * 65536; st.FiltY[i] = (int32_t)s.Y[i] * 65536;
+        st.DerivX[i] = 0;                      st.DerivY[i] = 0;
+    }
+}
+
+/* 2*pi in Q16 */
+#define GC_TWO_PI_Q16 411775LL
+
+void GcDspOneEuroQ15(GC_STICKS_Q15 s, const GC_ONE_EURO_PARAMS_Q15* p, GC_ONE_EURO_STATE_Q15 st)
+{
+    /* Same alpha = w / (w + rate) as the float path, with w = 2 pi fc in
+       milli-rad/s against the rate in mHz. Alphas are Q30: at 1 kHz and a
+       1 Hz cutoff alpha is ~0.006, which Q15 would only resolve to 0.3%. */
+    int64_t rate = p->RateHz, rateM = rate * 1000;
+    int64_t wd = ((int64_t)p->DCutoffMilliHz * GC_TWO_PI_Q16) >> 16;
+    int64_t ad = DivRound(wd * Q30_ONE, wd + rateM);
+    for (size_t i = 0; i < s.Count; ++i)
+    {
+        int64_t dx = (int64_t)s.X[i] * 65536 - st.FiltX[i];
+        int64_t dy = (int64_t)s.Y[i] * 65536 - st.FiltY[i];
+        int64_t ex = st.DerivX[i], ey = st.DerivY[i];
+        ex = Sat32(ex + DivRound(ad * (DivRound(dx * rate, 65536) - ex), Q30_ONE));
+        ey = Sat32(ey + DivRound(ad * (DivRound(dy * rate, 65536) - ey), Q30_ONE));
+        st.DerivX[i] = (int32_t)ex; st.DerivY[i] = (int32_t)ey;
+        int64_t speed = IsqrtU64((uint64_t)(ex * ex) + (uint64_t)(ey * ey));
+        int64_t fc = p->MinCutoffMilliHz + DivRound((int64_t)p->BetaMilliHz * speed, GC_Q15_ONE);
+        int64_t w = (fc * GC_TWO_PI_Q16) >> 16;
+        int64_t a = DivRound(w * Q30_ONE, w + rateM);
+        st.FiltX[i] += (int32_t)DivRound(a * dx, Q30_ONE);
+        st.FiltY[i] += (int32_t)DivRound(a * dy, Q30_ONE);
+        s.X[i] = Sat16(DivRound(st.FiltX[i], 65536));
+        s.Y[i] = Sat16(DivRound(st.FiltY[i], 65536));
+    }
+}
+
+/* ---- clamp / conversion ------------------------------------------------- */
+
+void GcDspCircularClampF(GC_STICKS_F s, float maxR)
+{
+    size_t i = 0;
+#if GC_DSP_SSE2
+    __m128 vmax = _mm_set1_ps(maxR), one = _mm_set1_ps(1.0f);
+    for (; i + 4 <= s.Count; i += 4)
+    {
+        __m128 x = _mm_loadu_ps(s.X + i), y = _mm_loadu_ps(s.Y + i);
+        __m128 r = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)));
+        __m128 k = SelectPs(_mm_cmpgt_ps(r, vmax), _mm_div_ps(vmax, r), one);
+        _mm_storeu_ps(s.X + i, _mm_mul_ps(x, k));
+        _mm_storeu_ps(s.Y + i, _mm_mul_ps(y, k));
+    }
+#endif
+    for (; i < s.Count; ++i)
+    {
+        float r = sqrtf(s.X[i] * s.X[i] + s.Y[i] * s.Y[i]);
+        if (r <= maxR) continue;
+        float k = maxR / r;
+        s.X[i] *= k; s.Y[i] *= k;
+    }
+}
+
+void GcDspCircularClampQ15(GC_STICKS_Q15 s, int16_t maxR)
+{
+    uint64_t max2 = maxR > 0 ? (uint64_t)((int32_t)maxR * maxR) : 0;
+    for (size_t i = 0; i < s.Count; ++i)
+    {
+        uint64_t r2 = Mag2Q15(s.X[i], s.Y[i]);
+        if (r2 <= max2) continue;
+        ScaleVecQ15(&s.X[i], &s.Y[i], (int64_t)maxR * MAG_FRAC, Mag8(r2));
+    }
+}
+
+void GcDspToQ15(const float* in, int16_t* out, size_t count)
+{
+    for (size_t i = 0; i < count; ++i)
+    {
+        float v = in[i] * (float)GC_Q15_ONE;
+        if (v > 32767.0f) v = 32767.0f;
+        if (v < -32768.0f) v = -32768.0f;
+        out[i] = (int16_t)(v < 0.0f ? v - 0.5f : v + 0.5f);
+    }
+}
+
+void GcDspFromQ15(const int16_t* in, float* out, size_t count)
+{
+    const float k = 1.0f / (float)GC_Q15_ONE;
+    for (size_t i = 0; i < count; ++i) out[i] = (float)in[i] * k;
+}
@@ -0,0 +1,67 @@
+#include "gc/Watchdog.h"
+
+#include <string.h>
+
+void GcWatchdogInit(PGC_WATCHDOG w, uint64_t timeoutNs)
+{
+    memset(w, 0, sizeof(*w));
+    w->TimeoutNs = timeoutNs;
+    w->State = GC_WATCHDOG_IDLE;
+}
+
+int GcWatchdogFeed(PGC_WATCHDOG w, uint64_t nowNs)
+{
+    w->LastFeedNs = nowNs;
+    if (w->TimeoutNs == 0 || w->State == GC_WATCHDOG_ARMED) return 0;
+    if (w->State == GC_WATCHDOG_STALE)
+    {
+        w->Recoveries++;
+        w->StaleSinceNs = 0;
+    }
+    w->State = GC_WATCHDOG_ARMED;
+    return 1;
+}
+
+int GcWatchdogPoll(PGC_WATCHDOG w, uint64_t nowNs, uint64_t* nextNs)
+{
+    *nextNs = 0;
+    if (w->State != GC_WATCHDOG_ARMED) return 0;
+    uint64_t deadline = w->LastFeedNs + w->TimeoutNs;
+    if (nowNs < deadline)
+    {
+        /* Fed since the timer was started: sleep until the moved deadline. */
+        *nextNs = deadline;
+        return 0;
+    }
+    w->State = GC_WATCHDOG_STALE;
+    w->StaleSinceNs = nowNs;
+    w->Expirations++;
+    return 1;
+}
+
+int GcWatchdogSetTimeout(PGC_WATCHDOG w, uint64_t timeoutNs, uint64_t nowNs)
+{
+    w->TimeoutNs = timeoutNs;
+    if (timeoutNs == 0)
+    {
+        w->State = GC_WATCHDOG_IDLE;
+        w->StaleSinceNs = 0;
+        return 0;
+    }
+    if (w->State != GC_WATCHDOG_ARMED) return 0;
+    /* The new timeout counts from now, not from the last feed, so
+       shortening it never expires a client that was within the old one. */
+    if (w->LastFeedNs < nowNs) w->LastFeedNs = nowNs;
+    return 1;
+}
+
+void GcWatchdogStop(PGC_WATCHDOG w)
+{
+    w->State = GC_WATCHDOG_IDLE;
+    w->StaleSinceNs = 0;
+}
+
+int GcWatchdogStale(const GC_WATCHDOG* w)
+{
+    return w->State == GC_WATCHDOG_STALE;
+}
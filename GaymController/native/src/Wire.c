@@ -0,0 +1,131 @@
+#include "gc/Wire.h"
+
+#define SET_STATE_PAYLOAD 24
+#define TRACE_BYTES       16
+
+static inline void Put16(uint8_t* p, uint16_t v) { p[0] = (uint8_t)v; p[1] = (uint8_t)(v >> 8); }
+static inline void Put32(uint8_t* p, uint32_t v) { Put16(p, (uint16_t)v); Put16(p + 2, (uint16_t)(v >> 16)); }
+static inline void Put64(uint8_t* p, uint64_t v) { Put32(p, (uint32_t)v); Put32(p + 4, (uint32_t)(v >> 32)); }
+static inline uint16_t Get16(const uint8_t* p) { return (uint16_t)(p[0] | (p[1] << 8)); }
+static inline uint32_t Get32(const uint8_t* p) { return Get16(p) | ((uint32_t)Get16(p + 2) << 16); }
+static inline uint64_t Get64(const uint8_t* p) { return Get32(p) | ((uint64_t)Get32(p + 4) << 32); }
+
+static uint8_t* Begin(uint8_t* dst, size_t cap, uint32_t payload, uint16_t type, uint16_t flags)
+{
+    uint32_t len = GC_WIRE_HEADER_BYTES + payload;
+    if (cap < len) return NULL;
+    Put32(dst, len);
+    Put16(dst + 4, type);
+    Put16(dst + 6, flags);
+    return dst + GC_WIRE_HEADER_BYTES;
+}
+
+static size_t PackU32(uint8_t* dst, size_t cap, uint16_t type, uint32_t v)
+{
+    uint8_t* p = Begin(dst, cap, 4, type, 0);
+    if (!p) return 0;
+    Put32(p, v);
+    return GC_WIRE_HEADER_BYTES + 4;
+}
+
+static size_t PackU64(uint8_t* dst, size_t cap, uint16_t type, uint64_t v)
+{
+    uint8_t* p = Begin(dst, cap, 8, type, 0);
+    if (!p) return 0;
+    Put64(p, v);
+    return GC_WIRE_HEADER_BYTES + 8;
+}
+
+size_t GcWirePackHello(uint8_t* dst, size_t cap) { return PackU32(dst, cap, GC_MSG_HELLO, 1); }
+size_t GcWirePackHelloOk(uint8_t* dst, size_t cap, uint32_t caps) { return PackU32(dst, cap, GC_MSG_HELLO_OK, caps); }
+size_t GcWirePackOpenController(uint8_t* dst, size_t cap, uint32_t slot) { return PackU32(dst, cap, GC_MSG_OPEN_CONTROLLER, slot); }
+size_t GcWirePackOpenOk(uint8_t* dst, size_t cap, uint64_t handle) { return PackU64(dst, cap, GC_MSG_OPEN_OK, handle); }
+size_t GcWirePackAck(uint8_t* dst, size_t cap, uint32_t echoType) { return PackU32(dst, cap, GC_MSG_ACK, echoType); }
+size_t GcWirePackCloseController(uint8_t* dst, size_t cap, uint64_t handle) { return PackU64(dst, cap, GC_MSG_CLOSE_CONTROLLER, handle); }
+size_t GcWirePackRumbleSubscribe(uint8_t* dst, size_t cap, uint64_t handle) { return PackU64(dst, cap, GC_MSG_RUMBLE_SUBSCRIBE, handle); }
+
+size_t GcWirePackSetState(uint8_t* dst, size_t cap, uint64_t handle, const GC_GAMEPAD_STATE* state,
+                          const GC_TRACE* trace)
+{
+    uint32_t payload = SET_STATE_PAYLOAD + (trace ? TRACE_BYTES : 0);
+    uint8_t* p = Begin(dst, cap, payload, GC_MSG_SET_STATE, trace ? GC_WIRE_FLAG_TRACE : 0);
+    if (!p) return 0;
+    Put64(p, handle);
+    Put16(p + 8, state->LX);
+    Put16(p + 10, state->LY);
+    Put16(p + 12, state->RX);
+    Put16(p + 14, state->RY);
+    Put16(p + 16, state->LT);
+    Put16(p + 18, state->RT);
+    Put32(p + 20, state->Buttons);
+    if (trace)
+    {
+        Put32(p + 24, trace->Sequence);
+        Put32(p + 28, trace->LastOffsetNs);
+        Put64(p + 32, trace->OriginNs);
+    }
+    return GC_WIRE_HEADER_BYTES + payload;
+}
+
+size_t GcWirePackRumbleEvent(uint8_t* dst, size_t cap, uint64_t handle, uint16_t low, uint16_t high)
+{
+    uint8_t* p = Begin(dst, cap, 12, GC_MSG_RUMBLE_EVENT, 0);
+    if (!p) return 0;
+    Put64(p, handle);
+    Put16(p + 8, low);
+    Put16(p + 10, high);
+    return GC_WIRE_HEADER_BYTES + 12;
+}
+
+size_t GcWirePackError(uint8_t* dst, size_t cap, uint32_t code, uint32_t detail)
+{
+    uint8_t* p = Begin(dst, cap, 8, GC_MSG_ERROR, 0);
+    if (!p) return 0;
+    Put32(p, code);
+    Put32(p + 4, detail);
+    return GC_WIRE_HEADER_BYTES + 8;
+}
+
+GC_WIRE_STATUS GcWireParseFrame(const uint8_t* src, size_t len, GC_WIRE_FRAME* frame)
+{
+    if (len < GC_WIRE_HEADER_BYTES) return GC_WIRE_NEED_MORE;
+    uint32_t flen = Get32(src);
+    if (flen < GC_WIRE_HEADER_BYTES || flen > GC_WIRE_MAX_FRAME) return GC_WIRE_BAD_LENGTH;
+    if (len < flen) return GC_WIRE_NEED_MORE;
+    frame->Length = flen;
+    frame->Type = Get16(src + 4);
+    frame->Flags = Get16(src + 6);
+    frame->Payload = src + GC_WIRE_HEADER_BYTES;
+    frame->PayloadLength = flen - GC_WIRE_HEADER_BYTES;
+    return GC_WIRE_OK;
+}
+
+GC_WIRE_STATUS GcWireReadSetState(const GC_WIRE_FRAME* frame, GC_WIRE_SET_STATE* out)
+{
+    int traced = (frame->Flags & GC_WIRE_FLAG_TRACE) != 0;
+    uint32_t want = SET_STATE_PAYLOAD + (traced ? TRACE_BYTES : 0);
+    if (frame->Type != GC_MSG_SET_STATE || frame->PayloadLength < want) return GC_WIRE_BAD_PAYLOAD;
+    const uint8_t* p = frame->Payload;
+    out->Handle = Get64(p);
+    out->State.LX = Get16(p + 8);
+    out->State.LY = Get16(p + 10);
+    out->State.RX = Get16(p + 12);
+    out->State.RY = Get16(p + 14);
+    out->State.LT = Get16(p + 16);
+    out->State.RT = Get16(p + 18);
+    out->State.Buttons = Get32(p + 20);
+    out->HasTrace = traced;
+    if (traced)
+    {
+        out->Trace.Sequence = Get32(p + 24);
+        out->Trace.LastOffsetNs = Get32(p + 28);
+        out->Trace.OriginNs = Get64(p + 32);
+    }
+    else
+    {
+        out->Trace.Sequence = 0;
+        out->Trace.LastOffsetNs = 0;
+        out->Trace.OriginNs = 0;
+    }
+    return GC_WIRE_OK;
+}
@@ -0,0 +1,166 @@
+#include "Check.h"
+#include "gc/AllowList.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace {
+
+GC_ALLOW_ENTRY Entry(uint32_t image, uint32_t pid) {
+    GC_ALLOW_ENTRY e{};
+    uint64_t s = image * 0x9E3779B97F4A7C15ull + 1;   // stand-in for a SHA-256
+    for (auto& b : e.Digest) b = uint8_t((s = s * 6364136223846793005ull + 1442695040888963407ull) >> 56);
+    e.Pid = pid;
+    return e;
+}
+
+struct Buffer {
+    explicit Buffer(uint32_t count) : Bytes(GcAllowSetBytes(count)), Mem((Bytes + 7) / 8) {}
+    PGC_ALLOW_SET Build(const std::vector<GC_ALLOW_ENTRY>& v, uint32_t gen) {
+        return GcAllowSetBuild(Mem.data(), Bytes, v.data(), uint32_t(v.size()), gen);
+    }
+    size_t Bytes;
+    std::vector<uint64_t> Mem;
+};
+
+} // namespace
+
+GC_TEST(MatchesExactPidAndWildcard) {
+    std::vector<GC_ALLOW_ENTRY> v = {Entry(1, 1000), Entry(2, GC_ALLOW_ANY_PID), Entry(1, 1000), Entry(3, 8)};
+    Buffer buf(uint32_t(v.size()));
+    PGC_ALLOW_SET s = buf.Build(v, 7);
+    GC_CHECK(s != nullptr);
+    GC_CHECK(GcAllowSetCount(s) == 3);   // duplicate collapsed
+    GC_CHECK(GcAllowSetGeneration(s) == 7);
+
+    GC_CHECK(GcAllowSetContains(s, Entry(1, 0).Digest, 1000));
+    GC_CHECK(!GcAllowSetContains(s, Entry(1, 0).Digest, 1004));   // image 1 only for PID 1000
+    GC_CHECK(GcAllowSetContains(s, Entry(2, 0).Digest, 1004));    // image 2 for any PID
+    GC_CHECK(GcAllowSetContains(s, Entry(2, 0).Digest, 4));
+    GC_CHECK(GcAllowSetContains(s, Entry(3, 0).Digest, 8));
+    GC_CHECK(!GcAllowSetContains(s, Entry(4, 0).Digest, 8));
+
+    // One differing digest byte is a different identity.
+    GC_ALLOW_ENTRY e = Entry(1, 1000);
+    e.Digest[31] ^= 1;
+    GC_CHECK(!GcAllowSetContains(s, e.Digest, 1000));
+}
+
+GC_TEST(RejectsBadBuffers) {
+    std::vector<GC_ALLOW_ENTRY> v = {Entry(1, 4)};
+    Buffer buf(1);
+    GC_CHECK(GcAllowSetBuild(buf.Mem.data(), buf.Bytes - 1, v.data(), 1, 0) == nullptr);
+    GC_CHECK(GcAllowSetBuild(reinterpret_cast<uint8_t*>(buf.Mem.data()) + 4, buf.Bytes, v.data(), 1, 0) == nullptr);
+    GC_CHECK(GcAllowSetBytes(GC_ALLOW_MAX_ENTRIES + 1) == 0);
+    GC_CHECK(GcAllowSetBuild(buf.Mem.data(), buf.Bytes, v.data(), 0, 0) != nullptr);   // empty list
+}
+
+GC_TEST(LargeSetHasNoFalseHits) {
+    const uint32_t n = 10000;
+    std::vector<GC_ALLOW_ENTRY> v;
+    for (uint32_t i = 0; i < n; ++i) v.push_back(Entry(i, (i % 3) ? i * 4 : GC_ALLOW_ANY_PID));
+    Buffer buf(n);
+    PGC_ALLOW_SET s = buf.Build(v, 1);
+    GC_CHECK(GcAllowSetCount(s) == n);
+    int hits = 0, falseHits = 0;
+    for (uint32_t i = 0; i < n; ++i) {
+        hits += GcAllowSetContains(s, Entry(i, 0).Digest, i * 4);
+        falseHits += GcAllowSetContains(s, Entry(i + n, 0).Digest, i * 4);
+        if (i % 3) falseHits += GcAllowSetContains(s, Entry(i, 0).Digest, i * 4 + 4);
+    }
+    GC_CHECK(hits == int(n));
+    GC_CHECK(falseHits == 0);
+}
+
+GC_TEST(EmptyListPassesThroughAndPublishReturnsPrevious) {
+    auto l = std::make_unique<GC_ALLOW_LIST>();
+    GcAllowListInit(l.get());
+    GC_CHECK(GcAllowListCheck(l.get(), Entry(9, 0).Digest, 4) == 1);   // fail-safe pass-through
+    GC_CHECK(GcAllowListGeneration(l.get()) == 0);
+
+    Buffer a(1), b(1);
+    PGC_ALLOW_SET sa = a.Build({Entry(1, 0)}, 1);
+    PGC_ALLOW_SET sb = b.Build({Entry(2, 0)}, 2);
+    GC_CHECK(GcAllowListPublish(l.get(), sa) == nullptr);
+    GC_CHECK(GcAllowListCheck(l.get(), Entry(1, 0).Digest, 4) == 1);
+    GC_CHECK(GcAllowListCheck(l.get(), Entry(2, 0).Digest, 4) == 0);
+    GC_CHECK(GcAllowListPublish(l.get(), sb) == sa);
+    GC_CHECK(GcAllowListGeneration(l.get()) == 2);
+    GC_CHECK(GcAllowListCheck(l.get(), Entry(1, 0).Digest, 4) == 0);
+    GC_CHECK(GcAllowListCheck(l.get(), Entry(2, 0).Digest, 4) == 1);
+    GC_CHECK(GcAllowListPublish(l.get(), nullptr) == sb);
+    GC_CHECK(GcAllowListCheck(l.get(), Entry(1, 0).Digest, 4) == 1);
+}
+
+GC_TEST(LookupsStayConsistentDuringSwaps) {
+    // Every set allows the 'always' images and never the 'never' images;
+    // the rest change per generation. Retired sets are poisoned before
+    // reuse, so a reader still inside one would see wrong answers.
+    const uint32_t n = 256;
+    auto l = std::make_unique<GC_ALLOW_LIST>();
+    GcAllowListInit(l.get());
+    std::vector<std::unique_ptr<Buffer>> pool;
+    for (int i = 0; i < 3; ++i) pool.push_back(std::make_unique<Buffer>(n));
+
+    auto listFor = [&](uint32_t gen) {
+        std::vector<GC_ALLOW_ENTRY> v;
+        for (uint32_t i = 0; i < n / 2; ++i) v.push_back(Entry(i, GC_ALLOW_ANY_PID));             // always
+        for (uint32_t i = 0; i < n / 2; ++i) v.push_back(Entry(10000 + gen * n + i, GC_ALLOW_ANY_PID));
+        return v;
+    };
+    std::vector<Buffer*> free = {pool[1].get(), pool[2].get()};
+    GcAllowListPublish(l.get(), pool[0]->Build(listFor(1), 1));
+
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> lookups{0}, wrong{0};
+    std::vector<std::thread> readers;
+    for (uint32_t t = 0; t < 4; ++t) {
+        readers.emplace_back([&, t] {
+            uint64_t local = 0, bad = 0;
+            uint32_t lastGen = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                for (uint32_t i = 0; i < n / 2; ++i) {
+                    uint32_t pid = (t * 997 + i) * 4;
+                    bad += GcAllowListCheck(l.get(), Entry(i, 0).Digest, pid) != 1;
+                    bad += GcAllowListCheck(l.get(), Entry(5000 + i, 0).Digest, pid) != 0;   // never
+                    local += 2;
+                }
+                uint32_t gen = GcAllowListGeneration(l.get());
+                bad += gen < lastGen || gen == 0;   // generations only move forward
+                lastGen = gen;
+            }
+            lookups += local;
+            wrong += bad;
+        });
+    }
+
+    const uint32_t swaps = 2000;
+    for (uint32_t gen = 2; gen <= swaps; ++gen) {
+        Buffer* b = free.back();
+        free.pop_back();
+        PGC_ALLOW_SET old = GcAllowListPublish(l.get(), b->Build(listFor(gen), gen));
+        for (auto& p : pool)
+            if (reinterpret_cast<void*>(p->Mem.data()) == old) {
+                std::memset(p->Mem.data(), 0xA5, p->Bytes);
+                free.push_back(p.get());
+            }
+        if (gen % 64 == 0) std::this_thread::yield();
+    }
+    stop = true;
+    for (auto& r : readers) r.join();
+
+    GC_CHECK(free.size() == 2);
+    GC_CHECK(wrong.load() == 0);
+    GC_CHECK(lookups.load() > 0);
+    GC_CHECK(GcAllowListGeneration(l.get()) == swaps);
+    for (uint32_t k = 0; k < GC_ALLOW_STRIPES; ++k) {
+        GC_CHECK(l->Slots[0][k].Readers == 0);
+        GC_CHECK(l->Slots[1][k].Readers == 0);
+    }
+}
+
+GC_TEST_MAIN()
@@ -0,0 +1,156 @@
+#include "Check.h"
+#include "gc/AnalogHistory.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+struct Rng {
+    uint32_t S = 0x2468ACE1u;
+    uint32_t Next() { S ^= S << 13; S ^= S >> 17; S ^= S << 5; return S; }
+    uint32_t Below(uint32_t n) { return Next() % n; }
+};
+
+// Per-key signal mixing idle stretches, sensor jitter, key travel and jumps.
+struct Signal {
+    std::vector<std::vector<uint8_t>> Keys;
+    Signal(uint32_t keys, uint32_t frames, uint32_t seed) : Keys(keys) {
+        Rng r; r.S ^= seed;
+        for (uint32_t k = 0; k < keys; ++k) {
+            auto& v = Keys[k];
+            v.resize(frames);
+            int cur = 0, mode = 0, left = 0;
+            for (uint32_t f = 0; f < frames; ++f) {
+                if (left-- <= 0) { mode = int(r.Below(4)); left = int(r.Below(300)); }
+                switch (mode) {
+                case 0: break;                                                     // hold
+                case 1: cur += int(r.Below(3)) - 1; break;                         // jitter
+                case 2: cur += int(r.Below(9)) - 2; break;                         // travel
+                default: if (r.Below(20) == 0) cur = int(r.Below(256)); break;     // jumps
+                }
+                cur = std::clamp(cur, 0, 255);
+                v[f] = uint8_t(cur);
+            }
+        }
+    }
+    std::vector<uint8_t> Frame(uint32_t f) const {
+        std::vector<uint8_t> out(Keys.size());
+        for (size_t k = 0; k < Keys.size(); ++k) out[k] = Keys[k][f];
+        return out;
+    }
+};
+
+GC_HISTORY_STATS BruteForce(const std::vector<uint8_t>& v, uint64_t first, uint64_t end, uint8_t thr) {
+    GC_HISTORY_STATS s{};
+    s.Min = 255;
+    for (uint64_t i = first; i < end; ++i) {
+        s.Min = std::min(s.Min, v[i]);
+        s.Max = std::max(s.Max, v[i]);
+        s.Sum += v[i];
+        ++s.Count;
+        if (i > first && (v[i] >= thr) != (v[i - 1] >= thr)) ++s.Crossings;
+    }
+    return s;
+}
+
+PGC_HISTORY Fill(const GC_HISTORY_CONFIG& cfg, const Signal& sig, uint32_t frames) {
+    PGC_HISTORY h = GcHistoryCreate(&cfg);
+    for (uint32_t f = 0; f < frames; ++f) GcHistoryAppend(h, sig.Frame(f).data());
+    return h;
+}
+
+} // namespace
+
+GC_TEST(RejectsInvalidConfigs) {
+    GC_HISTORY_CONFIG ok{4, 64, 8, 2 * 64 * 5};
+    PGC_HISTORY h = GcHistoryCreate(&ok);
+    GC_CHECK(h != nullptr);
+    GcHistoryDestroy(h);
+    GC_HISTORY_CONFIG bad[] = {{0, 64, 8, 4096}, {4, 60, 8, 4096}, {4, 8192, 8, 1u << 20},
+                               {4, 64, 0, 4096}, {4, 64, 8, 2 * 64 * 5 - 1}};
+    for (const auto& c : bad) GC_CHECK(GcHistoryCreate(&c) == nullptr);
+}
+
+GC_TEST(ReadRoundTripsCodedAndRawBlocks) {
+    const uint32_t keys = 21, frames = 64 * 20 + 17;  // 16-key transpose plus a scalar tail
+    Signal sig(keys, frames, 1);
+    PGC_HISTORY h = Fill({keys, 64, 64, 1u << 16}, sig, frames);
+    GC_CHECK(GcHistoryFrames(h) == frames);
+    GC_CHECK(GcHistoryOldestFrame(h) == 0);
+    std::vector<uint8_t> out(frames);
+    for (uint32_t k = 0; k < keys; ++k) {
+        GC_CHECK(GcHistoryRead(h, k, 0, frames, out.data()) == frames);
+        GC_CHECK(out == sig.Keys[k]);
+        size_t n = GcHistoryRead(h, k, 100, 777, out.data());
+        GC_CHECK(n == 677);
+        GC_CHECK(std::equal(out.begin(), out.begin() + n, sig.Keys[k].begin() + 100));
+    }
+    GC_CHECK(GcHistoryRead(h, keys, 0, frames, out.data()) == 0);
+    GcHistoryDestroy(h);
+}
+
+GC_TEST(QueryMatchesBruteForce) {
+    const uint32_t keys = 19, frames = 128 * 30 + 45;
+    Signal sig(keys, frames, 2);
+    PGC_HISTORY h = Fill({keys, 128, 64, 1u << 18}, sig, frames);
+    Rng r;
+    for (int q = 0; q < 2000; ++q) {
+        uint32_t k = r.Below(keys);
+        uint64_t a = r.Below(frames), b = r.Below(frames + 1);
+        if (q % 4 == 0) { a = (a / 128) * 128; b = a + 128 * (1 + r.Below(6)); }  // block-aligned
+        if (a > b) std::swap(a, b);
+        uint8_t thr = uint8_t(q % 8 == 0 ? 0 : r.Below(256));
+        GC_HISTORY_STATS got, exp = BruteForce(sig.Keys[k], a, std::min<uint64_t>(b, frames), thr);
+        int any = GcHistoryQuery(h, k, a, b, thr, &got);
+        GC_CHECK(any == (exp.Count > 0));
+        if (!exp.Count) continue;
+        GC_CHECK(got.Count == exp.Count);
+        GC_CHECK(got.Sum == exp.Sum);
+        GC_CHECK(got.Min == exp.Min);
+        GC_CHECK(got.Max == exp.Max);
+        GC_CHECK(got.Crossings == exp.Crossings);
+    }
+    GcHistoryDestroy(h);
+}
+
+GC_TEST(EvictsOldestBlocksByCountAndBytes) {
+    const uint32_t keys = 3, frames = 64 * 40;
+    Signal sig(keys, frames, 3);
+
+    PGC_HISTORY byCount = Fill({keys, 64, 4, 1u << 16}, sig, frames);
+    // 4 coded blocks plus the sealed and open raw blocks.
+    GC_CHECK(GcHistoryOldestFrame(byCount) == frames - 64 * 5);
+    GcHistoryDestroy(byCount);
+
+    PGC_HISTORY byBytes = Fill({keys, 64, 64, 2 * 64 * (keys + 1)}, sig, frames);
+    uint64_t oldest = GcHistoryOldestFrame(byBytes);
+    GC_CHECK(oldest > 0 && oldest < frames);
+    GC_CHECK(GcHistoryCodedBytes(byBytes) <= 2 * 64 * (keys + 1));
+    std::vector<uint8_t> out(frames);
+    for (uint32_t k = 0; k < keys; ++k) {
+        size_t n = GcHistoryRead(byBytes, k, 0, frames, out.data());
+        GC_CHECK(n == frames - oldest);
+        GC_CHECK(std::equal(out.begin(), out.begin() + n, sig.Keys[k].begin() + oldest));
+    }
+    GcHistoryDestroy(byBytes);
+}
+
+GC_TEST(IdleAndJitterCompressWell) {
+    const uint32_t keys = 64, B = 1024, frames = B * 40;
+    GC_HISTORY_CONFIG cfg{keys, B, 64, 4u << 20};
+    PGC_HISTORY h = GcHistoryCreate(&cfg);
+    std::vector<uint8_t> frame(keys, 0);
+    Rng r;
+    for (uint32_t f = 0; f < frames; ++f) {
+        frame[0] = uint8_t(200 + r.Below(2));  // held key with 1-LSB sensor jitter
+        GcHistoryAppend(h, frame.data());
+    }
+    // 38 coded blocks: idle keys cost ~8 bytes per block, the jittering one ~1/3 byte per frame.
+    size_t coded = GcHistoryCodedBytes(h);
+    GC_CHECK(coded < 38 * (63 * 16 + B / 2));
+    GcHistoryDestroy(h);
+}
+
+GC_TEST_MAIN()
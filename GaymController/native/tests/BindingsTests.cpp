@@ -0,0 +1,272 @@
+#include "Check.h"
+#include "gc/Bindings.h"
+
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace gc::bind;
+
+namespace {
+
+constexpr uint8_t kCtrl = 0x11, kShift = 0x10, kAlt = 0x12;
+constexpr uint8_t kA = 0x41, kC = 0x43, kF = 0x46, kG = 0x47, kW = 0x57, kF8 = 0x77;
+constexpr uint64_t kMs = 1000;
+
+// Key state plus a matcher, driven like one input report per call.
+struct Rig {
+    explicit Rig(const std::vector<Binding>& b, uint32_t gapUs = 500000) {
+        Status = P.Compile(b, gapUs);
+        M = std::make_unique<Matcher>(P);
+        GcKeyInit(&K, 0, 0);
+    }
+    const std::vector<Event>& Report(uint64_t nowUs, std::initializer_list<uint8_t> down = {},
+                                     std::initializer_list<uint8_t> up = {}) {
+        for (uint8_t k : up) GcKeyUp(&K, k);
+        for (uint8_t k : down) GcKeyDown(&K, k);
+        M->Evaluate(K, nowUs, Out);
+        return Out;
+    }
+    bool Has(uint8_t action, bool down) const {
+        for (const Event& e : Out)
+            if (e.Action == action && e.Down == down) return true;
+        return false;
+    }
+
+    Program P;
+    CompileStatus Status;
+    std::unique_ptr<Matcher> M;
+    GC_KEY_STATE K;
+    std::vector<Event> Out;
+};
+
+Binding Chord(Kind type, std::vector<uint8_t> keys, uint8_t action) {
+    Binding b;
+    b.Type = type;
+    b.Keys = std::move(keys);
+    b.Action = action;
+    return b;
+}
+
+Binding TapHold(uint8_t key, uint8_t tap, uint8_t hold, uint32_t holdUs) {
+    Binding b = Chord(Kind::TapHold, {key}, tap);
+    b.HoldAction = hold;
+    b.HoldUs = holdUs;
+    return b;
+}
+
+} // namespace
+
+GC_TEST(HoldChordFollowsKeys) {
+    Rig r({Chord(Kind::Hold, {kCtrl, kF}, 1)});
+    GC_CHECK(r.Status == CompileStatus::Ok);
+    GC_CHECK(r.Report(0, {kCtrl}).empty());
+    GC_CHECK(r.Report(1, {kF}).size() == 1 && r.Has(1, true) && r.M->ActionOn(1));
+    GC_CHECK(r.Report(2).empty());   // unchanged report: nothing
+    GC_CHECK(r.Report(3, {}, {kCtrl}).size() == 1 && r.Has(1, false) && !r.M->ActionOn(1));
+    GC_CHECK(r.Report(4, {}, {kF}).empty());
+
+    // Completed by either key, and unrelated held keys do not matter.
+    r.Report(10, {kW, kF});
+    GC_CHECK(r.Report(11, {kCtrl}).size() == 1 && r.Has(1, true));
+}
+
+GC_TEST(MostSpecificChordWinsThenDeclarationOrder) {
+    Rig r({
+        Chord(Kind::Hold, {kShift, kF}, 1),
+        Chord(Kind::Hold, {kCtrl, kShift, kF}, 2),
+        Chord(Kind::Hold, {kCtrl, kF}, 3),
+        Chord(Kind::Hold, {kF}, 4),
+        Chord(Kind::Hold, {kF, kShift}, 5),   // same set as #0: never wins
+    });
+    r.Report(0, {kCtrl, kShift});
+    GC_CHECK(r.Report(1, {kF}).size() == 1 && r.Has(2, true));   // 3 keys beat 2 and 1
+    r.Report(2, {}, {kCtrl, kShift, kF});
+
+    r.Report(3, {kShift});
+    GC_CHECK(r.Report(4, {kF}).size() == 1 && r.Has(1, true));   // #0 declared before #4
+    r.Report(5, {}, {kShift, kF});
+
+    // Two 2-key chords both completed by F: the earlier one wins.
+    Rig tie({Chord(Kind::Hold, {kCtrl, kF}, 7), Chord(Kind::Hold, {kAlt, kF}, 8)});
+    tie.Report(0, {kAlt, kCtrl});
+    GC_CHECK(tie.Report(1, {kF}).size() == 1 && tie.Has(7, true));
+
+    // All keys in one report: handled in key order, the chord fires once.
+    Rig same({Chord(Kind::Hold, {kCtrl, kShift, kF}, 9), Chord(Kind::Hold, {kShift}, 10)});
+    same.Report(0, {kF, kShift, kCtrl});
+    GC_CHECK(same.Out.size() == 1 && same.Has(9, true));
+}
+
+GC_TEST(TapAndHoldTiming) {
+    Rig r({TapHold(kC, 1, 2, 200 * kMs)});
+    r.Report(0, {kC});
+    GC_CHECK(r.Out.empty() && r.M->NextDeadlineUs() == 200 * kMs);
+    GC_CHECK(r.Report(199 * kMs).empty());
+    r.Report(199 * kMs + 999, {}, {kC});   // released just inside the window: tap
+    GC_CHECK(r.Out.size() == 2 && r.Out[0].Action == 1 && r.Out[0].Down && !r.Out[1].Down);
+    GC_CHECK(r.M->NextDeadlineUs() == 0 && !r.M->ActionOn(1));
+
+    r.Report(1000 * kMs, {kC});
+    GC_CHECK(r.Report(1200 * kMs).size() == 1 && r.Has(2, true) && r.M->ActionOn(2));   // at the deadline
+    GC_CHECK(r.Report(1500 * kMs).empty());
+    GC_CHECK(r.Report(1600 * kMs, {}, {kC}).size() == 1 && r.Has(2, false) && !r.M->ActionOn(2));
+
+    // A deadline that passed between reports is honoured before the release
+    // in the same report: hold down, hold up, no tap.
+    r.Report(2000 * kMs, {kC});
+    r.Report(2500 * kMs, {}, {kC});
+    GC_CHECK(r.Out.size() == 2 && r.Out[0].Action == 2 && r.Out[0].Down && r.Out[1].Action == 2);
+}
+
+GC_TEST(ChordSwallowsPendingTapHold) {
+    // Ctrl taps "1" / holds "2", Ctrl+C is "3": copying must not tap Ctrl.
+    Rig r({TapHold(kCtrl, 1, 2, 200 * kMs), Chord(Kind::Hold, {kCtrl, kC}, 3)});
+    r.Report(0, {kCtrl});
+    GC_CHECK(r.Report(50 * kMs, {kC}).size() == 1 && r.Has(3, true));
+    r.Report(60 * kMs, {}, {kC});
+    GC_CHECK(r.Report(400 * kMs).empty());   // no hold either
+    GC_CHECK(r.Report(410 * kMs, {}, {kCtrl}).empty());
+
+    // Once the hold started the chord no longer cancels it.
+    r.Report(1000 * kMs, {kCtrl});
+    r.Report(1300 * kMs);
+    GC_CHECK(r.M->ActionOn(2));
+    r.Report(1310 * kMs, {kC});
+    GC_CHECK(r.Has(3, true) && r.M->ActionOn(2));
+}
+
+GC_TEST(TogglesLatchAcrossPresses) {
+    // AutoSprint-style toggle and the F8 mode toggle.
+    Rig r({Chord(Kind::Toggle, {kAlt, kW}, 5), Chord(Kind::Toggle, {kF8}, 6)});
+    r.Report(0, {kAlt, kW});
+    GC_CHECK(r.Has(5, true) && r.M->ActionOn(5));
+    r.Report(1, {}, {kAlt, kW});
+    GC_CHECK(r.Out.empty() && r.M->ActionOn(5));   // latched past release
+    r.Report(2, {kAlt});
+    r.Report(3, {kW});
+    GC_CHECK(r.Has(5, false) && !r.M->ActionOn(5));
+    r.Report(4, {kF8});
+    r.Report(5, {}, {kF8});
+    r.Report(6, {kF8});
+    GC_CHECK(r.Has(6, false) && !r.M->ActionOn(6));
+
+    r.M->Reset();
+    GC_CHECK(!r.M->ActionOn(5));
+}
+
+GC_TEST(SequencesMatchWithinGap) {
+    Binding gg = Chord(Kind::Sequence, {kG, kG}, 1);
+    Binding cab = Chord(Kind::Sequence, {kC, kA, kF}, 2);
+    Binding af = Chord(Kind::Sequence, {kA, kF}, 3);   // suffix of C A F
+    Rig r({gg, cab, af}, 300 * kMs);
+
+    r.Report(0, {kG});
+    r.Report(10 * kMs, {}, {kG});
+    GC_CHECK(r.Report(250 * kMs, {kG}).size() == 2 && r.Has(1, true) && r.Has(1, false));
+    r.Report(260 * kMs, {}, {kG});
+    GC_CHECK(r.Report(270 * kMs, {kG}).empty());   // a match starts over, no overlap
+    r.Report(280 * kMs, {}, {kG});
+
+    // Too slow: the gap resets progress.
+    r.Report(2000 * kMs, {kG});
+    r.Report(2010 * kMs, {}, {kG});
+    GC_CHECK(r.Report(2400 * kMs, {kG}).empty());
+    r.Report(2410 * kMs, {}, {kG});
+
+    // Longest match wins over its suffix; a false start recovers mid-way.
+    r.Report(5000 * kMs, {kC});
+    r.Report(5010 * kMs, {}, {kC});
+    r.Report(5020 * kMs, {kC});
+    r.Report(5030 * kMs, {}, {kC});
+    r.Report(5040 * kMs, {kA});
+    r.Report(5050 * kMs, {}, {kA});
+    r.Report(5060 * kMs, {kF});
+    GC_CHECK(r.Out.size() == 2 && r.Has(2, true) && !r.Has(3, true));
+    r.Report(5070 * kMs, {}, {kF});
+    r.Report(5080 * kMs, {kA});
+    r.Report(5090 * kMs, {}, {kA});
+    r.Report(5100 * kMs, {kF});
+    GC_CHECK(r.Has(3, true));
+
+    // A sequence that is a prefix of another waits for the next press.
+    Rig p({Chord(Kind::Sequence, {kW, kA}, 4), Chord(Kind::Sequence, {kW, kA, kC}, 5)}, 300 * kMs);
+    p.Report(0, {kW});
+    p.Report(10 * kMs, {}, {kW});
+    GC_CHECK(p.Report(20 * kMs, {kA}).empty() && p.M->NextDeadlineUs() == 320 * kMs + 1);
+    p.Report(30 * kMs, {}, {kA});
+    GC_CHECK(p.Report(40 * kMs, {kC}).size() == 2 && p.Has(5, true) && !p.Has(4, true));
+    p.Report(50 * kMs, {}, {kC});
+    // ...fires when the next press does not extend it...
+    p.Report(1000 * kMs, {kW});
+    p.Report(1010 * kMs, {}, {kW});
+    p.Report(1020 * kMs, {kA});
+    p.Report(1030 * kMs, {}, {kA});
+    GC_CHECK(p.Report(1040 * kMs, {kF}).size() == 2 && p.Has(4, true) && p.Has(4, false));
+    p.Report(1050 * kMs, {}, {kF});
+    // ...or when the gap runs out, without another report.
+    p.Report(2000 * kMs, {kW});
+    p.Report(2010 * kMs, {}, {kW});
+    p.Report(2020 * kMs, {kA});
+    GC_CHECK(p.Report(p.M->NextDeadlineUs() - 1).empty());
+    GC_CHECK(p.Report(p.M->NextDeadlineUs()).size() == 2 && p.Has(4, true) && p.M->NextDeadlineUs() == 0);
+}
+
+GC_TEST(ResetAfterRecompile) {
+    // The matcher holds the program by reference; a bigger profile compiled
+    // into it is picked up by Reset.
+    Rig r({Chord(Kind::Hold, {kA}, 1)});
+    std::vector<Binding> more;
+    for (uint8_t k = 0x60; k < 0x70; ++k) more.push_back(Chord(Kind::Hold, {k}, uint8_t(k)));
+    more.push_back(Chord(Kind::Toggle, {kCtrl, kG}, 9));
+    GC_CHECK(r.P.Compile(more) == CompileStatus::Ok && r.P.Count() == 17);
+    r.M->Reset();
+    GC_CHECK(r.Report(0, {kCtrl, kG}).size() == 1 && r.Has(9, true));
+    GC_CHECK(r.Report(1, {0x6F}).size() == 1 && r.Has(0x6F, true));
+    r.Report(2, {}, {0x6F});
+    GC_CHECK(r.Has(0x6F, false) && r.M->ActionOn(9));
+}
+
+GC_TEST(ManyBindingsBehaveLikeOne) {
+    // The same chord among 1000 unrelated bindings gives the same events.
+    std::vector<Binding> many;
+    for (int i = 0; i < 999; ++i)
+        many.push_back(Chord(Kind::Hold, {uint8_t(0x80 + i % 64), uint8_t(0xC0 + i / 64 % 16)}, uint8_t(i)));
+    many.push_back(Chord(Kind::Hold, {kCtrl, kF}, 200));
+    Rig r(many);
+    GC_CHECK(r.P.Count() == 1000);
+    r.Report(0, {kCtrl});
+    GC_CHECK(r.Report(1, {kF}).size() == 1 && r.Out[0].Binding == 999 && r.Has(200, true));
+
+    // More related keys down than the subset search covers: same answer via
+    // the candidate list.
+    std::vector<Binding> wide;
+    for (uint8_t k = 0x60; k < 0x6C; ++k) wide.push_back(Chord(Kind::Hold, {k, kF}, uint8_t(k)));
+    wide.push_back(Chord(Kind::Hold, {0x60, 0x61, 0x62, kF}, 42));
+    Rig w(wide);
+    for (uint8_t k = 0x60; k < 0x6C; ++k) w.Report(k, {k});
+    GC_CHECK(w.Report(1000, {kF}).size() == 1 && w.Has(42, true));
+}
+
+GC_TEST(CompileErrors) {
+    Program p;
+    uint32_t bad = 0;
+    GC_CHECK(p.Compile({Chord(Kind::Hold, {kA}, 1), Chord(Kind::Hold, {}, 2)}, 0, &bad) == CompileStatus::NoKeys);
+    GC_CHECK(bad == 1 && p.Count() == 0);
+    GC_CHECK(p.Compile({Chord(Kind::Hold, {kA, kA}, 1)}, 0, &bad) == CompileStatus::DuplicateKey && bad == 0);
+    GC_CHECK(p.Compile({Chord(Kind::Hold, {1, 2, 3, 4, 5, 6, 7, 8, 9}, 1)}) == CompileStatus::TooManyKeys);
+    GC_CHECK(p.Compile({Chord(Kind::Sequence, {kG, kG}, 1)}) == CompileStatus::Ok);   // repeats fine in sequences
+    GC_CHECK(std::string(StatusName(CompileStatus::DuplicateKey)) == "DuplicateKey");
+
+    // An empty program matches nothing.
+    GC_CHECK(p.Compile({}) == CompileStatus::Ok);
+    Matcher m(p);
+    std::vector<Event> out;
+    uint64_t all[4] = {~0ull, ~0ull, ~0ull, ~0ull};
+    m.Evaluate(all, 0, out);
+    GC_CHECK(out.empty());
+}
+
+GC_TEST_MAIN()
@@ -0,0 +1,47 @@
+#pragma once
+
+// Minimal self-registering test runner; each test binary is one ctest entry.
+
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace gc::test {
+
+struct Case { const char* Name; void (*Fn)(); };
+
+inline std::vector<Case>& Registry() { static std::vector<Case> cases; return cases; }
+inline int& Failures() { static int n = 0; return n; }
+
+struct Registrar {
+    Registrar(const char* name, void (*fn)()) { Registry().push_back({name, fn}); }
+};
+
+inline int RunAll() {
+    for (const auto& c : Registry()) {
+        int before = Failures();
+        c.Fn();
+        std::printf("[%s] %s\n", Failures() == before ? "PASS" : "FAIL", c.Name);
+    }
+    std::printf("%zu tests, %d failures\n", Registry().size(), Failures());
+    return Failures() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+} // namespace gc::test
+
+#define GC_TEST(name) \
+    static void name(); \
+    static ::gc::test::Registrar name##_registrar(#name, name); \
+    static void name()
+
+#define GC_CHECK(cond) \
+    do { if (!(cond)) { ++::gc::test::Failures(); \
+        std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); } } while (0)
+
+#define GC_CHECK_NEAR(a, b, tol) \
+    do { auto gc_a_ = (a); auto gc_b_ = (b); auto gc_d_ = gc_a_ > gc_b_ ? gc_a_ - gc_b_ : gc_b_ - gc_a_; \
+        if (gc_d_ > (tol)) { ++::gc::test::Failures(); \
+            std::fprintf(stderr, "%s:%d: |%s - %s| = %g > %g\n", __FILE__, __LINE__, #a, #b, \
+                         (double)gc_d_, (double)(tol)); } } while (0)
+
+#define GC_TEST_MAIN() int main() { return ::gc::test::RunAll(); }
@@ -0,0 +1,306 @@
+#include "Check.h"
+#include "gc/HidPlan.h"
+#include "VPadShared.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <climits>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+using UCHAR = unsigned char;
+#include "HidDescriptor.h"
+
+using namespace gc::hid;
+
+namespace {
+
+struct Rng {
+    uint32_t S = 0x13579BDFu;
+    uint32_t Next() { S ^= S << 13; S ^= S >> 17; S ^= S << 5; return S; }
+    uint32_t Below(uint32_t n) { return Next() % n; }
+};
+
+// Tiny descriptor builder: item(prefix tag/type, value) with the smallest data size.
+struct Desc {
+    std::vector<uint8_t> B;
+    Desc& Item(uint8_t tagType, int64_t v, int size = -1) {
+        if (size < 0) size = (v >= -128 && v <= 127) ? 1 : (v >= -32768 && v <= 32767) ? 2 : 4;
+        B.push_back(uint8_t(tagType | (size == 4 ? 3 : size)));
+        for (int k = 0; k < size; ++k) B.push_back(uint8_t(uint64_t(v) >> (8 * k)));
+        return *this;
+    }
+    Desc& Page(int v) { return Item(0x04, v, v > 0xFF ? 2 : 1); }
+    Desc& Usage(int v) { return Item(0x08, v, v > 0xFF ? 2 : 1); }
+    Desc& Min(int64_t v) { return Item(0x14, v); }
+    Desc& Max(int64_t v) { return Item(0x24, v); }
+    Desc& Size(int v) { return Item(0x74, v); }
+    Desc& Count(int v) { return Item(0x94, v); }
+    Desc& Id(int v) { return Item(0x84, v); }
+    Desc& Input(int flags) { return Item(0x80, flags); }
+    Desc& Open() { return Item(0xA0, 1); }
+    Desc& Close() { B.push_back(0xC0); return *this; }
+};
+
+// Reference extractor: one bit at a time.
+int64_t ReadBits(const uint8_t* p, uint32_t off, uint32_t size, bool sign) {
+    uint64_t v = 0;
+    for (uint32_t i = 0; i < size; ++i) v |= uint64_t((p[(off + i) / 8] >> ((off + i) % 8)) & 1) << i;
+    if (sign && (v >> (size - 1)) & 1) v |= ~0ull << size;
+    return int64_t(v);
+}
+
+void WriteBits(uint8_t* p, uint32_t off, uint32_t size, uint64_t v) {
+    for (uint32_t i = 0; i < size; ++i) {
+        uint8_t& b = p[(off + i) / 8];
+        b = uint8_t((b & ~(1u << ((off + i) % 8))) | (((v >> i) & 1) << ((off + i) % 8)));
+    }
+}
+
+void CheckInvariants(const Plan& plan) {
+    for (const auto& r : plan.Reports) GC_CHECK(r.Bytes() <= kMaxReportBytes);
+    GC_CHECK(plan.Fields.size() <= kMaxFields);
+    for (const auto& f : plan.Fields) {
+        const Report* r = plan.Find(f.Kind, f.ReportId);
+        GC_CHECK(r != nullptr);
+        GC_CHECK(f.BitSize >= 1 && f.BitSize <= 32);
+        if (r) GC_CHECK(f.BitOffset + f.BitSize <= r->Bits);
+    }
+}
+
+} // namespace
+
+GC_TEST(ParsesVPadDescriptor) {
+    Plan plan;
+    GC_CHECK(Parse(g_VPadReportDescriptor, sizeof g_VPadReportDescriptor, plan) == ParseStatus::Ok);
+    GC_CHECK(plan.Reports.size() == 3);
+    const Report* in = plan.Find(ReportKind::Input, 0);
+    GC_CHECK(in && in->Bytes() == sizeof(VPAD_STATE));
+    const Report* rumble = plan.Find(ReportKind::Output, 1);
+    const Report* leds = plan.Find(ReportKind::Output, 2);
+    GC_CHECK(rumble && rumble->Bytes() == 3);
+    GC_CHECK(leds && leds->Bytes() == 4);
+
+    GC_CHECK(plan.Fields.size() == 16 + 2 + 4 + 2 + 3);
+    for (int i = 0; i < 16; ++i) {
+        const Field& b = plan.Fields[i];
+        GC_CHECK(b.UsagePage == 0x09 && b.Usage == i + 1 && b.BitOffset == uint32_t(i) && b.BitSize == 1);
+    }
+    GC_CHECK(plan.Fields[16].UsagePage == 0x02 && plan.Fields[16].Usage == 0xC4);
+    GC_CHECK(plan.Fields[17].BitOffset == 24 && plan.Fields[17].LogicalMax == 255);
+    const Field& ry = plan.Fields[21];
+    GC_CHECK(ry.UsagePage == 0x01 && ry.Usage == 0x34 && ry.BitOffset == 80 && ry.BitSize == 16);
+    GC_CHECK(ry.Signed() && ry.LogicalMin == -32768 && ry.LogicalMax == 32767);
+    const Field& ledB = plan.Fields[26];
+    GC_CHECK(ledB.Kind == ReportKind::Output && ledB.ReportId == 2 && ledB.UsagePage == 0xFF00);
+    GC_CHECK(ledB.Usage == 0x07 && ledB.BitOffset == 24);
+}
+
+GC_TEST(ExtractsVPadState) {
+    Plan plan;
+    Parse(g_VPadReportDescriptor, sizeof g_VPadReportDescriptor, plan);
+    Extractor x;
+    GC_CHECK(x.Compile(plan, ReportKind::Input, 0));
+    GC_CHECK(x.Count() == 22);
+    GC_CHECK(!x.Compile(plan, ReportKind::Input, 7));
+
+    VPAD_STATE s{};
+    s.Buttons = 0x8421;
+    s.LeftTrigger = 17;
+    s.RightTrigger = 255;
+    s.LX = -32768;
+    s.LY = 32767;
+    s.RX = -1;
+    s.RY = 1234;
+    uint8_t report[sizeof s];
+    std::memcpy(report, &s, sizeof s);
+    int32_t v[22];
+    GC_CHECK(x.Extract(report, sizeof report, v));
+    for (int i = 0; i < 16; ++i) GC_CHECK(v[i] == ((s.Buttons >> i) & 1));
+    GC_CHECK(v[16] == 17 && v[17] == 255);
+    GC_CHECK(v[18] == -32768 && v[19] == 32767 && v[20] == -1 && v[21] == 1234);
+    GC_CHECK(!x.Extract(report, sizeof report - 1, v));
+
+    uint16_t u[22];
+    GC_CHECK(x.ExtractUnit(report, sizeof report, u));
+    GC_CHECK(u[0] == 65535 && u[1] == 0);
+    GC_CHECK(u[16] == 17 * 257 && u[17] == 65535);
+    GC_CHECK(u[18] == 0 && u[19] == 65535);
+    GC_CHECK_NEAR(int(u[20]), 32767, 1);
+
+    // Output reports carry their ID byte.
+    Extractor rumble;
+    GC_CHECK(rumble.Compile(plan, ReportKind::Output, 1));
+    const uint8_t out1[] = {1, 200, 40};
+    GC_CHECK(rumble.Extract(out1, sizeof out1, v) && v[0] == 200 && v[1] == 40);
+    const uint8_t wrongId[] = {2, 200, 40};
+    GC_CHECK(!rumble.Extract(wrongId, sizeof wrongId, v));
+}
+
+GC_TEST(HandlesArraysPushPopLongAndExtendedUsages) {
+    Desc d;
+    d.Page(0x01).Usage(0x06).Open().Id(3);
+    d.Item(0xA4, 0, 0);                                      // push
+    d.Page(0x07).Item(0x18, 0x04).Item(0x28, 0x1D);          // usage min/max A..Z
+    d.Min(0).Max(0x1D).Size(8).Count(6).Input(0x00);         // 6-key array
+    d.Item(0xB4, 0, 0);                                      // pop back to page 1
+    d.B.insert(d.B.end(), {0xFE, 2, 0x10, 0xAA, 0xBB});      // long item, skipped
+    d.Item(0x08, 0x00090005, 4);                             // extended usage: Button 5
+    d.Min(0).Max(1).Size(1).Count(1).Input(0x02);
+    d.Size(7).Count(1).Input(0x01);                          // constant padding
+    d.Usage(0x30).Min(-2048).Max(2047).Size(12).Count(2).Input(0x02);
+    d.Close();
+
+    Plan plan;
+    GC_CHECK(Parse(d.B.data(), d.B.size(), plan) == ParseStatus::Ok);
+    GC_CHECK(plan.Fields.size() == 6 + 1 + 2);
+    const Field& key = plan.Fields[0];
+    GC_CHECK(!(key.Flags & kFieldVariable) && key.UsagePage == 0x07 && key.Usage == 0x04 && key.UsageMax == 0x1D);
+    GC_CHECK(key.BitOffset == 8 && plan.Fields[5].BitOffset == 48);
+    const Field& btn = plan.Fields[6];
+    GC_CHECK(btn.UsagePage == 0x09 && btn.Usage == 5 && btn.BitOffset == 56);
+    // The usage list is shorter than the count: the last usage repeats.
+    GC_CHECK(plan.Fields[7].Usage == 0x30 && plan.Fields[8].Usage == 0x30 && plan.Fields[8].UsagePage == 0x01);
+    GC_CHECK(plan.Fields[7].BitOffset == 64 && plan.Fields[8].BitOffset == 76);
+    GC_CHECK(plan.Find(ReportKind::Input, 3)->Bytes() == 11);
+
+    Extractor x;
+    x.Compile(plan, ReportKind::Input, 3);
+    uint8_t report[11] = {3, 0x04, 0x1D, 0, 0, 0, 0, 0x01};
+    WriteBits(report, 64, 12, uint64_t(-2048));
+    WriteBits(report, 76, 12, 2047);
+    int32_t v[9];
+    GC_CHECK(x.Extract(report, sizeof report, v));
+    GC_CHECK(v[0] == 0x04 && v[1] == 0x1D && v[6] == 1 && v[7] == -2048 && v[8] == 2047);
+}
+
+GC_TEST(ExtractMatchesBitReference) {
+    Rng r;
+    for (int round = 0; round < 200; ++round) {
+        Desc d;
+        d.Page(0xFF00).Usage(1).Open();
+        uint32_t fields = 1 + r.Below(24);
+        for (uint32_t i = 0; i < fields; ++i) {
+            int size = 1 + int(r.Below(32));
+            bool sign = r.Below(2) && size > 1;
+            int64_t lo = sign ? -(int64_t(1) << (size - 1)) : 0;
+            int64_t hi = sign ? (int64_t(1) << (size - 1)) - 1 : std::min<int64_t>((int64_t(1) << size) - 1, INT32_MAX);
+            d.Usage(int(i + 1)).Min(lo).Max(hi).Size(size).Count(1).Input(0x02);
+        }
+        d.Close();
+        Plan plan;
+        GC_CHECK(Parse(d.B.data(), d.B.size(), plan) == ParseStatus::Ok);
+        GC_CHECK(plan.Fields.size() == fields);
+        Extractor x;
+        x.Compile(plan, ReportKind::Input, 0);
+        std::vector<uint8_t> report(x.ReportBytes());
+        for (auto& b : report) b = uint8_t(r.Next());
+        std::vector<int32_t> v(fields);
+        GC_CHECK(x.Extract(report.data(), report.size(), v.data()));
+        for (uint32_t i = 0; i < fields; ++i) {
+            const Field& f = plan.Fields[i];
+            int64_t ref = ReadBits(report.data(), f.BitOffset, f.BitSize, f.Signed());
+            GC_CHECK(v[i] == int32_t(ref));
+        }
+    }
+}
+
+GC_TEST(RejectsMalformedDescriptors) {
+    struct Case { std::vector<uint8_t> B; ParseStatus Expect; };
+    const Case cases[] = {
+        {{0x05}, ParseStatus::Truncated},
+        {{0x27, 0xFF, 0xFF}, ParseStatus::Truncated},
+        {{0xFE, 4, 0x10, 0x00}, ParseStatus::Truncated},
+        {{0x0C}, ParseStatus::BadItem},                                  // reserved item type
+        {{0xD0}, ParseStatus::BadItem},                                  // unknown main tag
+        {{0x85, 0x00}, ParseStatus::BadItem},                            // report ID 0
+        {{0x75, 0x00, 0x95, 0x01, 0x81, 0x02}, ParseStatus::BadReportSize},
+        {{0x75, 0x21, 0x95, 0x01, 0x81, 0x02}, ParseStatus::BadReportSize},
+        {{0x75, 0x08, 0x96, 0x01, 0x04, 0x81, 0x02}, ParseStatus::ReportTooLong},
+        {{0xC0}, ParseStatus::StackUnderflow},
+        {{0xB4}, ParseStatus::StackUnderflow},
+        {{0xA1, 0x01}, ParseStatus::UnclosedCollection},
+    };
+    for (const auto& c : cases) {
+        Plan plan;
+        plan.Fields.resize(3);
+        ParseStatus s = Parse(c.B.data(), c.B.size(), plan);
+        GC_CHECK(s == c.Expect);
+        if (s != c.Expect) std::fprintf(stderr, "  got %s, expected %s\n", StatusName(s), StatusName(c.Expect));
+        GC_CHECK(plan.Fields.empty() && plan.Reports.empty());
+    }
+
+    std::vector<uint8_t> deep, pushes, many;
+    for (int i = 0; i < 40; ++i) deep.insert(deep.end(), {0xA1, 0x00});
+    for (int i = 0; i < 9; ++i) pushes.push_back(0xA4);
+    for (int i = 0; i < 3; ++i) many.insert(many.end(), {0x85, uint8_t(i + 1), 0x75, 0x01, 0x96, 0x00, 0x08, 0x81, 0x02});
+    Plan plan;
+    GC_CHECK(Parse(deep.data(), deep.size(), plan) == ParseStatus::StackOverflow);
+    GC_CHECK(Parse(pushes.data(), pushes.size(), plan) == ParseStatus::StackOverflow);
+    GC_CHECK(Parse(many.data(), many.size(), plan) == ParseStatus::TooManyFields);
+}
+
+GC_TEST(FuzzedDescriptorsStayInBounds) {
+    Rng r;
+    const std::vector<uint8_t> seed(g_VPadReportDescriptor, g_VPadReportDescriptor + sizeof g_VPadReportDescriptor);
+    int ok = 0;
+    for (int iter = 0; iter < 20000; ++iter) {
+        std::vector<uint8_t> d;
+        if (iter % 4 == 0) {
+            d.resize(r.Below(96));
+            for (auto& b : d) b = uint8_t(r.Next());
+        } else {
+            d = seed;
+            for (uint32_t m = 1 + r.Below(4); m-- > 0 && !d.empty();) {
+                size_t at = r.Below(uint32_t(d.size()));
+                switch (r.Below(4)) {
+                case 0: d[at] = uint8_t(r.Next()); break;
+                case 1: d[at] ^= uint8_t(1u << r.Below(8)); break;
+                case 2: d.erase(d.begin() + long(at)); break;
+                default: d.resize(at); break;
+                }
+            }
+        }
+        // Heap copy of exactly len bytes so sanitizers catch any over-read.
+        std::unique_ptr<uint8_t[]> buf(new uint8_t[d.size() + 1]);
+        if (!d.empty()) std::memcpy(buf.get(), d.data(), d.size());
+        Plan plan;
+        if (Parse(buf.get(), d.size(), plan) != ParseStatus::Ok) {
+            GC_CHECK(plan.Fields.empty());
+            continue;
+        }
+        ++ok;
+        CheckInvariants(plan);
+        for (const auto& rep : plan.Reports) {
+            Extractor x;
+            GC_CHECK(x.Compile(plan, rep.Kind, rep.Id));
+            std::vector<uint8_t> report(x.ReportBytes() ? x.ReportBytes() : 1, uint8_t(r.Next()));
+            report[0] = rep.Id ? rep.Id : report[0];
+            std::vector<int32_t> v(x.Count() + 1);
+            std::vector<uint16_t> u(x.Count() + 1);
+            GC_CHECK(x.Extract(report.data(), x.ReportBytes(), v.data()));
+            GC_CHECK(x.ExtractUnit(report.data(), x.ReportBytes(), u.data()));
+        }
+    }
+    GC_CHECK(ok > 1000);   // mutations must still exercise the extractor
+}
+
+GC_TEST(GeneratesRawMapping) {
+    Plan plan;
+    Parse(g_VPadReportDescriptor, sizeof g_VPadReportDescriptor, plan);
+    GC_CHECK(MappingJson(plan, 0) == R"({"2":"Accelerator","3":"Brake"})");
+
+    // Analog keyboard: report 1 carries one depth byte per key.
+    Desc d;
+    d.Page(0xFF54).Usage(1).Open().Id(1).Page(0x07).Item(0x18, 0x04).Item(0x28, 0x06);
+    d.Usage(0x31).Min(0).Max(255).Size(8).Count(4).Input(0x02).Close();
+    GC_CHECK(Parse(d.B.data(), d.B.size(), plan) == ParseStatus::Ok);
+    GC_CHECK(MappingJson(plan, 1) == R"({"1":"Key A","2":"Key B","3":"Key C","4":"Key \\"})");
+    GC_CHECK(UsageName(0x01, 0x31) == "Y");
+    GC_CHECK(UsageName(0x07, 0x27) == "Key 0");
+    GC_CHECK(UsageName(0xFF00, 0x05) == "Page 0xFF00 Usage 0x05");
+}
+
+GC_TEST_MAIN()
@@ -0,0 +1,203 @@
+#include "Check.h"
+#include "gc/KeyState.h"
+
+#include <cmath>
+#include <cstdint>
+
+namespace {
+
+// Windows virtual-key codes, as the legacy StickMapper uses.
+constexpr uint8_t kW = 0x57, kA = 0x41, kS = 0x53, kD = 0x44;
+
+GC_WASD_MAP Wasd(GC_SOCD_MODE mode) { return {kW, kA, kS, kD, mode, mode}; }
+
+// Legacy StickMapper.WasdToLeftStick for a set of held keys.
+void Legacy(bool w, bool a, bool s, bool d, short* ox, short* oy) {
+    int x = 0, y = 0;
+    if (a) x -= 1;
+    if (d) x += 1;
+    if (w) y -= 1;
+    if (s) y += 1;
+    float fx = float(x), fy = float(y);
+    float len = std::sqrt(fx * fx + fy * fy);
+    if (len > 1e-5f) { fx /= len; fy /= len; }
+    *ox = short(fx * 32767);
+    *oy = short(-fy * 32767);
+}
+
+} // namespace
+
+GC_TEST(BitsetAndDepthTrackKeys) {
+    GC_KEY_STATE k;
+    GcKeyInit(&k, 0, 0);
+    for (int key : {0, 63, 64, 200, 255}) {
+        GC_CHECK(!GcKeyIsDown(&k, uint8_t(key)));
+        GcKeyDown(&k, uint8_t(key));
+        GC_CHECK(GcKeyIsDown(&k, uint8_t(key)) && k.Depth[key] == 255);
+    }
+    GC_CHECK(k.Pressed[0] == (1ull | 1ull << 63) && k.Pressed[1] == 1 && k.Pressed[3] == (1ull << 8 | 1ull << 63));
+    GcKeyUp(&k, 63);
+    GC_CHECK(!GcKeyIsDown(&k, 63) && k.Depth[63] == 0 && GcKeyIsDown(&k, 64));
+
+    // Repeats (typematic key-downs) do not count as new presses.
+    uint32_t at = k.PressedAt[200];
+    GcKeyDown(&k, 200);
+    GC_CHECK(k.PressedAt[200] == at);
+}
+
+GC_TEST(AnalogDepthUsesHysteresis) {
+    GC_KEY_STATE k;
+    GcKeyInit(&k, 100, 60);
+    GcKeySetDepth(&k, kW, 99);
+    GC_CHECK(!GcKeyIsDown(&k, kW) && k.Depth[kW] == 99);
+    GcKeySetDepth(&k, kW, 100);
+    GC_CHECK(GcKeyIsDown(&k, kW));
+    GcKeySetDepth(&k, kW, 60);   // still above the release point
+    GC_CHECK(GcKeyIsDown(&k, kW));
+    GcKeySetDepth(&k, kW, 59);
+    GC_CHECK(!GcKeyIsDown(&k, kW));
+    GcKeySetDepth(&k, kW, 80);   // between the points: stays up
+    GC_CHECK(!GcKeyIsDown(&k, kW));
+
+    GcKeyInit(&k, 10, 200);   // release above actuation is clamped
+    GC_CHECK(k.Release == 10);
+}
+
+GC_TEST(LastWinsHandsBackToHeldKey) {
+    GC_KEY_STATE k;
+    GcKeyInit(&k, 0, 0);
+    GcKeyDown(&k, kA);
+    GC_CHECK(GcSocdAxis(&k, kA, kD, GC_SOCD_LAST_WINS) == -255);
+    GcKeyDown(&k, kD);
+    GC_CHECK(GcSocdAxis(&k, kA, kD, GC_SOCD_LAST_WINS) == 255);
+    GcKeyUp(&k, kD);
+    GC_CHECK(GcSocdAxis(&k, kA, kD, GC_SOCD_LAST_WINS) == -255);   // A still held
+    GcKeyDown(&k, kD);
+    GcKeyUp(&k, kA);
+    GcKeyDown(&k, kA);   // re-pressing A makes it the newer key
+    GC_CHECK(GcSocdAxis(&k, kA, kD, GC_SOCD_LAST_WINS) == -255);
+    GcKeyUp(&k, kA);
+    GcKeyUp(&k, kD);
+    GC_CHECK(GcSocdAxis(&k, kA, kD, GC_SOCD_LAST_WINS) == 0);
+}
+
+GC_TEST(NeutralCancelsOpposites) {
+    GC_KEY_STATE k;
+    GcKeyInit(&k, 0, 0);
+    GcKeyDown(&k, kD);
+    GC_CHECK(GcSocdAxis(&k, kA, kD, GC_SOCD_NEUTRAL) == 255);
+    GcKeyDown(&k, kA);
+    GC_CHECK(GcSocdAxis(&k, kA, kD, GC_SOCD_NEUTRAL) == 0);
+    GcKeyUp(&k, kD);
+    GC_CHECK(GcSocdAxis(&k, kA, kD, GC_SOCD_NEUTRAL) == -255);
+}
+
+GC_TEST(FirstWinsHoldsUntilReleased) {
+    GC_KEY_STATE k;
+    GcKeyInit(&k, 0, 0);
+    GcKeyDown(&k, kA);
+    GcKeyDown(&k, kD);
+    GC_CHECK(GcSocdAxis(&k, kA, kD, GC_SOCD_FIRST_WINS) == -255);
+    GcKeyUp(&k, kA);
+    GC_CHECK(GcSocdAxis(&k, kA, kD, GC_SOCD_FIRST_WINS) == 255);
+    GcKeyDown(&k, kA);   // D is now the older key
+    GC_CHECK(GcSocdAxis(&k, kA, kD, GC_SOCD_FIRST_WINS) == 255);
+}
+
+GC_TEST(PressOrderSurvivesClockWrap) {
+    GC_KEY_STATE k;
+    GcKeyInit(&k, 0, 0);
+    k.Clock = 0xFFFFFFFEu;
+    GcKeyDown(&k, kA);   // stamped 0xFFFFFFFF
+    GcKeyDown(&k, kD);   // stamped 0 after the wrap, still the later press
+    GC_CHECK(GcSocdAxis(&k, kA, kD, GC_SOCD_LAST_WINS) == 255);
+    GC_CHECK(GcSocdAxis(&k, kA, kD, GC_SOCD_FIRST_WINS) == -255);
+}
+
+GC_TEST(DigitalWasdMatchesLegacyMapper) {
+    // Without opposing keys every mode agrees with the legacy mapper; with
+    // them the legacy mapper behaved like NEUTRAL.
+    for (int m = 0; m < 16; ++m) {
+        bool w = m & 1, a = m & 2, s = m & 4, d = m & 8;
+        GC_KEY_STATE k;
+        GcKeyInit(&k, 0, 0);
+        if (w) GcKeyDown(&k, kW);
+        if (a) GcKeyDown(&k, kA);
+        if (s) GcKeyDown(&k, kS);
+        if (d) GcKeyDown(&k, kD);
+        short lx, ly;
+        Legacy(w, a, s, d, &lx, &ly);
+        for (GC_SOCD_MODE mode : {GC_SOCD_LAST_WINS, GC_SOCD_NEUTRAL, GC_SOCD_FIRST_WINS}) {
+            if (mode != GC_SOCD_NEUTRAL && ((w && s) || (a && d))) continue;
+            GC_WASD_MAP map = Wasd(mode);
+            int16_t x, y;
+            GcWasdToStick(&k, &map, &x, &y);
+            GC_CHECK_NEAR(int(x), int(lx), 2);
+            GC_CHECK_NEAR(int(y), int(ly), 2);
+        }
+    }
+}
+
+GC_TEST(AnalogDepthScalesOnCircle) {
+    GC_KEY_STATE k;
+    GcKeyInit(&k, 1, 1);
+    GC_WASD_MAP map = Wasd(GC_SOCD_LAST_WINS);
+    int16_t x, y;
+
+    GcKeySetDepth(&k, kD, 128);   // half travel straight right
+    GcWasdToStick(&k, &map, &x, &y);
+    GC_CHECK_NEAR(int(x), 128 * 32767 / 255, 1);
+    GC_CHECK(y == 0);
+    GcKeyUp(&k, kD);
+    GcKeyDown(&k, kA);
+    GcWasdToStick(&k, &map, &x, &y);
+    GC_CHECK(x == -32767 && y == 0);   // symmetric with full right
+    GcKeyUp(&k, kA);
+
+    // Every depth pair: direction kept, magnitude = deeper key / 255.
+    double worstMag = 0, worstAngle = 0;
+    for (int dx = 0; dx < 256; dx += 3) {
+        for (int dy = 0; dy < 256; dy += 3) {
+            GcKeySetDepth(&k, kD, uint8_t(dx));
+            GcKeySetDepth(&k, kW, uint8_t(dy));
+            GcWasdToStick(&k, &map, &x, &y);
+            int hi = dx > dy ? dx : dy;
+            double mag = std::hypot(double(x), double(y));
+            worstMag = std::fmax(worstMag, std::fabs(mag - hi * 32767.0 / 255));
+            GC_CHECK(mag <= 32767 * 1.001);
+            if (hi > 0)
+                worstAngle = std::fmax(worstAngle, std::fabs(std::atan2(double(y), double(x)) - std::atan2(dy, dx)));
+        }
+    }
+    GC_CHECK(worstMag <= 33);   // 0.1% of full scale
+    GC_CHECK(worstAngle < 0.001);
+}
+
+GC_TEST(SocdAppliesPerAxisWithDepth) {
+    // W held deep, S tapped shallow later: LAST_WINS follows S's depth,
+    // FIRST_WINS keeps W's, NEUTRAL centres Y; X is untouched.
+    GC_KEY_STATE k;
+    GcKeyInit(&k, 1, 1);
+    GcKeySetDepth(&k, kW, 255);
+    GcKeySetDepth(&k, kS, 64);
+    GcKeySetDepth(&k, kD, 255);
+    int16_t x, y;
+    GC_WASD_MAP last = Wasd(GC_SOCD_LAST_WINS), first = Wasd(GC_SOCD_FIRST_WINS), neutral = Wasd(GC_SOCD_NEUTRAL);
+    GcWasdToStick(&k, &last, &x, &y);
+    GC_CHECK(y < 0 && x > 0);
+    GC_CHECK_NEAR(std::hypot(double(x), double(y)), 32767.0, 33.0);   // D is full travel
+    GcWasdToStick(&k, &first, &x, &y);
+    GC_CHECK_NEAR(int(x), 23170, 40);
+    GC_CHECK_NEAR(int(y), 23170, 40);
+    GcWasdToStick(&k, &neutral, &x, &y);
+    GC_CHECK(x == 32767 && y == 0);
+
+    // Mixed modes: X last-wins, Y neutral.
+    GcKeySetDepth(&k, kA, 200);
+    GC_WASD_MAP mixed = {kW, kA, kS, kD, GC_SOCD_LAST_WINS, GC_SOCD_NEUTRAL};
+    GcWasdToStick(&k, &mixed, &x, &y);
+    GC_CHECK_NEAR(int(x), -200 * 32767 / 255, 1);
+    GC_CHECK(y == 0);
+}
+
+GC_TEST_MAIN()
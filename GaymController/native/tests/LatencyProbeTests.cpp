@@ -0,0 +1,75 @@
+#include "Check.h"
+#include "gc/LatencyProbe.h"
+
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+GC_TEST(BucketsAreMonotonicAndCoverTheirValues) {
+    uint32_t prev = 0;
+    for (uint64_t v = 0; v < (1ull << 20); v += 1 + v / 64) {
+        uint32_t b = GcLatencyBucketOf(v);
+        GC_CHECK(b >= prev);
+        GC_CHECK(b < GC_LATENCY_BUCKETS);
+        GC_CHECK(GcLatencyBucketUpper(b) >= v);
+        if (b > 0) GC_CHECK(GcLatencyBucketUpper(b - 1) < v);
+        prev = b;
+    }
+    GC_CHECK(GcLatencyBucketOf(~0ull) == GC_LATENCY_BUCKETS - 1);
+    // ~6% relative resolution above the exact range.
+    uint32_t b = GcLatencyBucketOf(1000000);
+    GC_CHECK(GcLatencyBucketUpper(b) - GcLatencyBucketUpper(b - 1) <= 1000000 / 16);
+}
+
+GC_TEST(PercentilesOfUniformRamp) {
+    auto h = std::make_unique<GC_LATENCY_HISTOGRAM>();
+    GcLatencyReset(h.get());
+    for (uint64_t v = 1; v <= 10000; ++v) GcLatencyRecord(h.get(), v * 100);
+    GC_CHECK(h->Count == 10000);
+    GC_CHECK(h->MaxNs == 1000000);
+    GC_CHECK(GcLatencyMeanNs(h.get()) == 500050);
+    uint64_t p50 = GcLatencyPercentile(h.get(), 5000);
+    uint64_t p99 = GcLatencyPercentile(h.get(), 9900);
+    GC_CHECK(p50 >= 500000 && p50 <= 500000 * 107 / 100);
+    GC_CHECK(p99 >= 990000 && p99 <= 1000000);
+    GC_CHECK(GcLatencyPercentile(h.get(), 10000) == 1000000);
+}
+
+GC_TEST(TraceSplitsTotalAndStage) {
+    auto p = std::make_unique<GC_LATENCY_PROBE>();
+    GcProbeReset(p.get());
+    GC_TRACE t;
+    GcTraceBegin(p.get(), 1000, &t);
+    GC_CHECK(t.Sequence == 0);
+    GcTraceStamp(p.get(), GC_HOP_HID_READ, &t, 1010);
+    GcTraceStamp(p.get(), GC_HOP_GRAPH_OUT, &t, 1300);
+    GcTraceStamp(p.get(), GC_HOP_WIRE_TX, &t, 1250);  // clock went backwards: stage clamps to 0
+    GcTraceStamp(p.get(), GC_HOP_DRIVER_SUBMIT, &t, 5000);
+    GC_CHECK(p->Total[GC_HOP_HID_READ].MaxNs == 10);
+    GC_CHECK(p->Stage[GC_HOP_GRAPH_OUT].MaxNs == 290);
+    GC_CHECK(p->Total[GC_HOP_GRAPH_OUT].MaxNs == 300);
+    GC_CHECK(p->Stage[GC_HOP_WIRE_TX].MaxNs == 0);
+    GC_CHECK(p->Total[GC_HOP_DRIVER_SUBMIT].MaxNs == 4000);
+    GC_CHECK(p->Stage[GC_HOP_DRIVER_SUBMIT].MaxNs == 3750);
+    GC_CHECK(p->Total[GC_HOP_BROKER_RX].Count == 0);
+    GcTraceBegin(p.get(), 0, &t);
+    GC_CHECK(t.Sequence == 1);
+}
+
+GC_TEST(ConcurrentRecordingLosesNothing) {
+    auto h = std::make_unique<GC_LATENCY_HISTOGRAM>();
+    GcLatencyReset(h.get());
+    constexpr int kThreads = 4, kPer = 200000;
+    std::vector<std::thread> ts;
+    for (int t = 0; t < kThreads; ++t)
+        ts.emplace_back([&, t] { for (int i = 0; i < kPer; ++i) GcLatencyRecord(h.get(), uint64_t(i % 5000) * (t + 1)); });
+    for (auto& t : ts) t.join();
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < GC_LATENCY_BUCKETS; ++i) sum += h->Buckets[i];
+    GC_CHECK(h->Count == uint64_t(kThreads) * kPer);
+    GC_CHECK(sum == h->Count);
+    GC_CHECK(h->MaxNs == 4999ull * kThreads);
+}
+
+GC_TEST_MAIN()
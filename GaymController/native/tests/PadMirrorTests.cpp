@@ -0,0 +1,236 @@
+#include "Check.h"
+#include "gc/PadMirrorMap.h"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+using namespace gc::mirror;
+
+namespace {
+
+// Every field derives from n, so a snapshot mixing two publishes fails the
+// comparison against Expected(s.Reports).
+GC_MIRROR_SNAPSHOT Expected(uint64_t n) {
+    GC_MIRROR_SNAPSHOT s{};
+    s.State.Buttons = uint16_t(n);
+    s.State.LeftTrigger = uint8_t(n);
+    s.State.RightTrigger = uint8_t(n >> 8);
+    s.State.LX = int16_t(n);
+    s.State.LY = int16_t(~n);
+    s.State.RX = int16_t(n * 3);
+    s.State.RY = int16_t(n * 5);
+    s.RumbleLeft = uint8_t(n * 7);
+    s.RumbleRight = uint8_t(n * 11);
+    s.LedR = uint8_t(n >> 16);
+    s.LedG = uint8_t(n >> 4);
+    s.LedB = uint8_t(n * 13);
+    s.Connected = 1;
+    s.RumbleSequence = uint32_t(n);
+    s.UpdatedNs = n * 125000;
+    s.Reports = n;
+    s.RateHz = uint32_t(n) ^ 0x5A5A5A5Au;
+    s.TargetRateHz = ~uint32_t(n);
+    s.LatencyP50Ns = uint32_t(n * 3);
+    s.LatencyP99Ns = uint32_t(n * 5);
+    s.LatencyMaxNs = uint32_t(n * 7);
+    s.Reserved1 = uint32_t(n) ^ 0xFFFF0000u;
+    return s;
+}
+
+bool Consistent(const GC_MIRROR_SNAPSHOT& s) {
+    GC_MIRROR_SNAPSHOT e = Expected(s.Reports);
+    if (s.Reports == 0) std::memset(&e, 0, sizeof(e));   // nothing published yet
+    return std::memcmp(&s, &e, sizeof(s)) == 0;
+}
+
+struct ReadStats {
+    uint64_t Reads = 0, Torn = 0, Backwards = 0, Last = 0;
+};
+
+void ReadUntil(const PadMirrorMap& m, uint64_t last, ReadStats& st) {
+    GC_MIRROR_SNAPSHOT s;
+    while (st.Last < last) {
+        if (!m.Read(s, 1000)) continue;
+        st.Reads++;
+        st.Torn += !Consistent(s);
+        st.Backwards += s.Reports < st.Last;
+        st.Last = s.Reports;
+    }
+}
+
+} // namespace
+
+GC_TEST(LayoutMatchesGolden) {
+    // Shared with tests/WireTests/PadMirrorTests.cs.
+    auto page = std::make_unique<GC_MIRROR_PAGE>();
+    GcMirrorInit(page.get(), 3, 0x01020304, 0x1112131415161718);
+    GC_MIRROR_SNAPSHOT s{};
+    s.State.Buttons = 0x0201;
+    s.State.LeftTrigger = 0x03;
+    s.State.RightTrigger = 0x04;
+    s.State.LX = 0x0605;
+    s.State.LY = -2;
+    s.State.RX = 0x0A09;
+    s.State.RY = 0x0C0B;
+    s.RumbleLeft = 0x0D;
+    s.RumbleRight = 0x0E;
+    s.LedR = 0x0F;
+    s.LedG = 0x10;
+    s.LedB = 0x11;
+    s.Connected = 1;
+    s.RumbleSequence = 0x15141312;
+    s.UpdatedNs = 0x1D1C1B1A19181716;
+    s.Reports = 0x2524232221201F1E;
+    s.RateHz = 8000;
+    s.TargetRateHz = 4000;
+    s.LatencyP50Ns = 0x31302F2E;
+    s.LatencyP99Ns = 0x35343332;
+    s.LatencyMaxNs = 0x39383736;
+    GcMirrorPublish(page.get(), &s);
+
+    const uint8_t header[] = {0x47, 0x43, 0x4D, 0x52, 0x01, 0x00, 0x00, 0x00, 0x40, 0x00, 0x00, 0x00,
+                              0x03, 0x00, 0x00, 0x00, 0x04, 0x03, 0x02, 0x01, 0x00, 0x00, 0x00, 0x00,
+                              0x18, 0x17, 0x16, 0x15, 0x14, 0x13, 0x12, 0x11};
+    const uint8_t body[] = {
+        0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,   // Sequence = 2, Reserved2
+        0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0xFE, 0xFF, 0x09, 0x0A, 0x0B, 0x0C,   // VPAD_STATE
+        0x0D, 0x0E, 0x0F, 0x10, 0x11, 0x01, 0x00, 0x00,   // rumble, LEDs, Connected
+        0x12, 0x13, 0x14, 0x15,                           // RumbleSequence
+        0x16, 0x17, 0x18, 0x19, 0x1A, 0x1B, 0x1C, 0x1D,   // UpdatedNs
+        0x1E, 0x1F, 0x20, 0x21, 0x22, 0x23, 0x24, 0x25,   // Reports
+        0x40, 0x1F, 0x00, 0x00, 0xA0, 0x0F, 0x00, 0x00,   // RateHz, TargetRateHz
+        0x2E, 0x2F, 0x30, 0x31, 0x32, 0x33, 0x34, 0x35, 0x36, 0x37, 0x38, 0x39,
+        0x00, 0x00, 0x00, 0x00};
+    const auto* bytes = reinterpret_cast<const uint8_t*>(page.get());
+    GC_CHECK(std::memcmp(bytes, header, sizeof(header)) == 0);
+    GC_CHECK(std::memcmp(bytes + 64, body, sizeof(body)) == 0);
+    GC_CHECK(sizeof(body) == 8 + sizeof(GC_MIRROR_SNAPSHOT));
+}
+
+GC_TEST(ReaderRejectsBadLayoutAndBusyWriter) {
+    auto page = std::make_unique<GC_MIRROR_PAGE>();
+    std::memset(page.get(), 0, sizeof(*page));
+    GC_MIRROR_SNAPSHOT s;
+    GC_CHECK(GcMirrorRead(page.get(), &s, 4) == 0);   // never initialised
+    GcMirrorInit(page.get(), 0, 1, 0);
+    GC_CHECK(GcMirrorRead(page.get(), &s, 4) == 1);
+    GC_CHECK(s.Reports == 0 && s.Connected == 0);
+    page->Version = GC_MIRROR_VERSION + 1;
+    GC_CHECK(GcMirrorRead(page.get(), &s, 4) == 0);
+    page->Version = GC_MIRROR_VERSION;
+    page->Sequence = 7;   // writer died mid-publish
+    GC_CHECK(GcMirrorRead(page.get(), &s, 4) == 0);
+}
+
+GC_TEST(WindowsPageIsGlobalAndUserReadOnly) {
+    // Written by the broker service in session 0, read from the desktop
+    // session: the name must be global and the DACL must let interactive
+    // users map it for reading, and nothing more. Same as PadMirror.cs.
+#if defined(_WIN32)
+    GC_CHECK(PageName(2) == "Global\\GaymController.Pad2");
+#else
+    GC_CHECK(PageName(2) == "/GaymController.Pad2");
+#endif
+    std::string sddl = kPageSddl;
+    GC_CHECK(sddl.rfind("D:P", 0) == 0); // protected: no inherited ACEs
+    GC_CHECK(sddl.find("(A;;GR;;;IU)") != std::string::npos);
+    size_t aces = 0;
+    for (size_t at = sddl.find(";;;IU)"); at != std::string::npos; at = sddl.find(";;;IU)", at + 1)) aces++;
+    GC_CHECK(aces == 1);
+    GC_CHECK(sddl.find("(A;;GR;;;WD)") == std::string::npos && sddl.find(";;;AU)") == std::string::npos);
+}
+
+GC_TEST(ThreadsNeverSeeTornSnapshots) {
+    auto page = std::make_unique<GC_MIRROR_PAGE>();
+    GcMirrorInit(page.get(), 0, 1, 0);
+    const uint64_t last = 200000;
+    std::atomic<uint64_t> torn{0}, reads{0};
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 3; ++t)
+        readers.emplace_back([&] {
+            GC_MIRROR_SNAPSHOT s;
+            uint64_t seen = 0, bad = 0, n = 0;
+            while (seen < last) {
+                if (!GcMirrorRead(page.get(), &s, 1000)) continue;
+                ++n;
+                bad += !Consistent(s) || s.Reports < seen;
+                seen = s.Reports;
+            }
+            torn += bad;
+            reads += n;
+        });
+    for (uint64_t n = 1; n <= last; ++n) {
+        GC_MIRROR_SNAPSHOT s = Expected(n);
+        GcMirrorPublish(page.get(), &s);
+        if (n % 256 == 0) std::this_thread::yield();
+    }
+    for (auto& r : readers) r.join();
+    GC_CHECK(torn.load() == 0);
+    GC_CHECK(reads.load() >= 3);
+    GC_CHECK(page->Sequence == 2 * last);
+}
+
+#if defined(__linux__)
+GC_TEST(CrossProcessReadersUnder8kHzWriter) {
+    // Writer in this process publishes through POSIX shm at 8 kHz for one
+    // second; two forked readers map the page read-only and validate every
+    // snapshot they copy, alongside a reader thread in the writer process.
+    const uint32_t slot = 1000000 + uint32_t(getpid());
+    const uint64_t last = 8000;
+    PadMirrorMap writer;
+    GC_CHECK(writer.Create(slot, 0) == MapStatus::Ok);
+    if (!writer.IsOpen()) return;
+
+    pid_t children[2];
+    for (auto& pid : children) {
+        pid = fork();
+        if (pid == 0) {
+            PadMirrorMap m;
+            if (m.Open(slot) != MapStatus::Ok || m.Writable()) _exit(10);
+            ReadStats st;
+            ReadUntil(m, last, st);
+            _exit(st.Torn ? 1 : st.Backwards ? 2 : st.Reads == 0 ? 3 : 0);
+        }
+    }
+    ReadStats local;
+    PadMirrorMap reader;
+    GC_CHECK(reader.Open(slot) == MapStatus::Ok);
+    std::thread t([&] { ReadUntil(reader, last, local); });
+
+    timespec next;
+    clock_gettime(CLOCK_MONOTONIC, &next);
+    for (uint64_t n = 1; n <= last; ++n) {
+        next.tv_nsec += 125000;
+        if (next.tv_nsec >= 1000000000) {
+            next.tv_nsec -= 1000000000;
+            next.tv_sec++;
+        }
+        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next, nullptr);
+        writer.Publish(Expected(n));
+    }
+    t.join();
+    for (pid_t pid : children) {
+        int status = 0;
+        waitpid(pid, &status, 0);
+        GC_CHECK(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    }
+    GC_CHECK(local.Torn == 0 && local.Backwards == 0 && local.Reads > 0);
+    GC_CHECK(writer.Publishes() == last);
+    PadMirrorMap::Unlink(slot);
+    PadMirrorMap gone;
+    GC_CHECK(gone.Open(slot) == MapStatus::NotFound);
+}
+#endif
+
+GC_TEST_MAIN()
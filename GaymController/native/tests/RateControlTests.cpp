@@ -0,0 +1,114 @@
+#include "Check.h"
+#include "gc/RateControl.h"
+#include "gc/RateSim.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace {
+
+constexpr uint64_t kMs = 1000000;
+
+GC_RATE_CONTROL Make(uint64_t now = 0) {
+    GC_RATE_CONFIG cfg;
+    GcRateDefaultConfig(&cfg);
+    GC_RATE_CONTROL rc;
+    GcRateInit(&rc, &cfg, now);
+    return rc;
+}
+
+} // namespace
+
+GC_TEST(RejectsInvalidConfigs) {
+    GC_RATE_CONFIG ok;
+    GcRateDefaultConfig(&ok);
+    GC_RATE_CONTROL rc;
+    GC_CHECK(GcRateInit(&rc, &ok, 0) == 1);
+    GC_CHECK(rc.RateHz == 8000 && rc.IntervalNs == 125000);
+    GC_RATE_CONFIG bad[5] = {ok, ok, ok, ok, ok};
+    bad[0].MinRateHz = 0;
+    bad[1].MinRateHz = 9000;
+    bad[2].DecreaseQ16 = 0;
+    bad[3].DecreaseQ16 = 65536;
+    bad[4].PeriodNs = 0;
+    for (const auto& c : bad) GC_CHECK(GcRateInit(&rc, &c, 0) == 0);
+}
+
+GC_TEST(CutsToDrainedRateThenIncreasesAdditively) {
+    GC_RATE_CONTROL rc = Make();
+    // Consumer drains one report per 400 us (2.5 kHz); the 12th comes back late.
+    for (int i = 1; i <= 12; ++i) GcRateObserve(&rc, i * 400000ull, 0, i < 12 ? 500000 : 1500000);
+    GC_CHECK(rc.Decreases == 1);
+    GC_CHECK(rc.RateHz == 1875);   // 2500 Hz drained * 0.75, not 8000 * 0.75
+    GC_CHECK(rc.IntervalNs == 1000000000u / 1875);
+
+    // Clean feedback from then on: +100 Hz per closed period.
+    for (uint64_t t = 5 * kMs; t <= 60 * kMs; t += kMs) GcRateObserve(&rc, t, 0, 300000);
+    GC_CHECK(rc.Increases >= 4);
+    GC_CHECK(rc.Decreases == 1);
+    GC_CHECK(rc.RateHz == 1875 + 100 * rc.Increases);
+}
+
+GC_TEST(DepthAloneTriggersDecrease) {
+    GC_RATE_CONTROL rc = Make();
+    GcRateObserve(&rc, 1 * kMs, 2, 100000);
+    GcRateObserve(&rc, 3 * kMs, 9, 100000);   // backlog above MaxQueueDepth
+    GC_CHECK(rc.Decreases == 1);
+    GC_CHECK(rc.RateHz < 8000);
+}
+
+GC_TEST(StaleLatencyDoesNotCutTwice) {
+    GC_RATE_CONTROL rc = Make();
+    // 8 kHz of completions for 5 ms, the last one late: cut to 6 kHz at 5 ms.
+    for (int i = 1; i <= 40; ++i) GcRateObserve(&rc, i * 125000ull, 0, i < 40 ? 300000 : 2 * kMs);
+    GC_CHECK(rc.Decreases == 1 && rc.RateHz == 6000);
+    // Sent at 3 and 4 ms, before the cut: old backlog, ignored.
+    GcRateObserve(&rc, 6 * kMs, 1, 3 * kMs);
+    GcRateObserve(&rc, 9 * kMs, 1, 5 * kMs);
+    GcRateTick(&rc, 16 * kMs);
+    GC_CHECK(rc.Decreases == 1 && rc.Increases == 0 && rc.RateHz == 6000);
+    // A late report sent after the cut does cut again.
+    for (int i = 1; i <= 40; ++i) GcRateObserve(&rc, 16 * kMs + i * 125000ull, 0, i < 40 ? 300000 : 2 * kMs);
+    GC_CHECK(rc.Decreases == 2 && rc.RateHz == 4500);
+}
+
+GC_TEST(ShouldSendPacesCoalescingWindows) {
+    GC_RATE_CONFIG cfg;
+    GcRateDefaultConfig(&cfg);
+    cfg.MaxRateHz = 1000;
+    GC_RATE_CONTROL rc;
+    GcRateInit(&rc, &cfg, 0);
+    int sends = 0;
+    for (uint64_t t = 0; t < 1000 * kMs; t += 125000) sends += GcRateShouldSend(&rc, t);
+    GC_CHECK(sends == 1000);
+    // Caller stalls for 50 ms: one send, then back on a 1 ms grid from there.
+    GC_CHECK(GcRateShouldSend(&rc, 1050 * kMs) == 1);
+    GC_CHECK(GcRateShouldSend(&rc, 1050 * kMs + 500000) == 0);
+    GC_CHECK(GcRateShouldSend(&rc, 1051 * kMs) == 1);
+}
+
+GC_TEST(SimulationConvergesUnderStepLoads) {
+    using gc::sim::RateSim;
+    GC_RATE_CONFIG cfg;
+    GcRateDefaultConfig(&cfg);
+    const std::vector<gc::sim::Step> schedule = {
+        {0, 50000}, {1000 * kMs, 400000}, {3000 * kMs, 800000}, {5000 * kMs, 100000}, {7000 * kMs, 250000}};
+    RateSim sim(cfg, schedule);
+    sim.Run(9000 * kMs);
+
+    for (const auto& p : sim.Phases()) {
+        double reachable = std::min(p.CapacityHz, double(cfg.MaxRateHz));
+        GC_CHECK(p.DeliveredHz >= 0.75 * reachable);             // throughput kept
+        GC_CHECK(p.P99Ns <= cfg.TargetLatencyNs * 3 / 2);         // latency near target
+        // Drops settle within a few periods; recovering to MaxRateHz is additive.
+        GC_CHECK(p.ConvergeMs <= (p.CapacityHz >= cfg.MaxRateHz ? 1000.0 : 150.0));
+    }
+
+    // Deterministic: a second run reproduces the trace exactly.
+    RateSim again(cfg, schedule);
+    again.Run(9000 * kMs);
+    GC_CHECK(again.Trace().size() == sim.Trace().size());
+    GC_CHECK(again.RateTrace() == sim.RateTrace());
+}
+
+GC_TEST_MAIN()
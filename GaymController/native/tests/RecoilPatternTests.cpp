@@ -0,0 +1,240 @@
+#include "Check.h"
+#include "gc/RecoilPattern.h"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+namespace {
+
+struct Table {
+    explicit Table(const GC_RECOIL_DESC& d) : Mem((GcRecoilBakeBytes(&d) + 3) / 4) {
+        T = GcRecoilBake(Mem.data(), Mem.size() * 4, &d);
+    }
+    std::vector<uint32_t> Mem;
+    PGC_RECOIL_TABLE T;
+};
+
+GC_RECOIL_DESC TimeDesc(const std::vector<GC_RECOIL_POINT>& p, uint32_t shift = 0) {
+    return {p.data(), uint32_t(p.size()), GC_RECOIL_KEY_TIME_US, 0, shift};
+}
+
+// The authored pattern itself: piecewise linear from rest at t = 0, held
+// after the last key.
+void Authored(const std::vector<GC_RECOIL_POINT>& p, double scaleUs, double t, double* x, double* y) {
+    double k0 = 0, x0 = 0, y0 = 0;
+    for (const auto& q : p) {
+        double k1 = q.Key * scaleUs;
+        if (t <= k1) {
+            double a = k1 > k0 ? (t - k0) / (k1 - k0) : 1.0;
+            *x = x0 + (q.X - x0) * a;
+            *y = y0 + (q.Y - y0) * a;
+            return;
+        }
+        k0 = k1; x0 = q.X; y0 = q.Y;
+    }
+    *x = x0;
+    *y = y0;
+}
+
+// Largest gap between the baked table and the authored polyline: a step
+// that contains a key cuts its corner by at most a quarter step times the
+// slope change there (plus rounding).
+double CornerTolerance(const std::vector<GC_RECOIL_POINT>& p, double scaleUs, uint32_t stepUs) {
+    double worst = 0, k0 = 0, x0 = 0, y0 = 0, sx = 0, sy = 0;
+    for (const auto& q : p) {
+        double k1 = q.Key * scaleUs;
+        double nx = k1 > k0 ? (q.X - x0) / (k1 - k0) : 0, ny = k1 > k0 ? (q.Y - y0) / (k1 - k0) : 0;
+        worst = std::fmax(worst, std::fmax(std::fabs(nx - sx), std::fabs(ny - sy)));
+        sx = nx; sy = ny; k0 = k1; x0 = q.X; y0 = q.Y;
+    }
+    worst = std::fmax(worst, std::fmax(std::fabs(sx), std::fabs(sy)));   // into the hold
+    return worst * stepUs / 4 + 1;
+}
+
+// A 7-shot spray: pull down hard, then drift right and back left.
+const std::vector<GC_RECOIL_POINT> kSpray = {
+    {0, 0, -2000}, {1, 300, -6000}, {2, 900, -9000}, {3, 2500, -10000},
+    {4, 4000, -10500}, {5, 2000, -11000}, {6, -1500, -11000},
+};
+
+} // namespace
+
+GC_TEST(PlaybackMatchesAuthoredPattern) {
+    // Keys on the step grid: playback is exact up to rounding everywhere.
+    std::vector<GC_RECOIL_POINT> grid = {{4096, 1000, -3000}, {16384, -2000, -12000}, {40960, 500, -20000}};
+    Table a(TimeDesc(grid));
+    GC_CHECK(a.T != nullptr && GcRecoilDurationUs(a.T) == 40960);
+    for (uint32_t t = 0; t < 60000; t += 7) {
+        int16_t x, y;
+        double ex, ey;
+        GcRecoilSample(a.T, t, &x, &y);
+        Authored(grid, 1.0, t, &ex, &ey);
+        GC_CHECK_NEAR(double(x), ex, 1.0);
+        GC_CHECK_NEAR(double(y), ey, 1.0);
+    }
+
+    // Keys between grid points: exact on the grid; in a step that contains
+    // a key the corner is cut by at most a quarter step of slope change.
+    std::vector<GC_RECOIL_POINT> odd = {{1500, 4000, -4000}, {2300, -4000, -9000}, {9999, 0, -9000}};
+    Table b(TimeDesc(odd));
+    GC_CHECK(GcRecoilDurationUs(b.T) == 10240);
+    double maxErr = 0;
+    for (uint32_t t = 0; t < 12000; ++t) {
+        int16_t x, y;
+        double ex, ey;
+        GcRecoilSample(b.T, t, &x, &y);
+        Authored(odd, 1.0, t, &ex, &ey);
+        if (t % 1024 == 0) {
+            GC_CHECK_NEAR(double(x), ex, 1.0);
+            GC_CHECK_NEAR(double(y), ey, 1.0);
+        }
+        maxErr = std::fmax(maxErr, std::fmax(std::fabs(x - ex), std::fabs(y - ey)));
+    }
+    GC_CHECK(maxErr > 1.0);   // the corners really are cut...
+    GC_CHECK(maxErr <= CornerTolerance(odd, 1.0, 1024));   // ...but only within one step
+}
+
+GC_TEST(ShotIndexedPatternFollowsFireRate) {
+    GC_RECOIL_DESC d{kSpray.data(), uint32_t(kSpray.size()), GC_RECOIL_KEY_SHOT, 100000, 0};   // 600 RPM
+    for (uint32_t shift : {10u, 6u}) {
+        d.StepShift = shift;
+        Table t(d);
+        GC_CHECK(t.T != nullptr);
+        double tol = CornerTolerance(kSpray, 100000, 1u << shift);
+        for (uint32_t at = 0; at < 800000; at += 1000) {
+            int16_t x, y;
+            double ex, ey;
+            GcRecoilSample(t.T, at, &x, &y);
+            Authored(kSpray, 100000, at, &ex, &ey);
+            GC_CHECK_NEAR(double(x), ex, tol);
+            GC_CHECK_NEAR(double(y), ey, tol);
+        }
+        if (shift == 6) GC_CHECK(tol < 2);   // finer steps for shot-exact playback
+    }
+
+    // Half-way between shots 3 and 4, away from any corner.
+    d.StepShift = 0;
+    Table t(d);
+    int16_t x, y;
+    GcRecoilSample(t.T, 350000, &x, &y);
+    GC_CHECK_NEAR(int(x), 3250, 1);
+    GC_CHECK_NEAR(int(y), -10250, 1);
+
+    // The same shots at 900 RPM land on the same offsets sooner.
+    d.ShotIntervalUs = 66667;
+    d.StepShift = 6;
+    Table fast(d);
+    GcRecoilSample(fast.T, 4 * 66667, &x, &y);
+    GC_CHECK_NEAR(int(x), 4000, 2);
+}
+
+GC_TEST(ReproducesLegacyExponentialOffset) {
+    // AntiRecoilNode: -0.15 * exp(-t / 120 ms) while firing, authored as a
+    // 5 ms polyline and played back without any exp() per tick.
+    std::vector<GC_RECOIL_POINT> p;
+    for (uint32_t ms = 0; ms <= 1000; ms += 5)
+        p.push_back({ms * 1000, 0, int16_t(std::lround(-0.15 * 32767 * std::exp(-double(ms) / 120.0)))});
+    Table t(TimeDesc(p, 9));
+    GC_RECOIL_MIXER m;
+    GcRecoilMixerInit(&m);
+    GcRecoilStart(&m, t.T, 32768);
+    double elapsedMs = 0;
+    for (int tick = 0; tick < 1000; ++tick) {
+        int16_t x, y;
+        GcRecoilTick(&m, 1000, &x, &y);
+        elapsedMs += 1.0;
+        double legacy = -0.15 * std::exp(-elapsedMs / 120.0) * 32767;
+        GC_CHECK(x == 0);
+        GC_CHECK_NEAR(double(y), legacy, 3.0);
+    }
+}
+
+GC_TEST(MixerBlendsAndHolds) {
+    Table spray({kSpray.data(), uint32_t(kSpray.size()), GC_RECOIL_KEY_SHOT, 100000, 0});
+    std::vector<GC_RECOIL_POINT> drift = {{300000, 8000, 0}};
+    Table right(TimeDesc(drift));
+
+    GC_RECOIL_MIXER m;
+    GcRecoilMixerInit(&m);
+    int16_t x, y;
+    GcRecoilTick(&m, 1000, &x, &y);
+    GC_CHECK(x == 0 && y == 0);
+
+    int a = GcRecoilStart(&m, spray.T, 16384);   // crossfade halfway
+    int b = GcRecoilStart(&m, right.T, 16384);
+    GC_CHECK(a >= 0 && b >= 0 && a != b);
+    for (int i = 0; i < 150; ++i) GcRecoilTick(&m, 1000, &x, &y);   // t = 150 ms
+    int16_t sx, sy, rx, ry;
+    GcRecoilSample(spray.T, 150000, &sx, &sy);
+    GcRecoilSample(right.T, 150000, &rx, &ry);
+    GC_CHECK_NEAR(int(x), (sx + rx) / 2, 1);
+    GC_CHECK_NEAR(int(y), (sy + ry) / 2, 1);
+
+    // Weight changes apply on the next tick; negative weight mirrors.
+    GcRecoilSetWeight(&m, a, 0);
+    GcRecoilSetWeight(&m, b, -32768);
+    GcRecoilTick(&m, 0, &x, &y);
+    GC_CHECK(x == -rx && y == 0);
+
+    // Past the end the last offset holds for as long as the trigger does,
+    // and hours of ticking neither wrap nor drift.
+    GcRecoilStop(&m, a);
+    GcRecoilSetWeight(&m, b, 32768);
+    for (int i = 0; i < 4 * 3600; ++i) GcRecoilTick(&m, 1000000, &x, &y);
+    GC_CHECK(x == 8000 && y == 0);
+    GC_CHECK(m.Instances[b].ElapsedUs == GcRecoilDurationUs(right.T));
+
+    // Stacked full-weight patterns saturate instead of wrapping.
+    GcRecoilStop(&m, b);
+    std::vector<GC_RECOIL_POINT> big = {{0, 30000, -30000}};
+    Table full(TimeDesc(big));
+    GC_CHECK(GcRecoilDurationUs(full.T) == 0);
+    GcRecoilStart(&m, full.T, 32768);
+    GcRecoilStart(&m, full.T, 32768);
+    GcRecoilTick(&m, 1000, &x, &y);
+    GC_CHECK(x == 32767 && y == -32768);
+}
+
+GC_TEST(InstanceLimitAndReuse) {
+    std::vector<GC_RECOIL_POINT> p = {{1000, 1, 1}};
+    Table t(TimeDesc(p));
+    GC_RECOIL_MIXER m;
+    GcRecoilMixerInit(&m);
+    for (int i = 0; i < GC_RECOIL_MAX_INSTANCES; ++i) GC_CHECK(GcRecoilStart(&m, t.T, 32768) == i);
+    GC_CHECK(GcRecoilStart(&m, t.T, 32768) == -1);
+    GcRecoilStop(&m, 70);
+    GcRecoilStop(&m, 999);   // out of range: ignored
+    GC_CHECK(GcRecoilStart(&m, t.T, 32768) == 70);
+}
+
+GC_TEST(RejectsBadPatterns) {
+    std::vector<GC_RECOIL_POINT> unordered = {{10, 0, 0}, {10, 1, 1}};
+    GC_CHECK(GcRecoilBakeBytes(nullptr) == 0);
+    GC_RECOIL_DESC d = TimeDesc(unordered);
+    GC_CHECK(GcRecoilBakeBytes(&d) == 0);
+    d.Count = 0;
+    GC_CHECK(GcRecoilBakeBytes(&d) == 0);
+
+    GC_RECOIL_DESC shots{kSpray.data(), uint32_t(kSpray.size()), GC_RECOIL_KEY_SHOT, 0, 0};
+    GC_CHECK(GcRecoilBakeBytes(&shots) == 0);   // no fire rate
+    shots.ShotIntervalUs = 100000;
+    shots.StepShift = 16;
+    GC_CHECK(GcRecoilBakeBytes(&shots) == 0);   // step too coarse for int32 interpolation
+
+    std::vector<GC_RECOIL_POINT> longest = {{GC_RECOIL_MAX_STEPS << 10, 0, 0}};
+    d = TimeDesc(longest);
+    GC_CHECK(GcRecoilBakeBytes(&d) != 0);
+    longest[0].Key++;
+    GC_CHECK(GcRecoilBakeBytes(&d) == 0);
+
+    std::vector<GC_RECOIL_POINT> ok = {{1000, 1, 1}};
+    d = TimeDesc(ok);
+    std::vector<uint32_t> mem(64);
+    GC_CHECK(GcRecoilBake(mem.data(), GcRecoilBakeBytes(&d) - 1, &d) == nullptr);
+    GC_CHECK(GcRecoilBake(reinterpret_cast<uint8_t*>(mem.data()) + 2, 200, &d) == nullptr);
+    GC_CHECK(GcRecoilBake(mem.data(), mem.size() * 4, &d) != nullptr);
+}
+
+GC_TEST_MAIN()
@@ -0,0 +1,254 @@
+#include "Check.h"
+#include "gc/StickDsp.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Rng {
+    uint32_t S = 0x12345678u;
+    uint32_t Next() { S ^= S << 13; S ^= S >> 17; S ^= S << 5; return S; }
+    float Uniform(float lo, float hi) { return lo + (hi - lo) * (Next() >> 8) * (1.0f / 16777216.0f); }
+};
+
+struct GoldenConfig {
+    float Sens, Expo, Adz, MaxSpeed, Alpha, VGain, Jitter, ScaleX, ScaleY;
+    std::vector<float> Dx, Dy;
+    std::vector<int> Sx, Sy;
+};
+
+std::vector<GoldenConfig> LoadGolden() {
+    std::vector<GoldenConfig> cfgs;
+    std::ifstream in(GC_TEST_DATA_DIR "/ToStickGolden.csv");
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.rfind("#cfg ", 0) == 0) {
+            GoldenConfig c{};
+            std::sscanf(line.c_str() + 5, "%f,%f,%f,%f,%f,%f,%f,%f,%f", &c.Sens, &c.Expo, &c.Adz, &c.MaxSpeed,
+                        &c.Alpha, &c.VGain, &c.Jitter, &c.ScaleX, &c.ScaleY);
+            cfgs.push_back(c);
+        } else if (!line.empty() && line[0] != '#' && !cfgs.empty()) {
+            float dx, dy; int sx, sy;
+            if (std::sscanf(line.c_str(), "%f,%f,%d,%d", &dx, &dy, &sx, &sy) == 4) {
+                auto& c = cfgs.back();
+                c.Dx.push_back(dx); c.Dy.push_back(dy); c.Sx.push_back(sx); c.Sy.push_back(sy);
+            }
+        }
+    }
+    return cfgs;
+}
+
+int16_t ToStickUnits(float v) {
+    // Same truncating conversion as CurveProcessor.ToStick.
+    float s = v * 32767.0f;
+    if (s > 32767.0f) s = 32767.0f;
+    if (s < -32768.0f) s = -32768.0f;
+    return (int16_t)s;
+}
+
+// 7 lanes: one SSE block plus a scalar tail, all fed the same stream.
+constexpr size_t kLanes = 7;
+
+} // namespace
+
+GC_TEST(FloatChainMatchesCSharpToStick) {
+    auto cfgs = LoadGolden();
+    GC_CHECK(cfgs.size() == 4);
+    for (const auto& c : cfgs) {
+        GC_CHECK(c.Dx.size() == 500);
+        std::vector<float> x(kLanes), y(kLanes), lastR(kLanes), emaX(kLanes), emaY(kLanes);
+        GC_STICKS_F s{x.data(), y.data(), kLanes};
+        float maxR = c.MaxSpeed > 0.0f ? c.MaxSpeed : 1.0f;
+        float scale = c.Sens / 50.0f;
+        int worst = 0;
+        for (size_t t = 0; t < c.Dx.size(); ++t) {
+            for (size_t i = 0; i < kLanes; ++i) { x[i] = c.Dx[t] * scale * c.ScaleX; y[i] = c.Dy[t] * scale * c.ScaleY; }
+            GcDspRadialDeadzoneF(s, c.Jitter, 0);
+            GcDspVelocityGainF(s, c.VGain, lastR.data());
+            GcDspRadialCurveF(s, c.Expo, maxR);
+            GcDspAntiDeadzoneF(s, c.Adz, maxR);
+            if (c.Alpha > 0.0f) GcDspEmaF(s, c.Alpha, emaX.data(), emaY.data());
+            GcDspCircularClampF(s, maxR);
+            for (size_t i = 0; i < kLanes; ++i) {
+                int dx = std::abs(ToStickUnits(x[i]) - c.Sx[t]);
+                int dy = std::abs(ToStickUnits(-y[i]) - c.Sy[t]);
+                worst = std::max(worst, std::max(dx, dy));
+            }
+        }
+        GC_CHECK(worst <= 1);
+    }
+}
+
+namespace {
+
+struct Q15Fixture {
+    std::vector<int16_t> Qx, Qy;
+    std::vector<float> Fx, Fy;
+    GC_STICKS_Q15 Q() { return {Qx.data(), Qy.data(), Qx.size()}; }
+    GC_STICKS_F F() { return {Fx.data(), Fy.data(), Fx.size()}; }
+
+    void Load(const std::vector<int16_t>& x, const std::vector<int16_t>& y) {
+        Qx = x; Qy = y;
+        Fx.resize(x.size()); Fy.resize(y.size());
+        GcDspFromQ15(Qx.data(), Fx.data(), Qx.size());
+        GcDspFromQ15(Qy.data(), Fy.data(), Qy.size());
+    }
+
+    int MaxDiff() {
+        std::vector<int16_t> rx(Fx.size()), ry(Fy.size());
+        GcDspToQ15(Fx.data(), rx.data(), rx.size());
+        GcDspToQ15(Fy.data(), ry.data(), ry.size());
+        int worst = 0;
+        for (size_t i = 0; i < rx.size(); ++i)
+            worst = std::max(worst, std::max(std::abs(rx[i] - Qx[i]), std::abs(ry[i] - Qy[i])));
+        return worst;
+    }
+};
+
+void RandomSticks(Rng& rng, size_t n, float maxMag, std::vector<int16_t>& x, std::vector<int16_t>& y) {
+    x.resize(n); y.resize(n);
+    for (size_t i = 0; i < n; ++i) {
+        float fx = rng.Uniform(-maxMag, maxMag), fy = rng.Uniform(-maxMag, maxMag);
+        if (i % 9 == 0) fx = fy = 0.0f;
+        GcDspToQ15(&fx, &x[i], 1);
+        GcDspToQ15(&fy, &y[i], 1);
+    }
+}
+
+int16_t Frac(float v) { return (int16_t)std::lround(v * 32768.0f); }
+float FracF(int16_t q) { return q / 32768.0f; }
+int16_t Units(float v) { return (int16_t)std::lround(v * 32767.0f); }
+float UnitsF(int16_t q) { return q / 32767.0f; }
+
+constexpr size_t kSticks = 37;
+
+} // namespace
+
+GC_TEST(Q15StatelessStagesMatchFloat) {
+    Rng rng;
+    std::vector<int16_t> x, y;
+    Q15Fixture f;
+    for (int round = 0; round < 200; ++round) {
+        RandomSticks(rng, kSticks, 1.0f, x, y);
+        int16_t inner = Units(0.1f), maxR = Units(0.9f), adz = Frac(0.05f), expo = Frac(0.6f);
+
+        for (int rescale = 0; rescale < 2; ++rescale) {
+            f.Load(x, y);
+            GcDspRadialDeadzoneQ15(f.Q(), inner, rescale);
+            GcDspRadialDeadzoneF(f.F(), UnitsF(inner), rescale);
+            GC_CHECK(f.MaxDiff() <= 1);
+
+            f.Load(x, y);
+            GcDspAxialDeadzoneQ15(f.Q(), inner, rescale);
+            GcDspAxialDeadzoneF(f.F(), UnitsF(inner), rescale);
+            GC_CHECK(f.MaxDiff() <= 1);
+        }
+
+        f.Load(x, y);
+        GcDspAntiDeadzoneQ15(f.Q(), adz, maxR);
+        GcDspAntiDeadzoneF(f.F(), FracF(adz), UnitsF(maxR));
+        GC_CHECK(f.MaxDiff() <= 1);
+
+        for (int16_t m : {maxR, (int16_t)GC_Q15_ONE}) {
+            f.Load(x, y);
+            GcDspRadialCurveQ15(f.Q(), expo, m);
+            GcDspRadialCurveF(f.F(), FracF(expo), UnitsF(m));
+            GC_CHECK(f.MaxDiff() <= 1);
+        }
+
+        f.Load(x, y);
+        GcDspCircularClampQ15(f.Q(), maxR);
+        GcDspCircularClampF(f.F(), UnitsF(maxR));
+        GC_CHECK(f.MaxDiff() <= 1);
+    }
+}
+
+GC_TEST(Q15StatefulStagesMatchFloat) {
+    Rng rng;
+    std::vector<int16_t> x, y;
+    Q15Fixture vel, ema, euro;
+    std::vector<float> lastRF(kSticks), emaXF(kSticks), emaYF(kSticks);
+    std::vector<int32_t> lastRQ(kSticks), emaXQ(kSticks), emaYQ(kSticks);
+    std::vector<float> fxF(kSticks), fyF(kSticks), dxF(kSticks), dyF(kSticks);
+    std::vector<int32_t> fxQ(kSticks), fyQ(kSticks), dxQ(kSticks), dyQ(kSticks);
+    GC_ONE_EURO_STATE_F stF{fxF.data(), fyF.data(), dxF.data(), dyF.data()};
+    GC_ONE_EURO_STATE_Q15 stQ{fxQ.data(), fyQ.data(), dxQ.data(), dyQ.data()};
+    GC_ONE_EURO_PARAMS_Q15 pQ{1000, 500, 1000, 1000};
+    GC_ONE_EURO_PARAMS pF{pQ.MinCutoffMilliHz / 1000.0f, pQ.BetaMilliHz / 1000.0f, pQ.DCutoffMilliHz / 1000.0f,
+                          (float)pQ.RateHz};
+    int16_t gain = Frac(0.5f), alpha = Frac(0.2f);
+
+    // Random walk so the filters see both slow drift and jumps.
+    std::vector<float> wx(kSticks), wy(kSticks);
+    int worstVel = 0, worstEma = 0, worstEuro = 0;
+    for (int t = 0; t < 2000; ++t) {
+        for (size_t i = 0; i < kSticks; ++i) {
+            float step = (t % 97 == 0) ? 0.3f : 0.02f;
+            wx[i] = std::fmax(-0.5f, std::fmin(0.5f, wx[i] + rng.Uniform(-step, step)));
+            wy[i] = std::fmax(-0.5f, std::fmin(0.5f, wy[i] + rng.Uniform(-step, step)));
+        }
+        x.resize(kSticks); y.resize(kSticks);
+        GcDspToQ15(wx.data(), x.data(), kSticks);
+        GcDspToQ15(wy.data(), y.data(), kSticks);
+
+        vel.Load(x, y);
+        GcDspVelocityGainQ15(vel.Q(), gain, lastRQ.data());
+        GcDspVelocityGainF(vel.F(), FracF(gain), lastRF.data());
+        worstVel = std::max(worstVel, vel.MaxDiff());
+
+        ema.Load(x, y);
+        GcDspEmaQ15(ema.Q(), alpha, emaXQ.data(), emaYQ.data());
+        GcDspEmaF(ema.F(), FracF(alpha), emaXF.data(), emaYF.data());
+        worstEma = std::max(worstEma, ema.MaxDiff());
+
+        euro.Load(x, y);
+        if (t == 0) { GcDspOneEuroResetQ15(euro.Q(), stQ); GcDspOneEuroResetF(euro.F(), stF); }
+        GcDspOneEuroQ15(euro.Q(), &pQ, stQ);
+        GcDspOneEuroF(euro.F(), &pF, stF);
+        worstEuro = std::max(worstEuro, euro.MaxDiff());
+    }
+    GC_CHECK(worstVel <= 1);
+    GC_CHECK(worstEma <= 1);
+    GC_CHECK(worstEuro <= 1);
+}
+
+GC_TEST(DeadzoneAndClampSemantics) {
+    float x[5] = {0.05f, 0.6f, 0.0f, 1.0f, -0.8f};
+    float y[5] = {0.05f, 0.8f, 0.0f, 0.0f, 0.6f};
+    GC_STICKS_F s{x, y, 5};
+    GcDspRadialDeadzoneF(s, 0.1f, 1);
+    GC_CHECK(x[0] == 0.0f && y[0] == 0.0f);
+    GC_CHECK_NEAR(std::sqrt(x[1] * x[1] + y[1] * y[1]), 1.0f, 1e-6f);
+    GC_CHECK_NEAR(x[1] / y[1], 0.75f, 1e-6f);
+    GC_CHECK(x[2] == 0.0f && y[2] == 0.0f);
+    GC_CHECK_NEAR(x[3], 1.0f, 1e-6f);
+
+    float cx[5] = {2.0f, 0.3f, 0.0f, -3.0f, 0.6f};
+    float cy[5] = {0.0f, 0.4f, 0.0f, 4.0f, 0.8f};
+    GC_STICKS_F c{cx, cy, 5};
+    GcDspCircularClampF(c, 1.0f);
+    GC_CHECK_NEAR(cx[0], 1.0f, 1e-6f);
+    GC_CHECK_NEAR(cx[1], 0.3f, 1e-7f);
+    GC_CHECK(cx[2] == 0.0f && cy[2] == 0.0f);
+    GC_CHECK_NEAR(cx[3], -0.6f, 1e-6f);
+    GC_CHECK_NEAR(cy[3], 0.8f, 1e-6f);
+}
+
+GC_TEST(CurveIsIdentityWithoutExpo) {
+    Rng rng;
+    std::vector<float> x(13), y(13), x0, y0;
+    for (size_t i = 0; i < x.size(); ++i) { x[i] = rng.Uniform(-0.7f, 0.7f); y[i] = rng.Uniform(-0.7f, 0.7f); }
+    x0 = x; y0 = y;
+    GcDspRadialCurveF({x.data(), y.data(), x.size()}, 0.0f, 1.0f);
+    for (size_t i = 0; i < x.size(); ++i) { GC_CHECK_NEAR(x[i], x0[i], 2e-6f); GC_CHECK_NEAR(y[i], y0[i], 2e-6f); }
+}
+
+GC_TEST_MAIN()
@@ -0,0 +1,206 @@
+#include "Check.h"
+#include "gc/HostWdk.h"
+#include "VPadShared.h"
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+
+namespace {
+
+// One func driver device on the host WDK (host/), removed at scope exit.
+struct FuncPad {
+    FuncPad() { GC_CHECK(GcHostAddDevice(GcVPadFuncDriverEntry, &Dev) == STATUS_SUCCESS); }
+    ~FuncPad() { GcHostRemoveDevice(Dev); }
+
+    NTSTATUS Ioctl(ULONG code, const void* in, size_t inLen, void* out = nullptr, size_t outLen = 0) {
+        return GcHostIoctl(Dev, code, in, inLen, out, outLen, &Info);
+    }
+    NTSTATUS SetState(const VPAD_STATE& s) { return Ioctl(IOCTL_VPAD_SET_STATE, &s, sizeof(s)); }
+    template <class T> T Get(ULONG code) {
+        T out;
+        std::memset(&out, 0, sizeof(out));
+        GC_CHECK(Ioctl(code, nullptr, 0, &out, sizeof(out)) == STATUS_SUCCESS);
+        GC_CHECK(Info == sizeof(out));
+        return out;
+    }
+    ULONG Report(UCHAR* out) { return GcHostVhfLastReport(Dev, out, 64); }
+
+    WDFDEVICE Dev = nullptr;
+    size_t Info = 0;
+};
+
+} // namespace
+
+GC_TEST(DeviceAddSubmitsNeutral) {
+    FuncPad p;
+    GC_CHECK(GcHostVhfSubmits(p.Dev) == 1);
+    UCHAR r[64];
+    GC_CHECK(p.Report(r) == 12);
+    for (int i = 0; i < 12; ++i) GC_CHECK(r[i] == 0);
+    GC_CHECK(p.Get<ULONG>(IOCTL_VPAD_GET_VERSION) == VPAD_VERSION);
+}
+
+GC_TEST(SetStatePacksInputReport) {
+    FuncPad p;
+    VPAD_STATE s = { 0x1234, 10, 200, -1, 2, 300, -32768 };
+    GC_CHECK(p.SetState(s) == STATUS_SUCCESS);
+    GC_CHECK(p.Info == 0);
+    GC_CHECK(GcHostVhfSubmits(p.Dev) == 2);
+
+    UCHAR r[64];
+    GC_CHECK(p.Report(r) == 12);
+    const UCHAR want[12] = { 0x34, 0x12, 10, 200, 0xFF, 0xFF, 2, 0, 0x2C, 0x01, 0x00, 0x80 };
+    GC_CHECK(std::memcmp(r, want, sizeof(want)) == 0);
+
+    VPAD_PRESSURE pr = p.Get<VPAD_PRESSURE>(IOCTL_VPAD_GET_PRESSURE);
+    GC_CHECK(pr.Submitted == 1 && pr.Rejected == 0 && pr.InFlight == 0 && pr.PeakInFlight == 1);
+
+    // A VHF failure is counted, not surfaced: the request still succeeds.
+    GcHostVhfSetSubmitStatus(p.Dev, STATUS_INSUFFICIENT_RESOURCES);
+    GC_CHECK(p.SetState(s) == STATUS_SUCCESS);
+    pr = p.Get<VPAD_PRESSURE>(IOCTL_VPAD_GET_PRESSURE);
+    GC_CHECK(pr.Submitted == 1 && pr.Rejected == 1);
+
+    // A trace appended to the state lands in the latency histograms.
+    GcHostVhfSetSubmitStatus(p.Dev, STATUS_SUCCESS);
+    VPAD_STATE_TRACED t = { s, { 7, 0, 1 } };
+    GC_CHECK(p.Ioctl(IOCTL_VPAD_SET_STATE, &t, sizeof(t)) == STATUS_SUCCESS);
+    GC_CHECK(p.Get<VPAD_LATENCY>(IOCTL_VPAD_GET_LATENCY).Count == 1);
+}
+
+GC_TEST(BufferLengthsAreChecked) {
+    FuncPad p;
+    VPAD_STATE s = { 1, 0, 0, 0, 0, 0, 0 };
+    GC_CHECK(p.Ioctl(IOCTL_VPAD_SET_STATE, &s, sizeof(s) - 1) == STATUS_BUFFER_TOO_SMALL);
+    GC_CHECK(p.Ioctl(IOCTL_VPAD_SET_STATE, nullptr, 0) == STATUS_BUFFER_TOO_SMALL);
+    GC_CHECK(GcHostVhfSubmits(p.Dev) == 1);   // the DeviceAdd neutral only
+
+    UCHAR small[3] = { 0, 0, 0 };
+    GC_CHECK(p.Ioctl(IOCTL_VPAD_GET_VERSION, nullptr, 0, small, sizeof(small)) == STATUS_BUFFER_TOO_SMALL);
+    GC_CHECK(p.Info == 0);
+    GC_CHECK(p.Ioctl(IOCTL_VPAD_GET_LATENCY, nullptr, 0, small, sizeof(small)) == STATUS_BUFFER_TOO_SMALL);
+    GC_CHECK(p.Ioctl(CTL_CODE(FILE_DEVICE_VPAD, 0x8FF, METHOD_BUFFERED, FILE_ANY_ACCESS), nullptr, 0)
+             == STATUS_INVALID_DEVICE_REQUEST);
+    GC_CHECK(p.Ioctl(IOCTL_VPAD_CREATE, nullptr, 0) == STATUS_SUCCESS);
+}
+
+GC_TEST(OutputReportsDriveRumbleAndLeds) {
+    FuncPad p;
+    const UCHAR rumble[2] = { 255, 0 };
+    GcHostVhfWrite(p.Dev, 1, rumble, sizeof(rumble));
+    VPAD_RUMBLE r = p.Get<VPAD_RUMBLE>(IOCTL_VPAD_GET_RUMBLE);
+    GC_CHECK(r.Sequence == 1 && r.Left == 255 && r.Right == 0);
+    VPAD_LEDS l = p.Get<VPAD_LEDS>(IOCTL_VPAD_GET_LEDS);
+    GC_CHECK(l.R == 0 && l.G == 0 && l.B == 255);   // left motor maps to blue
+
+    GcHostVhfWrite(p.Dev, 1, rumble, 1);            // too short: ignored
+    GC_CHECK(p.Get<VPAD_RUMBLE>(IOCTL_VPAD_GET_RUMBLE).Sequence == 1);
+
+    const UCHAR leds[3] = { 1, 2, 3 };
+    GcHostVhfWrite(p.Dev, 2, leds, sizeof(leds));
+    l = p.Get<VPAD_LEDS>(IOCTL_VPAD_GET_LEDS);
+    GC_CHECK(l.R == 1 && l.G == 2 && l.B == 3);
+    const VPAD_LEDS set = { 9, 8, 7 };
+    GC_CHECK(p.Ioctl(IOCTL_VPAD_SET_LEDS, &set, sizeof(set)) == STATUS_SUCCESS);
+    l = p.Get<VPAD_LEDS>(IOCTL_VPAD_GET_LEDS);
+    GC_CHECK(l.R == 9 && l.G == 8 && l.B == 7);
+}
+
+GC_TEST(WatchdogTimerSubmitsNeutral) {
+    FuncPad p;
+    uint32_t ms = 1;
+    GC_CHECK(p.Ioctl(IOCTL_VPAD_SET_WATCHDOG, &ms, sizeof(ms)) == STATUS_SUCCESS);
+    GC_CHECK(GcHostTimerDue(p.Dev) == 0);           // never fed: nothing armed
+
+    VPAD_STATE s = { 0, 0, 0, 1000, 0, 0, 0 };
+    GC_CHECK(p.SetState(s) == STATUS_SUCCESS);
+    GC_CHECK(GcHostTimerDue(p.Dev) == -10000);      // 1 ms, relative, 100 ns units
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    GC_CHECK(GcHostFireTimers(p.Dev) == 1);
+    GC_CHECK(GcHostTimerDue(p.Dev) == 0);           // stale: not re-armed
+
+    UCHAR r[64];
+    GC_CHECK(p.Report(r) == 12 && r[4] == 0 && r[5] == 0);
+    VPAD_WATCHDOG w = p.Get<VPAD_WATCHDOG>(IOCTL_VPAD_GET_WATCHDOG);
+    GC_CHECK(w.TimeoutMs == 1 && w.Stale == 1 && w.Expirations == 1 && w.StaleForNs > 0);
+
+    GC_CHECK(p.SetState(s) == STATUS_SUCCESS);
+    w = p.Get<VPAD_WATCHDOG>(IOCTL_VPAD_GET_WATCHDOG);
+    GC_CHECK(w.Stale == 0 && w.Recoveries == 1);
+}
+
+GC_TEST(DestroyIsNeutralAndLeavesTheWatchdogIdle) {
+    FuncPad p;
+    VPAD_STATE s = { 0x0101, 200, 0, 1000, 0, 0, 0 };
+    GC_CHECK(p.SetState(s) == STATUS_SUCCESS);      // default 500 ms watchdog armed
+    GC_CHECK(GcHostTimerDue(p.Dev) != 0);
+    uint64_t before = GcHostVhfSubmits(p.Dev);
+    GC_CHECK(p.Ioctl(IOCTL_VPAD_DESTROY, nullptr, 0) == STATUS_SUCCESS);
+    GC_CHECK(GcHostVhfSubmits(p.Dev) == before + 1);
+    UCHAR r[64];
+    GC_CHECK(p.Report(r) == 12);
+    for (int i = 0; i < 12; ++i) GC_CHECK(r[i] == 0);
+
+    // No second neutral, no expiry, not reported stale.
+    GC_CHECK(GcHostTimerDue(p.Dev) == 0);
+    GcHostFireTimers(p.Dev);
+    GC_CHECK(GcHostVhfSubmits(p.Dev) == before + 1);
+    VPAD_WATCHDOG w = p.Get<VPAD_WATCHDOG>(IOCTL_VPAD_GET_WATCHDOG);
+    GC_CHECK(w.Stale == 0 && w.Expirations == 0);
+
+    // The next client arms it again.
+    GC_CHECK(p.SetState(s) == STATUS_SUCCESS);
+    GC_CHECK(GcHostTimerDue(p.Dev) != 0);
+}
+
+GC_TEST(PowerDownStopsTheWatchdogTimer) {
+    FuncPad p;
+    VPAD_STATE s = { 0, 0, 0, 1000, 0, 0, 0 };
+    GC_CHECK(p.SetState(s) == STATUS_SUCCESS);
+    GC_CHECK(GcHostTimerDue(p.Dev) != 0);
+    uint64_t before = GcHostVhfSubmits(p.Dev);
+    GC_CHECK(GcHostPowerDown(p.Dev) == STATUS_SUCCESS);
+    GC_CHECK(GcHostTimerDue(p.Dev) == 0);
+    GC_CHECK(GcHostFireTimers(p.Dev) == 0);
+    GC_CHECK(GcHostVhfSubmits(p.Dev) == before);
+    GC_CHECK(p.Get<VPAD_WATCHDOG>(IOCTL_VPAD_GET_WATCHDOG).Stale == 0);
+
+    GC_CHECK(p.SetState(s) == STATUS_SUCCESS);      // back in D0: armed by the next feed
+    GC_CHECK(GcHostTimerDue(p.Dev) != 0);
+}
+
+GC_TEST(BusPadCountFollowsRegistry) {
+    GcHostRegistryClear();
+    GcHostRegistrySetULong(L"PadCount", 3);
+    WDFDEVICE bus = nullptr;
+    GC_CHECK(GcHostAddDevice(GcVPadBusDriverEntry, &bus) == STATUS_SUCCESS);
+    // Identification descriptions carry no index, so the child list holds
+    // one child however many pads are configured.
+    GC_CHECK(GcHostChildCount(bus) == 1);
+
+    ULONG n = 0;
+    size_t info = 0;
+    GC_CHECK(GcHostIoctl(bus, IOCTL_VPADBUS_GET_PADCOUNT, nullptr, 0, &n, sizeof(n), &info) == STATUS_SUCCESS);
+    GC_CHECK(n == 3 && info == sizeof(ULONG));
+
+    ULONG set = 40;   // clamped to 16 and persisted
+    GC_CHECK(GcHostIoctl(bus, IOCTL_VPADBUS_SET_PADCOUNT, &set, sizeof(set), nullptr, 0, &info) == STATUS_SUCCESS);
+    GC_CHECK(GcHostIoctl(bus, IOCTL_VPADBUS_GET_PADCOUNT, nullptr, 0, &n, sizeof(n), &info) == STATUS_SUCCESS);
+    GC_CHECK(n == 16);
+    ULONG stored = 0;
+    GC_CHECK(GcHostRegistryGetULong(L"PadCount", &stored) && stored == 16);
+    GC_CHECK(GcHostIoctl(bus, IOCTL_VPADBUS_RESCAN, nullptr, 0, nullptr, 0, &info) == STATUS_SUCCESS);
+    GC_CHECK(GcHostIoctl(bus, IOCTL_VPADBUS_SET_PADCOUNT, &set, 2, nullptr, 0, &info) == STATUS_BUFFER_TOO_SMALL);
+    GcHostRemoveDevice(bus);
+
+    GcHostRegistrySetULong(L"PadCount", 99);   // out of range: default
+    GC_CHECK(GcHostAddDevice(GcVPadBusDriverEntry, &bus) == STATUS_SUCCESS);
+    GC_CHECK(GcHostIoctl(bus, IOCTL_VPADBUS_GET_PADCOUNT, nullptr, 0, &n, sizeof(n), &info) == STATUS_SUCCESS);
+    GC_CHECK(n == 4);
+    GcHostRemoveDevice(bus);
+    GcHostRegistryClear();
+}
+
+GC_TEST_MAIN()
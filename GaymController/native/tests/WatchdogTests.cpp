@@ -0,0 +1,141 @@
+#include "Check.h"
+#include "gc/Watchdog.h"
+
+#include <cstdint>
+
+namespace {
+
+constexpr uint64_t kMs = 1000000;
+
+// The func driver's use of the watchdog on a virtual clock: SET_STATE
+// feeds, one one-shot timer polls, an expiry submits one neutral report.
+struct Pad {
+    explicit Pad(uint64_t timeoutNs) { GcWatchdogInit(&W, timeoutNs); }
+
+    void SetState(uint64_t now) {
+        Advance(now);
+        Reports++;
+        if (GcWatchdogFeed(&W, now)) TimerAt = now + W.TimeoutNs;
+    }
+    void SetTimeout(uint64_t timeoutNs, uint64_t now) {
+        Advance(now);
+        if (GcWatchdogSetTimeout(&W, timeoutNs, now)) TimerAt = now + timeoutNs;
+    }
+    void Destroy(uint64_t now) {
+        Advance(now);
+        NeutralSubmits++;   // the clean release submits its own neutral
+        GcWatchdogStop(&W);
+    }
+    void Advance(uint64_t to) {
+        while (TimerAt && TimerAt <= to) {
+            uint64_t now = TimerAt, next;
+            TimerAt = 0;
+            TimerFires++;
+            if (GcWatchdogPoll(&W, now, &next)) {
+                NeutralSubmits++;
+                LastNeutralNs = now;
+            }
+            TimerAt = next;
+        }
+    }
+
+    GC_WATCHDOG W;
+    uint64_t TimerAt = 0;   // 0 = timer not pending
+    uint64_t LastNeutralNs = 0;
+    int Reports = 0, NeutralSubmits = 0, TimerFires = 0;
+};
+
+} // namespace
+
+GC_TEST(TimesOutOnceAfterLastFeed) {
+    Pad p(100 * kMs);
+    p.Advance(10000 * kMs);
+    GC_CHECK(p.NeutralSubmits == 0 && p.TimerFires == 0);   // never fed: nothing to protect
+
+    p.SetState(1000 * kMs);
+    p.Advance(1100 * kMs - 1);
+    GC_CHECK(p.NeutralSubmits == 0 && !GcWatchdogStale(&p.W));
+    p.Advance(1100 * kMs);
+    GC_CHECK(p.NeutralSubmits == 1 && p.LastNeutralNs == 1100 * kMs);
+    GC_CHECK(GcWatchdogStale(&p.W) && p.W.StaleSinceNs == 1100 * kMs);
+
+    // No extra submits and no timer while stale, however long it stays so.
+    p.Advance(100000 * kMs);
+    GC_CHECK(p.NeutralSubmits == 1 && p.TimerAt == 0 && p.W.Expirations == 1);
+    uint64_t next = 1;
+    GC_CHECK(GcWatchdogPoll(&p.W, 200000 * kMs, &next) == 0 && next == 0);
+}
+
+GC_TEST(SteadyFeederNeverExpiresAndTimerStaysCheap) {
+    Pad p(100 * kMs);
+    for (uint64_t t = 0; t < 10000 * kMs; t += kMs / 8) p.SetState(t);   // 8 kHz for 10 s
+    GC_CHECK(p.NeutralSubmits == 0);
+    GC_CHECK(p.TimerFires <= 10000 / 100 + 1);   // one expiry per timeout, not per report
+    GC_CHECK(p.Reports == 80000);
+
+    // Slow but live feeder just inside the timeout: still no expiry.
+    Pad slow(100 * kMs);
+    for (uint64_t t = 0; t < 5000 * kMs; t += 99 * kMs) slow.SetState(t);
+    GC_CHECK(slow.NeutralSubmits == 0);
+}
+
+GC_TEST(FeedAfterStaleRecovers) {
+    Pad p(50 * kMs);
+    p.SetState(0);
+    p.Advance(60 * kMs);
+    GC_CHECK(p.NeutralSubmits == 1 && GcWatchdogStale(&p.W));
+    p.SetState(70 * kMs);
+    GC_CHECK(!GcWatchdogStale(&p.W) && p.W.Recoveries == 1 && p.W.StaleSinceNs == 0);
+    GC_CHECK(p.TimerAt == 120 * kMs);   // re-armed by the recovering feed
+    p.SetState(100 * kMs);
+    p.Advance(149 * kMs);
+    GC_CHECK(p.NeutralSubmits == 1);
+    p.Advance(150 * kMs);
+    GC_CHECK(p.NeutralSubmits == 2 && p.W.Expirations == 2);
+}
+
+GC_TEST(StopAfterCleanReleaseNeverExpires) {
+    Pad p(500 * kMs);
+    p.SetState(0);
+    p.Destroy(100 * kMs);
+    GC_CHECK(p.TimerAt == 500 * kMs);   // still pending; it must find nothing to do
+    p.Advance(10000 * kMs);
+    GC_CHECK(p.NeutralSubmits == 1 && p.W.Expirations == 0 && !GcWatchdogStale(&p.W));
+    GC_CHECK(p.TimerAt == 0 && p.W.TimeoutNs == 500 * kMs);
+
+    // A new client arms it again; a stop while stale clears the flag.
+    p.SetState(10000 * kMs);
+    GC_CHECK(p.TimerAt == 10500 * kMs);
+    p.Advance(10500 * kMs);
+    GC_CHECK(GcWatchdogStale(&p.W) && p.W.Expirations == 1);
+    p.Destroy(10600 * kMs);
+    GC_CHECK(!GcWatchdogStale(&p.W) && p.W.State == GC_WATCHDOG_IDLE && p.W.Recoveries == 0);
+}
+
+GC_TEST(TimeoutChangesAndDisable) {
+    Pad p(0);   // disabled: feeds never arm a timer
+    p.SetState(0);
+    p.Advance(10000 * kMs);
+    GC_CHECK(p.TimerAt == 0 && p.NeutralSubmits == 0);
+
+    p.SetTimeout(100 * kMs, 10000 * kMs);   // enabled while idle: armed by the next feed
+    GC_CHECK(p.TimerAt == 0);
+    p.SetState(10010 * kMs);
+    GC_CHECK(p.TimerAt == 10110 * kMs);
+
+    // Shortening counts from now: a client fed 90 ms ago is not expired at once.
+    p.SetTimeout(20 * kMs, 10100 * kMs);
+    p.Advance(10119 * kMs);
+    GC_CHECK(p.NeutralSubmits == 0);
+    p.Advance(10120 * kMs);
+    GC_CHECK(p.NeutralSubmits == 1);
+
+    // Disabling clears the stale flag; the stale pad stays neutral.
+    p.SetTimeout(0, 10200 * kMs);
+    GC_CHECK(!GcWatchdogStale(&p.W) && p.W.State == GC_WATCHDOG_IDLE);
+    p.SetState(10300 * kMs);
+    p.Advance(20000 * kMs);
+    GC_CHECK(p.NeutralSubmits == 1 && p.W.Recoveries == 0);
+}
+
+GC_TEST_MAIN()
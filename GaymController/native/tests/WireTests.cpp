@@ -0,0 +1,83 @@
+#include "Check.h"
+#include "gc/Wire.h"
+
+#include <cstdint>
+#include <cstring>
+
+// Golden frames shared with tests/WireTests/WirePackTests.cs.
+
+GC_TEST(HelloFrameMatchesGolden) {
+    uint8_t buf[16];
+    const uint8_t exp[] = {0x0C,0x00,0x00,0x00,0x01,0x00,0x00,0x00,0x01,0x00,0x00,0x00};
+    GC_CHECK(GcWirePackHello(buf, sizeof(buf)) == sizeof(exp));
+    GC_CHECK(std::memcmp(buf, exp, sizeof(exp)) == 0);
+}
+
+GC_TEST(SetStateFrameMatchesGolden) {
+    uint8_t buf[64];
+    GC_GAMEPAD_STATE st{32767, 32767, 32767, 32767, 0, 0, 0};
+    const uint8_t exp[] = {
+        0x20,0x00,0x00,0x00,0x14,0x00,0x00,0x00,
+        0x88,0x77,0x66,0x55,0x44,0x33,0x22,0x11,
+        0xFF,0x7F,0xFF,0x7F,0xFF,0x7F,0xFF,0x7F,
+        0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00};
+    GC_CHECK(GcWirePackSetState(buf, sizeof(buf), 0x1122334455667788ull, &st, nullptr) == sizeof(exp));
+    GC_CHECK(std::memcmp(buf, exp, sizeof(exp)) == 0);
+}
+
+GC_TEST(TracedSetStateFrameMatchesGolden) {
+    uint8_t buf[64];
+    GC_GAMEPAD_STATE st{32767, 32767, 32767, 32767, 0, 0, 0};
+    GC_TRACE tr{0x01020304u, 0x21222324u, 0x1112131415161718ull};
+    const uint8_t exp[] = {
+        0x30,0x00,0x00,0x00,0x14,0x00,0x01,0x00,
+        0x88,0x77,0x66,0x55,0x44,0x33,0x22,0x11,
+        0xFF,0x7F,0xFF,0x7F,0xFF,0x7F,0xFF,0x7F,
+        0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+        0x04,0x03,0x02,0x01,0x24,0x23,0x22,0x21,
+        0x18,0x17,0x16,0x15,0x14,0x13,0x12,0x11};
+    size_t n = GcWirePackSetState(buf, sizeof(buf), 0x1122334455667788ull, &st, &tr);
+    GC_CHECK(n == sizeof(exp));
+    GC_CHECK(std::memcmp(buf, exp, sizeof(exp)) == 0);
+
+    GC_WIRE_FRAME f;
+    GC_WIRE_SET_STATE s;
+    GC_CHECK(GcWireParseFrame(buf, n, &f) == GC_WIRE_OK);
+    GC_CHECK(GcWireReadSetState(&f, &s) == GC_WIRE_OK);
+    GC_CHECK(s.Handle == 0x1122334455667788ull);
+    GC_CHECK(s.State.LX == 32767 && s.State.Buttons == 0);
+    GC_CHECK(s.HasTrace);
+    GC_CHECK(s.Trace.Sequence == tr.Sequence && s.Trace.LastOffsetNs == tr.LastOffsetNs && s.Trace.OriginNs == tr.OriginNs);
+}
+
+GC_TEST(RumbleEventFrameMatchesGolden) {
+    uint8_t buf[32];
+    const uint8_t exp[] = {
+        0x14,0x00,0x00,0x00,0x29,0x00,0x00,0x00,
+        0x08,0x07,0x06,0x05,0x04,0x03,0x02,0x01,
+        0x0B,0x0A,0x0D,0x0C};
+    GC_CHECK(GcWirePackRumbleEvent(buf, sizeof(buf), 0x0102030405060708ull, 0x0A0B, 0x0C0D) == sizeof(exp));
+    GC_CHECK(std::memcmp(buf, exp, sizeof(exp)) == 0);
+}
+
+GC_TEST(ParserRejectsShortAndBadFrames) {
+    uint8_t buf[64];
+    GC_GAMEPAD_STATE st{};
+    GC_WIRE_FRAME f;
+    GC_WIRE_SET_STATE s;
+    GC_CHECK(GcWirePackSetState(buf, 16, 1, &st, nullptr) == 0);
+    size_t n = GcWirePackSetState(buf, sizeof(buf), 1, &st, nullptr);
+    GC_CHECK(GcWireParseFrame(buf, 4, &f) == GC_WIRE_NEED_MORE);
+    GC_CHECK(GcWireParseFrame(buf, n - 1, &f) == GC_WIRE_NEED_MORE);
+    buf[6] = GC_WIRE_FLAG_TRACE;  // claims a trace the payload does not carry
+    GC_CHECK(GcWireParseFrame(buf, n, &f) == GC_WIRE_OK);
+    GC_CHECK(GcWireReadSetState(&f, &s) == GC_WIRE_BAD_PAYLOAD);
+    buf[0] = 4;
+    GC_CHECK(GcWireParseFrame(buf, n, &f) == GC_WIRE_BAD_LENGTH);
+    GcWirePackAck(buf, sizeof(buf), 20);
+    GC_CHECK(GcWireParseFrame(buf, sizeof(buf), &f) == GC_WIRE_OK);
+    GC_CHECK(f.Length == 12 && f.Type == GC_MSG_ACK);
+    GC_CHECK(GcWireReadSetState(&f, &s) == GC_WIRE_BAD_PAYLOAD);
+}
+
+GC_TEST_MAIN()
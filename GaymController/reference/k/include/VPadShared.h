@@ -37,7 +37,7 @@
 /* Version information */
 #define VPAD_VERSION_MAJOR 1
 #define VPAD_VERSION_MINOR 0
-#define VPAD_VERSION_PATCH 3
+#define VPAD_VERSION_PATCH 6
 #define VPAD_VERSION ((VPAD_VERSION_MAJOR << 16) | (VPAD_VERSION_MINOR << 8) | VPAD_VERSION_PATCH)
 
 /* Device interface GUIDs
@@ -72,6 +72,15 @@ VPAD_EXTERN_GUID GUID_DEVINTERFACE_VPADBUS;
 #define IOCTL_VPAD_GET_RUMBLE    CTL_CODE(FILE_DEVICE_VPAD,    0x905, METHOD_BUFFERED, FILE_READ_DATA)
 #define IOCTL_VPAD_SET_LEDS      CTL_CODE(FILE_DEVICE_VPAD,    0x906, METHOD_BUFFERED, FILE_WRITE_DATA)
 #define IOCTL_VPAD_GET_LEDS      CTL_CODE(FILE_DEVICE_VPAD,    0x907, METHOD_BUFFERED, FILE_READ_DATA)
+#define IOCTL_VPAD_GET_LATENCY   CTL_CODE(FILE_DEVICE_VPAD,    0x908, METHOD_BUFFERED, FILE_READ_DATA)
+#define IOCTL_VPAD_GET_PRESSURE  CTL_CODE(FILE_DEVICE_VPAD,    0x909, METHOD_BUFFERED, FILE_READ_DATA)
+#define IOCTL_VPAD_GET_WATCHDOG  CTL_CODE(FILE_DEVICE_VPAD,    0x90A, METHOD_BUFFERED, FILE_READ_DATA)
+#define IOCTL_VPAD_SET_WATCHDOG  CTL_CODE(FILE_DEVICE_VPAD,    0x90B, METHOD_BUFFERED, FILE_WRITE_DATA)
+
+/* Safe mode: a pad that gets no IOCTL_VPAD_SET_STATE for the watchdog
+   timeout is set to neutral once and reported stale. Feeders only need to
+   send at least once per timeout while idle. */
+#define VPAD_WATCHDOG_DEFAULT_MS 500
 
 #define IOCTL_VPADBUS_GET_PADCOUNT CTL_CODE(FILE_DEVICE_VPADBUS, 0xA01, METHOD_BUFFERED, FILE_READ_DATA)
 #define IOCTL_VPADBUS_SET_PADCOUNT CTL_CODE(FILE_DEVICE_VPADBUS, 0xA02, METHOD_BUFFERED, FILE_WRITE_DATA)
@@ -103,12 +112,66 @@ typedef struct _VPAD_LEDS
     uint8_t G;
     uint8_t B;
 } VPAD_LEDS, *PVPAD_LEDS;
+
+/* Optional latency trace appended to IOCTL_VPAD_SET_STATE input.
+   OriginNs is QPC time of the raw HID read converted to ns. */
+typedef struct _VPAD_TRACE
+{
+    uint32_t Sequence;
+    uint32_t LastOffsetNs;
+    uint64_t OriginNs;
+} VPAD_TRACE, *PVPAD_TRACE;
+
+typedef struct _VPAD_STATE_TRACED
+{
+    VPAD_STATE State;
+    VPAD_TRACE Trace;
+} VPAD_STATE_TRACED, *PVPAD_STATE_TRACED;
+
+/* Output of IOCTL_VPAD_GET_LATENCY: origin->submit and previous hop->submit. */
+typedef struct _VPAD_LATENCY
+{
+    uint64_t Count;
+    uint32_t TotalP50Ns;
+    uint32_t TotalP99Ns;
+    uint32_t TotalMaxNs;
+    uint32_t StageP50Ns;
+    uint32_t StageP99Ns;
+    uint32_t StageMaxNs;
+} VPAD_LATENCY, *PVPAD_LATENCY;
+/* Output of IOCTL_VPAD_GET_PRESSURE: backpressure for the sender's rate
+   controller (native/include/gc/RateControl.h). PeakInFlight restarts
+   from the current InFlight on every read. */
+typedef struct _VPAD_PRESSURE
+{
+    uint64_t Submitted;      /* SET_STATE reports handed to VHF */
+    uint32_t InFlight;       /* SET_STATE requests being serviced now */
+    uint32_t PeakInFlight;   /* max InFlight since the previous read */
+    uint32_t Rejected;       /* VhfReadReportSubmit failures */
+    uint32_t LastSubmitNs;   /* driver time spent on the latest SET_STATE */
+} VPAD_PRESSURE, *PVPAD_PRESSURE;
+
+/* Input of IOCTL_VPAD_SET_WATCHDOG: TimeoutMs, 0 disables.
+   Output of IOCTL_VPAD_GET_WATCHDOG. */
+typedef struct _VPAD_WATCHDOG
+{
+    uint32_t TimeoutMs;
+    uint32_t Stale;          /* 1 after a timeout until the next SET_STATE */
+    uint64_t Expirations;    /* neutral states submitted by the watchdog */
+    uint64_t Recoveries;     /* SET_STATE after a timeout */
+    uint64_t StaleForNs;     /* time since the timeout, 0 when live */
+} VPAD_WATCHDOG, *PVPAD_WATCHDOG;
 #pragma pack(pop)
 
 /* ABI checks */
 VPAD_STATIC_ASSERT(sizeof(VPAD_STATE)  == 12, "VPAD_STATE must be 12 bytes");
 VPAD_STATIC_ASSERT(sizeof(VPAD_RUMBLE) == 6,  "VPAD_RUMBLE must be 6 bytes");
 VPAD_STATIC_ASSERT(sizeof(VPAD_LEDS)   == 3,  "VPAD_LEDS must be 3 bytes");
+VPAD_STATIC_ASSERT(sizeof(VPAD_TRACE)  == 16, "VPAD_TRACE must be 16 bytes");
+VPAD_STATIC_ASSERT(sizeof(VPAD_STATE_TRACED) == 28, "VPAD_STATE_TRACED must be 28 bytes");
+VPAD_STATIC_ASSERT(sizeof(VPAD_LATENCY) == 32, "VPAD_LATENCY must be 32 bytes");
+VPAD_STATIC_ASSERT(sizeof(VPAD_PRESSURE) == 24, "VPAD_PRESSURE must be 24 bytes");
+VPAD_STATIC_ASSERT(sizeof(VPAD_WATCHDOG) == 32, "VPAD_WATCHDOG must be 32 bytes");
 
 #ifdef __cplusplus
 }
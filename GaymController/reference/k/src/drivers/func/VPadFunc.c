@@ -8,8 +8,12 @@ VOID VPadFuncEvtIoDeviceControl(WDFQUEUE Queue, WDFREQUEST Request,
 
 static VOID VPadOnVhfReadyForWrite(PVOID Context);
 static VOID VPadOnVhfProcessOutput(PVOID Context, PHID_XFER_PACKET OutputPacket);
-static VOID VPadSendInputReport(PFUNC_CONTEXT ctx, PVPAD_STATE state);
+static NTSTATUS VPadSendInputReport(PFUNC_CONTEXT ctx, PVPAD_STATE state);
 static VOID ClampShort(SHORT* v);
+static uint64_t VPadNowNs(void);
+static VOID VPadOnWatchdogTimer(WDFTIMER Timer);
+static VOID VPadStartWatchdogTimer(PFUNC_CONTEXT ctx, uint64_t inNs);
+static NTSTATUS VPadFuncEvtDeviceD0Exit(WDFDEVICE Device, WDF_POWER_DEVICE_STATE TargetState);
 
 static VOID MapRumbleToLeds(PFUNC_CONTEXT ctx, UCHAR left, UCHAR right)
 {
@@ -38,6 +42,11 @@ NTSTATUS VPadFuncEvtDeviceAdd(WDFDRIVER Driver, PWDFDEVICE_INIT DeviceInit)
 
     WdfDeviceInitSetDeviceType(DeviceInit, FILE_DEVICE_UNKNOWN);
 
+    WDF_PNPPOWER_EVENT_CALLBACKS pnp;
+    WDF_PNPPOWER_EVENT_CALLBACKS_INIT(&pnp);
+    pnp.EvtDeviceD0Exit = VPadFuncEvtDeviceD0Exit;
+    WdfDeviceInitSetPnpPowerEventCallbacks(DeviceInit, &pnp);
+
     WDF_OBJECT_ATTRIBUTES attrs;
     WDF_OBJECT_ATTRIBUTES_INIT_CONTEXT_TYPE(&attrs, FUNC_CONTEXT);
 
@@ -57,6 +66,19 @@ NTSTATUS VPadFuncEvtDeviceAdd(WDFDRIVER Driver, PWDFDEVICE_INIT DeviceInit)
     status = WdfIoQueueCreate(device, &qcfg, WDF_NO_OBJECT_ATTRIBUTES, &ctx->IoctlQueue);
     if (!NT_SUCCESS(status)) return status;
 
+    WDF_OBJECT_ATTRIBUTES childAttrs;
+    WDF_OBJECT_ATTRIBUTES_INIT(&childAttrs);
+    childAttrs.ParentObject = device;
+    status = WdfSpinLockCreate(&childAttrs, &ctx->SubmitLock);
+    if (!NT_SUCCESS(status)) return status;
+
+    WDF_TIMER_CONFIG tcfg;
+    WDF_TIMER_CONFIG_INIT(&tcfg, VPadOnWatchdogTimer);
+    tcfg.AutomaticSerialization = FALSE;
+    status = WdfTimerCreate(&tcfg, &childAttrs, &ctx->WatchdogTimer);
+    if (!NT_SUCCESS(status)) return status;
+    GcWatchdogInit(&ctx->Watchdog, VPAD_WATCHDOG_DEFAULT_MS * 1000000ull);
+
     VHF_CONFIG cfg;
     VHF_CONFIG_INIT(&cfg, WdfDeviceWdmGetDeviceObject(device), g_VPadReportDescriptor, sizeof(g_VPadReportDescriptor));
     cfg.EvtVhfReadyForWrite = VPadOnVhfReadyForWrite;
@@ -103,13 +125,67 @@ static VOID VPadOnVhfProcessOutput(PVOID Context, PHID_XFER_PACKET OutputPacket)
     }
 }
 
+// Same time base as the user-mode trace origin (QueryPerformanceCounter).
+static uint64_t VPadNowNs(void)
+{
+#ifdef _NTDDK_
+    LARGE_INTEGER freq;
+    LARGE_INTEGER t = KeQueryPerformanceCounter(&freq);
+    uint64_t f = (uint64_t)freq.QuadPart, c = (uint64_t)t.QuadPart;
+    return (c / f) * 1000000000ull + (c % f) * 1000000000ull / f;
+#else
+    return 0;
+#endif
+}
+
+static ULONG Clamp32(uint64_t v)
+{
+    return v > 0xFFFFFFFFull ? 0xFFFFFFFFul : (ULONG)v;
+}
+
+static VOID VPadStartWatchdogTimer(PFUNC_CONTEXT ctx, uint64_t inNs)
+{
+    // Relative due time in 100 ns units.
+    WdfTimerStart(ctx->WatchdogTimer, -(int64_t)((inNs + 99) / 100));
+}
+
+// One-shot; re-armed from GcWatchdogPoll while the feeder keeps moving the
+// deadline, so a live pad costs one expiry per timeout.
+static VOID VPadOnWatchdogTimer(WDFTIMER Timer)
+{
+    PFUNC_CONTEXT ctx = VPadFuncGetContext(WdfTimerGetParentObject(Timer));
+    uint64_t now = VPadNowNs(), next = 0;
+    WdfSpinLockAcquire(ctx->SubmitLock);
+    if (GcWatchdogPoll(&ctx->Watchdog, now, &next))
+    {
+        VPAD_STATE neutral = {0};
+        VPadSendInputReport(ctx, &neutral);
+    }
+    WdfSpinLockRelease(ctx->SubmitLock);
+    if (next) VPadStartWatchdogTimer(ctx, next > now ? next - now : 0);
+}
+
+// Power-down and removal: no watchdog submit may reach VHF after this.
+// The watchdog goes idle first so a DPC already waiting on SubmitLock
+// finds nothing to do; the next SET_STATE after D0Entry arms it again.
+static NTSTATUS VPadFuncEvtDeviceD0Exit(WDFDEVICE Device, WDF_POWER_DEVICE_STATE TargetState)
+{
+    UNREFERENCED_PARAMETER(TargetState);
+    PFUNC_CONTEXT ctx = VPadFuncGetContext(Device);
+    WdfSpinLockAcquire(ctx->SubmitLock);
+    GcWatchdogStop(&ctx->Watchdog);
+    WdfSpinLockRelease(ctx->SubmitLock);
+    WdfTimerStop(ctx->WatchdogTimer, TRUE);
+    return STATUS_SUCCESS;
+}
+
 static VOID ClampShort(SHORT* v)
 {
     if (*v < -32768) *v = -32768;
     if (*v >  32767) *v =  32767;
 }
 
-static VOID VPadSendInputReport(PFUNC_CONTEXT ctx, PVPAD_STATE state)
+static NTSTATUS VPadSendInputReport(PFUNC_CONTEXT ctx, PVPAD_STATE state)
 {
     UCHAR report[2 + 2 + 8] = {0};
     report[0] = (UCHAR)(state->Buttons & 0xFF);
@@ -123,8 +199,9 @@ static VOID VPadSendInputReport(PFUNC_CONTEXT ctx, PVPAD_STATE state)
 
     HID_XFER_PACKET pkt; pkt.reportBuffer = report; pkt.reportBufferLen = (ULONG)sizeof(report); pkt.reportId = 0;
 
-    VhfReadReportSubmit(ctx->VhfHandle, &pkt);
+    NTSTATUS status = VhfReadReportSubmit(ctx->VhfHandle, &pkt);
     ctx->LastState = *state;
+    return status;
 }
 
 VOID VPadFuncEvtIoDeviceControl(WDFQUEUE Queue, WDFREQUEST Request,
@@ -156,19 +233,110 @@ VOID VPadFuncEvtIoDeviceControl(WDFQUEUE Queue, WDFREQUEST Request,
         WdfRequestSetInformation(Request, 0); break;
     case IOCTL_VPAD_DESTROY:
     {
+        // Ordered against SET_STATE and the timer like any submit. A clean
+        // release is not a stale client: the watchdog goes idle with it.
         VPAD_STATE zero = {0};
+        WdfSpinLockAcquire(ctx->SubmitLock);
         VPadSendInputReport(ctx, &zero);
+        GcWatchdogStop(&ctx->Watchdog);
+        WdfSpinLockRelease(ctx->SubmitLock);
+        WdfTimerStop(ctx->WatchdogTimer, FALSE);
         WdfRequestSetInformation(Request, 0);
         break;
     }
     case IOCTL_VPAD_SET_STATE:
     {
         PVPAD_STATE st = NULL; size_t len = 0;
+        uint64_t t0 = VPadNowNs();
+        GcAtomicMaxU64(&ctx->PeakInFlight, GcAtomicAddU64(&ctx->InFlight, 1) + 1);
         status = WdfRequestRetrieveInputBuffer(Request, sizeof(VPAD_STATE), (PVOID*)&st, &len);
         if (NT_SUCCESS(status))
         {
             ClampShort(&st->LX); ClampShort(&st->LY); ClampShort(&st->RX); ClampShort(&st->RY);
-            VPadSendInputReport(ctx, st);
+            uint64_t armNs = 0;
+            WdfSpinLockAcquire(ctx->SubmitLock);
+            NTSTATUS submit = VPadSendInputReport(ctx, st);
+            if (GcWatchdogFeed(&ctx->Watchdog, t0)) armNs = ctx->Watchdog.TimeoutNs;
+            WdfSpinLockRelease(ctx->SubmitLock);
+            if (armNs) VPadStartWatchdogTimer(ctx, armNs);
+            if (NT_SUCCESS(submit)) GcAtomicAddU64(&ctx->Submitted, 1);
+            else GcAtomicAddU64(&ctx->Rejected, 1);
+            if (len >= sizeof(VPAD_STATE_TRACED))
+            {
+                PVPAD_TRACE vt = &((PVPAD_STATE_TRACED)st)->Trace;
+                GC_TRACE t;
+                t.Sequence = vt->Sequence; t.LastOffsetNs = vt->LastOffsetNs; t.OriginNs = vt->OriginNs;
+                GcTraceStampInto(&ctx->SubmitTotal, &ctx->SubmitStage, &t, VPadNowNs());
+            }
+            WdfRequestSetInformation(Request, 0);
+        }
+        GcAtomicStoreU64(&ctx->LastSubmitNs, VPadNowNs() - t0);
+        GcAtomicAddU64(&ctx->InFlight, (uint64_t)-1);
+        break;
+    }
+    case IOCTL_VPAD_GET_LATENCY:
+    {
+        PVPAD_LATENCY out = NULL; size_t len = 0;
+        status = WdfRequestRetrieveOutputBuffer(Request, sizeof(VPAD_LATENCY), (PVOID*)&out, &len);
+        if (NT_SUCCESS(status))
+        {
+            out->Count = ctx->SubmitTotal.Count;
+            out->TotalP50Ns = Clamp32(GcLatencyPercentile(&ctx->SubmitTotal, 5000));
+            out->TotalP99Ns = Clamp32(GcLatencyPercentile(&ctx->SubmitTotal, 9900));
+            out->TotalMaxNs = Clamp32(ctx->SubmitTotal.MaxNs);
+            out->StageP50Ns = Clamp32(GcLatencyPercentile(&ctx->SubmitStage, 5000));
+            out->StageP99Ns = Clamp32(GcLatencyPercentile(&ctx->SubmitStage, 9900));
+            out->StageMaxNs = Clamp32(ctx->SubmitStage.MaxNs);
+            WdfRequestSetInformation(Request, sizeof(VPAD_LATENCY));
+        }
+        break;
+    }
+    case IOCTL_VPAD_GET_PRESSURE:
+    {
+        PVPAD_PRESSURE out = NULL; size_t len = 0;
+        status = WdfRequestRetrieveOutputBuffer(Request, sizeof(VPAD_PRESSURE), (PVOID*)&out, &len);
+        if (NT_SUCCESS(status))
+        {
+            uint64_t inFlight = GcAtomicLoadU64(&ctx->InFlight);
+            out->Submitted = GcAtomicLoadU64(&ctx->Submitted);
+            out->InFlight = Clamp32(inFlight);
+            out->PeakInFlight = Clamp32(GcAtomicLoadU64(&ctx->PeakInFlight));
+            out->Rejected = Clamp32(GcAtomicLoadU64(&ctx->Rejected));
+            out->LastSubmitNs = Clamp32(GcAtomicLoadU64(&ctx->LastSubmitNs));
+            GcAtomicStoreU64(&ctx->PeakInFlight, inFlight);
+            WdfRequestSetInformation(Request, sizeof(VPAD_PRESSURE));
+        }
+        break;
+    }
+    case IOCTL_VPAD_GET_WATCHDOG:
+    {
+        PVPAD_WATCHDOG out = NULL; size_t len = 0;
+        status = WdfRequestRetrieveOutputBuffer(Request, sizeof(VPAD_WATCHDOG), (PVOID*)&out, &len);
+        if (NT_SUCCESS(status))
+        {
+            uint64_t now = VPadNowNs();
+            WdfSpinLockAcquire(ctx->SubmitLock);
+            out->TimeoutMs = Clamp32(ctx->Watchdog.TimeoutNs / 1000000);
+            out->Stale = (uint32_t)GcWatchdogStale(&ctx->Watchdog);
+            out->Expirations = ctx->Watchdog.Expirations;
+            out->Recoveries = ctx->Watchdog.Recoveries;
+            out->StaleForNs = out->Stale && now > ctx->Watchdog.StaleSinceNs ? now - ctx->Watchdog.StaleSinceNs : 0;
+            WdfSpinLockRelease(ctx->SubmitLock);
+            WdfRequestSetInformation(Request, sizeof(VPAD_WATCHDOG));
+        }
+        break;
+    }
+    case IOCTL_VPAD_SET_WATCHDOG:
+    {
+        uint32_t* timeoutMs = NULL; size_t len = 0;
+        status = WdfRequestRetrieveInputBuffer(Request, sizeof(uint32_t), (PVOID*)&timeoutMs, &len);
+        if (NT_SUCCESS(status))
+        {
+            uint64_t timeoutNs = (uint64_t)*timeoutMs * 1000000;
+            WdfSpinLockAcquire(ctx->SubmitLock);
+            int arm = GcWatchdogSetTimeout(&ctx->Watchdog, timeoutNs, VPadNowNs());
+            WdfSpinLockRelease(ctx->SubmitLock);
+            if (arm) VPadStartWatchdogTimer(ctx, timeoutNs);
             WdfRequestSetInformation(Request, 0);
         }
         break;
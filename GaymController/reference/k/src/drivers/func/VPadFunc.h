@@ -70,6 +70,7 @@ typedef void* WDFREQUEST;
 typedef struct _WDF_OBJECT_ATTRIBUTES {
     size_t Size;
     size_t ContextSize;
+    void*  ParentObject;
 } WDF_OBJECT_ATTRIBUTES, *PWDF_OBJECT_ATTRIBUTES;
 
 #define WDF_NO_OBJECT_ATTRIBUTES 0
@@ -125,6 +126,35 @@ typedef struct _WDF_CHILD_IDENTIFICATION_DESCRIPTION_HEADER {
 
 #define WDF_CHILD_IDENTIFICATION_DESCRIPTION_HEADER_INIT(p, s) do { (p)->Size=(ULONG)(s); } while(0)
 
+// Timer and spin lock stubs
+typedef void* WDFTIMER;
+typedef void* WDFSPINLOCK;
+typedef void* WDFOBJECT;
+
+typedef struct _WDF_TIMER_CONFIG {
+    VOID (*EvtTimerFunc)(WDFTIMER);
+    ULONG Period;
+    BOOLEAN AutomaticSerialization;
+} WDF_TIMER_CONFIG, *PWDF_TIMER_CONFIG;
+
+#define WDF_TIMER_CONFIG_INIT(c, f) do { (c)->EvtTimerFunc = (f); (c)->Period = 0; (c)->AutomaticSerialization = TRUE; } while(0)
+#define WDF_OBJECT_ATTRIBUTES_INIT(a) do { (a)->Size = sizeof(*(a)); (a)->ContextSize = 0; (a)->ParentObject = NULL; } while(0)
+#define WdfTimerCreate(c, a, t) ((*(t) = (WDFTIMER)0x1), STATUS_SUCCESS)
+#define WdfTimerStart(t, due) ((void)(due))
+#define WdfTimerStop(t, wait) TRUE
+#define WdfTimerGetParentObject(t) (WDFOBJECT)0
+// PnP/power stubs
+typedef int WDF_POWER_DEVICE_STATE;
+typedef struct _WDF_PNPPOWER_EVENT_CALLBACKS {
+    ULONG Size;
+    NTSTATUS (*EvtDeviceD0Exit)(WDFDEVICE, WDF_POWER_DEVICE_STATE);
+} WDF_PNPPOWER_EVENT_CALLBACKS, *PWDF_PNPPOWER_EVENT_CALLBACKS;
+#define WDF_PNPPOWER_EVENT_CALLBACKS_INIT(c) do { (c)->Size = sizeof(*(c)); (c)->EvtDeviceD0Exit = NULL; } while(0)
+#define WdfDeviceInitSetPnpPowerEventCallbacks(d, c) (void)0
+#define WdfSpinLockCreate(a, l) ((*(l) = (WDFSPINLOCK)0x1), STATUS_SUCCESS)
+#define WdfSpinLockAcquire(l) (void)0
+#define WdfSpinLockRelease(l) (void)0
+
 // Simple interlocked increment stub
 #define InterlockedIncrement(p) (++(*p))
 
@@ -177,7 +207,7 @@ static inline void RtlAppendUnicodeToString(PUNICODE_STRING dest, PCWSTR src) {
 #define WdfDeviceWdmGetDeviceObject(d) (PVOID)0x1
 #define VhfCreate(c, h) ((*(h) = (PVOID)0x1), STATUS_SUCCESS)
 #define VhfStart(h) (void)0
-#define VhfReadReportSubmit(h, p) (void)0
+#define VhfReadReportSubmit(h, p) STATUS_SUCCESS
 #define WdfRequestRetrieveOutputBuffer(r, s, p, l) STATUS_INVALID_DEVICE_REQUEST
 #define WdfRequestSetInformation(r, i) (void)0
 #define WdfRequestRetrieveInputBuffer(r, s, p, l) STATUS_INVALID_DEVICE_REQUEST
@@ -199,6 +229,9 @@ static inline void RtlAppendUnicodeToString(PUNICODE_STRING dest, PCWSTR src) {
 #endif
 #include "VPadShared.h"
 #include "HidDescriptor.h"
+#include "gc/Atomic.h"
+#include "gc/LatencyProbe.h"
+#include "gc/Watchdog.h"
 
 // Removed WDK function variable declarations for non-WDK build.
 
@@ -212,6 +245,16 @@ typedef struct _FUNC_CONTEXT
     UCHAR      RumbleLeft;
     UCHAR      RumbleRight;
     UCHAR      LedR, LedG, LedB;
+    GC_LATENCY_HISTOGRAM SubmitTotal;   // origin -> VhfReadReportSubmit
+    GC_LATENCY_HISTOGRAM SubmitStage;   // previous hop -> VhfReadReportSubmit
+    volatile uint64_t Submitted;        // IOCTL_VPAD_GET_PRESSURE counters
+    volatile uint64_t InFlight;
+    volatile uint64_t PeakInFlight;
+    volatile uint64_t Rejected;
+    volatile uint64_t LastSubmitNs;
+    GC_WATCHDOG Watchdog;               // safe mode, under SubmitLock
+    WDFTIMER    WatchdogTimer;
+    WDFSPINLOCK SubmitLock;             // orders SET_STATE and watchdog submits
 } FUNC_CONTEXT, *PFUNC_CONTEXT;
 
 WDF_DECLARE_CONTEXT_TYPE_WITH_NAME(FUNC_CONTEXT, VPadFuncGetContext);
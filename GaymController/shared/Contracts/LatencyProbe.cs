@@ -0,0 +1,102 @@
+using System;
+using System.Numerics;
+using System.Threading;
+
+namespace GaymController.Shared.Contracts {
+    /// <summary>Hops of a <see cref="LatencyTrace"/> (native/include/gc/LatencyProbe.h GC_HOP).</summary>
+    public enum LatencyHop { HidRead=0, GraphOut, WireTx, BrokerRx, DriverSubmit, Count }
+
+    /// <summary>
+    /// Log-linear latency histogram, bucket for bucket the same as
+    /// GC_LATENCY_HISTOGRAM: exact below 16 ns, then 16 buckets per power of
+    /// two up to 2^37 ns. Recording is lock-free and allocation-free.
+    /// </summary>
+    public sealed class LatencyHistogram {
+        public const int SubBits=4, Sub=1<<SubBits, MaxBit=36;
+        public const int Buckets=(MaxBit-SubBits+2)*Sub;
+        private const ulong Saturate=(1UL<<(MaxBit+1))-1;
+
+        private readonly long[] _buckets=new long[Buckets];
+        private long _count, _sum, _max;
+
+        public long Count=>Volatile.Read(ref _count);
+        public ulong MaxNs=>(ulong)Volatile.Read(ref _max);
+        public ulong MeanNs { get { var n=Count; return n==0 ? 0 : (ulong)Volatile.Read(ref _sum)/(ulong)n; } }
+
+        public static int BucketOf(ulong ns){
+            if(ns>Saturate) ns=Saturate;
+            if(ns<Sub) return (int)ns;
+            int shift=BitOperations.Log2(ns)-SubBits;
+            return shift*Sub+(int)(ns>>shift);
+        }
+        public static ulong BucketUpper(int bucket){
+            if(bucket<Sub) return (ulong)bucket;
+            int shift=bucket/Sub-1;
+            ulong m=(ulong)(bucket%Sub+Sub);
+            return ((m+1)<<shift)-1;
+        }
+
+        public void Record(ulong ns){
+            long v=(long)Math.Min(ns, Saturate), cur;
+            Interlocked.Increment(ref _buckets[BucketOf(ns)]);
+            Interlocked.Add(ref _sum, v);
+            while(v>(cur=Volatile.Read(ref _max)) && Interlocked.CompareExchange(ref _max, v, cur)!=cur) {}
+            Interlocked.Increment(ref _count);
+        }
+
+        /// <summary>Value at <paramref name="perTenThousand"/> (5000 = p50), as its bucket's upper edge capped at MaxNs.</summary>
+        public ulong Percentile(uint perTenThousand){
+            var count=(ulong)Count;
+            if(count==0) return 0;
+            if(perTenThousand>10000) perTenThousand=10000;
+            var rank=Math.Max(1UL, (count*perTenThousand+9999)/10000);
+            ulong seen=0, max=MaxNs;
+            for(int i=0;i<Buckets;i++){
+                seen+=(ulong)Volatile.Read(ref _buckets[i]);
+                if(seen>=rank) return Math.Min(BucketUpper(i), max);
+            }
+            return max;
+        }
+
+        public void Reset(){
+            for(int i=0;i<Buckets;i++) Volatile.Write(ref _buckets[i], 0);
+            Volatile.Write(ref _count, 0); Volatile.Write(ref _sum, 0); Volatile.Write(ref _max, 0);
+        }
+    }
+
+    /// <summary>
+    /// Per-hop Total (now - origin) and Stage (now - previous hop)
+    /// histograms for the user-mode hops, as GC_LATENCY_PROBE keeps them for
+    /// native ones. One probe is shared by the HID reader, the mapping output
+    /// and the SET_STATE sender of a process.
+    /// </summary>
+    public sealed class LatencyProbe {
+        private readonly LatencyHistogram[] _total=new LatencyHistogram[(int)LatencyHop.Count];
+        private readonly LatencyHistogram[] _stage=new LatencyHistogram[(int)LatencyHop.Count];
+        private int _next=-1;
+
+        public LatencyProbe(){
+            for(int i=0;i<_total.Length;i++){ _total[i]=new LatencyHistogram(); _stage[i]=new LatencyHistogram(); }
+        }
+
+        public LatencyHistogram Total(LatencyHop hop)=>_total[(int)hop];
+        public LatencyHistogram Stage(LatencyHop hop)=>_stage[(int)hop];
+
+        /// <summary>Starts a trace at <paramref name="originNs"/> (see <see cref="LatencyTrace.NowNs"/>).</summary>
+        public LatencyTrace Begin(ulong originNs)=>new((uint)Interlocked.Increment(ref _next), originNs);
+
+        /// <summary>Records <paramref name="hop"/> and returns the trace moved past it.</summary>
+        public LatencyTrace Stamp(LatencyHop hop, in LatencyTrace trace, ulong nowNs){
+            var since=nowNs>trace.OriginNs ? nowNs-trace.OriginNs : 0UL;
+            var step=since>trace.LastOffsetNs ? since-trace.LastOffsetNs : 0UL;
+            if((uint)hop<(uint)LatencyHop.Count){ _total[(int)hop].Record(since); _stage[(int)hop].Record(step); }
+            return trace.Stamp(nowNs);
+        }
+        public LatencyTrace Stamp(LatencyHop hop, in LatencyTrace trace)=>Stamp(hop, trace, LatencyTrace.NowNs());
+
+        public void Reset(){
+            for(int i=0;i<_total.Length;i++){ _total[i].Reset(); _stage[i].Reset(); }
+            Volatile.Write(ref _next, -1);
+        }
+    }
+}
@@ -0,0 +1,31 @@
+using System.Diagnostics;
+using System.Runtime.InteropServices;
+
+namespace GaymController.Shared.Contracts {
+    /// <summary>
+    /// Origin stamp carried from the raw HID read to the func driver
+    /// (native/include/gc/LatencyProbe.h GC_TRACE, VPAD_TRACE). Times are
+    /// Stopwatch/QPC ticks converted to nanoseconds so user and kernel agree.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential, Pack=1)]
+    public readonly struct LatencyTrace {
+        public const int Bytes=16;
+        public readonly uint Sequence;
+        public readonly uint LastOffsetNs;
+        public readonly ulong OriginNs;
+        public LatencyTrace(uint sequence, ulong originNs, uint lastOffsetNs=0){ Sequence=sequence; OriginNs=originNs; LastOffsetNs=lastOffsetNs; }
+
+        public static ulong NowNs(){
+            var t=(ulong)Stopwatch.GetTimestamp(); var f=(ulong)Stopwatch.Frequency;
+            return t/f*1_000_000_000UL + t%f*1_000_000_000UL/f;
+        }
+        /// <summary>Builds a trace from an <see cref="Mapping.InputEvent"/> timestamp.</summary>
+        public static LatencyTrace FromTimestampUs(uint sequence, long timestampUs)=>new(sequence, (ulong)timestampUs*1000UL);
+
+        /// <summary>Marks a hop: returns the trace with LastOffsetNs moved to <paramref name="nowNs"/>.</summary>
+        public LatencyTrace Stamp(ulong nowNs){
+            var since = nowNs>OriginNs ? nowNs-OriginNs : 0UL;
+            return new LatencyTrace(Sequence, OriginNs, since>uint.MaxValue ? uint.MaxValue : (uint)since);
+        }
+    }
+}
@@ -0,0 +1,219 @@
+using System;
+using System.IO;
+using System.IO.MemoryMappedFiles;
+using System.Runtime.InteropServices;
+using System.Threading;
+
+namespace GaymController.Shared.Contracts {
+    /// <summary>
+    /// Snapshot copied out of a pad's live state page
+    /// (native/include/gc/PadMirror.h GC_MIRROR_SNAPSHOT, 64 bytes LE).
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential, Pack=1)]
+    public struct PadMirrorSnapshot {
+        public ushort Buttons;
+        public byte LeftTrigger, RightTrigger;
+        public short LX, LY, RX, RY;
+        public byte RumbleLeft, RumbleRight;
+        public byte LedR, LedG, LedB;
+        public byte Connected;
+        public ushort Reserved0;
+        public uint RumbleSequence;
+        public ulong UpdatedNs;
+        public ulong Reports;
+        public uint RateHz, TargetRateHz;
+        /// <summary>Origin→broker receive of traced reports over the last second (not the driver submit hop).</summary>
+        public uint LatencyP50Ns, LatencyP99Ns, LatencyMaxNs;
+        public uint Reserved1;
+    }
+
+    /// <summary>
+    /// Read-only view of the broker's per-pad state page for HUDs and
+    /// visualizers. Polling <see cref="TryRead"/> copies the snapshot under
+    /// the page's seqlock: no IPC, no locks, no effect on the writer.
+    /// </summary>
+    public sealed class PadMirrorReader : IDisposable {
+        public const uint Magic=0x524D4347; // "GCMR"
+        public const uint Version=1;
+        public const int MapBytes=4096;
+        public const int SequenceOffset=64;
+        public const int SnapshotOffset=72;
+        public const int SnapshotBytes=64;
+
+        private readonly MemoryMappedFile? _file;
+        private readonly MemoryMappedViewAccessor _view;
+
+        public uint Slot { get; }
+        public uint WriterPid { get; }
+
+        /// <summary>
+        /// Global on Windows: the writer is the broker service in session 0,
+        /// readers run in the desktop session (native gc::mirror::PageName).
+        /// </summary>
+        public static string PageName(uint slot)=>
+            OperatingSystem.IsWindows() ? $"Global\\GaymController.Pad{slot}" : $"/GaymController.Pad{slot}";
+
+        /// <summary>Maps the page the broker created for <paramref name="slot"/>.</summary>
+        /// <exception cref="FileNotFoundException">No broker has published the pad.</exception>
+        /// <exception cref="InvalidDataException">The page has an unknown layout.</exception>
+        public static PadMirrorReader Open(uint slot){
+            MemoryMappedFile file;
+            if (OperatingSystem.IsWindows()) {
+                file=MemoryMappedFile.OpenExisting(PageName(slot), MemoryMappedFileRights.Read);
+            } else {
+                file=MemoryMappedFile.CreateFromFile("/dev/shm"+PageName(slot), FileMode.Open, null, 0, MemoryMappedFileAccess.Read);
+            }
+            try { return new PadMirrorReader(file, file.CreateViewAccessor(0, MapBytes, MemoryMappedFileAccess.Read)); }
+            catch { file.Dispose(); throw; }
+        }
+
+        /// <summary>Wraps an existing view (tests, custom transports); the reader owns it.</summary>
+        public PadMirrorReader(MemoryMappedViewAccessor view) : this(null, view) {}
+
+        private PadMirrorReader(MemoryMappedFile? file, MemoryMappedViewAccessor view){
+            _file=file; _view=view;
+            if (view.Capacity<SnapshotOffset+SnapshotBytes || view.ReadUInt32(0)!=Magic ||
+                view.ReadUInt32(4)!=Version || view.ReadUInt32(8)!=SnapshotBytes) {
+                view.Dispose();
+                throw new InvalidDataException("not a GaymController pad mirror page");
+            }
+            Slot=view.ReadUInt32(12);
+            WriterPid=view.ReadUInt32(16);
+        }
+
+        /// <summary>Publishes seen so far; skip redraws while it is unchanged.</summary>
+        public uint Publishes { get { Interlocked.MemoryBarrier(); return _view.ReadUInt32(SequenceOffset)/2; } }
+
+        /// <summary>
+        /// Copies a consistent snapshot; false if every attempt overlapped a
+        /// publish (or the writer died mid-publish).
+        /// </summary>
+        public bool TryRead(out PadMirrorSnapshot snapshot, int maxAttempts=64){
+            for (int i=0;i<maxAttempts;i++) {
+                var before=_view.ReadUInt32(SequenceOffset);
+                if ((before&1)!=0) { Thread.SpinWait(1); continue; }
+                Interlocked.MemoryBarrier();
+                _view.Read(SnapshotOffset, out snapshot);
+                Interlocked.MemoryBarrier();
+                if (_view.ReadUInt32(SequenceOffset)==before) return true;
+            }
+            snapshot=default;
+            return false;
+        }
+
+        public void Dispose(){ _view.Dispose(); _file?.Dispose(); }
+    }
+
+    /// <summary>
+    /// The broker's side of a pad's state page: same layout and seqlock as
+    /// native GcMirrorInit/GcMirrorPublish (gc/PadMirror.h), so C++ and C#
+    /// readers see one format. Single writer per page.
+    /// </summary>
+    public sealed class PadMirrorWriter : IDisposable {
+        /// <summary>
+        /// DACL of the Windows page (native gc::mirror::kPageSddl): full access
+        /// for SYSTEM and administrators, read-only for interactive users, so
+        /// a desktop-session reader can map what the service writes.
+        /// </summary>
+        public const string PageSddl="D:P(A;;GA;;;SY)(A;;GA;;;BA)(A;;GR;;;IU)";
+        private const int CreatedNsOffset=24;
+        private readonly MemoryMappedFile? _file;
+        private readonly MemoryMappedViewAccessor _view;
+        private uint _sequence;
+
+        public uint Slot { get; }
+
+        /// <summary>Creates the page for <paramref name="slot"/>, or takes over one left by an earlier broker.</summary>
+        public static PadMirrorWriter CreateOrOpen(uint slot){
+            MemoryMappedFile file;
+            if (OperatingSystem.IsWindows()) {
+                // CreateOrOpen takes no security descriptor on .NET 8: create
+                // the section with PageSddl here, then open it by name.
+                var name=PadMirrorReader.PageName(slot);
+                var section=CreateSecuredSection(name);
+                try { file=MemoryMappedFile.OpenExisting(name, MemoryMappedFileRights.ReadWrite); }
+                finally { CloseHandle(section); }
+            } else {
+                var fs=new FileStream("/dev/shm"+PadMirrorReader.PageName(slot), FileMode.OpenOrCreate, FileAccess.ReadWrite, FileShare.ReadWrite);
+                try {
+                    if (fs.Length<PadMirrorReader.MapBytes) fs.SetLength(PadMirrorReader.MapBytes);
+                    file=MemoryMappedFile.CreateFromFile(fs, null, PadMirrorReader.MapBytes, MemoryMappedFileAccess.ReadWrite,
+                        HandleInheritability.None, leaveOpen: false);
+                }
+                catch { fs.Dispose(); throw; }
+            }
+            try { return new PadMirrorWriter(file, file.CreateViewAccessor(0, PadMirrorReader.MapBytes), slot); }
+            catch { file.Dispose(); throw; }
+        }
+
+        private static IntPtr CreateSecuredSection(string name){
+            if (!ConvertStringSecurityDescriptorToSecurityDescriptorW(PageSddl, SddlRevision1, out var sd, IntPtr.Zero))
+                throw new IOException($"bad page SDDL (error {Marshal.GetLastPInvokeError()})");
+            try {
+                var sa=new SECURITY_ATTRIBUTES { nLength=Marshal.SizeOf<SECURITY_ATTRIBUTES>(), lpSecurityDescriptor=sd };
+                var h=CreateFileMappingW(new IntPtr(-1), ref sa, PageReadWrite, 0, PadMirrorReader.MapBytes, name);
+                int err=Marshal.GetLastPInvokeError();
+                if (h==IntPtr.Zero) {
+                    if (err==ErrorAccessDenied) throw new UnauthorizedAccessException($"cannot create {name}");
+                    throw new IOException($"cannot create {name} (error {err})");
+                }
+                return h;
+            }
+            finally { LocalFree(sd); }
+        }
+
+        /// <summary>Removes the page name so new readers fail (POSIX; a Windows mapping goes with its last handle).</summary>
+        public static void Unlink(uint slot){
+            if (!OperatingSystem.IsWindows()) File.Delete("/dev/shm"+PadMirrorReader.PageName(slot));
+        }
+
+        /// <summary>Initialises an existing writable view (tests, custom transports); the writer owns it.</summary>
+        public PadMirrorWriter(MemoryMappedViewAccessor view, uint slot) : this(null, view, slot) {}
+
+        private PadMirrorWriter(MemoryMappedFile? file, MemoryMappedViewAccessor view, uint slot){
+            if (view.Capacity<PadMirrorReader.SnapshotOffset+PadMirrorReader.SnapshotBytes) {
+                view.Dispose();
+                throw new ArgumentException("view is smaller than a pad mirror page", nameof(view));
+            }
+            _file=file; _view=view; Slot=slot;
+            view.Write(0, 0u); // invalid until the header is complete
+            Interlocked.MemoryBarrier();
+            for (int o=4;o<PadMirrorReader.SnapshotOffset+PadMirrorReader.SnapshotBytes;o+=4) view.Write(o, 0u);
+            view.Write(4, PadMirrorReader.Version);
+            view.Write(8, (uint)PadMirrorReader.SnapshotBytes);
+            view.Write(12, slot);
+            view.Write(16, (uint)Environment.ProcessId);
+            view.Write(CreatedNsOffset, LatencyTrace.NowNs());
+            Interlocked.MemoryBarrier();
+            view.Write(0, PadMirrorReader.Magic); // magic last, as GcMirrorInit
+        }
+
+        public uint Publishes=>_sequence/2;
+
+        public void Publish(in PadMirrorSnapshot snapshot){
+            var s=snapshot;
+            _view.Write(PadMirrorReader.SequenceOffset, ++_sequence); // odd: publish in progress
+            Interlocked.MemoryBarrier();
+            _view.Write(PadMirrorReader.SnapshotOffset, ref s);
+            Interlocked.MemoryBarrier();
+            _view.Write(PadMirrorReader.SequenceOffset, ++_sequence);
+        }
+
+        public void Dispose(){ _view.Dispose(); _file?.Dispose(); }
+
+        private const uint SddlRevision1=1, PageReadWrite=0x04;
+        private const int ErrorAccessDenied=5;
+
+        [StructLayout(LayoutKind.Sequential)]
+        private struct SECURITY_ATTRIBUTES { public int nLength; public IntPtr lpSecurityDescriptor; public int bInheritHandle; }
+
+        [DllImport("advapi32.dll", CharSet=CharSet.Unicode, SetLastError=true)]
+        private static extern bool ConvertStringSecurityDescriptorToSecurityDescriptorW(string sddl, uint revision, out IntPtr sd, IntPtr size);
+        [DllImport("kernel32.dll", CharSet=CharSet.Unicode, SetLastError=true)]
+        private static extern IntPtr CreateFileMappingW(IntPtr file, ref SECURITY_ATTRIBUTES sa, uint protect, uint sizeHigh, uint sizeLow, string name);
+        [DllImport("kernel32.dll", SetLastError=true)]
+        private static extern bool CloseHandle(IntPtr handle);
+        [DllImport("kernel32.dll")]
+        private static extern IntPtr LocalFree(IntPtr mem);
+    }
+}
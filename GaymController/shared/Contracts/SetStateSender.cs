@@ -0,0 +1,54 @@
+using System;
+using System.Buffers.Binary;
+using System.IO;
+
+namespace GaymController.Shared.Contracts {
+    /// <summary>
+    /// App side of SET_STATE for one opened controller: packs the mapping
+    /// output with the latency trace of the input that produced it, writes it
+    /// to the broker and waits for the reply. The trace is stamped at
+    /// <see cref="LatencyHop.GraphOut"/> when the state is handed over and at
+    /// <see cref="LatencyHop.WireTx"/> as the frame goes out. Not thread-safe:
+    /// send from the output thread only.
+    /// </summary>
+    public sealed class SetStateSender {
+        private readonly Stream _pipe;
+        private readonly LatencyProbe _probe;
+        private readonly byte[] _frame=new byte[Wire.HeaderBytes+24+LatencyTrace.Bytes];
+        private readonly byte[] _reply=new byte[Wire.HeaderBytes+8];
+
+        public SetStateSender(Stream pipe, ulong handle, LatencyProbe probe){ _pipe=pipe; Handle=handle; _probe=probe; }
+
+        public ulong Handle { get; }
+
+        /// <summary>
+        /// Sends <paramref name="state"/>; an untraced (default) trace sends
+        /// the plain 24-byte frame. True on ACK, false on an ERROR reply.
+        /// </summary>
+        /// <exception cref="EndOfStreamException">The broker closed the pipe.</exception>
+        /// <exception cref="InvalidDataException">The reply is not ACK or ERROR.</exception>
+        public bool Send(in GamepadState state, in LatencyTrace trace){
+            int n;
+            if(trace.OriginNs!=0){
+                var t=_probe.Stamp(LatencyHop.GraphOut, trace);
+                t=_probe.Stamp(LatencyHop.WireTx, t);
+                n=Wire.PackSetState(_frame, Handle, state, t);
+            } else {
+                n=Wire.PackSetState(_frame, Handle, state);
+            }
+            _pipe.Write(_frame, 0, n);
+            _pipe.Flush();
+
+            _pipe.ReadExactly(_reply, 0, Wire.HeaderBytes);
+            var len=BinaryPrimitives.ReadUInt32LittleEndian(_reply);
+            var type=(MsgType)BinaryPrimitives.ReadUInt16LittleEndian(_reply.AsSpan(4));
+            if(len<Wire.HeaderBytes || len>_reply.Length) throw new InvalidDataException($"bad reply length {len}");
+            _pipe.ReadExactly(_reply, Wire.HeaderBytes, (int)len-Wire.HeaderBytes);
+            return type switch {
+                MsgType.ACK=>true,
+                MsgType.ERROR=>false,
+                _=>throw new InvalidDataException($"unexpected reply {type}")
+            };
+        }
+    }
+}
@@ -10,6 +10,7 @@ namespace GaymController.Shared.Contracts {
     }
     public static class Wire {
         public const int HeaderBytes=8; // u32 len, u16 type, u16 flags
+        public const ushort FlagTrace=0x0001; // SET_STATE: LatencyTrace follows the state
         public static byte[] Rent(int size)=>ArrayPool<byte>.Shared.Rent(size);
         public static void Return(byte[] buf)=>ArrayPool<byte>.Shared.Return(buf);
         public static void WriteHeader(Span<byte> dst,uint len,ushort type,ushort flags=0){
@@ -17,6 +18,11 @@ namespace GaymController.Shared.Contracts {
             BinaryPrimitives.WriteUInt16LittleEndian(dst.Slice(4),type);
             BinaryPrimitives.WriteUInt16LittleEndian(dst.Slice(6),flags);
         }
+        public static void ReadHeader(ReadOnlySpan<byte> src,out uint len,out MsgType type,out ushort flags){
+            len=BinaryPrimitives.ReadUInt32LittleEndian(src);
+            type=(MsgType)BinaryPrimitives.ReadUInt16LittleEndian(src.Slice(4));
+            flags=BinaryPrimitives.ReadUInt16LittleEndian(src.Slice(6));
+        }
         public static int PackHello(Span<byte> dst){
             const int len=HeaderBytes+4; WriteHeader(dst,len,(ushort)MsgType.HELLO);
             BinaryPrimitives.WriteUInt32LittleEndian(dst.Slice(HeaderBytes),1);
@@ -50,6 +56,40 @@ namespace GaymController.Shared.Contracts {
             BinaryPrimitives.WriteUInt32LittleEndian(dst.Slice(o),state.Buttons);
             return len;
         }
+        public static int PackSetState(Span<byte> dst,ulong handle,GamepadState state,in LatencyTrace trace){
+            const int len=HeaderBytes+24+LatencyTrace.Bytes;
+            PackSetState(dst,handle,state);
+            WriteHeader(dst,len,(ushort)MsgType.SET_STATE,FlagTrace);
+            var o=HeaderBytes+24;
+            BinaryPrimitives.WriteUInt32LittleEndian(dst.Slice(o),trace.Sequence); o+=4;
+            BinaryPrimitives.WriteUInt32LittleEndian(dst.Slice(o),trace.LastOffsetNs); o+=4;
+            BinaryPrimitives.WriteUInt64LittleEndian(dst.Slice(o),trace.OriginNs);
+            return len;
+        }
+        /// <summary>Decodes a SET_STATE payload (either form); false if it is short.</summary>
+        public static bool TryReadSetState(ReadOnlySpan<byte> payload,out ulong handle,out GamepadState state){
+            handle=0; state=default;
+            if(payload.Length<24) return false;
+            handle=BinaryPrimitives.ReadUInt64LittleEndian(payload);
+            state.LX=BinaryPrimitives.ReadUInt16LittleEndian(payload.Slice(8));
+            state.LY=BinaryPrimitives.ReadUInt16LittleEndian(payload.Slice(10));
+            state.RX=BinaryPrimitives.ReadUInt16LittleEndian(payload.Slice(12));
+            state.RY=BinaryPrimitives.ReadUInt16LittleEndian(payload.Slice(14));
+            state.LT=BinaryPrimitives.ReadUInt16LittleEndian(payload.Slice(16));
+            state.RT=BinaryPrimitives.ReadUInt16LittleEndian(payload.Slice(18));
+            state.Buttons=BinaryPrimitives.ReadUInt32LittleEndian(payload.Slice(20));
+            return true;
+        }
+        /// <summary>Reads the trace of a SET_STATE payload sent with <see cref="FlagTrace"/>.</summary>
+        public static bool TryReadTrace(ReadOnlySpan<byte> payload,ushort flags,out LatencyTrace trace){
+            trace=default;
+            if((flags&FlagTrace)==0 || payload.Length<24+LatencyTrace.Bytes) return false;
+            var t=payload.Slice(24);
+            trace=new LatencyTrace(BinaryPrimitives.ReadUInt32LittleEndian(t),
+                BinaryPrimitives.ReadUInt64LittleEndian(t.Slice(8)),
+                BinaryPrimitives.ReadUInt32LittleEndian(t.Slice(4)));
+            return true;
+        }
         public static int PackAck(Span<byte> dst,uint echoType){
             const int len=HeaderBytes+4; WriteHeader(dst,len,(ushort)MsgType.ACK);
             BinaryPrimitives.WriteUInt32LittleEndian(dst.Slice(HeaderBytes),echoType);
@@ -0,0 +1,42 @@
+using System;
+using System.IO;
+using System.IO.Pipes;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace GaymController.Broker {
+    /// <summary>
+    /// Byte stream the broker speaks wire frames over. A pending
+    /// <see cref="AcceptAsync"/> is one armed listener: it can take a client
+    /// from the moment it is called until it returns the connected stream.
+    /// </summary>
+    public interface IBrokerTransport {
+        Task<Stream> AcceptAsync(CancellationToken ct);
+        Task<Stream> ConnectAsync(CancellationToken ct);
+    }
+
+    /// <summary>
+    /// Named pipe transport. Message mode on Windows; elsewhere .NET backs the
+    /// pipe with a Unix domain socket, which only does byte mode (the frames
+    /// are length-prefixed, so nothing depends on message boundaries).
+    /// </summary>
+    public sealed class NamedPipeTransport : IBrokerTransport {
+        public const string DefaultName="GaymBroker";
+        private readonly string _name;
+        public NamedPipeTransport(string name=DefaultName){ _name=name; }
+
+        public async Task<Stream> AcceptAsync(CancellationToken ct){
+            var mode=OperatingSystem.IsWindows() ? PipeTransmissionMode.Message : PipeTransmissionMode.Byte;
+            var server=new NamedPipeServerStream(_name, PipeDirection.InOut, NamedPipeServerStream.MaxAllowedServerInstances,
+                mode, PipeOptions.Asynchronous);
+            try { await server.WaitForConnectionAsync(ct).ConfigureAwait(false); return server; }
+            catch { server.Dispose(); throw; }
+        }
+
+        public async Task<Stream> ConnectAsync(CancellationToken ct){
+            var client=new NamedPipeClientStream(".", _name, PipeDirection.InOut, PipeOptions.Asynchronous);
+            try { await client.ConnectAsync(ct).ConfigureAwait(false); return client; }
+            catch { client.Dispose(); throw; }
+        }
+    }
+}
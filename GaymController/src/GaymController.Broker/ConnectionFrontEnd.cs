@@ -0,0 +1,299 @@
+using System;
+using System.Buffers.Binary;
+using System.Collections.Concurrent;
+using System.IO;
+using System.Threading;
+using System.Threading.Tasks;
+using GaymController.Shared.Contracts;
+
+namespace GaymController.Broker {
+    /// <summary>
+    /// Client-facing side of the broker. <see cref="Listeners"/> accepts stay
+    /// armed at all times (a listener re-arms before its client is served), so
+    /// a reconnect storm after a profile switch connects in parallel instead
+    /// of one pipe instance at a time; OPEN_CONTROLLER is answered from the
+    /// <see cref="PadHandleCache"/>, so HELLO→OPEN_OK does no device open.
+    /// RUMBLE_SUBSCRIBE joins the slot's <see cref="RumbleFanout"/>, fed by a
+    /// poll of the open pads; each subscription has its own sender, so a
+    /// client that stops reading holds back nobody else.
+    /// Traced SET_STATE frames are stamped at <see cref="LatencyHop.BrokerRx"/>
+    /// into <see cref="Probe"/> and handed to the driver with their trace.
+    /// When the last session holding a pad closes it or disconnects, the pad
+    /// is centred: the cache keeps it open, so it would otherwise hold the
+    /// client's last input until the driver watchdog (if enabled) fires.
+    /// Slots with a <see cref="Mirrors"/> entry get their state page
+    /// republished on SET_STATE, open/close, rumble and LED changes and once
+    /// a second.
+    /// </summary>
+    public sealed class ConnectionFrontEnd {
+        public const int DefaultListeners=8;
+        // ERROR codes; detail is the offending type, slot or handle.
+        public const uint ErrUnknownType=1, ErrBadSlot=2, ErrBadHandle=3, ErrDevice=4, ErrBadFrame=5;
+
+        private const int MaxPayload=64;
+        private readonly IBrokerTransport _transport;
+        private readonly PadHandleCache _pads;
+        private readonly RumbleFanout[] _rumble;
+        private readonly int[] _holders; // sessions with the slot open, under _holdGates[slot]
+        private readonly object[] _holdGates;
+        private readonly ConcurrentDictionary<Task, byte> _live=new(); // running ServeAsync tasks
+        private int _sessions;
+
+        // One client connection. Replies and RUMBLE_EVENTs share the pipe;
+        // WriteLock keeps their frames whole.
+        private sealed class Session {
+            public readonly Stream Pipe;
+            public readonly SemaphoreSlim WriteLock=new(1, 1);
+            public readonly PadLease?[] Leases;
+            public readonly RumbleFanout.Subscriber?[] Rumble;
+            public Session(Stream pipe, int slots){ Pipe=pipe; Leases=new PadLease?[slots]; Rumble=new RumbleFanout.Subscriber?[slots]; }
+        }
+
+        public ConnectionFrontEnd(IBrokerTransport transport, PadHandleCache pads, int listeners=DefaultListeners, LatencyProbe? probe=null){
+            if (listeners<1) throw new ArgumentOutOfRangeException(nameof(listeners));
+            _transport=transport; _pads=pads; Listeners=listeners; Probe=probe ?? new LatencyProbe();
+            _rumble=new RumbleFanout[pads.Slots];
+            for (uint s=0;s<_rumble.Length;s++) _rumble[s]=new RumbleFanout(HandleOf(s));
+            _holders=new int[pads.Slots];
+            _holdGates=new object[pads.Slots];
+            for (int s=0;s<_holdGates.Length;s++) _holdGates[s]=new object();
+        }
+
+        public int Listeners { get; }
+        public LatencyProbe Probe { get; }
+        /// <summary>How often open pads with rumble subscribers or a mirror are polled for rumble and LEDs.</summary>
+        public TimeSpan FeedbackPoll { get; init; }=TimeSpan.FromMilliseconds(4);
+        /// <summary>Per-slot state pages; null (or a null entry) leaves a slot unmirrored.</summary>
+        public PadMirrorPublisher?[]? Mirrors { get; init; }
+        public RumbleFanout Rumble(uint slot)=>_rumble[slot];
+        private PadMirrorPublisher? Mirror(uint slot)=>Mirrors!=null && slot<Mirrors.Length ? Mirrors[slot] : null;
+        public int Sessions=>Volatile.Read(ref _sessions);
+
+        /// <summary>
+        /// Serves until <paramref name="ct"/> is cancelled; open sessions end
+        /// with it. Completes once the listeners, the feedback poll and every
+        /// session have finished, so the pads and mirrors can be disposed.
+        /// </summary>
+        public async Task RunAsync(CancellationToken ct){
+            var loops=new Task[Listeners+1];
+            for (int i=0;i<Listeners;i++) loops[i]=ListenAsync(ct);
+            loops[Listeners]=PollFeedbackAsync(ct);
+            await Task.WhenAll(loops).ConfigureAwait(false);
+            await Task.WhenAll(_live.Keys).ConfigureAwait(false);
+        }
+
+        private async Task ListenAsync(CancellationToken ct){
+            while (!ct.IsCancellationRequested) {
+                Stream client;
+                try { client=await _transport.AcceptAsync(ct).ConfigureAwait(false); }
+                catch (OperationCanceledException) { break; }
+                catch (IOException) { continue; } // client gave up mid-connect
+                var session=ServeAsync(client, ct);
+                _live.TryAdd(session, 0);
+                _=session.ContinueWith(t=>_live.TryRemove(t, out _), TaskScheduler.Default);
+            }
+        }
+
+        private async Task PollFeedbackAsync(CancellationToken ct){
+            const ulong Second=1_000_000_000UL;
+            using var timer=new PeriodicTimer(FeedbackPoll);
+            ulong lastTick=LatencyTrace.NowNs();
+            try {
+                while (await timer.WaitForNextTickAsync(ct).ConfigureAwait(false)) {
+                    ulong now=LatencyTrace.NowNs();
+                    for (uint s=0;s<_rumble.Length;s++) {
+                        var mirror=Mirror(s);
+                        if ((_rumble[s].Subscribers==0 && mirror==null) || !_pads.IsOpen(s)) continue;
+                        try {
+                            using var lease=_pads.Acquire(s);
+                            if (lease.Device.TryGetRumble(out uint seq, out byte left, out byte right)) {
+                                // VPAD_RUMBLE levels are 0..255; RUMBLE_EVENT carries 16-bit motors.
+                                _rumble[s].Publish((ushort)(left*257), (ushort)(right*257));
+                                mirror?.OnRumble(seq, left, right, now);
+                            }
+                            if (mirror!=null && lease.Device.TryGetLeds(out byte r, out byte g, out byte b))
+                                mirror.OnLeds(r, g, b, now);
+                        }
+                        catch (Exception) { } // SET_STATE reports and invalidates a dead pad
+                    }
+                    if (now-lastTick>=Second) {
+                        lastTick=now;
+                        if (Mirrors!=null) foreach (var m in Mirrors) m?.Tick(now);
+                    }
+                }
+            }
+            catch (OperationCanceledException) { }
+            catch (ObjectDisposedException) { } // mirrors disposed past the host's wait
+        }
+
+        private async Task ServeAsync(Stream pipe, CancellationToken ct){
+            await Task.Yield(); // let the listener re-arm before the handshake runs
+            Interlocked.Increment(ref _sessions);
+            var session=new Session(pipe, _pads.Slots);
+            var header=new byte[Wire.HeaderBytes];
+            var payload=new byte[MaxPayload];
+            var reply=new byte[Wire.HeaderBytes+8];
+            try {
+                while (await ReadExactAsync(pipe, header, ct).ConfigureAwait(false)) {
+                    Wire.ReadHeader(header, out uint len, out var type, out ushort flags);
+                    if (len<Wire.HeaderBytes || len-Wire.HeaderBytes>MaxPayload) {
+                        int n=Wire.PackError(reply, ErrBadFrame, len);
+                        await session.WriteLock.WaitAsync(ct).ConfigureAwait(false);
+                        try { await pipe.WriteAsync(reply.AsMemory(0, n), ct).ConfigureAwait(false); }
+                        finally { session.WriteLock.Release(); }
+                        break; // framing is lost
+                    }
+                    var body=payload.AsMemory(0, (int)len-Wire.HeaderBytes);
+                    if (!await ReadExactAsync(pipe, body, ct).ConfigureAwait(false)) break;
+                    // Held across Dispatch so a new subscription's first
+                    // RUMBLE_EVENT goes out after its ACK.
+                    await session.WriteLock.WaitAsync(ct).ConfigureAwait(false);
+                    try {
+                        int r=Dispatch(type, flags, body.Span, session, reply, ct);
+                        await pipe.WriteAsync(reply.AsMemory(0, r), ct).ConfigureAwait(false);
+                    }
+                    finally { session.WriteLock.Release(); }
+                }
+            }
+            catch (OperationCanceledException) { }
+            catch (IOException) { }
+            catch (ObjectDisposedException) { } // stopped past the host's wait
+            finally {
+                for (uint s=0;s<session.Rumble.Length;s++) Unsubscribe(session, s);
+                for (uint s=0;s<session.Leases.Length;s++) Release(session, s);
+                pipe.Dispose();
+                Interlocked.Decrement(ref _sessions);
+            }
+        }
+
+        private async Task SendRumbleAsync(Session session, RumbleFanout.Subscriber sub, CancellationToken ct){
+            try {
+                await foreach (var f in sub.Frames.ReadAllAsync(ct).ConfigureAwait(false)) {
+                    try {
+                        await session.WriteLock.WaitAsync(ct).ConfigureAwait(false);
+                        try { await session.Pipe.WriteAsync(f.Frame, ct).ConfigureAwait(false); }
+                        finally { session.WriteLock.Release(); }
+                    }
+                    finally { f.Release(); }
+                }
+            }
+            catch (OperationCanceledException) { }
+            catch (IOException) { }
+            catch (ObjectDisposedException) { } // session ended mid-write
+        }
+
+        private void Unsubscribe(Session session, uint slot){
+            var sub=session.Rumble[slot];
+            if (sub==null) return;
+            session.Rumble[slot]=null;
+            _rumble[slot].Unsubscribe(sub);
+        }
+
+        // Wire sticks are offset binary: 0x8000 is centre.
+        private static readonly GamepadState Neutral=new() { LX=0x8000, LY=0x8000, RX=0x8000, RY=0x8000 };
+
+        private void Hold(Session session, PadLease lease){
+            session.Leases[lease.Slot]=lease;
+            lock (_holdGates[lease.Slot]) {
+                if (++_holders[lease.Slot]==1)
+                    Mirror(lease.Slot)?.OnConnected(true, LatencyTrace.NowNs());
+            }
+        }
+
+        private void Release(Session session, uint slot){
+            var lease=session.Leases[slot];
+            if (lease==null) return;
+            session.Leases[slot]=null;
+            // Under the gate so a client opening the slot meanwhile cannot
+            // have its first SET_STATE overwritten by this neutral.
+            lock (_holdGates[slot]) {
+                if (--_holders[slot]==0) {
+                    try {
+                        lease.Device.SetState(Neutral);
+                        Mirror(slot)?.OnState(Neutral, null, LatencyTrace.NowNs());
+                    }
+                    catch (Exception) { _pads.Invalidate(slot); } // a reopen starts neutral anyway
+                    Mirror(slot)?.OnConnected(false, LatencyTrace.NowNs());
+                }
+            }
+            lease.Dispose();
+        }
+
+        private int Dispatch(MsgType type, ushort flags, ReadOnlySpan<byte> p, Session session, Span<byte> reply, CancellationToken ct){
+            var leases=session.Leases;
+            switch (type) {
+            case MsgType.HELLO:
+                return Wire.PackHelloOk(reply, 0);
+            case MsgType.OPEN_CONTROLLER: {
+                if (p.Length<4) return Wire.PackError(reply, ErrBadFrame, (uint)type);
+                uint slot=BinaryPrimitives.ReadUInt32LittleEndian(p);
+                if (slot>=leases.Length) return Wire.PackError(reply, ErrBadSlot, slot);
+                if (leases[slot]==null) {
+                    try { Hold(session, _pads.Acquire(slot)); }
+                    catch (Exception) { return Wire.PackError(reply, ErrDevice, slot); }
+                }
+                return Wire.PackOpenOk(reply, HandleOf(slot));
+            }
+            case MsgType.SET_STATE: {
+                if (!Wire.TryReadSetState(p, out ulong handle, out var s))
+                    return Wire.PackError(reply, ErrBadFrame, (uint)type);
+                var lease=Lease(leases, handle);
+                if (lease==null) return Wire.PackError(reply, ErrBadHandle, (uint)handle);
+                LatencyTrace? stamped=null;
+                try {
+                    if (Wire.TryReadTrace(p, flags, out var trace)) {
+                        stamped=Probe.Stamp(LatencyHop.BrokerRx, trace);
+                        lease.Device.SetState(s, stamped.Value);
+                    }
+                    else
+                        lease.Device.SetState(s);
+                }
+                catch (Exception) {
+                    _pads.Invalidate(lease.Slot); // the next OPEN_CONTROLLER reopens it
+                    return Wire.PackError(reply, ErrDevice, lease.Slot);
+                }
+                Mirror(lease.Slot)?.OnState(s, stamped, LatencyTrace.NowNs());
+                return Wire.PackAck(reply, (uint)MsgType.SET_STATE);
+            }
+            case MsgType.CLOSE_CONTROLLER: {
+                if (p.Length<8) return Wire.PackError(reply, ErrBadFrame, (uint)type);
+                ulong handle=BinaryPrimitives.ReadUInt64LittleEndian(p);
+                var lease=Lease(leases, handle);
+                if (lease==null) return Wire.PackError(reply, ErrBadHandle, (uint)handle);
+                Unsubscribe(session, lease.Slot);
+                Release(session, lease.Slot);
+                return Wire.PackAck(reply, (uint)MsgType.CLOSE_CONTROLLER);
+            }
+            case MsgType.RUMBLE_SUBSCRIBE: {
+                if (p.Length<8) return Wire.PackError(reply, ErrBadFrame, (uint)type);
+                ulong handle=BinaryPrimitives.ReadUInt64LittleEndian(p);
+                var lease=Lease(leases, handle);
+                if (lease==null) return Wire.PackError(reply, ErrBadHandle, (uint)handle);
+                if (session.Rumble[lease.Slot]==null) {
+                    var sub=_rumble[lease.Slot].Subscribe();
+                    session.Rumble[lease.Slot]=sub;
+                    _=SendRumbleAsync(session, sub, ct);
+                }
+                return Wire.PackAck(reply, (uint)MsgType.RUMBLE_SUBSCRIBE);
+            }
+            default:
+                return Wire.PackError(reply, ErrUnknownType, (uint)type);
+            }
+        }
+
+        // Handles are slot+1 (0 is never valid), as the mock broker hands out.
+        private static ulong HandleOf(uint slot)=>(ulong)slot+1;
+        private static PadLease? Lease(PadLease?[] leases, ulong handle)=>
+            handle-1<(ulong)leases.Length ? leases[handle-1] : null;
+
+        private static async Task<bool> ReadExactAsync(Stream s, Memory<byte> buf, CancellationToken ct){
+            int off=0;
+            while (off<buf.Length) {
+                int r=await s.ReadAsync(buf.Slice(off), ct).ConfigureAwait(false);
+                if (r==0) return false;
+                off+=r;
+            }
+            return true;
+        }
+    }
+}
@@ -1,24 +1,49 @@
 using System;
-using System.IO.Pipes;
+using System.IO;
 using System.ServiceProcess;
 using System.Threading;
 using System.Threading.Tasks;
+using GaymController.Shared.Contracts;
 
 namespace GaymController.Broker {
     public sealed class GcService : ServiceBase {
         private CancellationTokenSource? _cts;
-        protected override void OnStart(string[] args){ _cts=new(); _=RunAsync(_cts.Token); }
-        protected override void OnStop(){ _cts?.Cancel(); }
-        private async Task RunAsync(CancellationToken ct){
-            while(!ct.IsCancellationRequested){
-                using var server=new NamedPipeServerStream("GaymBroker", PipeDirection.InOut, 4, PipeTransmissionMode.Message, PipeOptions.Asynchronous);
-                await server.WaitForConnectionAsync(ct).ConfigureAwait(false);
-                _=HandleClientAsync(server, ct);
+        private PadHandleCache? _pads;
+        private PadMirrorPublisher?[]? _mirrors;
+        private Task? _serving;
+        // How long OnStop lets sessions and the feedback poll wind down
+        // before the pads and mirror pages are disposed under them.
+        private static readonly TimeSpan StopTimeout=TimeSpan.FromSeconds(5);
+        protected override void OnStart(string[] args){
+            _cts=new();
+            _pads=new PadHandleCache(new VPadDriver());
+            _mirrors=OpenMirrors(_pads.Slots);
+            _serving=RunAsync(_pads, _mirrors, _cts.Token);
+        }
+        protected override void OnStop(){
+            _cts?.Cancel();
+            try { _serving?.Wait(StopTimeout); }
+            catch (AggregateException) { } // a faulted loop must not keep the service from stopping
+            _pads?.Dispose();
+            if (_mirrors!=null) foreach (var m in _mirrors) m?.Dispose();
+        }
+        // A page that cannot be mapped only costs that slot its HUD view.
+        private static PadMirrorPublisher?[] OpenMirrors(int slots){
+            var mirrors=new PadMirrorPublisher?[slots];
+            for (uint s=0;s<slots;s++) {
+                try { mirrors[s]=new PadMirrorPublisher(PadMirrorWriter.CreateOrOpen(s)); }
+                catch (IOException) { }
+                catch (UnauthorizedAccessException) { }
             }
+            return mirrors;
         }
-        private async Task HandleClientAsync(NamedPipeServerStream pipe, CancellationToken ct){
-            // TODO: wire read loop, HELLO, OPEN, SET_STATE -> driver IOCTL
-            await Task.CompletedTask;
+        private static Task RunAsync(PadHandleCache pads, PadMirrorPublisher?[] mirrors, CancellationToken ct){
+            // Listeners are armed first; the pads open behind them, and a client
+            // that beats the prewarm to a slot just opens it itself.
+            var front=new ConnectionFrontEnd(new NamedPipeTransport(), pads) { Mirrors=mirrors };
+            var serving=front.RunAsync(ct);
+            _=Task.Run(()=>pads.Prewarm(), ct);
+            return serving;
         }
     }
 }
@@ -0,0 +1,115 @@
+using System;
+using System.Threading;
+using GaymController.Shared.Contracts;
+
+namespace GaymController.Broker {
+    /// <summary>An opened virtual pad (driver handle after IOCTL_VPAD_CREATE).</summary>
+    public interface IPadDevice : IDisposable {
+        void SetState(in GamepadState state);
+        /// <summary>SET_STATE that arrived traced; devices without a trace path drop it.</summary>
+        void SetState(in GamepadState state, in LatencyTrace trace)=>SetState(state);
+        /// <summary>Current motor levels the game asked for (0..255) and the driver's change count; false if the device has none to report.</summary>
+        bool TryGetRumble(out uint sequence, out byte left, out byte right){ sequence=0; left=right=0; return false; }
+        /// <summary>Current player LED colour; false if the device has none to report.</summary>
+        bool TryGetLeds(out byte r, out byte g, out byte b){ r=g=b=0; return false; }
+    }
+
+    public interface IPadDriver {
+        int Slots { get; }
+        /// <summary>The slow part of OPEN_CONTROLLER: interface lookup, CreateFile, IOCTL_VPAD_CREATE.</summary>
+        IPadDevice Open(uint slot);
+    }
+
+    /// <summary>One session's reference on a cached pad; dispose to let go.</summary>
+    public sealed class PadLease : IDisposable {
+        private PadHandleCache.Entry? _entry;
+        internal PadLease(uint slot, PadHandleCache.Entry entry){ Slot=slot; _entry=entry; Device=entry.Device; }
+        public uint Slot { get; }
+        public IPadDevice Device { get; }
+        public void Dispose(){ Interlocked.Exchange(ref _entry, null)?.Release(); }
+    }
+
+    /// <summary>
+    /// Opened per-slot driver handles shared by every client session. Handles
+    /// are opened up front by <see cref="Prewarm"/> (or by the first client of
+    /// a cold slot) and stay open after the last client lets go, so
+    /// OPEN_CONTROLLER is a refcount bump. <see cref="Invalidate"/> drops a
+    /// handle after a device error: sessions holding it finish with it, the
+    /// next acquire opens a fresh one.
+    /// </summary>
+    public sealed class PadHandleCache : IDisposable {
+        internal sealed class Entry {
+            public readonly IPadDevice Device;
+            private int _refs=1; // the cache's own reference while the entry is current
+            public Entry(IPadDevice device){ Device=device; }
+            public int Refs=>Volatile.Read(ref _refs);
+            public void AddRef(){ Interlocked.Increment(ref _refs); }
+            public void Release(){ if (Interlocked.Decrement(ref _refs)==0) Device.Dispose(); }
+        }
+
+        private readonly IPadDriver _driver;
+        private readonly Entry?[] _entries;
+        private readonly object[] _locks;
+        private int _opens;
+
+        public PadHandleCache(IPadDriver driver){
+            _driver=driver;
+            _entries=new Entry?[driver.Slots];
+            _locks=new object[driver.Slots];
+            for (int i=0;i<_locks.Length;i++) _locks[i]=new object();
+        }
+
+        public int Slots=>_entries.Length;
+        /// <summary>Device opens so far; stays flat while clients come and go.</summary>
+        public int Opens=>Volatile.Read(ref _opens);
+        public bool IsOpen(uint slot)=>slot<Slots && Volatile.Read(ref _entries[slot])!=null;
+
+        /// <summary>Sessions currently holding <paramref name="slot"/>.</summary>
+        public int Clients(uint slot){
+            var e=slot<Slots ? Volatile.Read(ref _entries[slot]) : null;
+            return e==null ? 0 : e.Refs-1;
+        }
+
+        /// <summary>
+        /// Opens every slot that is not open yet; returns how many are open.
+        /// A slot that fails stays cold and its first client retries it.
+        /// </summary>
+        public int Prewarm(){
+            int open=0;
+            for (uint s=0;s<Slots;s++) {
+                try { lock (_locks[s]) { Current(s); } open++; }
+                catch (Exception) { }
+            }
+            return open;
+        }
+
+        /// <exception cref="ArgumentOutOfRangeException">No such slot.</exception>
+        /// <remarks>Anything the driver's Open throws for a cold slot propagates.</remarks>
+        public PadLease Acquire(uint slot){
+            if (slot>=Slots) throw new ArgumentOutOfRangeException(nameof(slot));
+            lock (_locks[slot]) {
+                var e=Current(slot);
+                e.AddRef();
+                return new PadLease(slot, e);
+            }
+        }
+
+        public void Invalidate(uint slot){
+            if (slot>=Slots) return;
+            Entry? e;
+            lock (_locks[slot]) { e=_entries[slot]; Volatile.Write(ref _entries[slot], null); }
+            e?.Release();
+        }
+
+        public void Dispose(){ for (uint s=0;s<Slots;s++) Invalidate(s); }
+
+        private Entry Current(uint slot){
+            var e=_entries[slot];
+            if (e!=null) return e;
+            e=new Entry(_driver.Open(slot));
+            Interlocked.Increment(ref _opens);
+            Volatile.Write(ref _entries[slot], e);
+            return e;
+        }
+    }
+}
@@ -0,0 +1,84 @@
+using System;
+using GaymController.Shared.Contracts;
+
+namespace GaymController.Broker {
+    /// <summary>
+    /// Keeps one pad's <see cref="PadMirrorSnapshot"/> and republishes it to
+    /// its <see cref="PadMirrorWriter"/> on every SET_STATE, on rumble and LED
+    /// changes and on the once-a-second <see cref="Tick"/> that refreshes the
+    /// rate and latency figures. Callers come from several sessions and the
+    /// feedback poll; a lock keeps the page single-writer.
+    /// </summary>
+    public sealed class PadMirrorPublisher : IDisposable {
+        private readonly object _gate=new();
+        private readonly PadMirrorWriter _writer;
+        // Origin→BrokerRx of traced reports since the last Tick, which is
+        // what the page's Latency fields document. The driver's submit hop
+        // is only available cumulatively, via IOCTL_VPAD_GET_LATENCY.
+        private readonly LatencyHistogram _window=new();
+        private PadMirrorSnapshot _s;
+        private ulong _reportsAtTick;
+
+        public PadMirrorPublisher(PadMirrorWriter writer){ _writer=writer; }
+
+        public uint Slot=>_writer.Slot;
+        public uint Publishes=>_writer.Publishes;
+
+        /// <summary>A report was handed to the driver; <paramref name="trace"/> is its stamped trace, if it carried one.</summary>
+        public void OnState(in GamepadState state, LatencyTrace? trace, ulong nowNs){
+            lock (_gate) {
+                // Same conversion as VPadDriver: VPAD_STATE is what the page mirrors.
+                _s.Buttons=(ushort)state.Buttons;
+                _s.LeftTrigger=(byte)(state.LT>>8); _s.RightTrigger=(byte)(state.RT>>8);
+                _s.LX=(short)(state.LX^0x8000); _s.LY=(short)(state.LY^0x8000);
+                _s.RX=(short)(state.RX^0x8000); _s.RY=(short)(state.RY^0x8000);
+                _s.Reports++;
+                if (trace is LatencyTrace t) _window.Record(t.LastOffsetNs);
+                Publish(nowNs);
+            }
+        }
+
+        public void OnConnected(bool connected, ulong nowNs){
+            lock (_gate) {
+                byte c=connected ? (byte)1 : (byte)0;
+                if (_s.Connected==c) return;
+                _s.Connected=c;
+                Publish(nowNs);
+            }
+        }
+
+        public void OnRumble(uint sequence, byte left, byte right, ulong nowNs){
+            lock (_gate) {
+                if (_s.RumbleSequence==sequence && _s.RumbleLeft==left && _s.RumbleRight==right) return;
+                _s.RumbleSequence=sequence; _s.RumbleLeft=left; _s.RumbleRight=right;
+                Publish(nowNs);
+            }
+        }
+
+        public void OnLeds(byte r, byte g, byte b, ulong nowNs){
+            lock (_gate) {
+                if (_s.LedR==r && _s.LedG==g && _s.LedB==b) return;
+                _s.LedR=r; _s.LedG=g; _s.LedB=b;
+                Publish(nowNs);
+            }
+        }
+
+        /// <summary>Once a second: reports and latency over the second just ended.</summary>
+        public void Tick(ulong nowNs){
+            lock (_gate) {
+                _s.RateHz=(uint)Math.Min(_s.Reports-_reportsAtTick, uint.MaxValue);
+                _reportsAtTick=_s.Reports;
+                _s.LatencyP50Ns=Clamp(_window.Percentile(5000));
+                _s.LatencyP99Ns=Clamp(_window.Percentile(9900));
+                _s.LatencyMaxNs=Clamp(_window.MaxNs);
+                _window.Reset();
+                Publish(nowNs);
+            }
+        }
+
+        private void Publish(ulong nowNs){ _s.UpdatedNs=nowNs; _writer.Publish(_s); }
+        private static uint Clamp(ulong ns)=>(uint)Math.Min(ns, uint.MaxValue);
+
+        public void Dispose(){ _writer.Dispose(); }
+    }
+}
@@ -0,0 +1,134 @@
+using System;
+using System.ComponentModel;
+using System.Runtime.InteropServices;
+using System.Runtime.Versioning;
+using GaymController.Shared.Contracts;
+
+namespace GaymController.Broker {
+    /// <summary>
+    /// func driver pads via their device interface (reference/k VPadBroker's
+    /// OpenNthInterface, trimmed to what OPEN_CONTROLLER, SET_STATE and the feedback poll need).
+    /// </summary>
+    [SupportedOSPlatform("windows")]
+    public sealed class VPadDriver : IPadDriver {
+        static readonly Guid GUID_DEVINTERFACE_VPADPAD=new("E2A2D4A8-8BB3-41D8-BFC7-43B0B7D23B19");
+        const uint FILE_DEVICE_VPAD=0x9A00;
+        static uint CtlCode(uint func, uint access)=>(FILE_DEVICE_VPAD<<16)|(access<<14)|(func<<2); // METHOD_BUFFERED
+        static readonly uint IOCTL_VPAD_SET_STATE=CtlCode(0x902, 2);
+        static readonly uint IOCTL_VPAD_CREATE=CtlCode(0x903, 2);
+        static readonly uint IOCTL_VPAD_DESTROY=CtlCode(0x904, 2);
+        static readonly uint IOCTL_VPAD_GET_RUMBLE=CtlCode(0x905, 1);
+        static readonly uint IOCTL_VPAD_GET_LEDS=CtlCode(0x907, 1);
+
+        public int Slots { get; }
+        public VPadDriver(int slots=4){ Slots=slots; }
+
+        public IPadDevice Open(uint slot){
+            var dev=OpenNthInterface(GUID_DEVINTERFACE_VPADPAD, slot);
+            if (!DeviceIoControl(dev, IOCTL_VPAD_CREATE, IntPtr.Zero, 0, IntPtr.Zero, 0, out _, IntPtr.Zero)) {
+                int err=Marshal.GetLastWin32Error();
+                CloseHandle(dev);
+                throw new Win32Exception(err, "IOCTL_VPAD_CREATE failed");
+            }
+            return new Pad(dev);
+        }
+
+        [StructLayout(LayoutKind.Sequential, Pack=1)]
+        struct VPAD_STATE { public ushort Buttons; public byte LeftTrigger, RightTrigger; public short LX, LY, RX, RY; }
+        [StructLayout(LayoutKind.Sequential, Pack=1)]
+        struct VPAD_STATE_TRACED { public VPAD_STATE State; public LatencyTrace Trace; } // 28 bytes; the driver stamps submit latency
+        [StructLayout(LayoutKind.Sequential, Pack=1)]
+        struct VPAD_RUMBLE { public uint Sequence; public byte Left, Right; }
+        [StructLayout(LayoutKind.Sequential, Pack=1)]
+        struct VPAD_LEDS { public byte R, G, B; }
+
+        sealed class Pad : IPadDevice {
+            IntPtr _dev;
+            public Pad(IntPtr dev){ _dev=dev; }
+            public void SetState(in GamepadState s){
+                var st=ToDriver(s);
+                if (!DeviceIoControl(_dev, IOCTL_VPAD_SET_STATE, ref st, Marshal.SizeOf<VPAD_STATE>(), IntPtr.Zero, 0, out _, IntPtr.Zero))
+                    throw new Win32Exception(Marshal.GetLastWin32Error(), "IOCTL_VPAD_SET_STATE failed");
+            }
+            public void SetState(in GamepadState s, in LatencyTrace trace){
+                var st=new VPAD_STATE_TRACED { State=ToDriver(s), Trace=trace };
+                if (!DeviceIoControl(_dev, IOCTL_VPAD_SET_STATE, ref st, Marshal.SizeOf<VPAD_STATE_TRACED>(), IntPtr.Zero, 0, out _, IntPtr.Zero))
+                    throw new Win32Exception(Marshal.GetLastWin32Error(), "IOCTL_VPAD_SET_STATE failed");
+            }
+            public bool TryGetRumble(out uint sequence, out byte left, out byte right){
+                bool ok=DeviceIoControl(_dev, IOCTL_VPAD_GET_RUMBLE, IntPtr.Zero, 0, out VPAD_RUMBLE r, Marshal.SizeOf<VPAD_RUMBLE>(), out _, IntPtr.Zero);
+                sequence=r.Sequence; left=r.Left; right=r.Right;
+                return ok;
+            }
+            public bool TryGetLeds(out byte r, out byte g, out byte b){
+                bool ok=DeviceIoControl(_dev, IOCTL_VPAD_GET_LEDS, IntPtr.Zero, 0, out VPAD_LEDS l, Marshal.SizeOf<VPAD_LEDS>(), out _, IntPtr.Zero);
+                r=l.R; g=l.G; b=l.B;
+                return ok;
+            }
+            // Wire sticks are offset binary (32767 ~ centre), triggers 16-bit.
+            static VPAD_STATE ToDriver(in GamepadState s)=>new VPAD_STATE {
+                Buttons=(ushort)s.Buttons,
+                LeftTrigger=(byte)(s.LT>>8), RightTrigger=(byte)(s.RT>>8),
+                LX=(short)(s.LX^0x8000), LY=(short)(s.LY^0x8000),
+                RX=(short)(s.RX^0x8000), RY=(short)(s.RY^0x8000)
+            };
+            public void Dispose(){
+                if (_dev==IntPtr.Zero) return;
+                DeviceIoControl(_dev, IOCTL_VPAD_DESTROY, IntPtr.Zero, 0, IntPtr.Zero, 0, out _, IntPtr.Zero);
+                CloseHandle(_dev);
+                _dev=IntPtr.Zero;
+            }
+        }
+
+        static IntPtr OpenNthInterface(Guid guid, uint index){
+            var set=SetupDiGetClassDevs(ref guid, null, IntPtr.Zero, DIGCF_PRESENT|DIGCF_DEVICEINTERFACE);
+            if (set==(IntPtr)(-1)) throw new Win32Exception(Marshal.GetLastWin32Error());
+            try {
+                var data=new SP_DEVICE_INTERFACE_DATA { cbSize=Marshal.SizeOf<SP_DEVICE_INTERFACE_DATA>() };
+                if (!SetupDiEnumDeviceInterfaces(set, IntPtr.Zero, ref guid, index, ref data))
+                    throw new Win32Exception(Marshal.GetLastWin32Error(), $"no VPad interface {index}");
+                var detail=new SP_DEVICE_INTERFACE_DETAIL_DATA { cbSize=IntPtr.Size==8 ? 8 : 6 };
+                if (!SetupDiGetDeviceInterfaceDetail(set, ref data, ref detail, Marshal.SizeOf<SP_DEVICE_INTERFACE_DETAIL_DATA>(), out _, IntPtr.Zero))
+                    throw new Win32Exception(Marshal.GetLastWin32Error());
+                var dev=CreateFile(detail.DevicePath, GENERIC_READ|GENERIC_WRITE, FILE_SHARE_READ|FILE_SHARE_WRITE,
+                    IntPtr.Zero, OPEN_EXISTING, 0, IntPtr.Zero);
+                if (dev==(IntPtr)(-1)) throw new Win32Exception(Marshal.GetLastWin32Error());
+                return dev;
+            }
+            finally { SetupDiDestroyDeviceInfoList(set); }
+        }
+
+        const uint DIGCF_PRESENT=0x2, DIGCF_DEVICEINTERFACE=0x10;
+        const uint GENERIC_READ=0x80000000, GENERIC_WRITE=0x40000000;
+        const uint FILE_SHARE_READ=1, FILE_SHARE_WRITE=2, OPEN_EXISTING=3;
+
+        [StructLayout(LayoutKind.Sequential)]
+        struct SP_DEVICE_INTERFACE_DATA { public int cbSize; public Guid InterfaceClassGuid; public int Flags; public IntPtr Reserved; }
+        [StructLayout(LayoutKind.Sequential, CharSet=CharSet.Unicode)]
+        struct SP_DEVICE_INTERFACE_DETAIL_DATA { public int cbSize; [MarshalAs(UnmanagedType.ByValTStr, SizeConst=260)] public string DevicePath; }
+
+        [DllImport("setupapi.dll", CharSet=CharSet.Unicode, SetLastError=true)]
+        static extern IntPtr SetupDiGetClassDevs(ref Guid classGuid, string? enumerator, IntPtr hwndParent, uint flags);
+        [DllImport("setupapi.dll", SetLastError=true)]
+        static extern bool SetupDiEnumDeviceInterfaces(IntPtr set, IntPtr devInfo, ref Guid guid, uint index, ref SP_DEVICE_INTERFACE_DATA data);
+        [DllImport("setupapi.dll", CharSet=CharSet.Unicode, SetLastError=true)]
+        static extern bool SetupDiGetDeviceInterfaceDetail(IntPtr set, ref SP_DEVICE_INTERFACE_DATA data,
+            ref SP_DEVICE_INTERFACE_DETAIL_DATA detail, int size, out int required, IntPtr devInfo);
+        [DllImport("setupapi.dll", SetLastError=true)]
+        static extern bool SetupDiDestroyDeviceInfoList(IntPtr set);
+        [DllImport("kernel32.dll", CharSet=CharSet.Unicode, SetLastError=true)]
+        static extern IntPtr CreateFile(string name, uint access, uint share, IntPtr security, uint disposition, uint flags, IntPtr template);
+        [DllImport("kernel32.dll", SetLastError=true)]
+        static extern bool DeviceIoControl(IntPtr dev, uint code, IntPtr inBuf, int inLen, IntPtr outBuf, int outLen, out int returned, IntPtr overlapped);
+        [DllImport("kernel32.dll", SetLastError=true)]
+        static extern bool DeviceIoControl(IntPtr dev, uint code, ref VPAD_STATE inBuf, int inLen, IntPtr outBuf, int outLen, out int returned, IntPtr overlapped);
+        [DllImport("kernel32.dll", SetLastError=true)]
+        static extern bool DeviceIoControl(IntPtr dev, uint code, ref VPAD_STATE_TRACED inBuf, int inLen, IntPtr outBuf, int outLen, out int returned, IntPtr overlapped);
+        [DllImport("kernel32.dll", SetLastError=true)]
+        static extern bool DeviceIoControl(IntPtr dev, uint code, IntPtr inBuf, int inLen, out VPAD_RUMBLE outBuf, int outLen, out int returned, IntPtr overlapped);
+        [DllImport("kernel32.dll", SetLastError=true)]
+        static extern bool DeviceIoControl(IntPtr dev, uint code, IntPtr inBuf, int inLen, out VPAD_LEDS outBuf, int outLen, out int returned, IntPtr overlapped);
+        [DllImport("kernel32.dll", SetLastError=true)]
+        static extern bool CloseHandle(IntPtr handle);
+    }
+}
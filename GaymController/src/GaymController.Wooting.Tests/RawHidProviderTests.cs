@@ -2,6 +2,7 @@ using System;
 using System.Collections.Concurrent;
 using System.Collections.Generic;
 using System.Threading;
+using GaymController.Shared.Contracts;
 using GaymController.Wooting;
 using GaymController.Shared.Mapping;
 using Xunit;
@@ -47,5 +48,9 @@ public class RawHidProviderTests {
         Assert.Single(received);
         Assert.Equal("Key0", received[0].Source);
         Assert.Equal(1.0, received[0].Value, 3);
+        // Each report starts a trace; its events carry it past the HID read hop.
+        Assert.NotEqual(0UL, received[0].Trace.OriginNs);
+        Assert.Equal(received[0].TimestampUs, (long)(received[0].Trace.OriginNs / 1000));
+        Assert.Equal(1, provider.Probe.Total(LatencyHop.HidRead).Count);
     }
 }
@@ -1,10 +1,10 @@
 using System;
 using System.Collections.Generic;
-using System.Diagnostics;
 using System.IO;
 using System.Linq;
 using System.Text.Json;
 using System.Threading;
+using GaymController.Shared.Contracts;
 using GaymController.Shared.Mapping;
 
 namespace GaymController.Wooting {
@@ -16,22 +16,27 @@ namespace GaymController.Wooting {
         private volatile bool _running;
         private readonly byte[] _buf;
         private readonly double[] _last;
+        private readonly LatencyProbe _probe;
 
         public event EventHandler<InputEvent>? OnKeyAnalog;
 
-        public RawHidProvider(Func<Stream> opener, IDictionary<int,string> mapping, int reportSize = 64){
+        /// <summary>Starts every report's latency trace; share it with the output stage.</summary>
+        public LatencyProbe Probe => _probe;
+
+        public RawHidProvider(Func<Stream> opener, IDictionary<int,string> mapping, int reportSize = 64, LatencyProbe? probe = null){
             _opener = opener;
             _stream = opener();
             _map = mapping.Select(kv => (kv.Key, kv.Value)).ToArray();
             _buf = new byte[reportSize];
             _last = new double[_map.Length];
+            _probe = probe ?? new LatencyProbe();
             _thread = new Thread(ReadLoop){IsBackground=true};
         }
 
-        public static RawHidProvider FromMapping(Func<Stream> opener, string mappingPath, int reportSize = 64){
+        public static RawHidProvider FromMapping(Func<Stream> opener, string mappingPath, int reportSize = 64, LatencyProbe? probe = null){
             var json = File.ReadAllText(mappingPath);
             var map = JsonSerializer.Deserialize<Dictionary<int,string>>(json) ?? new();
-            return new RawHidProvider(opener, map, reportSize);
+            return new RawHidProvider(opener, map, reportSize, probe);
         }
 
         public void Start(){
@@ -64,13 +69,19 @@ namespace GaymController.Wooting {
                     continue;
                 }
 
-                var ts = Stopwatch.GetTimestamp() * 1_000_000 / Stopwatch.Frequency;
+                // The report is complete: this is the origin of its latency
+                // trace, carried by every event it produces.
+                var originNs = LatencyTrace.NowNs();
+                var ts = (long)(originNs / 1000);
+                LatencyTrace trace = default;
+                var traced = false;
                 for(var i=0;i<_map.Length;i++){
                     var (ofs,key) = _map[i];
                     var val = _buf[ofs] / 255.0;
                     if(Math.Abs(val - _last[i]) > 0.0001){
                         _last[i] = val;
-                        OnKeyAnalog?.Invoke(this, new InputEvent(key, val, ts));
+                        if(!traced){ trace = _probe.Stamp(LatencyHop.HidRead, _probe.Begin(originNs)); traced = true; }
+                        OnKeyAnalog?.Invoke(this, new InputEvent(key, val, ts, trace));
                     }
                 }
             }
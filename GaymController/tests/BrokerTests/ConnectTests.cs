@@ -0,0 +1,408 @@
+using System;
+using System.Buffers.Binary;
+using System.Collections.Concurrent;
+using System.Diagnostics;
+using System.IO;
+using System.IO.MemoryMappedFiles;
+using System.Linq;
+using System.Threading;
+using System.Threading.Tasks;
+using GaymController.Broker;
+using GaymController.Shared.Contracts;
+using Xunit;
+using Xunit.Abstractions;
+
+namespace BrokerTests {
+    public class ConnectTests {
+        private readonly ITestOutputHelper _out;
+        public ConnectTests(ITestOutputHelper output){ _out=output; }
+
+        // Stands in for the func driver; Open costs what a cold CreateFile +
+        // IOCTL_VPAD_CREATE roughly does.
+        sealed class FakeDriver : IPadDriver {
+            public int Slots { get; init; }=4;
+            public int OpenDelayMs { get; init; }
+            public int Opens, Disposed, Failing=-1;
+            public volatile int Rumble; // left | right << 8, as the game last set it
+            public volatile int Leds;   // r | g << 8 | b << 16
+            public readonly ConcurrentQueue<(uint Slot, GamepadState State)> States=new();
+            public readonly ConcurrentQueue<LatencyTrace> Traces=new();
+            public IPadDevice Open(uint slot){
+                if (slot==Failing) throw new IOException("device gone");
+                Interlocked.Increment(ref Opens);
+                if (OpenDelayMs>0) Thread.Sleep(OpenDelayMs);
+                return new Pad(this, slot);
+            }
+            sealed class Pad : IPadDevice {
+                readonly FakeDriver _d; readonly uint _slot;
+                public Pad(FakeDriver d, uint slot){ _d=d; _slot=slot; }
+                public void SetState(in GamepadState s){
+                    if (_slot==_d.Failing) throw new IOException("device gone");
+                    _d.States.Enqueue((_slot, s));
+                }
+                public void SetState(in GamepadState s, in LatencyTrace trace){
+                    SetState(s);
+                    _d.Traces.Enqueue(trace);
+                }
+                public bool TryGetRumble(out uint sequence, out byte left, out byte right){
+                    int r=_d.Rumble;
+                    sequence=(uint)r; left=(byte)r; right=(byte)(r>>8);
+                    return true;
+                }
+                public bool TryGetLeds(out byte r, out byte g, out byte b){
+                    int l=_d.Leds;
+                    r=(byte)l; g=(byte)(l>>8); b=(byte)(l>>16);
+                    return true;
+                }
+                public void Dispose(){ Interlocked.Increment(ref _d.Disposed); }
+            }
+        }
+
+        static async Task<(ushort Type, byte[] Payload)> RoundTrip(Stream s, byte[] frame, int len, CancellationToken ct){
+            await s.WriteAsync(frame.AsMemory(0, len), ct);
+            var header=new byte[Wire.HeaderBytes];
+            await s.ReadExactlyAsync(header, ct);
+            var payload=new byte[BinaryPrimitives.ReadUInt32LittleEndian(header)-Wire.HeaderBytes];
+            await s.ReadExactlyAsync(payload, ct);
+            return (BinaryPrimitives.ReadUInt16LittleEndian(header.AsSpan(4)), payload);
+        }
+
+        static async Task<ulong> HelloOpen(Stream s, uint slot, CancellationToken ct){
+            var frame=new byte[64];
+            var hello=await RoundTrip(s, frame, Wire.PackHello(frame), ct);
+            Assert.Equal((ushort)MsgType.HELLO_OK, hello.Type);
+            var open=await RoundTrip(s, frame, Wire.PackOpenController(frame, slot), ct);
+            Assert.Equal((ushort)MsgType.OPEN_OK, open.Type);
+            return BinaryPrimitives.ReadUInt64LittleEndian(open.Payload);
+        }
+
+        static string PipeName()=>$"gc_{Guid.NewGuid():N}";
+
+        [Fact]
+        public void CacheKeepsHandlesOpenAcrossClients() {
+            var driver=new FakeDriver();
+            using var pads=new PadHandleCache(driver);
+            Assert.Equal(4, pads.Prewarm());
+            Assert.Equal(4, pads.Opens);
+
+            var a=pads.Acquire(2); var b=pads.Acquire(2);
+            Assert.Same(a.Device, b.Device);
+            Assert.Equal(2, pads.Clients(2));
+            a.Dispose(); a.Dispose(); // double dispose releases once
+            b.Dispose();
+            Assert.Equal(0, pads.Clients(2));
+            Assert.True(pads.IsOpen(2));
+            Assert.Equal(0, driver.Disposed);
+            Assert.Equal(4, pads.Opens);
+
+            // Invalidated while held: the holder keeps its device until it lets
+            // go, the next client gets a fresh one.
+            var held=pads.Acquire(1);
+            pads.Invalidate(1);
+            Assert.False(pads.IsOpen(1));
+            Assert.Equal(0, driver.Disposed);
+            using (var fresh=pads.Acquire(1)) Assert.NotSame(held.Device, fresh.Device);
+            held.Dispose();
+            Assert.Equal(1, driver.Disposed);
+            Assert.Equal(5, pads.Opens);
+
+            Assert.Throws<ArgumentOutOfRangeException>(()=>pads.Acquire(4));
+            var failing=new FakeDriver { Failing=3 };
+            using var partial=new PadHandleCache(failing);
+            Assert.Equal(3, partial.Prewarm());
+            Assert.Throws<IOException>(()=>partial.Acquire(3));
+        }
+
+        [Fact]
+        public async Task SessionServesOpenSetStateClose() {
+            var cts=new CancellationTokenSource(TimeSpan.FromSeconds(10));
+            var driver=new FakeDriver { Failing=3 };
+            using var pads=new PadHandleCache(driver);
+            var transport=new NamedPipeTransport(PipeName());
+            var front=new ConnectionFrontEnd(transport, pads, 2);
+            var serving=front.RunAsync(cts.Token);
+
+            using (var s=await transport.ConnectAsync(cts.Token)) {
+                ulong h=await HelloOpen(s, 1, cts.Token);
+                Assert.Equal(2UL, h);
+                Assert.Equal(1, pads.Clients(1));
+
+                var frame=new byte[64];
+                var state=GamepadState.Neutral; state.Buttons=0x1234; state.LT=999;
+                var ack=await RoundTrip(s, frame, Wire.PackSetState(frame, h, state), cts.Token);
+                Assert.Equal((ushort)MsgType.ACK, ack.Type);
+                Assert.True(driver.States.TryDequeue(out var got));
+                Assert.Equal(1u, got.Slot);
+                Assert.Equal(0x1234u, got.State.Buttons);
+                Assert.Equal((ushort)999, got.State.LT);
+
+                var bad=await RoundTrip(s, frame, Wire.PackSetState(frame, 3, state), cts.Token); // slot 2 not opened
+                Assert.Equal((ushort)MsgType.ERROR, bad.Type);
+                Assert.Equal(ConnectionFrontEnd.ErrBadHandle, BinaryPrimitives.ReadUInt32LittleEndian(bad.Payload));
+                bad=await RoundTrip(s, frame, Wire.PackOpenController(frame, 9), cts.Token);
+                Assert.Equal(ConnectionFrontEnd.ErrBadSlot, BinaryPrimitives.ReadUInt32LittleEndian(bad.Payload));
+                bad=await RoundTrip(s, frame, Wire.PackOpenController(frame, 3), cts.Token);
+                Assert.Equal(ConnectionFrontEnd.ErrDevice, BinaryPrimitives.ReadUInt32LittleEndian(bad.Payload));
+                bad=await RoundTrip(s, frame, Wire.PackRumbleEvent(frame, h, 1, 2), cts.Token); // broker-to-client only
+                Assert.Equal(ConnectionFrontEnd.ErrUnknownType, BinaryPrimitives.ReadUInt32LittleEndian(bad.Payload));
+
+                ack=await RoundTrip(s, frame, Wire.PackCloseController(frame, h), cts.Token);
+                Assert.Equal((ushort)MsgType.ACK, ack.Type);
+                Assert.Equal(0, pads.Clients(1));
+                ulong again=await HelloOpen(s, 1, cts.Token); // same session reopens
+                Assert.Equal(h, again);
+            }
+            // Disconnect releases whatever the session still held.
+            for (int i=0;i<200 && (pads.Clients(1)!=0 || front.Sessions!=0);i++) await Task.Delay(10);
+            Assert.Equal(0, pads.Clients(1));
+            Assert.Equal(1, pads.Opens); // slot 1 once; slot 3 never opened
+            cts.Cancel();
+            await serving;
+        }
+
+        [Fact]
+        public async Task TracedSetStateIsStampedAndPassedOn() {
+            var cts=new CancellationTokenSource(TimeSpan.FromSeconds(10));
+            var driver=new FakeDriver();
+            using var pads=new PadHandleCache(driver);
+            var transport=new NamedPipeTransport(PipeName());
+            var front=new ConnectionFrontEnd(transport, pads, 1);
+            var serving=front.RunAsync(cts.Token);
+
+            using (var s=await transport.ConnectAsync(cts.Token)) {
+                ulong h=await HelloOpen(s, 0, cts.Token);
+                var frame=new byte[64];
+                var state=GamepadState.Neutral; state.Buttons=0x10;
+                var sent=new LatencyTrace(42, LatencyTrace.NowNs(), 1);
+                var ack=await RoundTrip(s, frame, Wire.PackSetState(frame, h, state, sent), cts.Token);
+                Assert.Equal((ushort)MsgType.ACK, ack.Type);
+                Assert.True(driver.States.TryDequeue(out var got));
+                Assert.Equal(0x10u, got.State.Buttons);
+                Assert.True(driver.Traces.TryDequeue(out var trace));
+                Assert.Equal(42u, trace.Sequence);
+                Assert.Equal(sent.OriginNs, trace.OriginNs);
+                Assert.True(trace.LastOffsetNs>=sent.LastOffsetNs);
+                Assert.Equal(1, front.Probe.Total(LatencyHop.BrokerRx).Count);
+
+                // Untraced frames take the plain path and record nothing.
+                ack=await RoundTrip(s, frame, Wire.PackSetState(frame, h, state), cts.Token);
+                Assert.Equal((ushort)MsgType.ACK, ack.Type);
+                Assert.True(driver.States.TryDequeue(out _));
+                Assert.True(driver.Traces.IsEmpty);
+                Assert.Equal(1, front.Probe.Total(LatencyHop.BrokerRx).Count);
+            }
+            cts.Cancel();
+            await serving;
+        }
+
+        static async Task<(ushort Type, byte[] Payload)> ReadFrame(Stream s, CancellationToken ct){
+            var header=new byte[Wire.HeaderBytes];
+            await s.ReadExactlyAsync(header, ct);
+            var payload=new byte[BinaryPrimitives.ReadUInt32LittleEndian(header)-Wire.HeaderBytes];
+            await s.ReadExactlyAsync(payload, ct);
+            return (BinaryPrimitives.ReadUInt16LittleEndian(header.AsSpan(4)), payload);
+        }
+
+        [Fact]
+        public async Task LastClientLeavingCentresThePad() {
+            var cts=new CancellationTokenSource(TimeSpan.FromSeconds(10));
+            var driver=new FakeDriver();
+            using var pads=new PadHandleCache(driver);
+            var transport=new NamedPipeTransport(PipeName());
+            var front=new ConnectionFrontEnd(transport, pads, 2);
+            var serving=front.RunAsync(cts.Token);
+
+            var frame=new byte[64];
+            var held=new GamepadState { Buttons=0x10, LT=0xFFFF, LX=0xFFFF, LY=0, RX=0x1234, RY=0x8000 };
+            using var a=await transport.ConnectAsync(cts.Token);
+            var b=await transport.ConnectAsync(cts.Token);
+            ulong ha=await HelloOpen(a, 0, cts.Token), hb=await HelloOpen(b, 0, cts.Token);
+            var ack=await RoundTrip(b, frame, Wire.PackSetState(frame, hb, held), cts.Token);
+            Assert.Equal((ushort)MsgType.ACK, ack.Type);
+            Assert.True(driver.States.TryDequeue(out _));
+
+            // b disconnects while a still holds the pad: nothing is sent.
+            b.Dispose();
+            for (int i=0;i<200 && front.Sessions!=1;i++) await Task.Delay(10);
+            Assert.Equal(1, front.Sessions);
+            Assert.True(driver.States.IsEmpty);
+
+            // a closes, the last holder: the pad is centred before the lease goes.
+            var closed=await RoundTrip(a, frame, Wire.PackCloseController(frame, ha), cts.Token);
+            Assert.Equal((ushort)MsgType.ACK, closed.Type);
+            Assert.True(driver.States.TryDequeue(out var neutral));
+            Assert.Equal(0u, neutral.Slot);
+            Assert.Equal(new GamepadState { LX=0x8000, LY=0x8000, RX=0x8000, RY=0x8000 }, neutral.State);
+            Assert.True(pads.IsOpen(0));
+
+            // Same on a disconnect without CLOSE_CONTROLLER.
+            ha=await HelloOpen(a, 0, cts.Token);
+            ack=await RoundTrip(a, frame, Wire.PackSetState(frame, ha, held), cts.Token);
+            Assert.Equal((ushort)MsgType.ACK, ack.Type);
+            Assert.True(driver.States.TryDequeue(out _));
+            a.Dispose();
+            for (int i=0;i<200 && driver.States.IsEmpty;i++) await Task.Delay(10);
+            Assert.True(driver.States.TryDequeue(out neutral));
+            Assert.Equal(0u, neutral.State.Buttons);
+            Assert.Equal((ushort)0, neutral.State.LT);
+            Assert.Equal((ushort)0x8000, neutral.State.LX);
+            Assert.True(driver.States.IsEmpty);
+            cts.Cancel();
+            await serving;
+        }
+
+        [Fact]
+        public async Task RumbleFansOutToSubscribers() {
+            var cts=new CancellationTokenSource(TimeSpan.FromSeconds(10));
+            var driver=new FakeDriver { Rumble=0x4020 };
+            using var pads=new PadHandleCache(driver);
+            var transport=new NamedPipeTransport(PipeName());
+            var front=new ConnectionFrontEnd(transport, pads, 2) { FeedbackPoll=TimeSpan.FromMilliseconds(1) };
+            var serving=front.RunAsync(cts.Token);
+
+            using var a=await transport.ConnectAsync(cts.Token);
+            using var b=await transport.ConnectAsync(cts.Token);
+            ulong ha=await HelloOpen(a, 0, cts.Token), hb=await HelloOpen(b, 0, cts.Token);
+            var frame=new byte[64];
+            var bad=await RoundTrip(a, frame, Wire.PackRumbleSubscribe(frame, 3), cts.Token);
+            Assert.Equal(ConnectionFrontEnd.ErrBadHandle, BinaryPrimitives.ReadUInt32LittleEndian(bad.Payload));
+            foreach (var (s, h) in new[] { (a, ha), (b, hb) }) {
+                var ack=await RoundTrip(s, frame, Wire.PackRumbleSubscribe(frame, h), cts.Token);
+                Assert.Equal((ushort)MsgType.ACK, ack.Type);
+            }
+            Assert.Equal(2, front.Rumble(0).Subscribers);
+
+            // Both get the current levels, scaled to 16 bits, from one encode.
+            foreach (var s in new[] { a, b }) {
+                var ev=await ReadFrame(s, cts.Token);
+                Assert.Equal((ushort)MsgType.RUMBLE_EVENT, ev.Type);
+                Assert.Equal(1UL, BinaryPrimitives.ReadUInt64LittleEndian(ev.Payload));
+                Assert.Equal((ushort)(0x20*257), BinaryPrimitives.ReadUInt16LittleEndian(ev.Payload.AsSpan(8)));
+                Assert.Equal((ushort)(0x40*257), BinaryPrimitives.ReadUInt16LittleEndian(ev.Payload.AsSpan(10)));
+            }
+            Assert.Equal(1, front.Rumble(0).Published);
+
+            // Closing the handle ends b's subscription; a keeps receiving.
+            var closed=await RoundTrip(b, frame, Wire.PackCloseController(frame, hb), cts.Token);
+            Assert.Equal((ushort)MsgType.ACK, closed.Type);
+            Assert.Equal(1, front.Rumble(0).Subscribers);
+            driver.Rumble=0x00FF;
+            var next=await ReadFrame(a, cts.Token);
+            Assert.Equal((ushort)MsgType.RUMBLE_EVENT, next.Type);
+            Assert.Equal((ushort)0xFFFF, BinaryPrimitives.ReadUInt16LittleEndian(next.Payload.AsSpan(8)));
+            Assert.Equal((ushort)0, BinaryPrimitives.ReadUInt16LittleEndian(next.Payload.AsSpan(10)));
+
+            a.Dispose();
+            for (int i=0;i<200 && front.Rumble(0).Subscribers!=0;i++) await Task.Delay(10);
+            Assert.Equal(0, front.Rumble(0).Subscribers);
+            cts.Cancel();
+            await serving;
+        }
+
+        [Fact]
+        public async Task MirrorFollowsSetStateFeedbackAndClose() {
+            var cts=new CancellationTokenSource(TimeSpan.FromSeconds(10));
+            var driver=new FakeDriver { Rumble=0x4020, Leds=0x030201 };
+            using var pads=new PadHandleCache(driver);
+            using var page=MemoryMappedFile.CreateNew(null, PadMirrorReader.MapBytes);
+            using var mirror=new PadMirrorPublisher(new PadMirrorWriter(page.CreateViewAccessor(), 1));
+            using var reader=new PadMirrorReader(page.CreateViewAccessor(0, 0, MemoryMappedFileAccess.Read));
+            var transport=new NamedPipeTransport(PipeName());
+            var front=new ConnectionFrontEnd(transport, pads, 1) {
+                FeedbackPoll=TimeSpan.FromMilliseconds(1), Mirrors=new PadMirrorPublisher?[] { null, mirror }
+            };
+            var serving=front.RunAsync(cts.Token);
+
+            Assert.True(reader.TryRead(out var snap));
+            Assert.Equal(0, snap.Connected);
+            using var s=await transport.ConnectAsync(cts.Token);
+            ulong h=await HelloOpen(s, 1, cts.Token);
+            var frame=new byte[64];
+            var state=new GamepadState { Buttons=0x1001, LT=0xFF00, LX=0x8000, RY=0xFFFF };
+            var sent=new LatencyTrace(7, LatencyTrace.NowNs());
+            var ack=await RoundTrip(s, frame, Wire.PackSetState(frame, h, state, sent), cts.Token);
+            Assert.Equal((ushort)MsgType.ACK, ack.Type);
+            Assert.True(reader.TryRead(out snap));
+            Assert.Equal(1, snap.Connected);
+            Assert.Equal(1UL, snap.Reports);
+            Assert.Equal((ushort)0x1001, snap.Buttons);
+            Assert.Equal((byte)0xFF, snap.LeftTrigger);
+            Assert.Equal((short)0, snap.LX);
+            Assert.Equal((short)0x7FFF, snap.RY);
+
+            // The feedback poll picks up rumble and LEDs without any subscriber.
+            for (int i=0;i<200 && (reader.TryRead(out snap) ? snap.LedB!=3 || snap.RumbleRight!=0x40 : true);i++) await Task.Delay(10);
+            Assert.Equal((byte)0x20, snap.RumbleLeft);
+            Assert.Equal((byte)0x40, snap.RumbleRight);
+            Assert.Equal(0x4020u, snap.RumbleSequence);
+            Assert.Equal((byte)1, snap.LedR);
+            uint quiet=mirror.Publishes;
+            await Task.Delay(50);
+            Assert.Equal(quiet, mirror.Publishes); // unchanged feedback does not republish
+
+            // The once-a-second tick reports the rate and the trace's latency.
+            for (int i=0;i<300 && (reader.TryRead(out snap) ? snap.RateHz==0 : true);i++) await Task.Delay(10);
+            Assert.Equal(1u, snap.RateHz);
+            Assert.True(snap.LatencyMaxNs>0 && snap.LatencyP50Ns<=snap.LatencyMaxNs);
+
+            var closed=await RoundTrip(s, frame, Wire.PackCloseController(frame, h), cts.Token);
+            Assert.Equal((ushort)MsgType.ACK, closed.Type);
+            Assert.True(reader.TryRead(out snap));
+            Assert.Equal(0, snap.Connected);
+
+            // Stopping with the session still connected: RunAsync ends only
+            // after it has, so the host may dispose the pads and mirrors.
+            Assert.Equal(1, front.Sessions);
+            cts.Cancel();
+            await serving;
+            Assert.Equal(0, front.Sessions);
+        }
+
+        [Fact]
+        public async Task ConnectStormNeedsNoDeviceOpen() {
+            // connect→OPEN_OK for 1..64 clients arriving at once: pre-armed
+            // listeners over a warm cache, one listener at a time (the old
+            // RunAsync loop), and pre-armed listeners over a cold cache.
+            await StormAsync(4, listeners: 8, prewarm: true); // JIT and thread pool warmup
+            _out.WriteLine("clients  p50/p99/max ms: 8 armed warm   1 armed warm         8 armed cold");
+            foreach (int clients in new[] { 1, 4, 16, 64 }) {
+                var (pooled, opens)=await StormAsync(clients, listeners: 8, prewarm: true);
+                Assert.Equal(4, opens); // the prewarm only
+                var (single, _)=await StormAsync(clients, listeners: 1, prewarm: true);
+                var (cold, coldOpens)=await StormAsync(clients, listeners: 8, prewarm: false);
+                Assert.Equal(Math.Min(clients, 4), coldOpens); // first client per slot, once
+                _out.WriteLine($"{clients,7}  {Stats(pooled),-21}{Stats(single),-21}{Stats(cold)}");
+            }
+        }
+
+        static async Task<(double[] Ms, int Opens)> StormAsync(int clients, int listeners, bool prewarm){
+            using var cts=new CancellationTokenSource(TimeSpan.FromSeconds(30));
+            var driver=new FakeDriver { OpenDelayMs=2 };
+            using var pads=new PadHandleCache(driver);
+            if (prewarm) pads.Prewarm();
+            var transport=new NamedPipeTransport(PipeName());
+            var serving=new ConnectionFrontEnd(transport, pads, listeners).RunAsync(cts.Token);
+            await Task.Delay(20); // listeners armed
+
+            using var start=new ManualResetEventSlim();
+            var runs=Enumerable.Range(0, clients).Select(i=>Task.Run(async ()=>{
+                start.Wait();
+                long t0=Stopwatch.GetTimestamp();
+                using var s=await transport.ConnectAsync(cts.Token);
+                await HelloOpen(s, (uint)(i%4), cts.Token);
+                return Stopwatch.GetElapsedTime(t0).TotalMilliseconds;
+            })).ToArray();
+            start.Set();
+            var ms=await Task.WhenAll(runs);
+            cts.Cancel();
+            await serving;
+            return (ms, driver.Opens);
+        }
+
+        static string Stats(double[] ms){
+            Array.Sort(ms);
+            double P(double q)=>ms[Math.Min(ms.Length-1, (int)(q*ms.Length))];
+            return $"{P(0.5):F2}/{P(0.99):F2}/{ms[^1]:F2}";
+        }
+    }
+}
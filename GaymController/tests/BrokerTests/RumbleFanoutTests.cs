@@ -0,0 +1,127 @@
+using System;
+using System.Buffers.Binary;
+using System.Collections.Generic;
+using System.Diagnostics;
+using GaymController.Broker;
+using GaymController.Shared.Contracts;
+using Xunit;
+using Xunit.Abstractions;
+
+namespace BrokerTests {
+    public class RumbleFanoutTests {
+        private readonly ITestOutputHelper _out;
+        public RumbleFanoutTests(ITestOutputHelper output){ _out=output; }
+
+        [Fact]
+        public void EncodesOnceForEverySubscriber() {
+            var fan=new RumbleFanout(7);
+            var a=fan.Subscribe(); var b=fan.Subscribe();
+            Assert.Equal(RumbleFanout.Status.Published, fan.Publish(0x0102, 0x0304));
+            Assert.True(a.Frames.TryRead(out var fa));
+            Assert.True(b.Frames.TryRead(out var fb));
+            Assert.Same(fa, fb);
+            var bytes=fa.Frame.Span;
+            Assert.Equal(RumbleFrame.Bytes, bytes.Length);
+            Assert.Equal((ushort)MsgType.RUMBLE_EVENT, BinaryPrimitives.ReadUInt16LittleEndian(bytes.Slice(4)));
+            Assert.Equal(7UL, BinaryPrimitives.ReadUInt64LittleEndian(bytes.Slice(Wire.HeaderBytes)));
+            Assert.Equal((ushort)0x0304, BinaryPrimitives.ReadUInt16LittleEndian(bytes.Slice(Wire.HeaderBytes+10)));
+            fa.Release(); fb.Release();
+
+            // Same motor values again: nothing to send.
+            Assert.Equal(RumbleFanout.Status.Unchanged, fan.Publish(0x0102, 0x0304));
+            Assert.False(a.Frames.TryRead(out _));
+            Assert.Equal(1, fan.Published);
+            Assert.Equal(1, fan.Unchanged);
+        }
+
+        [Fact]
+        public void StalledSubscriberKeepsOnlyTheLatest() {
+            var fan=new RumbleFanout(1);
+            var slow=fan.Subscribe(); var live=fan.Subscribe();
+            for (ushort v=1;v<=100;v++) {
+                fan.Publish(v, 0);
+                Assert.True(live.Frames.TryRead(out var f));
+                Assert.Equal(v, f.Low);
+                f.Release();
+            }
+            Assert.True(slow.Frames.TryRead(out var last));
+            Assert.Equal((ushort)100, last.Low);
+            Assert.Equal(100u, last.Sequence);
+            last.Release();
+            Assert.False(slow.Frames.TryRead(out _));
+            Assert.Equal(99, slow.Coalesced);
+            Assert.Equal(0, live.Coalesced);
+        }
+
+        [Fact]
+        public void LateSubscriberStartsCurrentAndUnsubscribeEndsTheQueue() {
+            var fan=new RumbleFanout(2);
+            Assert.Equal(RumbleFanout.Status.Published, fan.Publish(5, 6)); // nobody listening yet
+            var late=fan.Subscribe();
+            Assert.True(late.Frames.TryRead(out var f));
+            Assert.Equal((ushort)6, f.High);
+            f.Release();
+
+            fan.Publish(7, 8);
+            fan.Unsubscribe(late);
+            Assert.Equal(0, fan.Subscribers);
+            Assert.False(late.Frames.TryRead(out _)); // pending frame dropped
+            Assert.True(late.Frames.Completion.IsCompleted);
+            fan.Unsubscribe(late); // twice is harmless
+        }
+
+        [Fact]
+        public void FanoutCostAt1To64Subscribers() {
+            // Per event: one Publish plus every sender's take/release, against
+            // a naive per-client encode into a fresh send buffer; also Publish
+            // with every subscriber stalled (pure coalescing). CPU is wall time
+            // on this thread, memory is what the thread allocates per event.
+            const int events=20000;
+            long fanoutBytes1=0;
+            _out.WriteLine("subs   fanout ns/ev  ns/sub   stalled ns/ev   naive ns/ev  fanout B/ev  naive B/ev");
+            foreach (int n in new[] { 1, 2, 4, 8, 16, 32, 64 }) {
+                var fan=new RumbleFanout(1);
+                var subs=new RumbleFanout.Subscriber[n];
+                for (int i=0;i<n;i++) subs[i]=fan.Subscribe();
+                uint sink=0;
+                var (fanout, fanoutBytes)=PerEvent(events, i=>{
+                    fan.Publish((ushort)i, (ushort)~i);
+                    foreach (var s in subs) {
+                        s.Frames.TryRead(out var f);
+                        sink+=f!.Frame.Span[Wire.HeaderBytes+8];
+                        f.Release();
+                    }
+                });
+                var (stalled, _)=PerEvent(events, i=>fan.Publish((ushort)i, (ushort)i));
+                foreach (var s in subs) fan.Unsubscribe(s);
+
+                var queues=new Queue<byte[]>[n];
+                for (int q=0;q<n;q++) queues[q]=new Queue<byte[]>();
+                var (naive, naiveBytes)=PerEvent(events, i=>{
+                    foreach (var q in queues) {
+                        var frame=new byte[RumbleFrame.Bytes];
+                        Wire.PackRumbleEvent(frame, 1, (ushort)i, (ushort)~i);
+                        q.Enqueue(frame);
+                    }
+                    foreach (var q in queues) sink+=q.Dequeue()[Wire.HeaderBytes+8];
+                });
+                _out.WriteLine($"{n,4} {fanout,14:F1} {fanout/n,7:F1} {stalled,15:F1} {naive,13:F1} {fanoutBytes,12} {naiveBytes,11}");
+                GC.KeepAlive(sink);
+
+                // Encode-once: memory per event does not grow with subscribers.
+                if (n==1) fanoutBytes1=fanoutBytes;
+                else Assert.True(fanoutBytes<=fanoutBytes1+8, $"{fanoutBytes} B/ev at {n} subscribers");
+                Assert.True(naiveBytes>=n*RumbleFrame.Bytes);
+            }
+        }
+
+        static (double Ns, long Bytes) PerEvent(int events, Action<int> body){
+            for (int i=0;i<events/10;i++) body(i);
+            long b0=GC.GetAllocatedBytesForCurrentThread();
+            var sw=Stopwatch.StartNew();
+            for (int i=0;i<events;i++) body(i);
+            sw.Stop();
+            return (sw.Elapsed.TotalMilliseconds*1e6/events, (GC.GetAllocatedBytesForCurrentThread()-b0)/events);
+        }
+    }
+}
@@ -0,0 +1,100 @@
+using System;
+using System.Buffers.Binary;
+using System.IO;
+using Xunit;
+using GaymController.Shared.Contracts;
+
+namespace WireTests {
+    public class LatencyProbeTests {
+        [Fact]
+        public void BucketsMatchNative() {
+            // Edges from native/tests/LatencyProbeTests.cpp: exact below 16,
+            // then 16 buckets per power of two, saturating at the last one.
+            Assert.Equal(15, LatencyHistogram.BucketOf(15));
+            Assert.Equal(16, LatencyHistogram.BucketOf(16));
+            Assert.Equal(32, LatencyHistogram.BucketOf(32));
+            Assert.Equal(33, LatencyHistogram.BucketOf(34));
+            Assert.Equal(LatencyHistogram.Buckets-1, LatencyHistogram.BucketOf(ulong.MaxValue));
+            int prev=0;
+            for(ulong v=0;v<(1UL<<20);v+=1+v/64){
+                int b=LatencyHistogram.BucketOf(v);
+                Assert.True(b>=prev && LatencyHistogram.BucketUpper(b)>=v);
+                if(b>0) Assert.True(LatencyHistogram.BucketUpper(b-1)<v);
+                prev=b;
+            }
+        }
+
+        [Fact]
+        public void PercentilesOfUniformRamp() {
+            var h=new LatencyHistogram();
+            for(ulong v=1;v<=10000;v++) h.Record(v*100);
+            Assert.Equal(10000, h.Count);
+            Assert.Equal(1000000UL, h.MaxNs);
+            Assert.Equal(500050UL, h.MeanNs);
+            var p50=h.Percentile(5000);
+            Assert.True(p50>=500000 && p50<=500000*107/100);
+            Assert.Equal(1000000UL, h.Percentile(10000));
+        }
+
+        [Fact]
+        public void StampSplitsTotalAndStage() {
+            var p=new LatencyProbe();
+            var t=p.Begin(1000);
+            Assert.Equal(0u, t.Sequence);
+            Assert.Equal(1u, p.Begin(1000).Sequence);
+            t=p.Stamp(LatencyHop.HidRead, t, 1010);
+            t=p.Stamp(LatencyHop.GraphOut, t, 1300);
+            t=p.Stamp(LatencyHop.WireTx, t, 1250); // clock went backwards: stage clamps to 0
+            Assert.Equal(10UL, p.Total(LatencyHop.HidRead).MaxNs);
+            Assert.Equal(290UL, p.Stage(LatencyHop.GraphOut).MaxNs);
+            Assert.Equal(0UL, p.Stage(LatencyHop.WireTx).MaxNs);
+            Assert.Equal(250u, t.LastOffsetNs);
+            Assert.Equal(0, p.Total(LatencyHop.BrokerRx).Count);
+        }
+
+        // Captures what the sender writes and answers with a canned reply.
+        sealed class ReplyStream : Stream {
+            public readonly MemoryStream Sent=new();
+            private readonly MemoryStream _reply;
+            public ReplyStream(byte[] reply){ _reply=new MemoryStream(reply); }
+            public override int Read(byte[] buffer, int offset, int count)=>_reply.Read(buffer, offset, count);
+            public override void Write(byte[] buffer, int offset, int count)=>Sent.Write(buffer, offset, count);
+            public override bool CanRead=>true;
+            public override bool CanSeek=>false;
+            public override bool CanWrite=>true;
+            public override long Length=>throw new NotSupportedException();
+            public override long Position { get=>throw new NotSupportedException(); set=>throw new NotSupportedException(); }
+            public override void Flush(){}
+            public override long Seek(long offset, SeekOrigin origin)=>throw new NotSupportedException();
+            public override void SetLength(long value)=>throw new NotSupportedException();
+        }
+
+        [Fact]
+        public void SenderCarriesTheTraceOntoTheWire() {
+            var reply=new byte[32];
+            int n=Wire.PackAck(reply, (uint)MsgType.SET_STATE);
+            n+=Wire.PackError(reply.AsSpan(n), 3, 5);
+            var pipe=new ReplyStream(reply[..n]);
+            var probe=new LatencyProbe();
+            var sender=new SetStateSender(pipe, 2, probe);
+
+            var origin=probe.Begin(LatencyTrace.NowNs());
+            Assert.True(sender.Send(GamepadState.Neutral, origin));
+            Assert.Equal(1, probe.Total(LatencyHop.GraphOut).Count);
+            Assert.Equal(1, probe.Total(LatencyHop.WireTx).Count);
+            var frame=pipe.Sent.ToArray();
+            Assert.Equal(Wire.HeaderBytes+24+LatencyTrace.Bytes, frame.Length);
+            var flags=BinaryPrimitives.ReadUInt16LittleEndian(frame.AsSpan(6));
+            Assert.True(Wire.TryReadTrace(frame.AsSpan(Wire.HeaderBytes), flags, out var sent));
+            Assert.Equal(origin.Sequence, sent.Sequence);
+            Assert.Equal(origin.OriginNs, sent.OriginNs);
+
+            // Untraced input sends the plain frame; ERROR is reported, not thrown.
+            pipe.Sent.SetLength(0);
+            Assert.False(sender.Send(GamepadState.Neutral, default));
+            Assert.Equal(Wire.HeaderBytes+24, (int)pipe.Sent.Length);
+            Assert.Equal(1, probe.Total(LatencyHop.WireTx).Count);
+            Assert.Throws<EndOfStreamException>(()=>sender.Send(GamepadState.Neutral, default));
+        }
+    }
+}
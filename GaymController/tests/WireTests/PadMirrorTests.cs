@@ -0,0 +1,141 @@
+using System;
+using System.IO;
+using System.IO.MemoryMappedFiles;
+using System.Threading;
+using Xunit;
+using GaymController.Shared.Contracts;
+
+namespace WireTests {
+    public class PadMirrorTests {
+        // Page written by GcMirrorInit/GcMirrorPublish in native/tests/PadMirrorTests.cpp.
+        static readonly byte[] Header={
+            0x47,0x43,0x4D,0x52,0x01,0x00,0x00,0x00,0x40,0x00,0x00,0x00,0x03,0x00,0x00,0x00,
+            0x04,0x03,0x02,0x01,0x00,0x00,0x00,0x00,0x18,0x17,0x16,0x15,0x14,0x13,0x12,0x11
+        };
+        static readonly byte[] Body={
+            0x02,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+            0x01,0x02,0x03,0x04,0x05,0x06,0xFE,0xFF,0x09,0x0A,0x0B,0x0C,
+            0x0D,0x0E,0x0F,0x10,0x11,0x01,0x00,0x00,
+            0x12,0x13,0x14,0x15,
+            0x16,0x17,0x18,0x19,0x1A,0x1B,0x1C,0x1D,
+            0x1E,0x1F,0x20,0x21,0x22,0x23,0x24,0x25,
+            0x40,0x1F,0x00,0x00,0xA0,0x0F,0x00,0x00,
+            0x2E,0x2F,0x30,0x31,0x32,0x33,0x34,0x35,0x36,0x37,0x38,0x39,
+            0x00,0x00,0x00,0x00
+        };
+
+        static MemoryMappedViewAccessor GoldenPage(out MemoryMappedFile file){
+            file=MemoryMappedFile.CreateNew(null, PadMirrorReader.MapBytes);
+            var view=file.CreateViewAccessor();
+            view.WriteArray(0, Header, 0, Header.Length);
+            view.WriteArray(PadMirrorReader.SequenceOffset, Body, 0, Body.Length);
+            return view;
+        }
+
+        [Fact]
+        public void ReadsGoldenPage() {
+            using var reader=new PadMirrorReader(GoldenPage(out var file));
+            using var mapping=file;
+            Assert.Equal(3u, reader.Slot);
+            Assert.Equal(0x01020304u, reader.WriterPid);
+            Assert.Equal(1u, reader.Publishes);
+            Assert.True(reader.TryRead(out var s));
+            Assert.Equal((ushort)0x0201, s.Buttons);
+            Assert.Equal((byte)0x03, s.LeftTrigger);
+            Assert.Equal((byte)0x04, s.RightTrigger);
+            Assert.Equal((short)0x0605, s.LX);
+            Assert.Equal((short)-2, s.LY);
+            Assert.Equal((short)0x0C0B, s.RY);
+            Assert.Equal((byte)0x0E, s.RumbleRight);
+            Assert.Equal((byte)0x11, s.LedB);
+            Assert.Equal((byte)1, s.Connected);
+            Assert.Equal(0x15141312u, s.RumbleSequence);
+            Assert.Equal(0x1D1C1B1A19181716UL, s.UpdatedNs);
+            Assert.Equal(0x2524232221201F1EUL, s.Reports);
+            Assert.Equal(8000u, s.RateHz);
+            Assert.Equal(4000u, s.TargetRateHz);
+            Assert.Equal(0x35343332u, s.LatencyP99Ns);
+            Assert.Equal(0x39383736u, s.LatencyMaxNs);
+        }
+
+        [Fact]
+        public void RejectsUnknownLayoutAndBusyWriter() {
+            var view=GoldenPage(out var file);
+            using var mapping=file;
+            view.Write(4, 2u); // version 2
+            Assert.Throws<InvalidDataException>(()=>new PadMirrorReader(view));
+
+            using var reader=new PadMirrorReader(GoldenPage(out var file2));
+            using var mapping2=file2;
+            using var writer=file2.CreateViewAccessor();
+            writer.Write(PadMirrorReader.SequenceOffset, 3u); // publish in progress
+            Assert.False(reader.TryRead(out _, 4));
+        }
+
+        [Fact]
+        public void WriterProducesTheNativePage() {
+            using var golden=new PadMirrorReader(GoldenPage(out var file));
+            using var mapping=file;
+            Assert.True(golden.TryRead(out var s));
+
+            // Written over a stale page, as after a broker restart.
+            var view=GoldenPage(out var file2);
+            using var mapping2=file2;
+            using var writer=new PadMirrorWriter(view, 3);
+            using var page=file2.CreateViewAccessor();
+            Assert.Equal(0u, page.ReadUInt32(PadMirrorReader.SequenceOffset));
+            Assert.Equal(0UL, page.ReadUInt64(PadMirrorReader.SnapshotOffset+32)); // Reports cleared
+            writer.Publish(s);
+            Assert.Equal(1u, writer.Publishes);
+
+            var header=new byte[16];
+            page.ReadArray(0, header, 0, header.Length);
+            Assert.Equal(Header[..16], header);
+            Assert.Equal((uint)Environment.ProcessId, page.ReadUInt32(16));
+            var body=new byte[Body.Length];
+            page.ReadArray(PadMirrorReader.SequenceOffset, body, 0, body.Length);
+            Assert.Equal(Body, body);
+        }
+
+        [Fact]
+        public void WindowsPageIsGlobalAndUserReadOnly() {
+            // The broker service writes from session 0; HUDs read from the
+            // desktop session. Same checks as native PadMirrorTests.cpp.
+            Assert.Equal(OperatingSystem.IsWindows() ? "Global\\GaymController.Pad2" : "/GaymController.Pad2",
+                PadMirrorReader.PageName(2));
+            var sddl=PadMirrorWriter.PageSddl;
+            Assert.StartsWith("D:P", sddl);
+            Assert.Contains("(A;;GR;;;IU)", sddl);
+            Assert.Equal(1, sddl.Split(";;;IU)").Length-1);
+            Assert.DoesNotContain(";;;WD)", sddl);
+            Assert.DoesNotContain(";;;AU)", sddl);
+        }
+
+        [Fact]
+        public void NeverReturnsTornSnapshots() {
+            using var file=MemoryMappedFile.CreateNew(null, PadMirrorReader.MapBytes);
+            using var writer=new PadMirrorWriter(file.CreateViewAccessor(), 0);
+            using var reader=new PadMirrorReader(file.CreateViewAccessor());
+            const ulong last=100_000;
+            var t=new Thread(()=>{
+                var w=new PadMirrorSnapshot();
+                for (ulong n=1;n<=last;n++) {
+                    w.UpdatedNs=n*125_000; w.Reports=n; w.Reserved1=(uint)n;
+                    writer.Publish(w);
+                }
+            });
+            t.Start();
+            int torn=0, reads=0;
+            while (t.IsAlive) {
+                if (!reader.TryRead(out var s)) continue;
+                reads++;
+                if (s.UpdatedNs!=s.Reports*125_000 || s.Reserved1!=(uint)s.Reports) torn++;
+            }
+            t.Join();
+            Assert.Equal(0, torn);
+            Assert.True(reads>0);
+            Assert.True(reader.TryRead(out var final));
+            Assert.Equal(last, final.Reports);
+        }
+    }
+}
@@ -25,6 +25,32 @@ namespace WireTests {
             };
             Assert.Equal(exp.Length, len);
             Assert.True(buf.Slice(0,len).SequenceEqual(exp));
+            Wire.ReadHeader(buf, out var hlen, out var type, out var flags);
+            Assert.Equal((uint)len, hlen);
+            Assert.Equal(MsgType.SET_STATE, type);
+            Assert.Equal((ushort)0, flags);
+            Assert.True(Wire.TryReadSetState(buf.Slice(Wire.HeaderBytes,len-Wire.HeaderBytes), out var handle, out var back));
+            Assert.Equal(0x1122334455667788UL, handle);
+            Assert.Equal(state, back);
+            Assert.False(Wire.TryReadSetState(buf.Slice(Wire.HeaderBytes,23), out _, out _));
+        }
+        [Fact]
+        public void TracedSetStateFrameMatchesGolden() {
+            Span<byte> buf = stackalloc byte[48];
+            var trace = new LatencyTrace(0x01020304, 0x1112131415161718, 0x21222324);
+            var len = Wire.PackSetState(buf, 0x1122334455667788, GamepadState.Neutral, trace);
+            var exp = new byte[]{
+                0x30,0x00,0x00,0x00,0x14,0x00,0x01,0x00,
+                0x88,0x77,0x66,0x55,0x44,0x33,0x22,0x11,
+                0xFF,0x7F,0xFF,0x7F,0xFF,0x7F,0xFF,0x7F,
+                0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+                0x04,0x03,0x02,0x01,0x24,0x23,0x22,0x21,
+                0x18,0x17,0x16,0x15,0x14,0x13,0x12,0x11
+            };
+            Assert.Equal(exp.Length, len);
+            Assert.True(buf.Slice(0,len).SequenceEqual(exp));
+            Assert.True(Wire.TryReadTrace(buf.Slice(Wire.HeaderBytes,len-Wire.HeaderBytes), Wire.FlagTrace, out var back));
+            Assert.Equal(trace, back);
         }
         [Fact]
         public void RumbleEventFrameMatchesGolden() {
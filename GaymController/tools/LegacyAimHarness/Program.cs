@@ -5,7 +5,8 @@ using LegacyMouseAimPlugin = LegacyMouseAim.Legacy.LegacyMouseAim;
 
 namespace LegacyAimHarness {
     class Program {
-        static void Main(){
+        static void Main(string[] args){
+            if(args.Length >= 2 && args[0] == "golden"){ WriteGolden(args[1]); return; }
             var plugin = new LegacyMouseAimPlugin();
             var baseline = new BaselineCurve();
             double totalErr=0, maxErr=0; int n=0;
@@ -24,5 +25,37 @@ namespace LegacyAimHarness {
             Console.WriteLine($"Samples:{n} AvgErr%:{avgPct:F4} MaxErr%:{maxErr*100:F4}");
             Console.WriteLine(avgPct<0.5?"PASS":"FAIL");
         }
+
+        // Golden vectors for the native stick DSP (native/tests/data/ToStickGolden.csv).
+        // Each "#cfg" line lists sens,expo,adz,max,alpha,vgain,jitter,scaleX,scaleY
+        // followed by dx,dy,sx,sy rows from a fixed-seed delta stream.
+        static readonly float[][] GoldenConfigs = {
+            new[]{0.35f,0.6f,0.05f,1.0f,0.35f,0.0f,0.0f,1.0f,1.0f},
+            new[]{0.5f,0.3f,0.1f,0.8f,0.2f,0.4f,0.02f,1.0f,0.8f},
+            new[]{1.0f,0.0f,0.0f,1.0f,0.6f,1.0f,0.1f,1.2f,1.0f},
+            new[]{0.2f,0.9f,0.15f,1.0f,0.05f,0.0f,0.0f,1.0f,1.0f},
+        };
+
+        static void WriteGolden(string outPath){
+            var inv = CultureInfo.InvariantCulture;
+            using var w = new StreamWriter(outPath);
+            w.WriteLine("# generated by: dotnet run --project tools/LegacyAimHarness -- golden <path>");
+            foreach(var c in GoldenConfigs){
+                var aim = new LegacyMouseAimPlugin{
+                    Sensitivity=c[0], Expo=c[1], AntiDeadzone=c[2], MaxSpeed=c[3], EmaAlpha=c[4],
+                    VelocityGain=c[5], JitterFloor=c[6], ScaleX=c[7], ScaleY=c[8]
+                };
+                w.WriteLine("#cfg " + string.Join(",", Array.ConvertAll(c, v => v.ToString("R", inv))));
+                var rng = new Random(1234);
+                for(int i=0;i<500;i++){
+                    // Mostly small aim corrections with occasional flicks and idle frames.
+                    int mode = rng.Next(10);
+                    float dx = mode == 0 ? 0f : mode == 1 ? rng.Next(-400,401) : rng.Next(-40,41);
+                    float dy = mode == 0 ? 0f : mode == 1 ? rng.Next(-400,401) : rng.Next(-40,41);
+                    var (sx,sy) = aim.ToStick(dx,dy);
+                    w.WriteLine($"{dx.ToString(inv)},{dy.ToString(inv)},{sx},{sy}");
+                }
+            }
+        }
     }
 }